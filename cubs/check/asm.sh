@@ -0,0 +1,38 @@
+#!/bin/bash
+
+# Compile a program with the 32 bits backend, assemble it with nasm and
+# link it against the 32 bits libc, then run it.
+# Used as checker binary: BIN=check/asm.sh bash check/checker.sh
+
+COMPILER="./minicompil"
+options=""
+file=""
+
+for arg in "$@"; do
+    case $arg in
+	-x|-m)
+	    ;;
+	--*|-O[0-9])
+	    options="$options $arg"
+	    ;;
+	-*)
+	    exec $COMPILER "$@"
+	    ;;
+	*)
+	    file=$arg
+	    ;;
+    esac
+done
+
+tmp=`mktemp -d`
+trap "rm -rf $tmp" EXIT
+
+$COMPILER $options -S $file > $tmp/prog.asm
+ret=$?
+if [ $ret -ne 0 ]; then
+    exit $ret
+fi
+nasm -o $tmp/prog.o -f elf -d ELF_TYPE $tmp/prog.asm &&
+ld -m elf_i386 -s --dynamic-linker /lib/ld-linux.so.2 -lc \
+    $tmp/prog.o -o $tmp/prog || exit 255
+$tmp/prog
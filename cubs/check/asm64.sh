@@ -0,0 +1,35 @@
+#!/bin/bash
+
+# Compile a program with the x86-64 backend, then run it.
+# Used as checker binary: BIN=check/asm64.sh bash check/checker.sh
+
+COMPILER="./minicompil"
+options=""
+file=""
+
+for arg in "$@"; do
+    case $arg in
+	-x|-m)
+	    ;;
+	--*|-O[0-9])
+	    options="$options $arg"
+	    ;;
+	-*)
+	    exec $COMPILER "$@"
+	    ;;
+	*)
+	    file=$arg
+	    ;;
+    esac
+done
+
+tmp=`mktemp -d`
+trap "rm -rf $tmp" EXIT
+
+$COMPILER $options -A $file > $tmp/prog.s
+ret=$?
+if [ $ret -ne 0 ]; then
+    exit $ret
+fi
+as -o $tmp/prog.o $tmp/prog.s && ld -o $tmp/prog $tmp/prog.o || exit 255
+$tmp/prog
@@ -0,0 +1,240 @@
+#!/bin/bash
+
+# Run the programs of check/bench through every available backend, and
+# compare their speed. Each backend runs a program WARMUP times, then
+# RUNS times measured, except the SLOW ones which run once, not warmed
+# up. Backends compiling an executable are timed on the executable only.
+# A program reads the output of its .sh script if it has one, else its
+# .in file if it has one.
+# Reports the median and 95th percentile of the wall time, the peak
+# resident memory, and the speedup of each backend over the others.
+# All backends must give the same output and exit code as the first one,
+# and those which are available must compile every program.
+# Used by: make bench
+
+COMPILER=${COMPILER:-"./minicompil"}
+MEASURE=${MEASURE:-"check/measure"}
+BACKENDS=${BACKENDS:-"interp jit native cpp asm asm64 elf"}
+OPTIONS=${OPTIONS:-"-O2"}
+RUNS=${RUNS:-5}
+WARMUP=${WARMUP:-1}
+SLOW=${SLOW:-"interp"}
+WHITE=$'\E[m'
+RED=$'\E[01;31m'
+GREEN=$'\E[01;32m'
+PURPLE=$'\E[01;34m'
+YELLOW=$'\E[01;33m'
+SEP="${PURPLE}|${WHITE}"
+
+dir=`dirname $0`
+tmp=`mktemp -d`
+trap "rm -rf $tmp" EXIT
+glob_ret=0
+declare -A medians
+declare -a cmd
+
+# Prepare the command running a program with a backend.
+# Fill cmd, and return 1 if the backend isn't available, 2 if it is but
+# fails to compile the program.
+function prepare()
+{
+    local backend=$1
+    local file=$2
+    local options=$3
+    local prog=$tmp/prog.$backend
+
+    case $backend in
+	interp)
+	    cmd=($COMPILER $options -x $file)
+	    ;;
+	jit)
+	    cmd=($COMPILER $options -j $file)
+	    ;;
+	native)
+	    which c++ > /dev/null 2>&1 || return 1
+	    cmd=($COMPILER --native $options -x $file)
+	    ;;
+	cpp)
+	    which c++ > /dev/null 2>&1 || return 1
+	    $COMPILER $options -C $file > $prog.cc 2> /dev/null &&
+	    c++ -O2 -fwrapv -w -o $prog $prog.cc > /dev/null 2>&1 || return 2
+	    cmd=($prog)
+	    ;;
+	asm)
+	    which nasm > /dev/null 2>&1 || return 1
+	    $COMPILER $options -S $file > $prog.asm 2> /dev/null &&
+	    nasm -o $prog.o -f elf -d ELF_TYPE $prog.asm > /dev/null 2>&1 &&
+	    ld -m elf_i386 -s --dynamic-linker /lib/ld-linux.so.2 -lc \
+		$prog.o -o $prog > /dev/null 2>&1 || return 2
+	    cmd=($prog)
+	    ;;
+	asm64)
+	    which as > /dev/null 2>&1 || return 1
+	    $COMPILER $options -A $file > $prog.s 2> /dev/null &&
+	    as -o $prog.o $prog.s > /dev/null 2>&1 &&
+	    ld -o $prog $prog.o > /dev/null 2>&1 || return 2
+	    cmd=($prog)
+	    ;;
+	elf)
+	    $COMPILER $options -e $file > $prog 2> /dev/null &&
+	    chmod +x $prog || return 2
+	    cmd=($prog)
+	    ;;
+	*)
+	    echo "${RED}Unknown backend $backend${WHITE}" >&2
+	    return 1
+	    ;;
+    esac
+    return 0
+}
+
+# Print the median and 95th percentile (nearest rank) of some times.
+function statistics()
+{
+    sort -g | awk '{ t[NR] = $1 }
+	END {
+	    m = (NR % 2) ? t[(NR + 1) / 2] : (t[NR / 2] + t[NR / 2 + 1]) / 2;
+	    r = int(NR * 0.95); if (r < NR * 0.95) r++;
+	    printf "%.4f %.4f\n", m, t[r];
+	}'
+}
+
+function bench_file()
+{
+    local file=$1
+    local name=`basename $file .mmc`
+    local header=`head -n 1 $file`
+    local options="$OPTIONS"
+    local input=/dev/null
+    local reference=""
+    local ref_status=0
+
+    if [ "$header" != "#!/bin/cub" ]; then
+	options="$options ${header#* }"
+    fi
+    if [ -f "${file%.mmc}.sh" ]; then
+	input=$tmp/input
+	bash ${file%.mmc}.sh > $input
+    elif [ -f "${file%.mmc}.in" ]; then
+	input=${file%.mmc}.in
+    fi
+
+    echo
+    echo "${YELLOW}In $name: ${WHITE}"
+    printf " ${PURPLE}%-6s${WHITE} $SEP ${PURPLE}%9s${WHITE} $SEP ${PURPLE}%9s${WHITE} $SEP ${PURPLE}%8s${WHITE} $SEP ${PURPLE}%4s${WHITE} $SEP ${PURPLE}Output${WHITE}\n" \
+	Backend Median P95 "RSS (kB)" Exit
+    echo "${PURPLE}-----------------------------------------------------------${WHITE}"
+
+    for backend in $BACKENDS; do
+	prepare $backend $file "$options"
+	case $? in
+	    1)
+		printf " %-6s $SEP %9s $SEP %9s $SEP %8s $SEP %4s $SEP n/a\n" \
+		    $backend - - - -
+		continue
+		;;
+	    2)
+		printf " %-6s $SEP %9s $SEP %9s $SEP %8s $SEP %4s $SEP %s\n" \
+		    $backend - - - - "${RED}Compilation failed${WHITE}"
+		glob_ret=1
+		continue
+		;;
+	esac
+
+	local warmup=$WARMUP
+	local runs=$RUNS
+	if [[ " $SLOW " == *" $backend "* ]]; then
+	    warmup=0
+	    runs=1
+	fi
+	local i=0
+	for i in `seq 1 $warmup`; do
+	    $MEASURE $tmp/out "${cmd[@]}" < $input > /dev/null 2>&1
+	done
+
+	local times=""
+	local rss=0
+	local status=0
+	local same=1
+	for i in `seq 1 $runs`; do
+	    local res=`$MEASURE $tmp/out "${cmd[@]}" < $input 2> /dev/null`
+	    set -- $res
+	    times="$times$1"$'\n'
+	    [ "$2" -gt $rss ] && rss=$2
+	    status=$3
+	    if [ -z "$reference" ]; then
+		reference=$backend
+		ref_status=$status
+		cp $tmp/out $tmp/ref
+	    fi
+	    if [ "$status" != "$ref_status" ] || ! cmp -s $tmp/out $tmp/ref; then
+		same=0
+	    fi
+	done
+
+	local stats=`echo -n "$times" | statistics`
+	set -- $stats
+	medians["$name $backend"]=$1
+	local outvalue="${GREEN}Same${WHITE}"
+	if [ $same -eq 0 ]; then
+	    outvalue="${RED}Differ from $reference${WHITE}"
+	    glob_ret=1
+	fi
+	printf " %-6s $SEP %9s $SEP %9s $SEP %8s $SEP %4s $SEP %s\n" \
+	    $backend $1 $2 $rss $status "$outvalue"
+    done
+}
+
+# Print, for each pair of backends, how many times the one of the row
+# is faster than the one of the column: the geometric mean of the ratio
+# of medians, over the programs both could run.
+function speedups()
+{
+    echo
+    echo "${YELLOW}Speedup of row over column: ${WHITE}"
+    printf " %-6s" ""
+    for col in $BACKENDS; do
+	printf " $SEP %6s" $col
+    done
+    echo
+    for row in $BACKENDS; do
+	printf " ${PURPLE}%-6s${WHITE}" $row
+	for col in $BACKENDS; do
+	    local ratios=""
+	    for key in "${!medians[@]}"; do
+		local name=${key% *}
+		if [ "${key#* }" == "$row" ] &&
+		    [ -n "${medians["$name $col"]}" ]; then
+		    ratios="$ratios ${medians["$name $col"]} ${medians[$key]}"
+		fi
+	    done
+	    echo $ratios | awk '{
+		s = 0; n = 0;
+		for (i = 1; i < NF; i += 2)
+		    if ($(i + 1) > 0 && $i > 0) { s += log($i / $(i + 1)); n++ }
+		if (n == 0) printf " '"$SEP"' %6s", "-";
+		else printf " '"$SEP"' %6.3g", exp(s / n);
+	    }'
+	done
+	echo
+    done
+}
+
+function main()
+{
+    if [ ! -x $MEASURE ]; then
+	echo "${RED}$MEASURE not found, run: make bench${WHITE}" >&2
+	exit 2
+    fi
+    local files="$*"
+    if [ -z "$files" ]; then
+	files=`ls $dir/bench/*.mmc`
+    fi
+    for i in $files; do
+	bench_file $i
+    done
+    speedups
+    exit $glob_ret
+}
+
+main $*
@@ -0,0 +1,13 @@
+#!/bin/bash
+
+# Write the input of io.mmc: a number of records, then the records, each
+# an integer and a word.
+# Used by: check/bench.sh
+
+awk 'BEGIN {
+    n = 100000;
+    print n;
+    srand(1);
+    for (i = 0; i < n; i++)
+	printf "%d w%d\n", int(rand() * 100000), int(rand() * 50);
+}'
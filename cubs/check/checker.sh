@@ -1,6 +1,10 @@
 #!/bin/bash
 
-BIN="./minicompil" # To change
+# Each check/<dir>/<name>.mmc gives its options, exit code and standard
+# output in its header. If there is a check/<dir>/<name>.err, the
+# standard error must be the same as it too.
+
+BIN=${BIN:-"./minicompil"} # To change
 WHITE=$'\E[m'
 RED=$'\E[01;31m'
 GREEN=$'\E[01;32m'
@@ -12,6 +16,8 @@ SEP="${PURPLE}|${WHITE}"
 dir=`dirname $0`
 my_output="$dir/my.txt"
 ref_output="$dir/ref.txt"
+err_output=`mktemp`
+trap "rm -f $err_output" EXIT
 glob_ret=0
 
 
@@ -38,15 +44,19 @@ function get_output()
 function test_file()
 {
     local header=`cat $1 | head -n 1`
-    if [ "$header" != "#!/bin/cub" ]; then
+    local options=""
+    if [ "${header%% *}" != "#!/bin/cub" ]; then
 	return 255
     fi
+    if [ "$header" != "#!/bin/cub" ]; then
+	options=${header#* }
+    fi
     local attempted=`cat $1 | head -n 2 | tail -n 1`
     if [ "$attempted" == "#skip" ]; then
 	return 254
     fi
     attempted=${attempted###}
-    `$BIN $1 2> /dev/null > $ref_output`
+    `$BIN $options $1 2> $err_output > $ref_output`
     local ret=$?
     glob_ret=$ret
     glob_attempted=$attempted
@@ -92,6 +102,11 @@ function apply_test_to_file()
 		outvalue="Differ"
 		ret=1
 	    fi
+	    if [ -f "${1%.mmc}.err" ] &&
+		! diff "${1%.mmc}.err" $err_output > /dev/null; then
+		outvalue="Differ"
+		ret=1
+	    fi
 	fi
 	case $ret in
 	    0)
@@ -0,0 +1,35 @@
+#!/bin/bash
+
+# Compile a program into an executable, without assembler nor linker,
+# then run it.
+# Used as checker binary: BIN=check/elf.sh bash check/checker.sh
+
+COMPILER="./minicompil"
+options=""
+file=""
+
+for arg in "$@"; do
+    case $arg in
+	-x|-m)
+	    ;;
+	--*|-O[0-9])
+	    options="$options $arg"
+	    ;;
+	-*)
+	    exec $COMPILER "$@"
+	    ;;
+	*)
+	    file=$arg
+	    ;;
+    esac
+done
+
+tmp=`mktemp -d`
+trap "rm -rf $tmp" EXIT
+
+$COMPILER $options -e $file > $tmp/prog
+ret=$?
+if [ $ret -ne 0 ]; then
+    exit $ret
+fi
+chmod +x $tmp/prog && $tmp/prog
@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# Run a program compiled to x86-64 code in memory, instead of interpreted.
+# Used as checker binary: BIN=check/jit.sh bash check/checker.sh
+
+COMPILER="./minicompil"
+options=""
+files=""
+
+for arg in "$@"; do
+    case $arg in
+	-x|-m)
+	    ;;
+	--*|-O[0-9])
+	    options="$options $arg"
+	    ;;
+	-*)
+	    exec $COMPILER "$@"
+	    ;;
+	*)
+	    files="$files $arg"
+	    ;;
+    esac
+done
+
+exec $COMPILER $options -j $files
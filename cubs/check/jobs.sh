@@ -0,0 +1,51 @@
+#!/bin/bash
+
+# Lex a generated program large enough to be cut in JOBS chunks, with
+# invalid chars spread over its lines, by JOBS threads and by a single
+# one. Both must show the same tokens, the same errors in the same order,
+# and exit with the same code.
+# Used by: make check-jobs
+
+COMPILER=${COMPILER:-"./minicompil"}
+JOBS=${JOBS:-4}
+TOKENS=${TOKENS:-100000}
+MIN_CHUNK_SIZE=65536
+WHITE=$'\E[m'
+RED=$'\E[01;31m'
+GREEN=$'\E[01;32m'
+YELLOW=$'\E[01;33m'
+
+tmp=`mktemp -d`
+trap "rm -rf $tmp" EXIT
+
+$COMPILER --tokens=$TOKENS --output=$tmp/generated.mmc -G x > /dev/null 2>&1 ||
+    exit 1
+awk '{ print } NR % 499 == 0 { print "  $ " NR " @;" }' \
+    $tmp/generated.mmc > $tmp/prog.mmc
+
+size=`wc -c < $tmp/prog.mmc`
+if [ $size -lt $(($JOBS * $MIN_CHUNK_SIZE)) ]; then
+    echo "${RED}$size bytes are too few to be cut in $JOBS chunks${WHITE}" >&2
+    exit 1
+fi
+
+echo "${YELLOW}Lexing $size bytes with --jobs=$JOBS: ${WHITE}"
+for jobs in 1 $JOBS; do
+    $COMPILER --jobs=$jobs -L $tmp/prog.mmc > $tmp/out.$jobs 2> $tmp/err.$jobs
+    echo $? > $tmp/status.$jobs
+done
+
+ret=0
+for what in status out err; do
+    if cmp -s $tmp/$what.1 $tmp/$what.$JOBS; then
+	echo "${GREEN}[OK]${WHITE} Same $what as --jobs=1"
+    else
+	echo "${RED}[KO]${WHITE} Different $what from --jobs=1"
+	ret=1
+    fi
+done
+if ! grep -q "Invalid char" $tmp/err.1; then
+    echo "${RED}[KO]${WHITE} No lexing error found"
+    ret=1
+fi
+exit $ret
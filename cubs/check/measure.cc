@@ -0,0 +1,78 @@
+/*
+** Run a command, and measure it: wall time, peak resident memory and
+** exit status.
+** Used by the benchmarks: check/bench.sh
+**
+** Usage: measure output command [args...]
+** The standard output of the command goes to output, its standard
+** input is kept. The measure is written on one line:
+**   seconds peak_rss_in_kB status
+** status is 128 plus the signal number when the command was killed.
+*/
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace
+{
+  /*!
+  ** Get the time of a monotonic clock.
+  **
+  ** @return The time, in seconds
+  */
+  double
+  now()
+  {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 3)
+  {
+    std::fprintf(stderr, "Usage: %s output command [args...]\n", argv[0]);
+    return 2;
+  }
+
+  const double start = now();
+  const pid_t pid = fork();
+  if (pid < 0)
+  {
+    std::perror("fork");
+    return 2;
+  }
+  if (pid == 0)
+  {
+    const int fd = open(argv[1], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || dup2(fd, 1) < 0)
+      _exit(126);
+    close(fd);
+    execvp(argv[2], argv + 2);
+    _exit(127);
+  }
+
+  int status = 0;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage) != pid)
+  {
+    std::perror("wait4");
+    return 2;
+  }
+  const double elapsed = now() - start;
+
+  const int res = WIFEXITED(status) ? WEXITSTATUS(status) :
+    128 + WTERMSIG(status);
+  std::printf("%.6f %ld %d\n", elapsed, usage.ru_maxrss, res);
+  return 0;
+}
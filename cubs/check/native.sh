@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# Run a program compiled by the system C++ compiler, instead of interpreted.
+# Used as checker binary: BIN=check/native.sh bash check/checker.sh
+
+COMPILER="./minicompil"
+options=""
+files=""
+
+for arg in "$@"; do
+    case $arg in
+	-x|-m)
+	    ;;
+	--*|-O[0-9])
+	    options="$options $arg"
+	    ;;
+	-*)
+	    exec $COMPILER "$@"
+	    ;;
+	*)
+	    files="$files $arg"
+	    ;;
+    esac
+done
+
+exec $COMPILER --native $options -x $files
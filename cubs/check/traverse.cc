@@ -0,0 +1,226 @@
+/*
+** Measure how fast visitors walk a tree: a visitor counting the leaves,
+** a visitor given each node of the tree as a generic node, and the
+** pretty printer writing to /dev/null.
+** Used by: make bench-traverse
+**
+** Usage: traverse [tokens [runs [walks]]]
+** The tree is the one of a generated program of about tokens tokens
+** (default 10000, small enough to stay in cache, so that the walk and
+** not the memory is measured). Each measure is the best of runs
+** (default 5), and both counting visitors walk the tree walks times
+** (default 2000) per run.
+** Generic nodes are visited through the switch on their kind. Built
+** with -DVIRTUAL_VISIT against a tree where nodes accept visitors by
+** virtual calls, it measures the same walks with that dispatch.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sstream>
+#include <vector>
+#include <time.h>
+#include <unistd.h>
+#include "GenerateAST.hh"
+#include "Lexer.hh"
+#include "Parser.hh"
+#include "PrettyPrinterVisitor.hh"
+#include "NodeProgram.hh"
+#include "NodeNumber.hh"
+#include "NodeId.hh"
+
+using namespace MiniCompiler;
+
+/*
+** Apply X to the class name of each node.
+*/
+#define EACH_NODE(X)							\
+  X(NodeIds) X(NodeProgram) X(NodeAffect) X(NodeIf) X(NodeRead)		\
+  X(NodeArgument) X(NodeArguments) X(NodeReturn) X(NodeExit)		\
+  X(NodeCallFunc) X(NodeOperation) X(NodeExpression) X(NodeStringExpr)	\
+  X(NodeBoolean) X(NodeExpressions) X(NodeInstr) X(NodeCompoundInstr)	\
+  X(NodeFactor) X(NodeInstrs) X(NodeType) X(NodeFunction) X(NodeWhile)	\
+  X(NodeDeclarationBody) X(NodeFunctions) X(NodeNumber)			\
+  X(NodeDeclaration) X(NodeHeaderFunc) X(NodeDeclarations) X(NodeId)	\
+  X(NodeIdFunc) X(NodePrint)
+
+namespace
+{
+  /*!
+  ** Get the time of a monotonic clock.
+  **
+  ** @return The time, in seconds
+  */
+  double
+  now()
+  {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+  }
+
+#ifdef VIRTUAL_VISIT
+  /*!
+  ** Count the identifiers and numbers, the leaves of expressions.
+  */
+  class Counter : public ConstBaseVisitor
+  {
+  public:
+    Counter() : leaves(0) {}
+    using ConstBaseVisitor::visit;
+    virtual void visit(const AST::NodeId*) { ++leaves; }
+    virtual void visit(const AST::NodeNumber*) { ++leaves; }
+
+    unsigned long	leaves;
+  };
+# define WALK(visitor, tree) (tree)->accept(visitor)
+# define DISPATCH(visitor, node) (node)->accept(visitor)
+# define BASE(Visitor) ConstBaseVisitor
+# define VIRTUAL virtual
+#else
+  /*!
+  ** Count the identifiers and numbers, the leaves of expressions.
+  */
+  class Counter : public ConstBaseVisitor<Counter>
+  {
+  public:
+    Counter() : leaves(0) {}
+    using ConstBaseVisitor<Counter>::visit;
+    void visit(const AST::NodeId*) { ++leaves; }
+    void visit(const AST::NodeNumber*) { ++leaves; }
+
+    unsigned long	leaves;
+  };
+# define WALK(visitor, tree) (visitor).visit(tree)
+# define DISPATCH(visitor, node) (visitor).dispatch(node)
+# define BASE(Visitor) ConstBaseVisitor<Visitor>
+# define VIRTUAL
+#endif
+
+  /*!
+  ** Collect every node of a tree, parents before their children.
+  */
+  class Collector : public BASE(Collector)
+  {
+  public:
+#define COLLECT(Class)						\
+    VIRTUAL void visit(const AST::Class* node)			\
+    {								\
+      nodes.push_back(node);					\
+      BASE(Collector)::visit(node);				\
+    }
+    EACH_NODE(COLLECT)
+#undef COLLECT
+
+    std::vector<const AST::Node*>	nodes;
+  };
+
+  /*!
+  ** Count the nodes it is given by class, without visiting their
+  ** children.
+  */
+  class Kinds : public BASE(Kinds)
+  {
+  public:
+#define ZERO(Class) Class##s = 0;
+    Kinds() { EACH_NODE(ZERO) }
+#undef ZERO
+#define COUNT(Class)						\
+    VIRTUAL void visit(const AST::Class*) { ++Class##s; }	\
+    unsigned long Class##s;
+    EACH_NODE(COUNT)
+#undef COUNT
+
+    unsigned long total() const
+    {
+      unsigned long nodes = 0;
+#define ADD(Class) nodes += Class##s;
+      EACH_NODE(ADD)
+#undef ADD
+      return nodes;
+    }
+  };
+}
+
+int
+main(int argc, char** argv)
+{
+  GenerateAST::Parameters params;
+  params.tokens = argc > 1 ? std::atoll(argv[1]) : 10000;
+  const int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+  const int walks = argc > 3 ? std::atoi(argv[3]) : 2000;
+
+  std::stringstream program;
+  GenerateAST generator;
+  generator.setParameters(params);
+  generator.generate(program);
+  Lexer lexer(program);
+  Parser parser(lexer);
+  parser.construct();
+  const AST::NodeProgram* tree = parser.getSyntaxTree();
+  if (!tree)
+  {
+    std::fprintf(stderr, "The generated program doesn't parse\n");
+    return 1;
+  }
+
+  double walk = 1e9;
+  unsigned long leaves = 0;
+  for (int i = 0; i < runs; ++i)
+  {
+    Counter counter;
+    const double start = now();
+    for (int w = 0; w < walks; ++w)
+      WALK(counter, tree);
+    const double time = now() - start;
+    if (time < walk)
+      walk = time;
+    leaves = counter.leaves / walks;
+  }
+
+  Collector collector;
+  WALK(collector, tree);
+  const std::vector<const AST::Node*>& nodes = collector.nodes;
+  double dispatch = 1e9;
+  for (int i = 0; i < runs; ++i)
+  {
+    Kinds kinds;
+    const double start = now();
+    for (int w = 0; w < walks; ++w)
+      for (unsigned int n = 0; n < nodes.size(); ++n)
+	DISPATCH(kinds, nodes[n]);
+    const double time = now() - start;
+    if (time < dispatch)
+      dispatch = time;
+    if (kinds.total() != nodes.size() * walks)
+    {
+      std::fprintf(stderr, "%lu nodes visited instead of %lu\n",
+		   kinds.total(), static_cast<unsigned long>(nodes.size() * walks));
+      return 1;
+    }
+  }
+
+  double print = 1e9;
+  const int fd = open("/dev/null", O_WRONLY);
+  for (int i = 0; i < runs; ++i)
+  {
+    PrettyPrinterVisitor printer;
+    printer.setOutput(fd);
+    const double start = now();
+    WALK(printer, tree);
+    printer.flush();
+    const double time = now() - start;
+    if (time < print)
+      print = time;
+  }
+  close(fd);
+
+  std::printf("%lu leaves, %lu nodes\n", leaves,
+	      static_cast<unsigned long>(nodes.size()));
+  std::printf("walk %d times     %.4f s\n", walks, walk);
+  std::printf("dispatch %d times %.4f s\n", walks, dispatch);
+  std::printf("print             %.4f s\n", print);
+  return 0;
+}
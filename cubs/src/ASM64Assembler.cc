@@ -0,0 +1,1393 @@
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include "ASM64Assembler.hh"
+
+namespace MiniCompiler
+{
+  namespace
+  {
+    /*!
+    ** Pseudo register number of rip, only usable in memory references.
+    */
+    const int RIP = 16;
+
+    /*!
+    ** Remove spaces at both ends of a string.
+    **
+    ** @param s The string
+    **
+    ** @return The trimmed string
+    */
+    std::string
+    trim(const std::string& s)
+    {
+      const std::string::size_type begin = s.find_first_not_of(" \t");
+      if (begin == std::string::npos)
+	return "";
+      const std::string::size_type end = s.find_last_not_of(" \t");
+      return s.substr(begin, end - begin + 1);
+    }
+
+    /*!
+    ** Check if a char can be part of a symbol.
+    **
+    ** @param c The char
+    **
+    ** @return If it is allowed in a symbol
+    */
+    bool
+    isSymbolChar(const char c)
+    {
+      return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+    }
+
+    /*!
+    ** Split operands, separated by commas outside of strings.
+    **
+    ** @param text The operands
+    **
+    ** @return Each trimmed operand
+    */
+    std::vector<std::string>
+    split(const std::string& text)
+    {
+      std::vector<std::string> res;
+      std::string current;
+      char quote = 0;
+
+      for (std::string::size_type i = 0; i < text.size(); ++i)
+      {
+	const char c = text[i];
+	if (quote)
+	{
+	  if (c == '\\' && i + 1 < text.size())
+	    current += text[i++];
+	  else
+	    if (c == quote)
+	      quote = 0;
+	}
+	else
+	  if (c == '"' || c == '\'')
+	    quote = c;
+	  else
+	    if (c == ',')
+	    {
+	      res.push_back(trim(current));
+	      current.clear();
+	      continue;
+	    }
+	current += text[i];
+      }
+      if (!trim(current).empty() || !res.empty())
+	res.push_back(trim(current));
+
+      return res;
+    }
+
+    /*!
+    ** Get the number and the size of a register.
+    ** rax, rcx, rdx, rbx, rsp, rbp, rsi, rdi, then r8 to r15.
+    **
+    ** @param name The name
+    ** @param size Filled with its size in bytes
+    **
+    ** @return The register number, or -1 if it isn't a register
+    */
+    int
+    registerNumber(const std::string& name, int& size)
+    {
+      static const char* const NAMES[][8] =
+	{
+	  { "al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil" },
+	  { "ax", "cx", "dx", "bx", "sp", "bp", "si", "di" },
+	  { "eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi" },
+	  { "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi" }
+	};
+      static const int SIZES[] = { 1, 2, 4, 8 };
+      static const char SUFFIXES[] = { 'b', 'w', 'd', 0 };
+
+      for (int i = 0; i < 4; ++i)
+	for (int j = 0; j < 8; ++j)
+	  if (name == NAMES[i][j])
+	  {
+	    size = SIZES[i];
+	    return j;
+	  }
+
+      // r8 to r15, with an optional b, w or d suffix
+      if (name.size() < 2 || name[0] != 'r' || !isdigit(name[1]))
+	return -1;
+      std::string::size_type end = 1;
+      int nb = 0;
+      for (; end < name.size() && isdigit(name[end]); ++end)
+	nb = nb * 10 + name[end] - '0';
+      if (nb < 8 || nb > 15 || end + 1 < name.size())
+	return -1;
+      for (int i = 0; i < 4; ++i)
+	if ((end == name.size() && !SUFFIXES[i]) ||
+	    (end < name.size() && name[end] == SUFFIXES[i]))
+	{
+	  size = SIZES[i];
+	  return nb;
+	}
+
+      return -1;
+    }
+
+    /*!
+    ** Parse a number: decimal, hexadecimal with 0x, or a quoted char.
+    **
+    ** @param text The text
+    ** @param value Filled with the number
+    **
+    ** @return If it is a number
+    */
+    bool
+    parseNumber(const std::string& text, long long& value)
+    {
+      if (text.size() == 3 && text[0] == '\'' && text[2] == '\'')
+      {
+	value = static_cast<unsigned char>(text[1]);
+	return true;
+      }
+
+      std::string::size_type i = 0;
+      bool negative = false;
+      if (i < text.size() && (text[i] == '-' || text[i] == '+'))
+	negative = text[i++] == '-';
+      if (i >= text.size() || !isdigit(text[i]))
+	return false;
+
+      char* end = 0;
+      const unsigned long long n = strtoull(text.c_str() + i, &end, 0);
+      if (*end)
+	return false;
+      value = negative ? -static_cast<long long>(n) : n;
+      return true;
+    }
+
+    /*!
+    ** Parse an expression made of numbers and symbols, like
+    ** "label_end - label + 8". At most one symbol is added, and one
+    ** substracted.
+    **
+    ** @param text The expression
+    ** @param symbol Filled with the added symbol, if any
+    ** @param minus Filled with the substracted symbol, if any
+    ** @param value Filled with the sum of numbers
+    **
+    ** @return If the expression is valid
+    */
+    bool
+    parseExpression(const std::string& text, std::string& symbol,
+		    std::string& minus, long long& value)
+    {
+      std::string::size_type i = 0;
+      value = 0;
+      symbol.clear();
+      minus.clear();
+
+      while (i < text.size())
+      {
+	int sign = 1;
+	std::string::size_type next = text.find_first_of("+-", i + 1);
+	if (text[i] == '-' || text[i] == '+')
+	{
+	  sign = text[i] == '-' ? -1 : 1;
+	  next = text.find_first_of("+-", i + 1);
+	  ++i;
+	}
+	if (next == std::string::npos)
+	  next = text.size();
+	const std::string& term = trim(text.substr(i, next - i));
+	i = next;
+
+	long long n = 0;
+	if (parseNumber(term, n))
+	  value += sign * n;
+	else
+	{
+	  if (term.empty() || !isSymbolChar(term[0]) ||
+	      isdigit(static_cast<unsigned char>(term[0])))
+	    return false;
+	  std::string& target = sign > 0 ? symbol : minus;
+	  if (!target.empty())
+	    return false;
+	  target = term;
+	}
+      }
+
+      return minus.empty() || !symbol.empty();
+    }
+
+    /*!
+    ** Get the condition code of a jump or set suffix, like "ne" or "le".
+    **
+    ** @param suffix The suffix
+    **
+    ** @return The condition code, or -1 if unknown
+    */
+    int
+    conditionCode(const std::string& suffix)
+    {
+      static const char* const CONDITIONS[][3] =
+	{
+	  { "o", 0, 0 }, { "no", 0, 0 }, { "b", "c", "nae" },
+	  { "ae", "nb", "nc" }, { "e", "z", 0 }, { "ne", "nz", 0 },
+	  { "be", "na", 0 }, { "a", "nbe", 0 }, { "s", 0, 0 },
+	  { "ns", 0, 0 }, { "p", "pe", 0 }, { "np", "po", 0 },
+	  { "l", "nge", 0 }, { "ge", "nl", 0 }, { "le", "ng", 0 },
+	  { "g", "nle", 0 }
+	};
+
+      for (int i = 0; i < 16; ++i)
+	for (int j = 0; j < 3 && CONDITIONS[i][j]; ++j)
+	  if (suffix == CONDITIONS[i][j])
+	    return i;
+
+      return -1;
+    }
+
+    /*!
+    ** Check if a value can be encoded as a signed byte.
+    **
+    ** @param value The value
+    **
+    ** @return If it fits
+    */
+    bool
+    fitsByte(const long long value)
+    {
+      return value >= -128 && value <= 127;
+    }
+
+    /*!
+    ** Check if a value can be encoded as a signed 32 bits integer.
+    **
+    ** @param value The value
+    **
+    ** @return If it fits
+    */
+    bool
+    fitsInt(const long long value)
+    {
+      return value >= -2147483648LL && value <= 2147483647LL;
+    }
+
+    /*!
+    ** Get the opcode extension of an arithmetic instruction.
+    **
+    ** @param mnemonic The mnemonic
+    **
+    ** @return The extension, or -1 if it isn't arithmetic
+    */
+    int
+    arithmeticExtension(const std::string& mnemonic)
+    {
+      static const char* const NAMES[] =
+	{ "add", "or", "adc", "sbb", "and", "sub", "xor", "cmp" };
+
+      for (int i = 0; i < 8; ++i)
+	if (mnemonic == NAMES[i])
+	  return i;
+
+      return -1;
+    }
+
+    /*!
+    ** Get the opcode extension of a shift instruction.
+    **
+    ** @param mnemonic The mnemonic
+    **
+    ** @return The extension, or -1 if it isn't a shift
+    */
+    int
+    shiftExtension(const std::string& mnemonic)
+    {
+      static const char* const NAMES[] =
+	{ "rol", "ror", "rcl", "rcr", "shl", "shr", "sal", "sar" };
+
+      for (int i = 0; i < 8; ++i)
+	if (mnemonic == NAMES[i])
+	  return i == 6 ? 4 : i;
+
+      return -1;
+    }
+  }
+
+  /*!
+  ** Construct an empty operand.
+  */
+  ASM64Assembler::Operand::Operand()
+    : type(IMMEDIATE), size(0), reg(-1), index(-1), scale(1), value(0)
+  {
+  }
+
+  /*!
+  ** Construct an assembler, with every section empty.
+  */
+  ASM64Assembler::ASM64Assembler()
+    : _bssSize(0), _current(TEXT)
+  {
+  }
+
+  /*!
+  ** Destruct the assembler.
+  */
+  ASM64Assembler::~ASM64Assembler()
+  {
+  }
+
+  /*!
+  ** Assemble the given code, replacing the previous one.
+  ** Symbols are resolved later, by link.
+  **
+  ** @param code The assembly, in GNU as intel syntax
+  **
+  ** @return If the code was understood, else see getError
+  */
+  bool
+  ASM64Assembler::assemble(const std::string& code)
+  {
+    std::istringstream in(code);
+
+    for (unsigned int i = 0; i < NB_SECTIONS; ++i)
+      _bytes[i].clear();
+    _bssSize = 0;
+    _current = TEXT;
+    _symbols.clear();
+    _fixups.clear();
+
+    while (std::getline(in, _line))
+      if (!assembleLine(_line))
+	return false;
+
+    return true;
+  }
+
+  /*!
+  ** Resolve every reference to a symbol, once sections are placed.
+  ** May be called again, with other addresses.
+  **
+  ** @param bases The address of each section
+  **
+  ** @return If every symbol is defined and reachable, else see getError
+  */
+  bool
+  ASM64Assembler::link(const Address bases[NB_SECTIONS])
+  {
+    for (Fixups::const_iterator it = _fixups.begin();
+	 it != _fixups.end(); ++it)
+    {
+      Symbols::const_iterator sym = _symbols.find(it->symbol);
+      if (sym == _symbols.end())
+      {
+	_error = "Undefined symbol: " + it->symbol;
+	return false;
+      }
+      long long value = bases[sym->second.where] + sym->second.offset +
+	it->addend;
+      unsigned int size = 8;
+
+      if (!it->minus.empty())
+      {
+	Symbols::const_iterator minus = _symbols.find(it->minus);
+	if (minus == _symbols.end())
+	{
+	  _error = "Undefined symbol: " + it->minus;
+	  return false;
+	}
+	value -= bases[minus->second.where] + minus->second.offset;
+      }
+      if (it->relative)
+      {
+	value -= bases[it->where] + it->offset;
+	size = 4;
+	if (!fitsInt(value))
+	{
+	  _error = "Symbol out of reach: " + it->symbol;
+	  return false;
+	}
+      }
+
+      for (unsigned int i = 0; i < size; ++i)
+	_bytes[it->where][it->offset + i] = (value >> (i * 8)) & 0xFF;
+    }
+
+    return true;
+  }
+
+  /*!
+  ** Get the content of a section. The bss one is always empty.
+  **
+  ** @param s The section
+  **
+  ** @return Its bytes
+  */
+  const ASM64Assembler::Bytes&
+  ASM64Assembler::getSection(const section s) const
+  {
+    assert(s < NB_SECTIONS);
+    return _bytes[s];
+  }
+
+  /*!
+  ** Get the size of a section, once loaded in memory.
+  **
+  ** @param s The section
+  **
+  ** @return Its size in bytes
+  */
+  unsigned int
+  ASM64Assembler::getSize(const section s) const
+  {
+    assert(s < NB_SECTIONS);
+    return s == BSS ? _bssSize : _bytes[s].size();
+  }
+
+  /*!
+  ** Find where a symbol is defined.
+  **
+  ** @param name The symbol
+  ** @param where Filled with its section
+  ** @param offset Filled with its offset in the section
+  **
+  ** @return If it is defined
+  */
+  bool
+  ASM64Assembler::getSymbol(const std::string& name, section& where,
+			    unsigned int& offset) const
+  {
+    Symbols::const_iterator it = _symbols.find(name);
+    if (it == _symbols.end())
+      return false;
+
+    where = it->second.where;
+    offset = it->second.offset;
+    return true;
+  }
+
+  /*!
+  ** Get the last error, with the line it happened on.
+  **
+  ** @return The error message
+  */
+  const std::string&
+  ASM64Assembler::getError() const
+  {
+    return _error;
+  }
+
+  /*!
+  ** Assemble a line: labels, then a directive or an instruction.
+  **
+  ** @param line The line
+  **
+  ** @return If it was understood
+  */
+  bool
+  ASM64Assembler::assembleLine(const std::string& line)
+  {
+    // Remove the comment, which can't be in a string
+    std::string code;
+    char quote = 0;
+    for (std::string::size_type i = 0; i < line.size(); ++i)
+    {
+      const char c = line[i];
+      if (!quote && c == '#')
+	break;
+      if (quote && c == '\\' && i + 1 < line.size())
+	code += line[i++];
+      else
+	if (c == '"' || c == '\'')
+	  quote = quote == c ? 0 : (quote ? quote : c);
+      code += line[i];
+    }
+    code = trim(code);
+
+    // Labels
+    for (;;)
+    {
+      std::string::size_type end = 0;
+      while (end < code.size() && isSymbolChar(code[end]))
+	++end;
+      if (end == 0 || end >= code.size() || code[end] != ':')
+	break;
+
+      Symbol symbol;
+      symbol.where = _current;
+      symbol.offset = getSize(_current);
+      if (!_symbols.insert(std::make_pair(code.substr(0, end),
+					  symbol)).second)
+	return fail("Symbol already defined");
+      code = trim(code.substr(end + 1));
+    }
+    if (code.empty())
+      return true;
+
+    const std::string::size_type space = code.find_first_of(" \t");
+    const std::string& mnemonic = code.substr(0, space);
+    const std::string& rest =
+      space == std::string::npos ? "" : trim(code.substr(space));
+
+    if (mnemonic[0] == '.')
+      return assembleDirective(mnemonic, split(rest), rest);
+    return assembleInstruction(mnemonic, split(rest));
+  }
+
+  /*!
+  ** Assemble a directive: a section change, or data.
+  **
+  ** @param name The directive
+  ** @param args Its arguments
+  ** @param rest Its arguments, before being split
+  **
+  ** @return If it was understood
+  */
+  bool
+  ASM64Assembler::assembleDirective(const std::string& name,
+				    const Operands& args,
+				    const std::string& rest)
+  {
+    if (name == ".intel_syntax" || name == ".globl" || name == ".global")
+      return true;
+
+    if (name == ".text" || name == ".data" || name == ".bss" ||
+	name == ".section")
+    {
+      const std::string& target = name == ".section" ? rest : name;
+      if (target == ".text")
+	_current = TEXT;
+      else if (target == ".rodata")
+	_current = RODATA;
+      else if (target == ".data")
+	_current = DATA;
+      else if (target == ".bss")
+	_current = BSS;
+      else
+	return fail("Unknown section");
+      return true;
+    }
+
+    if (name == ".align" || name == ".zero")
+    {
+      long long n = 0;
+      if (args.size() != 1 || !parseNumber(args[0], n) || n < 0 ||
+	  (name == ".align" && (n == 0 || (n & (n - 1)))))
+	return fail("Invalid size");
+      if (name == ".align")
+	n = (n - getSize(_current) % n) % n;
+      if (_current == BSS)
+	_bssSize += n;
+      else
+	for (long long i = 0; i < n; ++i)
+	  emit(name == ".align" && _current == TEXT ? 0x90 : 0);
+      return true;
+    }
+
+    if (_current == BSS)
+      return fail("Data in bss");
+
+    if (name == ".byte" || name == ".long" || name == ".quad")
+    {
+      const unsigned int size =
+	name == ".byte" ? 1 : (name == ".long" ? 4 : 8);
+      for (Operands::const_iterator it = args.begin(); it != args.end(); ++it)
+      {
+	Fixup fixup;
+	if (!parseExpression(*it, fixup.symbol, fixup.minus, fixup.addend))
+	  return fail("Invalid expression");
+	if (fixup.symbol.empty())
+	{
+	  emitValue(fixup.addend, size);
+	  continue;
+	}
+	if (size != 8)
+	  return fail("Symbol in a value smaller than a quad");
+	fixup.where = _current;
+	fixup.offset = _bytes[_current].size();
+	fixup.relative = false;
+	_fixups.push_back(fixup);
+	emitValue(0, 8);
+      }
+      return true;
+    }
+
+    if (name == ".ascii" || name == ".asciz")
+    {
+      for (Operands::const_iterator it = args.begin(); it != args.end(); ++it)
+      {
+	const std::string& s = *it;
+	if (s.size() < 2 || s[0] != '"' || s[s.size() - 1] != '"')
+	  return fail("Invalid string");
+	for (std::string::size_type i = 1; i + 1 < s.size(); ++i)
+	{
+	  if (s[i] != '\\')
+	  {
+	    emit(s[i]);
+	    continue;
+	  }
+	  const char c = s[++i];
+	  if (c >= '0' && c <= '7')
+	  {
+	    int n = 0;
+	    for (int j = 0; j < 3 && s[i] >= '0' && s[i] <= '7'; ++j, ++i)
+	      n = n * 8 + s[i] - '0';
+	    --i;
+	    emit(n);
+	  }
+	  else
+	    switch (c)
+	    {
+	      case 'b': emit('\b'); break;
+	      case 'f': emit('\f'); break;
+	      case 'n': emit('\n'); break;
+	      case 'r': emit('\r'); break;
+	      case 't': emit('\t'); break;
+	      default: emit(c);
+	    }
+	}
+	if (name == ".asciz")
+	  emit(0);
+      }
+      return true;
+    }
+
+    return fail("Unknown directive");
+  }
+
+  /*!
+  ** Assemble an instruction.
+  **
+  ** @param mnemonic The mnemonic
+  ** @param args The operands
+  **
+  ** @return If it was understood
+  */
+  bool
+  ASM64Assembler::assembleInstruction(const std::string& mnemonic,
+				      const Operands& args)
+  {
+    if (_current != TEXT)
+      return fail("Instruction outside of text");
+
+    // Without operand
+    static const struct
+    {
+      const char*	mnemonic;
+      const char*	bytes;
+    } SIMPLES[] =
+      {
+	{ "ret", "\xC3" }, { "leave", "\xC9" }, { "syscall", "\x0F\x05" },
+	{ "cdq", "\x99" }, { "cqo", "\x48\x99" }, { "nop", "\x90" },
+	{ 0, 0 }
+      };
+    for (int i = 0; SIMPLES[i].mnemonic; ++i)
+      if (mnemonic == SIMPLES[i].mnemonic)
+      {
+	if (!args.empty())
+	  return fail("Unexpected operand");
+	for (const char* c = SIMPLES[i].bytes; *c; ++c)
+	  emit(*c);
+	return true;
+      }
+
+    // String instructions, with their repeat prefix
+    if (mnemonic == "rep" || mnemonic == "repe" || mnemonic == "repz" ||
+	mnemonic == "repne" || mnemonic == "repnz")
+    {
+      static const struct
+      {
+	const char*	mnemonic;
+	unsigned char	opcode;
+	bool		wide;
+      } STRINGS[] =
+	{
+	  { "movsb", 0xA4, false }, { "movsq", 0xA5, true },
+	  { "cmpsb", 0xA6, false }, { "stosb", 0xAA, false },
+	  { "stosq", 0xAB, true }, { "scasb", 0xAE, false },
+	  { 0, 0, false }
+	};
+      for (int i = 0; args.size() == 1 && STRINGS[i].mnemonic; ++i)
+	if (args[0] == STRINGS[i].mnemonic)
+	{
+	  emit(mnemonic.size() > 4 && mnemonic[3] == 'n' ? 0xF2 : 0xF3);
+	  if (STRINGS[i].wide)
+	    emit(0x48);
+	  emit(STRINGS[i].opcode);
+	  return true;
+	}
+      return fail("Unknown string instruction");
+    }
+
+    // Jumps and calls to a symbol
+    int size = 0;
+    const int condition =
+      mnemonic[0] == 'j' ? conditionCode(mnemonic.substr(1)) : -1;
+    if ((mnemonic == "jmp" || mnemonic == "call" || condition >= 0) &&
+	args.size() == 1 && !args[0].empty() && isSymbolChar(args[0][0]) &&
+	args[0].find_first_of(" [") == std::string::npos &&
+	registerNumber(args[0], size) < 0)
+    {
+      if (condition >= 0)
+      {
+	emit(0x0F);
+	emit(0x80 + condition);
+      }
+      else
+	emit(mnemonic == "jmp" ? 0xE9 : 0xE8);
+      emitRelative(args[0]);
+      return true;
+    }
+
+    Operand ops[3];
+    if (args.empty() || args.size() > 3)
+      return fail("Invalid number of operands");
+    for (unsigned int i = 0; i < args.size(); ++i)
+      if (!parseOperand(args[i], ops[i]))
+	return fail("Invalid operand " + args[i]);
+
+    if (args.size() == 1)
+      return encodeUnary(mnemonic, ops[0]);
+
+    if (args.size() == 3)
+    {
+      // imul r, r/m, imm
+      if (mnemonic != "imul" || ops[0].type != Operand::REGISTER ||
+	  ops[2].type != Operand::IMMEDIATE || ops[0].size < 4 ||
+	  ops[1].type == Operand::IMMEDIATE || !fitsInt(ops[2].value))
+	return fail("Invalid operands");
+      const bool small = fitsByte(ops[2].value);
+      emitRex(ops[0].size == 8, ops[0].reg, false, ops[1]);
+      emit(small ? 0x6B : 0x69);
+      emitModRM(ops[0].reg, ops[1], small ? 1 : 4);
+      emitValue(ops[2].value, small ? 1 : 4);
+      return true;
+    }
+
+    return encodeBinary(mnemonic, ops[0], ops[1]);
+  }
+
+  /*!
+  ** Parse an operand: a register, an immediate, a memory reference, or a
+  ** symbol.
+  **
+  ** @param text The operand
+  ** @param op Filled with the operand
+  **
+  ** @return If it is valid
+  */
+  bool
+  ASM64Assembler::parseOperand(const std::string& text, Operand& op) const
+  {
+    op = Operand();
+    if (text.empty())
+      return false;
+
+    if (parseNumber(text, op.value))
+    {
+      op.type = Operand::IMMEDIATE;
+      return true;
+    }
+
+    op.reg = registerNumber(text, op.size);
+    if (op.reg >= 0)
+    {
+      op.type = Operand::REGISTER;
+      return true;
+    }
+
+    if (text.find('[') != std::string::npos ||
+	text.find(" PTR ") != std::string::npos)
+      return parseMemory(text, op);
+
+    for (std::string::size_type i = 0; i < text.size(); ++i)
+      if (!isSymbolChar(text[i]))
+	return false;
+    op.type = Operand::SYMBOL;
+    op.symbol = text;
+    return true;
+  }
+
+  /*!
+  ** Parse a memory reference, like "QWORD PTR [rbp - 8]",
+  ** "[rdx + rdx * 4]" or "label[rip]".
+  **
+  ** @param text The operand
+  ** @param op Filled with the operand
+  **
+  ** @return If it is valid
+  */
+  bool
+  ASM64Assembler::parseMemory(const std::string& text, Operand& op) const
+  {
+    static const struct
+    {
+      const char*	name;
+      int		size;
+    } SIZES[] =
+      {
+	{ "BYTE PTR ", 1 }, { "WORD PTR ", 2 }, { "DWORD PTR ", 4 },
+	{ "QWORD PTR ", 8 }, { 0, 0 }
+      };
+    std::string rest = text;
+
+    op.type = Operand::MEMORY;
+    op.reg = -1;
+    for (int i = 0; SIZES[i].name; ++i)
+      if (rest.compare(0, std::string(SIZES[i].name).size(),
+		       SIZES[i].name) == 0)
+      {
+	op.size = SIZES[i].size;
+	rest = trim(rest.substr(std::string(SIZES[i].name).size()));
+	break;
+      }
+
+    const std::string::size_type open = rest.find('[');
+    if (open == std::string::npos || rest[rest.size() - 1] != ']')
+      return false;
+    op.symbol = trim(rest.substr(0, open));
+    for (std::string::size_type i = 0; i < op.symbol.size(); ++i)
+      if (!isSymbolChar(op.symbol[i]))
+	return false;
+
+    // Terms of the address, like "rbp", "- 8" or "rdx * 4"
+    const std::string& inner = rest.substr(open + 1, rest.size() - open - 2);
+    std::string::size_type i = 0;
+    while (i < inner.size())
+    {
+      int sign = 1;
+      const std::string::size_type begin = inner.find_first_not_of(" \t", i);
+      if (begin == std::string::npos)
+	break;
+      i = begin;
+      if (inner[i] == '-' || inner[i] == '+')
+      {
+	sign = inner[i] == '-' ? -1 : 1;
+	++i;
+      }
+      std::string::size_type next = inner.find_first_of("+-", i);
+      if (next == std::string::npos)
+	next = inner.size();
+      const std::string& term = trim(inner.substr(i, next - i));
+      i = next;
+
+      long long n = 0;
+      int size = 0;
+      const std::string::size_type star = term.find('*');
+      if (parseNumber(term, n))
+      {
+	op.value += sign * n;
+	continue;
+      }
+      if (sign < 0)
+	return false;
+      if (term == "rip")
+      {
+	if (op.reg >= 0)
+	  return false;
+	op.reg = RIP;
+	continue;
+      }
+      if (star != std::string::npos)
+      {
+	std::string name = trim(term.substr(0, star));
+	std::string scale = trim(term.substr(star + 1));
+	if (registerNumber(name, size) < 0)
+	  std::swap(name, scale);
+	const int reg = registerNumber(name, size);
+	if (reg < 0 || size != 8 || op.index >= 0 || !parseNumber(scale, n) ||
+	    (n != 1 && n != 2 && n != 4 && n != 8))
+	  return false;
+	op.index = reg;
+	op.scale = n;
+	continue;
+      }
+      const int reg = registerNumber(term, size);
+      if (reg < 0 || size != 8)
+	return false;
+      if (op.reg < 0)
+	op.reg = reg;
+      else
+	if (op.index < 0)
+	  op.index = reg;
+	else
+	  return false;
+    }
+
+    // rsp can't be an index, but it's the same to use it as base
+    if (op.index == 4 && op.scale == 1 && op.reg != 4 && op.reg != RIP)
+      std::swap(op.index, op.reg);
+    if (op.index == 4 || (op.reg == RIP && op.index >= 0))
+      return false;
+
+    // Only rip relative references may use a symbol
+    return op.symbol.empty() ? op.reg != RIP : op.reg == RIP;
+  }
+
+  /*!
+  ** Encode an instruction with two operands.
+  **
+  ** @param mnemonic The mnemonic
+  ** @param dst The destination
+  ** @param src The source
+  **
+  ** @return If it was understood
+  */
+  bool
+  ASM64Assembler::encodeBinary(const std::string& mnemonic, Operand& dst,
+			       Operand& src)
+  {
+    if (dst.type == Operand::IMMEDIATE || dst.type == Operand::SYMBOL ||
+	src.type == Operand::SYMBOL ||
+	(dst.type == Operand::MEMORY && src.type == Operand::MEMORY))
+      return fail("Invalid operands");
+
+    if (mnemonic == "lea")
+    {
+      if (dst.type != Operand::REGISTER || dst.size < 4 ||
+	  src.type != Operand::MEMORY)
+	return fail("Invalid operands");
+      emitRex(dst.size == 8, dst.reg, false, src);
+      emit(0x8D);
+      emitModRM(dst.reg, src, 0);
+      return true;
+    }
+
+    if (mnemonic == "movzx")
+    {
+      if (dst.type != Operand::REGISTER || dst.size < 4 ||
+	  src.type == Operand::IMMEDIATE || (src.size != 1 && src.size != 2))
+	return fail("Invalid operands");
+      emitRex(dst.size == 8, dst.reg, false, src);
+      emit(0x0F);
+      emit(src.size == 1 ? 0xB6 : 0xB7);
+      emitModRM(dst.reg, src, 0);
+      return true;
+    }
+
+    if (mnemonic == "imul")
+    {
+      if (src.type == Operand::IMMEDIATE)
+      {
+	Operand imm = src;
+	src = dst;
+	if (dst.type != Operand::REGISTER || dst.size < 4 ||
+	    !fitsInt(imm.value))
+	  return fail("Invalid operands");
+	const bool small = fitsByte(imm.value);
+	emitRex(dst.size == 8, dst.reg, false, src);
+	emit(small ? 0x6B : 0x69);
+	emitModRM(dst.reg, src, small ? 1 : 4);
+	emitValue(imm.value, small ? 1 : 4);
+	return true;
+      }
+      if (dst.type != Operand::REGISTER || dst.size < 4 ||
+	  (src.size && src.size != dst.size))
+	return fail("Invalid operands");
+      emitRex(dst.size == 8, dst.reg, false, src);
+      emit(0x0F);
+      emit(0xAF);
+      emitModRM(dst.reg, src, 0);
+      return true;
+    }
+
+    const int shift = shiftExtension(mnemonic);
+    if (shift >= 0)
+    {
+      const int size = dst.size;
+      if (!size || (src.type == Operand::REGISTER &&
+		    (src.reg != 1 || src.size != 1)) ||
+	  src.type == Operand::MEMORY)
+	return fail("Invalid operands");
+      if (size == 2)
+	emit(0x66);
+      emitRex(size == 8, shift, false, dst);
+      if (src.type == Operand::REGISTER)
+      {
+	emit(size == 1 ? 0xD2 : 0xD3);
+	emitModRM(shift, dst, 0);
+      }
+      else
+	if (src.value == 1)
+	{
+	  emit(size == 1 ? 0xD0 : 0xD1);
+	  emitModRM(shift, dst, 0);
+	}
+	else
+	{
+	  emit(size == 1 ? 0xC0 : 0xC1);
+	  emitModRM(shift, dst, 1);
+	  emitValue(src.value, 1);
+	}
+      return true;
+    }
+
+    const int size = dst.size ? dst.size : src.size;
+    if (!size || (src.type != Operand::IMMEDIATE && src.size &&
+		  src.size != size))
+      return fail("Invalid operand size");
+    if (src.type == Operand::IMMEDIATE &&
+	!(size == 8 && mnemonic == "mov" && dst.type == Operand::REGISTER) &&
+	!(size == 4 ? src.value >= -2147483648LL && src.value <= 4294967295LL :
+	  size == 2 ? src.value >= -32768 && src.value <= 65535 :
+	  size == 1 ? src.value >= -128 && src.value <= 255 :
+	  fitsInt(src.value)))
+      return fail("Immediate out of range");
+    // Value of the immediate, as seen once sign extended
+    long long imm = src.value;
+    if (size == 4)
+      imm = static_cast<int>(imm);
+    else if (size == 2)
+      imm = static_cast<short>(imm);
+    const bool byteRegisters = size == 1;
+    const bool wide = size == 8;
+
+    int opcode = -1;
+    int extension = -1;
+    unsigned int immSize = size == 1 ? 1 : (size == 2 ? 2 : 4);
+    const int arithmetic = arithmeticExtension(mnemonic);
+    if (mnemonic == "mov")
+    {
+      if (src.type == Operand::IMMEDIATE && dst.type == Operand::REGISTER)
+      {
+	// Short form, with the register in the opcode
+	if (!wide || !fitsInt(src.value))
+	{
+	  if (size == 2)
+	    emit(0x66);
+	  if (dst.reg >= 8 || wide || (byteRegisters && dst.reg >= 4))
+	    emit(0x40 | (wide ? 8 : 0) | (dst.reg >= 8 ? 1 : 0));
+	  emit((size == 1 ? 0xB0 : 0xB8) + (dst.reg & 7));
+	  emitValue(src.value, wide ? 8 : immSize);
+	  return true;
+	}
+	opcode = 0xC7;
+	extension = 0;
+      }
+      else if (src.type == Operand::IMMEDIATE)
+      {
+	opcode = size == 1 ? 0xC6 : 0xC7;
+	extension = 0;
+      }
+      else if (dst.type == Operand::REGISTER && src.type == Operand::MEMORY)
+	opcode = size == 1 ? 0x8A : 0x8B;
+      else
+	opcode = size == 1 ? 0x88 : 0x89;
+    }
+    else if (arithmetic >= 0)
+    {
+      if (src.type == Operand::IMMEDIATE)
+      {
+	extension = arithmetic;
+	if (size == 1)
+	  opcode = 0x80;
+	else if (fitsByte(imm))
+	{
+	  opcode = 0x83;
+	  immSize = 1;
+	}
+	else
+	  opcode = 0x81;
+      }
+      else if (dst.type == Operand::REGISTER && src.type == Operand::MEMORY)
+	opcode = arithmetic * 8 + (size == 1 ? 2 : 3);
+      else
+	opcode = arithmetic * 8 + (size == 1 ? 0 : 1);
+    }
+    else if (mnemonic == "test")
+    {
+      // Commutative, 0x85 works with the memory on either side
+      if (src.type == Operand::IMMEDIATE)
+      {
+	opcode = size == 1 ? 0xF6 : 0xF7;
+	extension = 0;
+      }
+      else
+	opcode = size == 1 ? 0x84 : 0x85;
+    }
+    else
+      return fail("Unknown instruction");
+
+    if (size == 2)
+      emit(0x66);
+    if (extension >= 0)
+    {
+      emitRex(wide, extension, false, dst);
+      emit(opcode);
+      emitModRM(extension, dst, immSize);
+      emitValue(imm, immSize);
+    }
+    else
+      if (dst.type == Operand::REGISTER && src.type == Operand::MEMORY)
+      {
+	emitRex(wide, dst.reg, byteRegisters, src);
+	emit(opcode);
+	emitModRM(dst.reg, src, 0);
+      }
+      else
+      {
+	emitRex(wide, src.reg, byteRegisters, dst);
+	emit(opcode);
+	emitModRM(src.reg, dst, 0);
+      }
+
+    return true;
+  }
+
+  /*!
+  ** Encode an instruction with one operand, which isn't a symbol.
+  **
+  ** @param mnemonic The mnemonic
+  ** @param op The operand
+  **
+  ** @return If it was understood
+  */
+  bool
+  ASM64Assembler::encodeUnary(const std::string& mnemonic, Operand& op)
+  {
+    if (op.type == Operand::SYMBOL)
+      return fail("Unknown instruction");
+
+    if (mnemonic == "push" || mnemonic == "pop")
+    {
+      const bool push = mnemonic == "push";
+      if (op.type == Operand::IMMEDIATE)
+      {
+	if (!push || !fitsInt(op.value))
+	  return fail("Invalid operand");
+	emit(fitsByte(op.value) ? 0x6A : 0x68);
+	emitValue(op.value, fitsByte(op.value) ? 1 : 4);
+	return true;
+      }
+      if (op.size && op.size != 8)
+	return fail("Invalid operand size");
+      if (op.type == Operand::REGISTER)
+      {
+	if (op.reg >= 8)
+	  emit(0x41);
+	emit((push ? 0x50 : 0x58) + (op.reg & 7));
+	return true;
+      }
+      emitRex(false, 0, false, op);
+      emit(push ? 0xFF : 0x8F);
+      emitModRM(push ? 6 : 0, op, 0);
+      return true;
+    }
+
+    if (op.type == Operand::IMMEDIATE)
+      return fail("Invalid operand");
+
+    if (mnemonic.compare(0, 3, "set") == 0)
+    {
+      const int condition = conditionCode(mnemonic.substr(3));
+      if (condition < 0 || (op.size && op.size != 1))
+	return fail("Invalid operand");
+      emitRex(false, 0, false, op);
+      emit(0x0F);
+      emit(0x90 + condition);
+      emitModRM(0, op, 0);
+      return true;
+    }
+
+    if (mnemonic == "jmp" || mnemonic == "call")
+    {
+      if (op.size && op.size != 8)
+	return fail("Invalid operand size");
+      emitRex(false, 0, false, op);
+      emit(0xFF);
+      emitModRM(mnemonic == "jmp" ? 4 : 2, op, 0);
+      return true;
+    }
+
+    static const struct
+    {
+      const char*	mnemonic;
+      unsigned char	opcode;
+      int		extension;
+    } UNARIES[] =
+      {
+	{ "inc", 0xFE, 0 }, { "dec", 0xFE, 1 }, { "not", 0xF6, 2 },
+	{ "neg", 0xF6, 3 }, { "mul", 0xF6, 4 }, { "imul", 0xF6, 5 },
+	{ "div", 0xF6, 6 }, { "idiv", 0xF6, 7 }, { 0, 0, 0 }
+      };
+    for (int i = 0; UNARIES[i].mnemonic; ++i)
+      if (mnemonic == UNARIES[i].mnemonic)
+      {
+	if (!op.size)
+	  return fail("Unknown operand size");
+	if (op.size == 2)
+	  emit(0x66);
+	emitRex(op.size == 8, UNARIES[i].extension, false, op);
+	emit(UNARIES[i].opcode + (op.size == 1 ? 0 : 1));
+	emitModRM(UNARIES[i].extension, op, 0);
+	return true;
+      }
+
+    return fail("Unknown instruction");
+  }
+
+  /*!
+  ** Append a byte to the current section.
+  **
+  ** @param byte The byte
+  */
+  void
+  ASM64Assembler::emit(const unsigned char byte)
+  {
+    _bytes[_current].push_back(byte);
+  }
+
+  /*!
+  ** Append a value to the current section, in little endian.
+  **
+  ** @param value The value
+  ** @param size Its size in bytes
+  */
+  void
+  ASM64Assembler::emitValue(long long value, const unsigned int size)
+  {
+    for (unsigned int i = 0; i < size; ++i)
+      emit((value >> (i * 8)) & 0xFF);
+  }
+
+  /*!
+  ** Append the REX prefix, if needed.
+  **
+  ** @param wide If the operation is on 64 bits
+  ** @param reg The register, or the opcode extension, of the reg field
+  ** @param byteRegister If the reg field is a byte register
+  ** @param rm The other operand
+  */
+  void
+  ASM64Assembler::emitRex(const bool wide, const int reg,
+			  const bool byteRegister, const Operand& rm)
+  {
+    unsigned char rex = 0x40;
+
+    if (wide)
+      rex |= 8;
+    if (reg >= 8)
+      rex |= 4;
+    if (rm.type == Operand::REGISTER && rm.reg >= 8)
+      rex |= 1;
+    if (rm.type == Operand::MEMORY)
+    {
+      if (rm.reg >= 8 && rm.reg != RIP)
+	rex |= 1;
+      if (rm.index >= 8)
+	rex |= 2;
+    }
+
+    // spl, bpl, sil and dil are only reachable with a REX prefix
+    if (rex != 0x40 || (byteRegister && reg >= 4 && reg < 8) ||
+	(rm.type == Operand::REGISTER && rm.size == 1 &&
+	 rm.reg >= 4 && rm.reg < 8))
+      emit(rex);
+  }
+
+  /*!
+  ** Append the ModRM byte, with the SIB byte and the displacement.
+  **
+  ** @param reg The register, or the opcode extension, of the reg field
+  ** @param rm The other operand
+  ** @param immediateSize Size of the immediate following, needed by rip
+  ** relative references
+  */
+  void
+  ASM64Assembler::emitModRM(const int reg, const Operand& rm,
+			    const unsigned int immediateSize)
+  {
+    const int field = (reg & 7) << 3;
+
+    if (rm.type == Operand::REGISTER)
+    {
+      emit(0xC0 | field | (rm.reg & 7));
+      return;
+    }
+
+    assert(rm.type == Operand::MEMORY);
+    if (rm.reg == RIP)
+    {
+      emit(0x05 | field);
+      Fixup fixup;
+      fixup.where = _current;
+      fixup.offset = _bytes[_current].size();
+      fixup.relative = true;
+      fixup.symbol = rm.symbol;
+      fixup.addend = rm.value - 4 - immediateSize;
+      _fixups.push_back(fixup);
+      emitValue(0, 4);
+      return;
+    }
+
+    int scale = 0;
+    for (int s = rm.scale; s > 1; s >>= 1)
+      ++scale;
+
+    // Without base, only a 32 bits displacement
+    if (rm.reg < 0)
+    {
+      emit(0x04 | field);
+      emit((scale << 6) | ((rm.index < 0 ? 4 : rm.index & 7) << 3) | 5);
+      emitValue(rm.value, 4);
+      return;
+    }
+
+    const int base = rm.reg & 7;
+    int mod = 2;
+    if (rm.value == 0 && base != 5)
+      mod = 0;
+    else
+      if (fitsByte(rm.value))
+	mod = 1;
+
+    if (rm.index < 0 && base != 4)
+      emit((mod << 6) | field | base);
+    else
+    {
+      emit((mod << 6) | field | 4);
+      emit((scale << 6) | ((rm.index < 0 ? 4 : rm.index & 7) << 3) | base);
+    }
+    if (mod == 1)
+      emitValue(rm.value, 1);
+    else
+      if (mod == 2)
+	emitValue(rm.value, 4);
+  }
+
+  /*!
+  ** Append a 32 bits reference to a symbol, relative to the end of the
+  ** instruction.
+  **
+  ** @param symbol The symbol
+  */
+  void
+  ASM64Assembler::emitRelative(const std::string& symbol)
+  {
+    Fixup fixup;
+    fixup.where = _current;
+    fixup.offset = _bytes[_current].size();
+    fixup.relative = true;
+    fixup.symbol = symbol;
+    fixup.addend = -4;
+    _fixups.push_back(fixup);
+    emitValue(0, 4);
+  }
+
+  /*!
+  ** Record an error, on the current line.
+  **
+  ** @param message The message
+  **
+  ** @return Always false
+  */
+  bool
+  ASM64Assembler::fail(const std::string& message)
+  {
+    _error = message + ": " + trim(_line);
+    return false;
+  }
+}
@@ -0,0 +1,129 @@
+#ifndef ASM64ASSEMBLER_HH_
+# define ASM64ASSEMBLER_HH_
+
+# include <map>
+# include <string>
+# include <vector>
+
+namespace MiniCompiler
+{
+  /*!
+  ** Assembler of the x86-64 code written by the ASM64GeneratorVisitor,
+  ** into machine code, without any external tool.
+  ** Only the subset of GNU as intel syntax used by the generator and its
+  ** runtime is understood. Every jump and call is encoded on 32 bits, so
+  ** the code is assembled in a single pass: references to symbols are
+  ** recorded, then resolved once sections are placed in memory.
+  */
+  class ASM64Assembler
+  {
+  public:
+    enum section
+      {
+	TEXT,
+	RODATA,
+	DATA,
+	BSS,
+	NB_SECTIONS
+      };
+
+    typedef std::vector<unsigned char> Bytes;
+    typedef unsigned long long Address;
+
+  private:
+    /*!
+    ** An operand of an instruction.
+    */
+    struct Operand
+    {
+      enum kind
+	{
+	  REGISTER,
+	  IMMEDIATE,
+	  MEMORY,
+	  SYMBOL
+	};
+
+      Operand();
+      kind		type;
+      int		size;	// In bytes, 0 if unknown
+      int		reg;	// Register, or base of a memory reference
+      int		index;	// Index of a memory reference, or -1
+      int		scale;
+      long long		value;	// Immediate, or displacement
+      std::string	symbol;	// Jump target, or rip relative reference
+    };
+
+    /*!
+    ** A reference to a symbol, resolved when sections are placed.
+    ** Absolute references are symbol - minus + addend, on 64 bits.
+    ** Relative ones are symbol + addend - position, on 32 bits.
+    */
+    struct Fixup
+    {
+      section		where;
+      unsigned int	offset;
+      bool		relative;
+      std::string	symbol;
+      std::string	minus;
+      long long		addend;
+    };
+
+    /*!
+    ** Where a symbol is defined.
+    */
+    struct Symbol
+    {
+      section		where;
+      unsigned int	offset;
+    };
+
+    typedef std::vector<std::string> Operands;
+    typedef std::map<std::string, Symbol> Symbols;
+    typedef std::vector<Fixup> Fixups;
+
+  public:
+    ASM64Assembler();
+    ~ASM64Assembler();
+
+  public:
+    bool assemble(const std::string& code);
+    bool link(const Address bases[NB_SECTIONS]);
+    const Bytes& getSection(const section s) const;
+    unsigned int getSize(const section s) const;
+    bool getSymbol(const std::string& name, section& where,
+		   unsigned int& offset) const;
+    const std::string& getError() const;
+
+  private:
+    bool assembleLine(const std::string& line);
+    bool assembleDirective(const std::string& name, const Operands& args,
+			   const std::string& rest);
+    bool assembleInstruction(const std::string& mnemonic,
+			     const Operands& args);
+    bool parseOperand(const std::string& text, Operand& op) const;
+    bool parseMemory(const std::string& text, Operand& op) const;
+    bool encodeBinary(const std::string& mnemonic, Operand& dst,
+		      Operand& src);
+    bool encodeUnary(const std::string& mnemonic, Operand& op);
+    void emit(const unsigned char byte);
+    void emitValue(long long value, const unsigned int size);
+    void emitRex(const bool wide, const int reg, const bool byteRegister,
+		 const Operand& rm);
+    void emitModRM(const int reg, const Operand& rm,
+		   const unsigned int immediateSize);
+    void emitRelative(const std::string& symbol);
+    bool fail(const std::string& message);
+
+  private:
+    Bytes		_bytes[NB_SECTIONS];
+    unsigned int	_bssSize;
+    section		_current;
+    Symbols		_symbols;
+    Fixups		_fixups;
+    std::string		_line;
+    std::string		_error;
+  };
+}
+
+#endif /* !ASM64ASSEMBLER_HH_ */
@@ -0,0 +1,1445 @@
+#include <cassert>
+#include <algorithm>
+#include "ASM64GeneratorVisitor.hh"
+#include "StrengthReduction.hh"
+#include "Error.hh"
+#include "ExecutionVisitor.hh"
+#include "Utils.hh"
+#include "NodeIds.hh"
+#include "NodeProgram.hh"
+#include "NodeAffect.hh"
+#include "NodeIf.hh"
+#include "NodeRead.hh"
+#include "NodeReturn.hh"
+#include "NodeExit.hh"
+#include "NodeCallFunc.hh"
+#include "NodeOperation.hh"
+#include "NodeExpression.hh"
+#include "NodeStringExpr.hh"
+#include "NodeBoolean.hh"
+#include "NodeExpressions.hh"
+#include "NodeInstr.hh"
+#include "NodeCompoundInstr.hh"
+#include "NodeFactor.hh"
+#include "NodeInstrs.hh"
+#include "NodeType.hh"
+#include "NodeFunction.hh"
+#include "NodeWhile.hh"
+#include "NodeDeclarationBody.hh"
+#include "NodeFunctions.hh"
+#include "NodeNumber.hh"
+#include "NodeDeclaration.hh"
+#include "NodeHeaderFunc.hh"
+#include "NodeDeclarations.hh"
+#include "NodeId.hh"
+#include "NodeIdFunc.hh"
+#include "NodePrint.hh"
+
+namespace MiniCompiler
+{
+  namespace
+  {
+    /*!
+    ** Escape a string for GNU as, after replacing special chars
+    ** like the execution does.
+    ** Example: "toto\ntata", into : "toto\012tata".
+    **
+    ** @param s The string to escape
+    **
+    ** @return The escaped string
+    */
+    std::string
+    escape_string(const std::string& s)
+    {
+      const std::string& real = Utils::activeSpecialChar(s);
+      std::stringstream ss;
+
+      for (std::string::const_iterator it = real.begin();
+	   it != real.end(); ++it)
+      {
+	const unsigned char c = *it;
+	if (c == '"' || c == '\\')
+	  ss << '\\' << c;
+	else
+	  if (c < ' ' || c > '~')
+	    ss << '\\' << std::oct << std::setw(3) << std::setfill('0')
+	       << static_cast<unsigned int>(c) << std::dec;
+	  else
+	    ss << c;
+      }
+
+      return ss.str();
+    }
+
+    /*!
+    ** Check if a factor can be used directly as an operand, without
+    ** computing anything.
+    **
+    ** @param factor The factor
+    **
+    ** @return If the factor is a variable or a literal
+    */
+    bool
+    isSimple(const AST::NodeFactor* factor)
+    {
+      assert(factor);
+      return factor->getId() || factor->getNumber() || factor->getBool() ||
+	factor->getStringExpr();
+    }
+
+    bool hasCall(const AST::NodeOperation* op);
+
+    /*!
+    ** Check if computing a factor calls a function, which may destroy
+    ** caller saved registers.
+    **
+    ** @param factor The factor
+    **
+    ** @return If the factor contains a call
+    */
+    bool
+    hasCall(const AST::NodeFactor* factor)
+    {
+      if (!factor)
+	return false;
+      if (factor->getCallFunc())
+	return true;
+      if (factor->getExpression())
+	return hasCall(factor->getExpression()->getOperation());
+      return false;
+    }
+
+    /*!
+    ** Check if computing an operation calls a function, including runtime
+    ** functions used by string operations.
+    **
+    ** @param op The operation
+    **
+    ** @return If the operation contains a call
+    */
+    bool
+    hasCall(const AST::NodeOperation* op)
+    {
+      assert(op);
+      const AST::NodeFactor* left = op->getLeftFactor();
+      assert(left);
+      if (op->getOpType() != AST::Operator::NONE &&
+	  left->getComputedType() == AST::Type::STRING)
+	return true;
+
+      return hasCall(left) || hasCall(op->getRightFactor());
+    }
+
+    /*!
+    ** Weight every use of a variable, uses inside loops being heavier,
+    ** count how many temporaries are needed at the same time, and check
+    ** if the code calls anything, the runtime included.
+    */
+    class UsageCounter : public ConstBaseVisitor<UsageCounter>
+    {
+    public:
+      typedef std::map<const AST::NodeId*, unsigned int> Weights;
+
+    private:
+      static const unsigned int LOOP_WEIGHT = 8;
+      static const unsigned int MAX_WEIGHT = 1 << 20;
+
+    public:
+      UsageCounter()
+	: _weight(1), _leaf(true)
+      {
+	for (unsigned int i = 0; i < 2; ++i)
+	  _nbTemporaries[i] = _maxTemporaries[i] = 0;
+      }
+
+      virtual ~UsageCounter()
+      {
+      }
+
+      using ConstBaseVisitor<UsageCounter>::visit;
+
+      void visit(const AST::NodeId* node)
+      {
+	assert(node);
+	_weights[node->getRef()] += _weight;
+      }
+
+      void visit(const AST::NodeWhile* node)
+      {
+	assert(node);
+	const unsigned int weight = _weight;
+	if (_weight < MAX_WEIGHT)
+	  _weight *= LOOP_WEIGHT;
+	ConstBaseVisitor<UsageCounter>::visit(node);
+	_weight = weight;
+      }
+
+      void visit(const AST::NodeOperation* node)
+      {
+	assert(node);
+	const AST::NodeFactor* left = node->getLeftFactor();
+	const AST::NodeFactor* right = node->getRightFactor();
+	assert(left);
+
+	visit(left);
+	if (!right)
+	  return;
+	if (left->getComputedType() == AST::Type::STRING)
+	  _leaf = false;
+	const bool temporary = !isSimple(left) && !isSimple(right);
+	const bool acrossCall = temporary && hasCall(right);
+	if (temporary &&
+	    ++_nbTemporaries[acrossCall] > _maxTemporaries[acrossCall])
+	  _maxTemporaries[acrossCall] = _nbTemporaries[acrossCall];
+	visit(right);
+	if (temporary)
+	  --_nbTemporaries[acrossCall];
+      }
+
+      void visit(const AST::NodeCallFunc* node)
+      {
+	_leaf = false;
+	ConstBaseVisitor<UsageCounter>::visit(node);
+      }
+
+      void visit(const AST::NodePrint* node)
+      {
+	_leaf = false;
+	ConstBaseVisitor<UsageCounter>::visit(node);
+      }
+
+      void visit(const AST::NodeRead* node)
+      {
+	_leaf = false;
+	ConstBaseVisitor<UsageCounter>::visit(node);
+      }
+
+      unsigned int weight(const AST::NodeId* id) const
+      {
+	Weights::const_iterator it = _weights.find(id);
+	return it == _weights.end() ? 0 : it->second;
+      }
+
+      unsigned int maxTemporaries(bool acrossCall) const
+      {
+	return _maxTemporaries[acrossCall];
+      }
+
+      bool isLeaf() const
+      {
+	return _leaf;
+      }
+
+    private:
+      Weights		_weights;
+      unsigned int	_weight;
+      unsigned int	_nbTemporaries[2];
+      unsigned int	_maxTemporaries[2];
+      bool		_leaf;
+    };
+
+    /*!
+    ** Order variables from the most used to the least used.
+    */
+    class HeavierFirst
+    {
+    public:
+      HeavierFirst(const UsageCounter& counter)
+	: _counter(counter)
+      {
+      }
+
+      bool operator()(const AST::NodeId* a, const AST::NodeId* b) const
+      {
+	return _counter.weight(a) > _counter.weight(b);
+      }
+
+    private:
+      const UsageCounter&	_counter;
+    };
+
+    /*!
+    ** Get the conditional jump taken when a comparison is false.
+    **
+    ** @param op The comparison operator
+    **
+    ** @return The jump instruction, or 0 if op isn't a comparison
+    */
+    const char*
+    jumpIfFalse(AST::Operator::type op)
+    {
+      switch (op)
+      {
+	case AST::Operator::EQUAL:
+	  return "jne";
+	case AST::Operator::DIFF:
+	  return "je";
+	case AST::Operator::SUP:
+	  return "jle";
+	case AST::Operator::SUPEQUAL:
+	  return "jl";
+	case AST::Operator::INF:
+	  return "jge";
+	case AST::Operator::INFEQUAL:
+	  return "jg";
+	default:
+	  return 0;
+      }
+    }
+
+    /*!
+    ** Check if an operand is an immediate value.
+    **
+    ** @param s The operand
+    **
+    ** @return If it is a number
+    */
+    bool
+    isImmediate(const std::string& s)
+    {
+      return !s.empty() && (isdigit(s[0]) || s[0] == '-');
+    }
+  }
+
+  const char* const
+  ASM64GeneratorVisitor::ARGUMENT_REGISTERS[NB_REGISTER_ARGUMENTS] =
+    { "rdi", "rsi", "rdx", "rcx", "r8", "r9" };
+
+  const ASM64GeneratorVisitor::Register
+  ASM64GeneratorVisitor::CALLEE_SAVED_REGISTERS[NB_CALLEE_SAVED_REGISTERS] =
+    {
+      { "rbx", "ebx" }, { "r12", "r12d" }, { "r13", "r13d" },
+      { "r14", "r14d" }
+    };
+
+  const char* const ASM64GeneratorVisitor::DEPTH_REGISTER = "r15";
+
+  const ASM64GeneratorVisitor::Register
+  ASM64GeneratorVisitor::SCRATCH_REGISTERS[NB_SCRATCH_REGISTERS] =
+    {
+      { "r8", "r8d" }, { "r9", "r9d" }, { "r10", "r10d" },
+      { "r11", "r11d" }, { "rsi", "esi" }, { "rdi", "edi" }
+    };
+
+  /*!
+  ** Construct the x86-64 asm convertor visitor.
+  */
+  ASM64GeneratorVisitor::ASM64GeneratorVisitor()
+    : _savedOffset(0), _leaf(false), _frame(true), _padding(0),
+      _printRuntime(false), _hosted(false),
+      _maxDepth(ExecutionVisitor::DEFAULT_MAX_DEPTH),
+      _nbLabels(0)
+  {
+    _tab = 0;
+  }
+
+  /*!
+  ** Destruct the visitor.
+  */
+  ASM64GeneratorVisitor::~ASM64GeneratorVisitor()
+  {
+  }
+
+  /*!
+  ** Get all ids declared by the given declarations, in order.
+  **
+  ** @param decls The declarations node
+  ** @param ids The list to fill
+  */
+  void
+  ASM64GeneratorVisitor::collectIds(const AST::NodeDeclarations* decls,
+				    Ids& ids)
+  {
+    for (; decls; decls = decls->getDeclarations())
+    {
+      const AST::NodeDeclaration* decl = decls->getDeclaration();
+      assert(decl);
+      const AST::NodeDeclarationBody* body = decl->getBody();
+      assert(body);
+      for (const AST::NodeIds* list = body->getIds(); list;
+	   list = list->getIds())
+      {
+	assert(list->getId());
+	ids.push_back(list->getId());
+      }
+    }
+  }
+
+  /*!
+  ** Get a location in the current frame.
+  **
+  ** @param offset The offset from rbp
+  **
+  ** @return The location
+  */
+  ASM64GeneratorVisitor::Location
+  ASM64GeneratorVisitor::memoryLocation(int offset)
+  {
+    std::stringstream ss;
+    Location location;
+
+    if (offset < 0)
+      ss << "[rbp - " << -offset << "]";
+    else
+      ss << "[rbp + " << offset << "]";
+    location.qword = "QWORD PTR " + ss.str();
+    location.dword = "DWORD PTR " + ss.str();
+
+    return location;
+  }
+
+  /*!
+  ** Choose which variables of a function live in callee saved registers.
+  ** Every variable lives during the whole function, so all live intervals
+  ** overlap: the scan gives registers to the heaviest variables first,
+  ** and the others are spilled in the frame. Remaining registers are kept
+  ** for temporaries which must survive a call.
+  ** A leaf function first uses caller saved registers, which need no save.
+  **
+  ** @param node The function node
+  ** @param variables Arguments and local variables of the function
+  */
+  void
+  ASM64GeneratorVisitor::allocateRegisters(const AST::NodeFunction* node,
+					   const Ids& variables)
+  {
+    // A register costs a save and a restore, so it must be used more
+    static const unsigned int MIN_WEIGHT = 2;
+    UsageCounter counter;
+    unsigned int nb = 0;
+
+    assert(node);
+    assert(node->getCompoundInstr());
+    counter.visit(node->getCompoundInstr());
+    _leaf = counter.isLeaf();
+
+    Ids sorted(variables);
+    std::stable_sort(sorted.begin(), sorted.end(), HeavierFirst(counter));
+
+    _saved.clear();
+    _freeCallee.clear();
+    if (_leaf)
+      allocateScratch(node, sorted, counter.maxTemporaries(false));
+    for (Ids::const_iterator it = sorted.begin();
+	 it != sorted.end() && nb < NB_CALLEE_SAVED_REGISTERS &&
+	   counter.weight(*it) >= MIN_WEIGHT; ++it)
+    {
+      if (_variables.find(*it) != _variables.end())
+	continue;
+      const Register* reg = &CALLEE_SAVED_REGISTERS[nb++];
+      _variables[*it].qword = reg->qword;
+      _variables[*it].dword = reg->dword;
+      _saved.push_back(reg);
+    }
+    for (unsigned int i = 0; i < counter.maxTemporaries(true) &&
+	   nb < NB_CALLEE_SAVED_REGISTERS; ++i, ++nb)
+    {
+      _saved.push_back(&CALLEE_SAVED_REGISTERS[nb]);
+      _freeCallee.push_back(&CALLEE_SAVED_REGISTERS[nb]);
+    }
+  }
+
+  /*!
+  ** Give caller saved registers to the heaviest variables of a leaf
+  ** function, whatever their weight: nothing can destroy them, and they
+  ** cost no save. Enough registers are left for temporaries. An argument
+  ** stays in the register it is given in, when this one can be used.
+  **
+  ** @param node The function node
+  ** @param sorted Arguments and local variables, the heaviest first
+  ** @param nbTemporaries How many temporaries are needed at the same time
+  */
+  void
+  ASM64GeneratorVisitor::allocateScratch(const AST::NodeFunction* node,
+					 const Ids& sorted,
+					 unsigned int nbTemporaries)
+  {
+    assert(node);
+    assert(_freeScratch.size() == NB_SCRATCH_REGISTERS);
+    unsigned int nb = 0;
+
+    if (nbTemporaries < _freeScratch.size())
+      nb = std::min<unsigned int>(sorted.size(),
+				  _freeScratch.size() - nbTemporaries);
+    const Ids::const_iterator end = sorted.begin() + nb;
+
+    for (unsigned int i = 0;
+	 i < node->nbArgument() && i < NB_REGISTER_ARGUMENTS; ++i)
+    {
+      const AST::NodeId* arg = node->getArgument(i);
+      if (std::find(sorted.begin(), end, arg) == end)
+	continue;
+      for (Registers::iterator it = _freeScratch.begin();
+	   it != _freeScratch.end(); ++it)
+	if (ARGUMENT_REGISTERS[i] == std::string((*it)->qword))
+	{
+	  _variables[arg].qword = (*it)->qword;
+	  _variables[arg].dword = (*it)->dword;
+	  _freeScratch.erase(it);
+	  break;
+	}
+    }
+    for (Ids::const_iterator it = sorted.begin(); it != end; ++it)
+      if (_variables.find(*it) == _variables.end())
+      {
+	_variables[*it].qword = _freeScratch.back()->qword;
+	_variables[*it].dword = _freeScratch.back()->dword;
+	_freeScratch.pop_back();
+      }
+  }
+
+  /*!
+  ** Get a free register to keep a temporary value.
+  **
+  ** @param acrossCall If the value must survive a function call
+  **
+  ** @return The register, or 0 if the value must be spilled on the stack
+  */
+  const ASM64GeneratorVisitor::Register*
+  ASM64GeneratorVisitor::allocateTemporary(bool acrossCall)
+  {
+    Registers& pool = acrossCall ? _freeCallee : _freeScratch;
+    if (pool.empty())
+      return 0;
+
+    const Register* reg = pool.back();
+    pool.pop_back();
+    return reg;
+  }
+
+  /*!
+  ** Give back a register used by a temporary value.
+  **
+  ** @param reg The register, 0 if the value was spilled
+  ** @param acrossCall If the value had to survive a function call
+  */
+  void
+  ASM64GeneratorVisitor::releaseTemporary(const Register* reg,
+					  bool acrossCall)
+  {
+    if (reg)
+      (acrossCall ? _freeCallee : _freeScratch).push_back(reg);
+  }
+
+  /*!
+  ** Check if a factor gives the same value whenever it is computed, so
+  ** it can be computed after its right operand. Global variables may be
+  ** changed by a called function.
+  **
+  ** @param factor The factor
+  **
+  ** @return If the factor can be computed later
+  */
+  bool
+  ASM64GeneratorVisitor::isStable(const AST::NodeFactor* factor) const
+  {
+    assert(factor);
+    if (factor->getNumber() || factor->getBool() || factor->getStringExpr())
+      return true;
+    if (!factor->getId())
+      return false;
+
+    return std::find(_globals.begin(), _globals.end(),
+		     factor->getId()->getRef()) == _globals.end();
+  }
+
+  /*!
+  ** Get a simple factor as an operand, loading it into rcx if it can't
+  ** be used directly.
+  **
+  ** @param factor The simple factor
+  **
+  ** @return Where is the value of the factor
+  */
+  ASM64GeneratorVisitor::Location
+  ASM64GeneratorVisitor::operand(const AST::NodeFactor* factor)
+  {
+    assert(factor);
+    assert(isSimple(factor));
+    Location location;
+
+    if (factor->getId())
+    {
+      Variables::const_iterator it =
+	_variables.find(factor->getId()->getRef());
+      assert(it != _variables.end());
+      return it->second;
+    }
+
+    if (factor->getNumber())
+    {
+      std::stringstream ss;
+      ss << factor->getNumber()->getNumber();
+      location.qword = ss.str();
+    }
+    else
+      if (factor->getBool())
+	location.qword = factor->getBool()->getBool() ? "1" : "0";
+      else
+      {
+	_indent << "\tlea\trcx, " << stringLabel(factor->getStringExpr())
+		<< "[rip]\n";
+	location.qword = "rcx";
+	location.dword = "ecx";
+	return location;
+      }
+    location.dword = location.qword;
+
+    return location;
+  }
+
+  /*!
+  ** Get the label of a string literal, creating it if needed.
+  **
+  ** @param node The string expression node
+  **
+  ** @return The label
+  */
+  const std::string&
+  ASM64GeneratorVisitor::stringLabel(const AST::NodeStringExpr* node)
+  {
+    assert(node);
+    const std::string& s = escape_string(node->getString());
+    ROStrings::const_iterator it = _strings.find(s);
+
+    if (it == _strings.end())
+    {
+      std::stringstream ss;
+      ss << "__cubs_string" << _strings.size() + 1;
+      it = _strings.insert(std::make_pair(s, ss.str())).first;
+    }
+
+    return it->second;
+  }
+
+  /*!
+  ** Give its default value to a local variable.
+  **
+  ** @param id The variable declaration
+  */
+  void
+  ASM64GeneratorVisitor::initVariable(const AST::NodeId* id)
+  {
+    assert(id);
+    if (id->getComputedType() == AST::Type::STRING)
+      _indent << "\tlea\trax, __cubs_empty[rip]\n"
+	"\tmov\t" << _variables[id].qword
+	      << ", rax\t# Automatic initialization\n";
+    else
+      _indent << "\tmov\t" << _variables[id].qword
+	      << ", 0\t# Automatic initialization\n";
+  }
+
+  /*!
+  ** Convert the program node.
+  ** Global variables are static data, the main block is the entry point.
+  **
+  ** @param node The program node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeProgram* node)
+  {
+    assert(node);
+    writeHeader();
+
+    collectIds(node->getDecls(), _globals);
+    for (Ids::const_iterator it = _globals.begin(); it != _globals.end(); ++it)
+    {
+      _variables[*it].qword = "QWORD PTR v_" + (*it)->getId() + "[rip]";
+      _variables[*it].dword = "DWORD PTR v_" + (*it)->getId() + "[rip]";
+    }
+
+    // Temporaries which don't survive a call use caller saved registers
+    for (unsigned int i = 0; i < NB_SCRATCH_REGISTERS; ++i)
+      _freeScratch.push_back(&SCRATCH_REGISTERS[i]);
+
+    _indent << "\n\t.text\n";
+    const AST::NodeFunctions* funcs = node->getFuncs();
+    if (funcs)
+      visit(funcs);
+
+    // The entry point never returns, so all registers are free
+    _saved.clear();
+    _freeCallee.clear();
+    for (unsigned int i = 0; i < NB_CALLEE_SAVED_REGISTERS; ++i)
+      _freeCallee.push_back(&CALLEE_SAVED_REGISTERS[i]);
+    _indent << "\n_start:\n"
+      "\tmov\tQWORD PTR __cubs_stack_top[rip], rsp\t# Where the collector stops\n"
+      "\tmov\t" << DEPTH_REGISTER << ", " << _maxDepth
+	    << "\t\t# Number of calls which can still be nested\n";
+    const AST::NodeCompoundInstr* instrs = node->getInstrs();
+    if (instrs)
+      visit(instrs);
+    _indent << "\txor\tedi, edi\t\t# Exit with return code of 0 (no error)\n"
+      "\tjmp\t__cubs_exit\n";
+    writeRuntime();
+    writePostlude();
+  }
+
+  /*!
+  ** Convert the affectation node
+  **
+  ** @param node The affectation node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeAffect* node)
+  {
+    assert(node);
+    const AST::NodeId* id = node->getId();
+    const AST::NodeExpression* expr = node->getExpr();
+    assert(id);
+    assert(expr);
+
+    visit(expr);
+    _indent << "\tmov\t";
+    visit(id);
+    _indent << ", rax\t# Just affect an expression\n";
+  }
+
+  /*!
+  ** Convert the if node
+  **
+  ** @param node The if node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeIf* node)
+  {
+    assert(node);
+    const AST::NodeExpression* cond = node->getCond();
+    const AST::NodeCompoundInstr* body = node->getBodyExprs();
+    const AST::NodeCompoundInstr* elseExprs = node->getElseExprs();
+    assert(cond);
+    assert(body);
+    const unsigned int label = newLabel();
+    std::stringstream elseLabel;
+    elseLabel << ".Lelse_" << label;
+
+    writeJumpIfFalse(cond, elseLabel.str());
+    visit(body);
+    if (elseExprs)
+      _indent << "\tjmp\t.Lend_if_" << label << "\t\t# Else\n";
+    _indent << ".Lelse_" << label << ":\n";
+    if (elseExprs)
+    {
+      visit(elseExprs);
+      _indent << ".Lend_if_" << label << ":\n";
+    }
+  }
+
+  /*!
+  ** Convert the read node
+  **
+  ** @param node The read node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeRead* node)
+  {
+    assert(node);
+    const AST::NodeId* id = node->getId();
+    assert(id);
+
+    switch (id->getComputedType())
+    {
+      case AST::Type::INTEGER:
+	_indent << "\tcall\t__cubs_read_int\n";
+	break;
+      case AST::Type::BOOLEAN:
+	_indent << "\tmov\trdi, ";
+	visit(id);
+	_indent << "\t# An invalid boolean doesn't change the variable\n"
+	  "\tcall\t__cubs_read_bool\n";
+	break;
+      case AST::Type::STRING:
+	_indent << "\tcall\t__cubs_read_string\n";
+	break;
+      default:
+	assert(false);
+    }
+    _indent << "\tmov\t";
+    visit(id);
+    _indent << ", rax\t# Copy back to our variable\n";
+  }
+
+  /*!
+  ** Evaluate arguments of a call from left to right, then give the
+  ** first ones in registers. Others stay on the stack, first on top.
+  ** When all arguments are given in registers, the last one, computed
+  ** after all others, goes directly into its register.
+  **
+  ** @param node The function call node
+  */
+  void
+  ASM64GeneratorVisitor::writeArguments(const AST::NodeCallFunc* node)
+  {
+    assert(node);
+    const unsigned int nb = node->nbArgument();
+    if (nb == 0)
+      return;
+    const unsigned int nbSaved = nb <= NB_REGISTER_ARGUMENTS ? nb - 1 : nb;
+
+    if (nbSaved > 0)
+      _indent << "\tsub\trsp, " << nbSaved * VAR_SIZE
+	      << "\t\t# Place for arguments\n";
+    for (unsigned int i = 0; i < nb; ++i)
+    {
+      const AST::NodeExpression* expr = node->getArgument(i);
+      assert(expr);
+      visit(expr);
+      if (i < nbSaved)
+	_indent << "\tmov\tQWORD PTR [rsp + " << i * VAR_SIZE
+		<< "], rax\t# Save argument " << i << "\n";
+    }
+    for (unsigned int i = 0; i < nbSaved && i < NB_REGISTER_ARGUMENTS; ++i)
+      _indent << "\tpop\t" << ARGUMENT_REGISTERS[i] << "\n";
+    if (nbSaved < nb)
+      _indent << "\tmov\t" << ARGUMENT_REGISTERS[nbSaved]
+	      << ", rax\t\t# Last argument\n";
+  }
+
+  /*!
+  ** Restore callee saved registers used by the current function, and
+  ** remove its frame, if any.
+  */
+  void
+  ASM64GeneratorVisitor::writeLeave()
+  {
+    if (!_leaf)
+      _indent << "\tinc\t" << DEPTH_REGISTER << "\n";
+    if (_frame)
+    {
+      for (unsigned int i = 0; i < _saved.size(); ++i)
+	_indent << "\tmov\t" << _saved[i]->qword << ", QWORD PTR [rbp - "
+		<< _savedOffset + (i + 1) * VAR_SIZE << "]\n";
+      _indent << "\tleave\n";
+      return;
+    }
+
+    if (_padding > 0)
+      _indent << "\tadd\trsp, " << _padding << "\n";
+    for (unsigned int i = _saved.size(); i > 0; --i)
+      _indent << "\tpop\t" << _saved[i - 1]->qword << "\n";
+  }
+
+  /*!
+  ** Leave the current function, its result being in rax.
+  */
+  void
+  ASM64GeneratorVisitor::writeEpilogue()
+  {
+    writeLeave();
+    _indent << "\tret\t\t\t# Return\n";
+  }
+
+  /*!
+  ** Convert the return node
+  **
+  ** @param node The return node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeReturn* node)
+  {
+    assert(node);
+    const AST::NodeExpression* expr = node->getExpr();
+    assert(expr);
+
+    // A tail call whose arguments all fit in registers doesn't need
+    // our frame anymore, so we leave it before jumping.
+    const AST::NodeCallFunc* call = node->getTailCall();
+    if (call && call->nbArgument() <= NB_REGISTER_ARGUMENTS)
+    {
+      writeArguments(call);
+      writeLeave();
+      _indent << "\tjmp\t";
+      visit(call->getId());
+      _indent << "\t\t# Tail call, reusing the current frame\n";
+      return;
+    }
+
+    visit(expr);
+    writeEpilogue();
+  }
+
+  /*!
+  ** Convert the exit node
+  **
+  ** @param node The exit node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeExit* node)
+  {
+    assert(node);
+    const AST::NodeExpression* expr = node->getExpr();
+    assert(expr);
+
+    visit(expr);
+    _indent << "\tmov\tedi, eax\t\t# Exit with given return code\n"
+      "\tjmp\t__cubs_exit\n";
+  }
+
+  /*!
+  ** Convert the function call node
+  **
+  ** @param node The function call node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeCallFunc* node)
+  {
+    assert(node);
+    const AST::NodeIdFunc* id = node->getId();
+    assert(id);
+
+    writeArguments(node);
+    _indent << "\tcall\t";
+    visit(id);
+    _indent << "\n";
+    if (node->nbArgument() > NB_REGISTER_ARGUMENTS)
+      _indent << "\tadd\trsp, "
+	      << (node->nbArgument() - NB_REGISTER_ARGUMENTS) * VAR_SIZE
+	      << "\t\t# Remove arguments given on the stack\n";
+  }
+
+  /*!
+  ** Apply an operator on the value in rax and the right operand,
+  ** putting the result in rax.
+  ** Integers are 32 bits, so they wrap around like in the execution.
+  ** Arithmetic by a constant uses cheaper instructions when possible.
+  **
+  ** @param op The operator
+  ** @param isString If operands are strings
+  ** @param right The right operand
+  */
+  void
+  ASM64GeneratorVisitor::writeOperation(AST::Operator::type op,
+					bool isString,
+					const Location& right)
+  {
+    if (isString)
+    {
+      _indent << "\tmov\trdi, rax\n"
+	"\tmov\trsi, " << right.qword << "\n";
+      switch (op)
+      {
+	case AST::Operator::PLUS:
+	  _indent << "\tcall\t__cubs_concat\n";
+	  break;
+	case AST::Operator::EQUAL:
+	  _indent << "\tcall\t__cubs_streq\n";
+	  break;
+	case AST::Operator::DIFF:
+	  _indent << "\tcall\t__cubs_streq\n"
+	    "\txor\teax, 1\n";
+	  break;
+	default:
+	  assert(false);
+      }
+      return;
+    }
+
+    int constant = 0;
+    if (isImmediate(right.dword) && Utils::fromString(constant, right.dword) &&
+	StrengthReduction::write(_indent, op, constant, "rax"))
+      return;
+
+    switch (op)
+    {
+      case AST::Operator::PLUS:
+	_indent << "\tadd\teax, " << right.dword << "\n";
+	break;
+      case AST::Operator::MINUS:
+	_indent << "\tsub\teax, " << right.dword << "\n";
+	break;
+      case AST::Operator::MUL:
+	_indent << "\timul\teax, " << (isImmediate(right.dword) ? "eax, " : "")
+		<< right.dword << "\n";
+	break;
+      case AST::Operator::DIV:
+      case AST::Operator::MODULO:
+	if (right.dword != "ecx")
+	  _indent << "\tmov\tecx, " << right.dword << "\n";
+	if (!isImmediate(right.dword) || right.dword == "0")
+	  _indent << "\ttest\tecx, ecx\n"
+	    "\tjz\t__cubs_division_by_zero\n";
+	_indent << "\tcdq\n"
+	  "\tidiv\tecx\n";
+	if (op == AST::Operator::MODULO)
+	  _indent << "\tmov\teax, edx\t\t# Remains of the division\n";
+	break;
+      case AST::Operator::EQUAL:
+	_indent << "\tcmp\teax, " << right.dword << "\n"
+	  "\tsete\tal\n"
+	  "\tmovzx\teax, al\n";
+	break;
+      case AST::Operator::DIFF:
+	_indent << "\tcmp\teax, " << right.dword << "\n"
+	  "\tsetne\tal\n"
+	  "\tmovzx\teax, al\n";
+	break;
+      case AST::Operator::SUP:
+	_indent << "\tcmp\teax, " << right.dword << "\n"
+	  "\tsetg\tal\n"
+	  "\tmovzx\teax, al\n";
+	break;
+      case AST::Operator::SUPEQUAL:
+	_indent << "\tcmp\teax, " << right.dword << "\n"
+	  "\tsetge\tal\n"
+	  "\tmovzx\teax, al\n";
+	break;
+      case AST::Operator::INF:
+	_indent << "\tcmp\teax, " << right.dword << "\n"
+	  "\tsetl\tal\n"
+	  "\tmovzx\teax, al\n";
+	break;
+      case AST::Operator::INFEQUAL:
+	_indent << "\tcmp\teax, " << right.dword << "\n"
+	  "\tsetle\tal\n"
+	  "\tmovzx\teax, al\n";
+	break;
+      default:
+	assert(false);
+    }
+  }
+
+  /*!
+  ** Compute both factors of a binary operation.
+  ** A variable or a literal right factor is used directly as operand.
+  ** Otherwise, the left factor is kept in a free register while
+  ** computing the right one, and only spilled on the stack when no
+  ** register is left.
+  **
+  ** @param node The operation node
+  **
+  ** @return Where is the right factor, the left one being in rax
+  */
+  ASM64GeneratorVisitor::Location
+  ASM64GeneratorVisitor::computeOperands(const AST::NodeOperation* node)
+  {
+    assert(node);
+    const AST::NodeFactor* leftFactor = node->getLeftFactor();
+    const AST::NodeFactor* rightFactor = node->getRightFactor();
+    assert(leftFactor);
+    assert(rightFactor);
+    Location right;
+    right.qword = "rcx";
+    right.dword = "ecx";
+
+    if (isSimple(rightFactor))
+    {
+      visit(leftFactor);
+      return operand(rightFactor);
+    }
+
+    if (isStable(leftFactor))
+    {
+      visit(rightFactor);
+      _indent << "\tmov\trcx, rax\n";
+      visit(leftFactor);
+      return right;
+    }
+
+    visit(leftFactor);
+    const bool acrossCall = hasCall(rightFactor);
+    const Register* reg = allocateTemporary(acrossCall);
+    if (reg)
+      _indent << "\tmov\t" << reg->qword << ", rax\t\t# Keep left factor\n";
+    else
+      _indent << "\tpush\trax\t\t# Spill left factor\n";
+    visit(rightFactor);
+    _indent << "\tmov\trcx, rax\n";
+    if (reg)
+      _indent << "\tmov\trax, " << reg->qword << "\n";
+    else
+      _indent << "\tpop\trax\n";
+    releaseTemporary(reg, acrossCall);
+
+    return right;
+  }
+
+  /*!
+  ** Convert the operation node
+  **
+  ** @param node The operation node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeOperation* node)
+  {
+    assert(node);
+    const AST::NodeFactor* leftFactor = node->getLeftFactor();
+    assert(leftFactor);
+
+    if (node->getOpType() == AST::Operator::NONE)
+    {
+      visit(leftFactor);
+      return;
+    }
+
+    const Location& right = computeOperands(node);
+    writeOperation(node->getOpType(),
+		   leftFactor->getComputedType() == AST::Type::STRING, right);
+  }
+
+  /*!
+  ** Jump to the given label if a condition is false.
+  ** An integer or boolean comparison is directly used by the jump,
+  ** without computing a boolean.
+  **
+  ** @param cond The condition
+  ** @param label Where to jump
+  */
+  void
+  ASM64GeneratorVisitor::writeJumpIfFalse(const AST::NodeExpression* cond,
+					  const std::string& label)
+  {
+    assert(cond);
+    const AST::NodeOperation* op = cond->getOperation();
+    assert(op);
+    const char* jump = jumpIfFalse(op->getOpType());
+
+    if (!jump || op->getLeftFactor()->getComputedType() == AST::Type::STRING)
+    {
+      visit(cond);
+      _indent << "\ttest\teax, eax\n"
+	"\tjz\t" << label << "\n";
+      return;
+    }
+
+    const Location& right = computeOperands(op);
+    _indent << "\tcmp\teax, " << right.dword << "\n"
+	    << "\t" << jump << "\t" << label << "\n";
+  }
+
+  /*!
+  ** Convert the expression node
+  ** Put the result in the rax register
+  **
+  ** @param node The expression node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeExpression* node)
+  {
+    assert(node);
+    ConstBaseVisitor<ASM64GeneratorVisitor>::visit(node);
+  }
+
+  /*!
+  ** Convert the string expression node
+  **
+  ** @param node The string expression node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeStringExpr* node)
+  {
+    assert(node);
+    _indent << "\tlea\trax, " << stringLabel(node) << "[rip]\n";
+  }
+
+  /*!
+  ** Convert the boolean node
+  **
+  ** @param node The boolean node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeBoolean* node)
+  {
+    assert(node);
+    _indent << (node->getBool() ? "\tmov\teax, 1\t\t# True\n" :
+		"\txor\teax, eax\t\t# False\n");
+  }
+
+  /*!
+  ** Convert the instruction node
+  **
+  ** @param node The instruction node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeInstr* node)
+  {
+    assert(node);
+    ConstBaseVisitor<ASM64GeneratorVisitor>::visit(node);
+  }
+
+  /*!
+  ** Convert the compound instruction node
+  **
+  ** @param node The compound instruction node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeCompoundInstr* node)
+  {
+    assert(node);
+    const AST::NodeInstrs* instrs = node->getInstrs();
+    if (instrs)
+      visit(instrs);
+  }
+
+  /*!
+  ** Convert the factor node
+  **
+  ** @param node The factor node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeFactor* node)
+  {
+    assert(node);
+    const AST::NodeId* id = node->getId();
+
+    if (id)
+    {
+      _indent << "\tmov\trax, ";
+      visit(id);
+      _indent << "\n";
+      return;
+    }
+
+    ConstBaseVisitor<ASM64GeneratorVisitor>::visit(node);
+  }
+
+  /*!
+  ** Convert the instructions node, without recursion.
+  **
+  ** @param node The instructions node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeInstrs* node)
+  {
+    assert(node);
+    for (; node; node = node->getInstrs())
+      if (node->getInstr())
+	visit(node->getInstr());
+  }
+
+  /*!
+  ** Convert the function node.
+  ** Heaviest variables live in registers, others in the frame. A
+  ** function whose variables all live in registers doesn't need any
+  ** frame, its saved registers are just pushed. The call depth is
+  ** checked like in the execution, counting down the calls left in a
+  ** reserved register: a leaf function calls nothing, so it only checks
+  ** that one more call is allowed.
+  **
+  ** @param node The function node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeFunction* node)
+  {
+    assert(node);
+    const AST::NodeHeaderFunc* header = node->getHeaderFunc();
+    const AST::NodeCompoundInstr* instr = node->getCompoundInstr();
+    assert(header);
+    assert(header->getType());
+    assert(instr);
+    const Registers scratch(_freeScratch);
+    unsigned int frameSize = 0;
+    Ids variables;
+    Ids locals;
+
+    for (unsigned int i = 0; i < node->nbArgument(); ++i)
+      variables.push_back(node->getArgument(i));
+    collectIds(node->getDeclarations(), locals);
+    variables.insert(variables.end(), locals.begin(), locals.end());
+    allocateRegisters(node, variables);
+
+    for (unsigned int i = 0; i < variables.size(); ++i)
+      if (_variables.find(variables[i]) == _variables.end())
+      {
+	if (i < NB_REGISTER_ARGUMENTS || i >= node->nbArgument())
+	{
+	  frameSize += VAR_SIZE;
+	  _variables[variables[i]] =
+	    memoryLocation(-static_cast<int>(frameSize));
+	}
+	else
+	  _variables[variables[i]] =
+	    memoryLocation(2 * VAR_SIZE +
+			   (i - NB_REGISTER_ARGUMENTS) * VAR_SIZE);
+      }
+    _frame = frameSize > 0 || node->nbArgument() > NB_REGISTER_ARGUMENTS;
+    _savedOffset = frameSize;
+    frameSize += _saved.size() * VAR_SIZE;
+
+    _indent << '\n';
+    visit(header->getId());
+    _indent << ":\n";
+    if (_frame)
+    {
+      // Keep the stack aligned on 16 bytes, as asked by the ABI
+      const unsigned int allocated = (frameSize + 15) & ~15u;
+
+      _indent << "\tpush\trbp\t\t# Begin\n"
+	"\tmov\trbp, rsp\n";
+      if (allocated > 0)
+	_indent << "\tsub\trsp, " << allocated
+		<< "\t\t# Place for arguments and local variables\n";
+      for (unsigned int i = 0; i < _saved.size(); ++i)
+	_indent << "\tmov\tQWORD PTR [rbp - "
+		<< _savedOffset + (i + 1) * VAR_SIZE << "], "
+		<< _saved[i]->qword << "\n";
+    }
+    else
+    {
+      // A leaf function doesn't care about the alignment
+      _padding = !_leaf && _saved.size() % 2 == 0 ? VAR_SIZE : 0;
+      for (unsigned int i = 0; i < _saved.size(); ++i)
+	_indent << "\tpush\t" << _saved[i]->qword << "\n";
+      if (_padding > 0)
+	_indent << "\tsub\trsp, " << _padding
+		<< "\t\t# Keep the stack aligned\n";
+    }
+    if (_leaf)
+      _indent << "\ttest\t" << DEPTH_REGISTER << ", " << DEPTH_REGISTER
+	      << "\n"
+	"\tjz\t__cubs_depth_exceeded\n";
+    else
+      _indent << "\tdec\t" << DEPTH_REGISTER << "\n"
+	"\tjs\t__cubs_depth_exceeded\n";
+
+    // Arguments given in a register which another one goes into are
+    // moved first
+    for (unsigned int pass = 0; pass < 2; ++pass)
+      for (unsigned int i = 0; i < node->nbArgument(); ++i)
+      {
+	const Location& location = _variables[node->getArgument(i)];
+	const bool toArgument =
+	  std::find(ARGUMENT_REGISTERS,
+		    ARGUMENT_REGISTERS + NB_REGISTER_ARGUMENTS,
+		    location.qword) != ARGUMENT_REGISTERS + NB_REGISTER_ARGUMENTS;
+	if (toArgument != (pass == 1))
+	  continue;
+	if (i < NB_REGISTER_ARGUMENTS)
+	{
+	  if (location.qword != ARGUMENT_REGISTERS[i])
+	    _indent << "\tmov\t" << location.qword << ", "
+		    << ARGUMENT_REGISTERS[i] << "\n";
+	  continue;
+	}
+	const Location& given =
+	  memoryLocation(2 * VAR_SIZE +
+			 (i - NB_REGISTER_ARGUMENTS) * VAR_SIZE);
+	if (location.qword != given.qword)
+	  _indent << "\tmov\t" << location.qword << ", " << given.qword
+		  << "\t# Argument given on the stack\n";
+      }
+    for (Ids::const_iterator it = locals.begin(); it != locals.end(); ++it)
+      initVariable(*it);
+
+    visit(instr);
+
+    // Default value, in case of no return instruction
+    if (Utils::stringToType(header->getType()->getType()) == AST::Type::STRING)
+      _indent << "\tlea\trax, __cubs_empty[rip]\n";
+    else
+      _indent << "\txor\teax, eax\n";
+    writeEpilogue();
+    _freeScratch = scratch;
+  }
+
+  /*!
+  ** Convert the while node
+  **
+  ** @param node The while node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeWhile* node)
+  {
+    assert(node);
+    const AST::NodeExpression* cond = node->getCond();
+    const AST::NodeCompoundInstr* body = node->getBodyExprs();
+    assert(cond);
+    assert(body);
+    const unsigned int label = newLabel();
+
+    std::stringstream endLabel;
+    endLabel << ".Lend_while_" << label;
+
+    _indent << ".Lwhile_" << label << ":\n";
+    writeJumpIfFalse(cond, endLabel.str());
+    visit(body);
+    _indent << "\tjmp\t.Lwhile_" << label << "\n"
+      ".Lend_while_" << label << ":\n";
+  }
+
+  /*!
+  ** Convert the number node
+  **
+  ** @param node The number node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeNumber* node)
+  {
+    assert(node);
+    _indent << "\tmov\teax, " << node->getNumber() << "\n";
+  }
+
+  /*!
+  ** Convert the id node, into the place of its declaration.
+  **
+  ** @param node The id node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeId* node)
+  {
+    assert(node);
+    Variables::const_iterator it = _variables.find(node->getRef());
+    assert(it != _variables.end());
+    _indent << it->second.qword;
+  }
+
+  /*!
+  ** Convert the function id node
+  **
+  ** @param node The function id node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodeIdFunc* node)
+  {
+    assert(node);
+    _indent << "f_" << node->getId();
+  }
+
+  /*!
+  ** Convert the print node
+  **
+  ** @param node The print node
+  */
+  void
+  ASM64GeneratorVisitor::visit(const AST::NodePrint* node)
+  {
+    assert(node);
+    const AST::NodeExpression* expr = node->getExpr();
+    assert(expr);
+
+    visit(expr);
+    _indent << "\tmov\trdi, rax\t\t# Prepare to being print\n"
+      "\tcall\t";
+    switch (expr->getComputedType())
+    {
+      case AST::Type::INTEGER:
+	_indent << "__cubs_print_int";
+	break;
+      case AST::Type::BOOLEAN:
+	_indent << "__cubs_print_bool";
+	break;
+      case AST::Type::STRING:
+	_indent << "__cubs_print_string";
+	break;
+      case AST::Type::UNDEFINED:
+      default:
+	assert(false);
+    }
+    _indent << "\n";
+  }
+
+  /*!
+  ** Print the buffered text of the given visitor in the choosen stream.
+  **
+  ** @param o The stream
+  ** @param v The visitor
+  **
+  ** @return The modified stream
+  */
+  std::ostream&
+  operator<<(std::ostream& o, const ASM64GeneratorVisitor& v)
+  {
+    v.print(o);
+    return o;
+  }
+}
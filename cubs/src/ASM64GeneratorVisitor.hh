@@ -0,0 +1,145 @@
+#ifndef ASM64GENERATORVISITOR_HH_
+# define ASM64GENERATORVISITOR_HH_
+
+# include <sstream>
+# include <map>
+# include <vector>
+# include "PrettyPrinterVisitor.hh"
+# include "Error.hh"
+# include "Utils.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Generate x86-64 assembly, in GNU as intel syntax, following the
+  ** System V ABI: the first arguments are given in registers, the result
+  ** is returned in rax. Temporaries are kept in registers, and the most
+  ** used variables of a function live in callee saved registers, or in
+  ** caller saved ones when it calls nothing. The number of calls which
+  ** can still be nested is kept in r15, which is never used otherwise.
+  ** The runtime only uses Linux system calls, so the
+  ** result can be linked without any library:
+  **   as -o prog.o prog.s && ld -o prog prog.o
+  ** or be turned into an executable by the ASM64Assembler.
+  */
+  class ASM64GeneratorVisitor :
+    public BasicPrettyPrinterVisitor<ASM64GeneratorVisitor>
+  {
+    friend std::ostream&
+    operator<<(std::ostream& o, const ASM64GeneratorVisitor& v);
+
+    /*!
+    ** A register, with the name of its 64 and 32 bits parts.
+    */
+    struct Register
+    {
+      const char*	qword;
+      const char*	dword;
+    };
+
+    /*!
+    ** Where a value is, as a 64 and 32 bits operand.
+    */
+    struct Location
+    {
+      std::string	qword;
+      std::string	dword;
+    };
+
+    typedef std::map<const AST::NodeId*, Location> Variables;
+    typedef std::vector<const AST::NodeId*> Ids;
+    typedef std::map<std::string, std::string> ROStrings;
+    typedef std::vector<const Register*> Registers;
+
+    static const unsigned int OUTPUT_BUFFER_SIZE = 8192;
+    static const unsigned int HEAP_CHUNK_SIZE = 1 << 20;
+    static const unsigned int VAR_SIZE = 8;
+    static const unsigned int NB_REGISTER_ARGUMENTS = 6;
+    static const char* const ARGUMENT_REGISTERS[NB_REGISTER_ARGUMENTS];
+    static const unsigned int NB_CALLEE_SAVED_REGISTERS = 4;
+    static const Register CALLEE_SAVED_REGISTERS[NB_CALLEE_SAVED_REGISTERS];
+    static const char* const DEPTH_REGISTER;
+    static const unsigned int NB_SCRATCH_REGISTERS = 6;
+    static const Register SCRATCH_REGISTERS[NB_SCRATCH_REGISTERS];
+
+  public:
+    ASM64GeneratorVisitor();
+    ~ASM64GeneratorVisitor();
+    void printRuntime(bool hasToBePrint);
+    void setHosted(const bool hosted);
+    void setMaxDepth(const unsigned int depth);
+
+  public:
+    using BasicPrettyPrinterVisitor<ASM64GeneratorVisitor>::visit;
+    void visit(const AST::NodeProgram* node);
+    void visit(const AST::NodeAffect* node);
+    void visit(const AST::NodeIf* node);
+    void visit(const AST::NodeRead* node);
+    void visit(const AST::NodeReturn* node);
+    void visit(const AST::NodeExit* node);
+    void visit(const AST::NodeCallFunc* node);
+    void visit(const AST::NodeOperation* node);
+    void visit(const AST::NodeExpression* node);
+    void visit(const AST::NodeStringExpr* node);
+    void visit(const AST::NodeBoolean* node);
+    void visit(const AST::NodeInstr* node);
+    void visit(const AST::NodeCompoundInstr* node);
+    void visit(const AST::NodeFactor* node);
+    void visit(const AST::NodeInstrs* node);
+    void visit(const AST::NodeFunction* node);
+    void visit(const AST::NodeWhile* node);
+    void visit(const AST::NodeNumber* node);
+    void visit(const AST::NodeId* node);
+    void visit(const AST::NodeIdFunc* node);
+    void visit(const AST::NodePrint* node);
+
+  protected:
+    void writeHeader();
+    void writeRuntime();
+    void writePostlude();
+    void writeString(const std::string& label, const std::string& s);
+
+  private:
+    static void collectIds(const AST::NodeDeclarations* decls, Ids& ids);
+    static Location memoryLocation(int offset);
+    void allocateRegisters(const AST::NodeFunction* node,
+			   const Ids& variables);
+    void allocateScratch(const AST::NodeFunction* node, const Ids& sorted,
+			 unsigned int nbTemporaries);
+    const Register* allocateTemporary(bool acrossCall);
+    void releaseTemporary(const Register* reg, bool acrossCall);
+    bool isStable(const AST::NodeFactor* factor) const;
+    Location operand(const AST::NodeFactor* factor);
+    const std::string& stringLabel(const AST::NodeStringExpr* node);
+    void initVariable(const AST::NodeId* id);
+    Location computeOperands(const AST::NodeOperation* node);
+    void writeOperation(AST::Operator::type op, bool isString,
+			const Location& right);
+    void writeJumpIfFalse(const AST::NodeExpression* cond,
+			  const std::string& label);
+    void writeArguments(const AST::NodeCallFunc* node);
+    void writeLeave();
+    void writeEpilogue();
+    unsigned int newLabel();
+
+  private:
+    Variables		_variables;
+    Ids			_globals;
+    ROStrings		_strings;
+    Registers		_saved;
+    unsigned int	_savedOffset;
+    bool		_leaf;
+    bool		_frame;
+    unsigned int	_padding;
+    Registers		_freeScratch;
+    Registers		_freeCallee;
+    bool		_printRuntime;
+    bool		_hosted;
+    unsigned int	_maxDepth;
+    unsigned int	_nbLabels;
+  };
+}
+
+# include "ASM64GeneratorVisitor.hxx"
+
+#endif /* !ASM64GENERATORVISITOR_HH_ */
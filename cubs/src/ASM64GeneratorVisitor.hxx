@@ -0,0 +1,784 @@
+namespace MiniCompiler
+{
+  /*!
+  ** Set if we need to print the runtime.
+  **
+  ** @param hasToBePrint If runtime has to be print
+  */
+  inline void
+  ASM64GeneratorVisitor::printRuntime(bool hasToBePrint)
+  {
+    _printRuntime = hasToBePrint;
+  }
+
+  /*!
+  ** Choose if the program is run by a host, in its own process. Then
+  ** the runtime is entered by __cubs_enter, and exiting goes back to
+  ** the host, instead of ending the process.
+  **
+  ** @param hosted If the program is run by a host
+  */
+  inline void
+  ASM64GeneratorVisitor::setHosted(const bool hosted)
+  {
+    _hosted = hosted;
+  }
+
+  /*!
+  ** Set the maximum number of nested function calls.
+  **
+  ** @param depth The maximum call depth
+  */
+  inline void
+  ASM64GeneratorVisitor::setMaxDepth(const unsigned int depth)
+  {
+    _maxDepth = depth;
+  }
+
+  /*!
+  ** Get a new label number.
+  **
+  ** @return An unused label number
+  */
+  inline unsigned int
+  ASM64GeneratorVisitor::newLabel()
+  {
+    return ++_nbLabels;
+  }
+
+  /*!
+  ** Just write the header.
+  */
+  inline void
+  ASM64GeneratorVisitor::writeHeader()
+  {
+    _indent << "# Generated by Cubs\n\n"
+      "\t.intel_syntax noprefix\n"
+      "\t.globl\t_start\n";
+  }
+
+  /*!
+  ** Just write the runtime, ie some functions needed to make it works.
+  ** Values are given in rdi and rsi, results are returned in rax.
+  ** Strings are freed by a mark and sweep collector, which takes any word
+  ** of the stack or of the globals looking like a string as a root.
+  */
+  inline void
+  ASM64GeneratorVisitor::writeRuntime()
+  {
+    if (!_printRuntime)
+      return;
+
+    _indent << "\n# === RUNTIME ===\n\n";
+    if (_hosted)
+      _indent <<
+	// enter
+	"__cubs_enter:\t\t\t# Run the program on the stack in rdi, from a host\n"
+	"\tpush\trbx\n"
+	"\tpush\trbp\n"
+	"\tpush\tr12\n"
+	"\tpush\tr13\n"
+	"\tpush\tr14\n"
+	"\tpush\tr15\n"
+	"\tmov\tQWORD PTR __cubs_host_stack[rip], rsp\n"
+	"\tmov\trsp, rdi\n"
+	"\tjmp\t_start\n"
+	"\n"
+	// exit
+	"__cubs_exit:\t\t\t# Flush the output, then give the code in edi to the host\n"
+	"\tpush\trdi\n"
+	"\tcall\t__cubs_flush\n"
+	"\tpop\trax\n"
+	"\tmov\trsp, QWORD PTR __cubs_host_stack[rip]\n"
+	"\tpop\tr15\n"
+	"\tpop\tr14\n"
+	"\tpop\tr13\n"
+	"\tpop\tr12\n"
+	"\tpop\trbp\n"
+	"\tpop\trbx\n"
+	"\tret\n"
+	"\n";
+    else
+      _indent <<
+	// exit
+	"__cubs_exit:\t\t\t# Flush the output, then exit with the code in edi\n"
+	"\tpush\trdi\n"
+	"\tcall\t__cubs_flush\n"
+	"\tpop\trdi\n"
+	"\tmov\teax, 60\n"
+	"\tsyscall\n"
+	"\n";
+    _indent <<
+      // error
+      "__cubs_error:\t\t\t# Print the message in rdi on stderr, then fail\n"
+      "\tmov\tBYTE PTR __cubs_failed[rip], 1\n"
+      "\tpush\trdi\n"
+      "\tcall\t__cubs_flush\n"
+      "\tpop\trdi\n"
+      "\tcall\t__cubs_strlen\n"
+      "\tmov\trdx, rax\n"
+      "\tmov\trsi, rdi\n"
+      "\tmov\tedi, 2\n"
+      "\tcall\t__cubs_syswrite\n"
+      "\tmov\tedi, " << Error::EXECUTION << "\n"
+      "\tjmp\t__cubs_exit\n"
+      "\n"
+      "__cubs_division_by_zero:\n"
+      "\tlea\trdi, __cubs_division_by_zero_message[rip]\n"
+      "\tjmp\t__cubs_error\n"
+      "\n"
+      "__cubs_depth_exceeded:\n"
+      "\tlea\trdi, __cubs_depth_exceeded_message[rip]\n"
+      "\tjmp\t__cubs_error\n"
+      "\n"
+      "__cubs_out_of_memory:\n"
+      "\tlea\trdi, __cubs_out_of_memory_message[rip]\n"
+      "\tjmp\t__cubs_error\n"
+      "\n"
+      // strlen
+      "__cubs_strlen:\t\t\t# Length of the string in rdi\n"
+      "\tmov\trax, rdi\n"
+      ".Lstrlen_loop:\n"
+      "\tcmp\tBYTE PTR [rax], 0\n"
+      "\tje\t.Lstrlen_end\n"
+      "\tinc\trax\n"
+      "\tjmp\t.Lstrlen_loop\n"
+      ".Lstrlen_end:\n"
+      "\tsub\trax, rdi\n"
+      "\tret\n"
+      "\n"
+      // syswrite
+      "__cubs_syswrite:\t\t# Write rdx bytes from rsi on the file edi\n"
+      "\ttest\trdx, rdx\n"
+      "\tjz\t.Lsyswrite_end\n"
+      "\tmov\teax, 1\n"
+      "\tsyscall\n"
+      "\ttest\trax, rax\n"
+      "\tjle\t.Lsyswrite_end\n"
+      "\tadd\trsi, rax\n"
+      "\tsub\trdx, rax\n"
+      "\tjmp\t__cubs_syswrite\n"
+      ".Lsyswrite_end:\n"
+      "\tret\n"
+      "\n"
+      // flush
+      "__cubs_flush:\t\t\t# Write the output buffer on stdout\n"
+      "\tlea\trsi, __cubs_out_buffer[rip]\n"
+      "\tmov\trdx, QWORD PTR __cubs_out_size[rip]\n"
+      "\tmov\tQWORD PTR __cubs_out_size[rip], 0\n"
+      "\tmov\tedi, 1\n"
+      "\tjmp\t__cubs_syswrite\n"
+      "\n"
+      // write
+      "__cubs_write:\t\t\t# Write rdx bytes from rsi on stdout, buffered\n"
+      "\tmov\trax, QWORD PTR __cubs_out_size[rip]\n"
+      "\tlea\trcx, [rax + rdx]\n"
+      "\tcmp\trcx, " << OUTPUT_BUFFER_SIZE << "\n"
+      "\tjbe\t.Lwrite_copy\n"
+      "\tpush\trsi\n"
+      "\tpush\trdx\n"
+      "\tcall\t__cubs_flush\n"
+      "\tpop\trdx\n"
+      "\tpop\trsi\n"
+      "\txor\teax, eax\n"
+      "\tcmp\trdx, " << OUTPUT_BUFFER_SIZE << "\n"
+      "\tjb\t.Lwrite_copy\n"
+      "\tmov\tedi, 1\t\t\t# Too large to be buffered\n"
+      "\tjmp\t__cubs_syswrite\n"
+      ".Lwrite_copy:\n"
+      "\tlea\trdi, __cubs_out_buffer[rip]\n"
+      "\tadd\trdi, rax\n"
+      "\tadd\trax, rdx\n"
+      "\tmov\tQWORD PTR __cubs_out_size[rip], rax\n"
+      "\tmov\trcx, rdx\n"
+      "\trep movsb\n"
+      "\tret\n"
+      "\n"
+      // print_string
+      "__cubs_print_string:\t\t# Print the string in rdi\n"
+      "\tmov\trsi, QWORD PTR [rdi]\n"
+      "\tmov\trdx, QWORD PTR [rdi + 8]\n"
+      "\tjmp\t__cubs_write\n"
+      "\n"
+      // print_bool
+      "__cubs_print_bool:\t\t# Print the boolean in edi\n"
+      "\ttest\tedi, edi\n"
+      "\tlea\trdi, __cubs_true[rip]\n"
+      "\tjnz\t__cubs_print_string\n"
+      "\tlea\trdi, __cubs_false[rip]\n"
+      "\tjmp\t__cubs_print_string\n"
+      "\n"
+      // print_int
+      "__cubs_print_int:\t\t# Print the integer in edi\n"
+      "\tsub\trsp, 16\n"
+      "\tlea\trsi, [rsp + 16]\n"
+      "\tmov\tr8d, 0xCCCCCCCD\t\t# 2^35 / 10, rounded up\n"
+      "\tmov\teax, edi\n"
+      "\ttest\teax, eax\n"
+      "\tjns\t.Lprint_int_loop\n"
+      "\tneg\teax\t\t\t# Unsigned, so -2147483648 works too\n"
+      ".Lprint_int_loop:\n"
+      "\tmov\tedx, eax\n"
+      "\timul\trdx, r8\n"
+      "\tshr\trdx, 35\t\t# edx = eax / 10\n"
+      "\tlea\tecx, [rdx + rdx * 4]\n"
+      "\tadd\tecx, ecx\n"
+      "\tsub\teax, ecx\n"
+      "\tadd\tal, '0'\n"
+      "\tdec\trsi\n"
+      "\tmov\tBYTE PTR [rsi], al\n"
+      "\tmov\teax, edx\n"
+      "\ttest\teax, eax\n"
+      "\tjnz\t.Lprint_int_loop\n"
+      "\ttest\tedi, edi\n"
+      "\tjns\t.Lprint_int_write\n"
+      "\tdec\trsi\n"
+      "\tmov\tBYTE PTR [rsi], '-'\n"
+      ".Lprint_int_write:\n"
+      "\tlea\trdx, [rsp + 16]\n"
+      "\tsub\trdx, rsi\n"
+      "\tcall\t__cubs_write\n"
+      "\tadd\trsp, 16\n"
+      "\tret\n"
+      "\n"
+      // alloc
+      "__cubs_alloc:\t\t\t# Allocate rdi bytes on the heap, esi is 2 for a string\n"
+      "\tlea\trdi, [rdi + 23]\t\t# A header of 8 bytes, blocks aligned on 16\n"
+      "\tand\trdi, -16\n"
+      ".Lalloc_retry:\n"
+      "\tmov\trax, QWORD PTR __cubs_heap[rip]\n"
+      "\tlea\trdx, [rax + rdi]\n"
+      "\tcmp\trdx, QWORD PTR __cubs_heap_end[rip]\n"
+      "\tja\t.Lalloc_run\n"
+      "\tmov\tQWORD PTR __cubs_heap[rip], rdx\n"
+      "\tadd\tQWORD PTR __cubs_allocated[rip], rdi\n"
+      "\tmov\trdx, rdi\n"
+      "\tor\trdx, rsi\n"
+      "\tmov\tQWORD PTR [rax], rdx\t# Size and kind of the block\n"
+      "\tmov\trdx, rax\n"
+      "\tshr\trdx, 4\n"
+      "\tadd\trdx, QWORD PTR __cubs_run_map[rip]\n"
+      "\tmov\tBYTE PTR [rdx], 1\t# Allocated\n"
+      "\tadd\trax, 8\n"
+      "\tret\n"
+      ".Lalloc_run:\t\t\t# Leave the current run of free memory\n"
+      "\tmov\trdx, QWORD PTR __cubs_heap_end[rip]\n"
+      "\tsub\trdx, rax\n"
+      "\tjz\t.Lalloc_next\n"
+      "\tmov\tQWORD PTR [rax], rdx\t# Its rest stays a free block\n"
+      ".Lalloc_next:\t\t\t# Take the next run, from the free list\n"
+      "\tmov\trax, QWORD PTR __cubs_free[rip]\n"
+      "\ttest\trax, rax\n"
+      "\tjz\t.Lalloc_empty\n"
+      "\tmov\trdx, QWORD PTR [rax + 8]\n"
+      "\tmov\tQWORD PTR __cubs_free[rip], rdx\n"
+      "\tmov\tQWORD PTR __cubs_heap[rip], rax\n"
+      "\tmov\trdx, QWORD PTR [rax]\n"
+      "\tadd\trdx, rax\n"
+      "\tmov\tQWORD PTR __cubs_heap_end[rip], rdx\n"
+      "\tcall\t__cubs_chunk\n"
+      "\tmov\trdx, rcx\n"
+      "\tshr\trdx, 4\n"
+      "\tneg\trdx\n"
+      "\tlea\trdx, [rcx + rdx + 32]\n"
+      "\tmov\tQWORD PTR __cubs_run_map[rip], rdx\n"
+      "\tjmp\t.Lalloc_retry\n"
+      ".Lalloc_empty:\t\t\t# Collect when as much as the live blocks was allocated\n"
+      "\tmov\trax, QWORD PTR __cubs_allocated[rip]\n"
+      "\tcmp\trax, QWORD PTR __cubs_collect_at[rip]\n"
+      "\tjb\t.Lalloc_chunk\n"
+      "\tpush\trdi\n"
+      "\tpush\trsi\n"
+      "\tcall\t__cubs_collect\n"
+      "\tpop\trsi\n"
+      "\tpop\trdi\n"
+      "\tjmp\t.Lalloc_next\n"
+      // Not brk, which would move the heap of a host behind its back
+      ".Lalloc_chunk:\t\t\t# Map a new chunk, linked to the previous ones\n"
+      "\tpush\trdi\n"
+      "\tpush\trsi\n"
+      "\tmov\trsi, rdi\n"
+      "\tshr\trsi, 3\t\t\t# Room for the map of its blocks\n"
+      "\tlea\trsi, [rsi + rdi + " << HEAP_CHUNK_SIZE + 31 << "]\n"
+      "\tand\trsi, -" << HEAP_CHUNK_SIZE << "\n"
+      "\tpush\trsi\n"
+      "\txor\tedi, edi\n"
+      "\tmov\tedx, 3\t\t\t# Readable and writable\n"
+      "\tmov\tr10d, 0x22\t\t# Private and anonymous\n"
+      "\tmov\tr8, -1\n"
+      "\txor\tr9d, r9d\n"
+      "\tmov\teax, 9\n"
+      "\tsyscall\n"
+      "\tpop\trsi\n"
+      "\tcmp\trax, -4096\n"
+      "\tja\t__cubs_out_of_memory\n"
+      "\tmov\trdx, QWORD PTR __cubs_chunks[rip]\n"
+      "\tmov\tQWORD PTR [rax], rdx\n"
+      "\tmov\tQWORD PTR [rax + 8], rsi\n"
+      "\tmov\tQWORD PTR __cubs_chunks[rip], rax\n"
+      "\tmov\trdx, rax\n"
+      "\tshr\trdx, 4\n"
+      "\tneg\trdx\n"
+      "\tlea\trdx, [rax + rdx + 32]\n"
+      "\tmov\tQWORD PTR __cubs_run_map[rip], rdx\n"
+      "\tlea\trdx, [rax + rsi]\n"
+      "\tmov\tQWORD PTR __cubs_heap_end[rip], rdx\n"
+      "\tshr\trsi, 4\n"
+      "\tlea\trax, [rax + rsi + 32]\t# Blocks are after the map\n"
+      "\tmov\tQWORD PTR __cubs_heap[rip], rax\n"
+      "\tpop\trsi\n"
+      "\tpop\trdi\n"
+      "\tjmp\t.Lalloc_retry\n"
+      "\n"
+      // chunk
+      "__cubs_chunk:\t\t\t# Get in rcx the chunk containing rax, or 0\n"
+      "\tmov\trcx, QWORD PTR __cubs_chunks[rip]\n"
+      ".Lchunk_loop:\n"
+      "\ttest\trcx, rcx\n"
+      "\tjz\t.Lchunk_end\n"
+      "\tcmp\trax, rcx\n"
+      "\tjb\t.Lchunk_next\n"
+      "\tmov\trdx, QWORD PTR [rcx + 8]\n"
+      "\tadd\trdx, rcx\n"
+      "\tcmp\trax, rdx\n"
+      "\tjb\t.Lchunk_end\n"
+      ".Lchunk_next:\n"
+      "\tmov\trcx, QWORD PTR [rcx]\n"
+      "\tjmp\t.Lchunk_loop\n"
+      ".Lchunk_end:\n"
+      "\tret\n"
+      "\n"
+      // mark
+      "__cubs_mark:\t\t\t# Mark the block at rdi if it is one, and its data\n"
+      "\ttest\tedi, 15\n"
+      "\tjnz\t.Lmark_end\n"
+      "\tmov\trax, rdi\n"
+      "\tcall\t__cubs_chunk\n"
+      "\ttest\trcx, rcx\n"
+      "\tjz\t.Lmark_end\n"
+      "\tmov\trdx, rdi\n"
+      "\tsub\trdx, rcx\n"
+      "\tshr\trdx, 4\n"
+      "\tcmp\tBYTE PTR [rcx + rdx + 32], 1\t# Allocated, not marked yet\n"
+      "\tjne\t.Lmark_end\n"
+      "\tmov\tBYTE PTR [rcx + rdx + 32], 2\n"
+      "\tmov\trax, QWORD PTR [rdi]\n"
+      "\tand\trax, -16\n"
+      "\tadd\tQWORD PTR __cubs_live[rip], rax\n"
+      "\ttest\tBYTE PTR [rdi], 2\t# A string: its data is reached too\n"
+      "\tjz\t.Lmark_end\n"
+      "\tmov\trdi, QWORD PTR [rdi + 8]\n"
+      "\tsub\trdi, 24\n"
+      "\tjmp\t__cubs_mark\n"
+      ".Lmark_end:\n"
+      "\tret\n"
+      "\n"
+      // scan
+      "__cubs_scan:\t\t\t# Mark what the words from rbx to rbp may point to\n"
+      "\tcmp\trbx, rbp\n"
+      "\tjae\t.Lscan_end\n"
+      "\tmov\trdi, QWORD PTR [rbx]\n"
+      "\tsub\trdi, 8\t\t\t# A string\n"
+      "\tcall\t__cubs_mark\n"
+      "\tmov\trdi, QWORD PTR [rbx]\n"
+      "\tsub\trdi, 24\t\t\t# The data of a string\n"
+      "\tcall\t__cubs_mark\n"
+      "\tadd\trbx, 8\n"
+      "\tjmp\t__cubs_scan\n"
+      ".Lscan_end:\n"
+      "\tret\n"
+      "\n"
+      // collect
+      "__cubs_collect:\t\t\t# Free the blocks the program can't reach anymore\n"
+      "\tpush\trbx\n"
+      "\tpush\trbp\n"
+      "\tpush\tr12\n"
+      "\tpush\tr13\n"
+      "\tpush\tr14\n"
+      "\tpush\tr15\t\t\t# Registers of the program are scanned with the stack\n"
+      "\tmov\trax, QWORD PTR __cubs_heap[rip]\n"
+      "\tmov\trdx, QWORD PTR __cubs_heap_end[rip]\n"
+      "\tsub\trdx, rax\n"
+      "\tjz\t.Lcollect_roots\n"
+      "\tmov\tQWORD PTR [rax], rdx\t# The rest of the current run stays free\n"
+      ".Lcollect_roots:\n"
+      "\txor\teax, eax\n"
+      "\tmov\tQWORD PTR __cubs_heap[rip], rax\n"
+      "\tmov\tQWORD PTR __cubs_heap_end[rip], rax\n"
+      "\tmov\tQWORD PTR __cubs_free[rip], rax\n"
+      "\tmov\tQWORD PTR __cubs_allocated[rip], rax\n"
+      "\tmov\tQWORD PTR __cubs_live[rip], rax\n"
+      "\tmov\trbx, rsp\n"
+      "\tmov\trbp, QWORD PTR __cubs_stack_top[rip]\n"
+      "\tcall\t__cubs_scan\n"
+      "\tlea\trbx, __cubs_globals[rip]\n"
+      "\tlea\trbp, __cubs_globals_end[rip]\n"
+      "\tcall\t__cubs_scan\n"
+      "\tmov\tr12, QWORD PTR __cubs_chunks[rip]\n"
+      ".Lcollect_chunk:\t\t# Sweep each chunk, block after block\n"
+      "\ttest\tr12, r12\n"
+      "\tjz\t.Lcollect_end\n"
+      "\tmov\tr13, QWORD PTR [r12 + 8]\n"
+      "\tmov\trbx, r13\n"
+      "\tshr\trbx, 4\n"
+      "\tlea\trbx, [r12 + rbx + 32]\t# The first block, after the map\n"
+      "\tadd\tr13, r12\n"
+      "\tmov\trbp, r12\n"
+      "\tshr\trbp, 4\n"
+      "\tneg\trbp\n"
+      "\tlea\trbp, [r12 + rbp + 32]\t# The map, indexed by address / 16\n"
+      ".Lcollect_block:\n"
+      "\tcmp\trbx, r13\n"
+      "\tjae\t.Lcollect_next\n"
+      "\tmov\trax, rbx\n"
+      "\tshr\trax, 4\n"
+      "\tcmp\tBYTE PTR [rbp + rax], 2\n"
+      "\tjne\t.Lcollect_free\n"
+      "\tmov\tBYTE PTR [rbp + rax], 1\t# Reached, so kept\n"
+      "\tmov\trax, QWORD PTR [rbx]\n"
+      "\tand\trax, -16\n"
+      "\tadd\trbx, rax\n"
+      "\tjmp\t.Lcollect_block\n"
+      ".Lcollect_free:\t\t\t# Join it with the next blocks not reached\n"
+      "\tmov\tr14, rbx\n"
+      ".Lcollect_join:\n"
+      "\tmov\tBYTE PTR [rbp + rax], 0\n"
+      "\tmov\trdx, QWORD PTR [rbx]\n"
+      "\tand\trdx, -16\n"
+      "\tadd\trbx, rdx\n"
+      "\tcmp\trbx, r13\n"
+      "\tjae\t.Lcollect_run\n"
+      "\tmov\trax, rbx\n"
+      "\tshr\trax, 4\n"
+      "\tcmp\tBYTE PTR [rbp + rax], 2\n"
+      "\tjne\t.Lcollect_join\n"
+      ".Lcollect_run:\t\t\t# A free run, put in the free list\n"
+      "\tmov\trax, rbx\n"
+      "\tsub\trax, r14\n"
+      "\tmov\tQWORD PTR [r14], rax\n"
+      "\tmov\trdx, QWORD PTR __cubs_free[rip]\n"
+      "\tmov\tQWORD PTR [r14 + 8], rdx\n"
+      "\tmov\tQWORD PTR __cubs_free[rip], r14\n"
+      "\tjmp\t.Lcollect_block\n"
+      ".Lcollect_next:\n"
+      "\tmov\tr12, QWORD PTR [r12]\n"
+      "\tjmp\t.Lcollect_chunk\n"
+      ".Lcollect_end:\t\t\t# Next time, when as much as the live blocks is allocated\n"
+      "\tmov\trax, QWORD PTR __cubs_live[rip]\n"
+      "\tcmp\trax, " << HEAP_CHUNK_SIZE << "\n"
+      "\tjae\t.Lcollect_quit\n"
+      "\tmov\teax, " << HEAP_CHUNK_SIZE << "\n"
+      ".Lcollect_quit:\n"
+      "\tmov\tQWORD PTR __cubs_collect_at[rip], rax\n"
+      "\tpop\tr15\n"
+      "\tpop\tr14\n"
+      "\tpop\tr13\n"
+      "\tpop\tr12\n"
+      "\tpop\trbp\n"
+      "\tpop\trbx\n"
+      "\tret\n"
+      "\n"
+      // new_string
+      "__cubs_new_string:\t\t# New string of rsi bytes at rdi\n"
+      "\tpush\trdi\n"
+      "\tpush\trsi\n"
+      "\tmov\tedi, 16\n"
+      "\tmov\tesi, 2\n"
+      "\tcall\t__cubs_alloc\n"
+      "\tpop\tQWORD PTR [rax + 8]\n"
+      "\tpop\tQWORD PTR [rax]\n"
+      "\tret\n"
+      "\n"
+      // concat
+      "__cubs_concat:\t\t\t# Concat strings in rdi and rsi\n"
+      "\tmov\trdx, QWORD PTR [rsi + 8]\n"
+      "\ttest\trdx, rdx\n"
+      "\tjz\t.Lconcat_left\n"
+      "\tmov\trcx, QWORD PTR [rdi + 8]\n"
+      "\ttest\trcx, rcx\n"
+      "\tjz\t.Lconcat_right\n"
+      "\tmov\tr8, QWORD PTR [rdi]\n"
+      "\tlea\tr9, [rcx + rdx]\n"
+      "\tcmp\trcx, QWORD PTR [r8 - 8]\t# Does the left string end its buffer,\n"
+      "\tjne\t.Lconcat_copy\n"
+      "\tcmp\tr9, QWORD PTR [r8 - 16]\t# with enough room after it ?\n"
+      "\tja\t.Lconcat_copy\n"
+      "\tmov\tQWORD PTR [r8 - 8], r9\t# Then append in place\n"
+      "\tpush\tr8\n"
+      "\tpush\tr9\n"
+      "\tlea\trdi, [r8 + rcx]\n"
+      "\tmov\trsi, QWORD PTR [rsi]\n"
+      "\tmov\trcx, rdx\n"
+      "\trep movsb\n"
+      "\tpop\trsi\n"
+      "\tpop\trdi\n"
+      "\tjmp\t__cubs_new_string\n"
+      ".Lconcat_copy:\t\t\t# Else copy both into a buffer twice larger\n"
+      "\tpush\trdi\n"
+      "\tpush\trsi\n"
+      "\tpush\tr9\n"
+      "\tlea\trdi, [r9 * 2 + 16]\n"
+      "\txor\tesi, esi\n"
+      "\tcall\t__cubs_alloc\n"
+      "\tpop\tr9\n"
+      "\tpop\tr10\n"
+      "\tpop\tr11\n"
+      "\tlea\trcx, [r9 * 2]\n"
+      "\tmov\tQWORD PTR [rax], rcx\t# Capacity\n"
+      "\tmov\tQWORD PTR [rax + 8], r9\t# Used\n"
+      "\tlea\trdi, [rax + 16]\n"
+      "\tpush\trdi\n"
+      "\tpush\tr9\n"
+      "\tmov\trsi, QWORD PTR [r11]\n"
+      "\tmov\trcx, QWORD PTR [r11 + 8]\n"
+      "\trep movsb\n"
+      "\tmov\trsi, QWORD PTR [r10]\n"
+      "\tmov\trcx, QWORD PTR [r10 + 8]\n"
+      "\trep movsb\n"
+      "\tpop\trsi\n"
+      "\tpop\trdi\n"
+      "\tjmp\t__cubs_new_string\n"
+      ".Lconcat_left:\n"
+      "\tmov\trax, rdi\n"
+      "\tret\n"
+      ".Lconcat_right:\n"
+      "\tmov\trax, rsi\n"
+      "\tret\n"
+      "\n"
+      // streq
+      "__cubs_streq:\t\t\t# Check if strings in rdi and rsi are equal\n"
+      "\txor\teax, eax\n"
+      "\tmov\trcx, QWORD PTR [rdi + 8]\n"
+      "\tcmp\trcx, QWORD PTR [rsi + 8]\t# Lengths first\n"
+      "\tjne\t.Lstreq_end\n"
+      "\tmov\trdi, QWORD PTR [rdi]\n"
+      "\tmov\trsi, QWORD PTR [rsi]\n"
+      "\trepe cmpsb\n"
+      "\tjne\t.Lstreq_end\n"
+      "\tinc\teax\n"
+      ".Lstreq_end:\n"
+      "\tret\n"
+      "\n"
+      // word_is
+      "__cubs_word_is:\t\t\t# Check if the word read is the one in rsi\n"
+      "\tlea\trdi, __cubs_read_buffer[rip]\n"
+      "\txor\teax, eax\n"
+      ".Lword_is_loop:\n"
+      "\tmov\tcl, BYTE PTR [rdi]\n"
+      "\tcmp\tcl, BYTE PTR [rsi]\n"
+      "\tjne\t.Lword_is_end\n"
+      "\tinc\trdi\n"
+      "\tinc\trsi\n"
+      "\ttest\tcl, cl\n"
+      "\tjnz\t.Lword_is_loop\n"
+      "\tinc\teax\n"
+      ".Lword_is_end:\n"
+      "\tret\n"
+      "\n"
+      // read_char
+      "__cubs_read_char:\t\t# Read a char from stdin, -1 at the end\n"
+      "\tsub\trsp, 8\n"
+      "\txor\tedi, edi\n"
+      "\tmov\trsi, rsp\n"
+      "\tmov\tedx, 1\n"
+      "\txor\teax, eax\n"
+      "\tsyscall\n"
+      "\tcmp\trax, 1\n"
+      "\tjne\t.Lread_char_end\n"
+      "\tmovzx\teax, BYTE PTR [rsp]\n"
+      "\tadd\trsp, 8\n"
+      "\tret\n"
+      ".Lread_char_end:\n"
+      "\tmov\teax, -1\n"
+      "\tadd\trsp, 8\n"
+      "\tret\n"
+      "\n"
+      // read_string
+      "__cubs_read_word:\t\t# Read a word from stdin, return its length\n"
+      "\tcall\t__cubs_flush\t\t# Show what was printed before\n"
+      "\tpush\trbx\n"
+      "\txor\tebx, ebx\n"
+      ".Lread_word_skip:\n"
+      "\tcall\t__cubs_read_char\n"
+      "\tcmp\teax, ' '\n"
+      "\tje\t.Lread_word_skip\n"
+      "\tlea\tecx, [rax - 9]\t\t# From \\t to \\r\n"
+      "\tcmp\tecx, 4\n"
+      "\tjbe\t.Lread_word_skip\n"
+      ".Lread_word_char:\n"
+      "\tcmp\teax, -1\n"
+      "\tje\t.Lread_word_end\n"
+      "\tcmp\teax, ' '\n"
+      "\tje\t.Lread_word_end\n"
+      "\tlea\tecx, [rax - 9]\n"
+      "\tcmp\tecx, 4\n"
+      "\tjbe\t.Lread_word_end\n"
+      "\tcmp\tebx, 4095\t\t# Longer words are truncated\n"
+      "\tjae\t.Lread_word_next\n"
+      "\tlea\trcx, __cubs_read_buffer[rip]\n"
+      "\tmov\tBYTE PTR [rcx + rbx], al\n"
+      "\tinc\tebx\n"
+      ".Lread_word_next:\n"
+      "\tcall\t__cubs_read_char\n"
+      "\tjmp\t.Lread_word_char\n"
+      ".Lread_word_end:\n"
+      "\tlea\trcx, __cubs_read_buffer[rip]\n"
+      "\tmov\tBYTE PTR [rcx + rbx], 0\n"
+      "\tmov\trax, rbx\n"
+      "\tpop\trbx\n"
+      "\tret\n"
+      "\n"
+      // read_string
+      "__cubs_read_string:\t\t# Read a word from stdin, into a new string\n"
+      "\tcall\t__cubs_read_word\n"
+      "\tpush\trax\n"
+      "\tlea\trdi, [rax + 16]\n"
+      "\txor\tesi, esi\n"
+      "\tcall\t__cubs_alloc\n"
+      "\tpop\trcx\n"
+      "\tmov\tQWORD PTR [rax], rcx\t# Capacity\n"
+      "\tmov\tQWORD PTR [rax + 8], rcx\t# Used\n"
+      "\tlea\trdi, [rax + 16]\n"
+      "\tpush\trdi\n"
+      "\tpush\trcx\n"
+      "\tlea\trsi, __cubs_read_buffer[rip]\n"
+      "\trep movsb\n"
+      "\tpop\trsi\n"
+      "\tpop\trdi\n"
+      "\tjmp\t__cubs_new_string\n"
+      "\n"
+      // read_int
+      "__cubs_read_int:\t\t# Read an integer from stdin\n"
+      "\tcall\t__cubs_read_word\n"
+      "\tlea\trdi, __cubs_read_buffer[rip]\n"
+      "\txor\teax, eax\n"
+      "\txor\tr8d, r8d\n"
+      "\tcmp\tBYTE PTR [rdi], '-'\n"
+      "\tjne\t.Lread_int_loop\n"
+      "\tinc\tr8d\n"
+      "\tinc\trdi\n"
+      ".Lread_int_loop:\n"
+      "\tmovzx\tecx, BYTE PTR [rdi]\n"
+      "\tsub\tecx, '0'\n"
+      "\tcmp\tecx, 9\n"
+      "\tja\t.Lread_int_end\n"
+      "\timul\teax, eax, 10\n"
+      "\tadd\teax, ecx\n"
+      "\tinc\trdi\n"
+      "\tjmp\t.Lread_int_loop\n"
+      ".Lread_int_end:\n"
+      "\ttest\tr8d, r8d\n"
+      "\tjz\t.Lread_int_quit\n"
+      "\tneg\teax\n"
+      ".Lread_int_quit:\n"
+      "\tret\n"
+      "\n"
+      // read_bool
+      "__cubs_read_bool:\t\t# Read a boolean from stdin, edi is kept if invalid\n"
+      "\tpush\trdi\n"
+      "\tcall\t__cubs_read_word\n"
+      "\tlea\trsi, __cubs_word_true[rip]\n"
+      "\tcall\t__cubs_word_is\n"
+      "\ttest\teax, eax\n"
+      "\tjnz\t.Lread_bool_true\n"
+      "\tlea\trsi, __cubs_word_one[rip]\n"
+      "\tcall\t__cubs_word_is\n"
+      "\ttest\teax, eax\n"
+      "\tjnz\t.Lread_bool_true\n"
+      "\tlea\trsi, __cubs_word_false[rip]\n"
+      "\tcall\t__cubs_word_is\n"
+      "\ttest\teax, eax\n"
+      "\tjnz\t.Lread_bool_false\n"
+      "\tlea\trsi, __cubs_word_zero[rip]\n"
+      "\tcall\t__cubs_word_is\n"
+      "\ttest\teax, eax\n"
+      "\tjnz\t.Lread_bool_false\n"
+      "\tpop\trax\n"
+      "\tret\n"
+      ".Lread_bool_true:\n"
+      "\tpop\trax\n"
+      "\tmov\teax, 1\n"
+      "\tret\n"
+      ".Lread_bool_false:\n"
+      "\tpop\trax\n"
+      "\txor\teax, eax\n"
+      "\tret\n"
+      "\n"
+      // Runtime data
+      "\t.data\n"
+      "\t.align\t8\n"
+      "__cubs_heap:\t.quad\t0\n"
+      "__cubs_heap_end:\t.quad\t0\n"
+      "__cubs_chunks:\t.quad\t0\n"
+      "__cubs_run_map:\t.quad\t0\n"
+      "__cubs_free:\t.quad\t0\n"
+      "__cubs_allocated:\t.quad\t0\n"
+      "__cubs_live:\t.quad\t0\n"
+      "__cubs_collect_at:\t.quad\t" << HEAP_CHUNK_SIZE << "\n"
+      "__cubs_stack_top:\t.quad\t0\n"
+      "__cubs_host_stack:\t.quad\t0\n"
+      "__cubs_out_size:\t.quad\t0\n"
+      "__cubs_failed:\t.byte\t0\n"
+      "\t.bss\n"
+      "__cubs_read_buffer:\t.zero\t4096\n"
+      "__cubs_out_buffer:\t.zero\t" << OUTPUT_BUFFER_SIZE << "\n"
+      "\t.section\t.rodata\n"
+      "__cubs_word_true:\t.asciz\t\"true\"\n"
+      "__cubs_word_false:\t.asciz\t\"false\"\n"
+      "__cubs_word_one:\t.asciz\t\"1\"\n"
+      "__cubs_word_zero:\t.asciz\t\"0\"\n"
+      "__cubs_division_by_zero_message:\n"
+      "\t.asciz\t\"A division by zero has occured...\\n\"\n"
+      "__cubs_depth_exceeded_message:\n"
+      "\t.asciz\t\"Maximum call depth of " << _maxDepth << " exceeded...\\n\"\n"
+      "__cubs_out_of_memory_message:\n"
+      "\t.asciz\t\"Out of memory...\\n\"\n";
+    writeString("__cubs_true", "true");
+    writeString("__cubs_false", "false");
+    _indent <<      "\n# === END RUNTIME ===\n";
+  }
+
+  /*!
+  ** Just write the postlude, ie global variables and read-only strings.
+  */
+  inline void
+  ASM64GeneratorVisitor::writePostlude()
+  {
+    _indent << "\n\t.data\n"
+      "\t.align\t8\n";
+    _indent << "__cubs_globals:\n";
+    for (Ids::const_iterator it = _globals.begin(); it != _globals.end(); ++it)
+      _indent << "v_" << (*it)->getId() << ":\t.quad\t"
+	      << ((*it)->getComputedType() == AST::Type::STRING ?
+		  "__cubs_empty" : "0")
+	      << "\n";
+    _indent << "__cubs_globals_end:\n";
+
+    _indent << "\n\t.section\t.rodata\n";
+    writeString("__cubs_empty", "");
+    for (ROStrings::const_iterator it = _strings.begin();
+	 it != _strings.end(); ++it)
+      writeString(it->second, it->first);
+  }
+
+  /*!
+  ** Write a read-only string. A string is its data and its length.
+  ** Data is preceded by the capacity and the used size of its buffer:
+  ** a capacity of 0 forbids appending in place.
+  **
+  ** @param label The label of the string
+  ** @param s The string, already escaped
+  */
+  inline void
+  ASM64GeneratorVisitor::writeString(const std::string& label,
+				     const std::string& s)
+  {
+    _indent << "\t.align\t8\n"
+	    << label << ":\n"
+      "\t.quad\t" << label << "_data, " << label << "_end - " << label
+	    << "_data\n"
+      "\t.quad\t0, " << label << "_end - " << label << "_data\n"
+	    << label << "_data:\t.ascii\t\"" << s << "\"\n"
+	    << label << "_end:\n";
+  }
+}
@@ -1,5 +1,10 @@
 #include <cassert>
+#include <algorithm>
+#include <vector>
 #include "ASMGeneratorVisitor.hh"
+#include "ExecutionVisitor.hh"
+#include "StrengthReduction.hh"
+#include "ThreadPool.hh"
 #include "Utils.hh"
 #include "NodeIds.hh"
 #include "NodeProgram.hh"
@@ -80,20 +85,290 @@ namespace MiniCompiler
 
       return ss.str();
     }
+
+    /*!
+    ** Get the conditional jump taken when a comparison is false.
+    **
+    ** @param op The comparison operator
+    **
+    ** @return The jump instruction, or 0 if op isn't a comparison
+    */
+    const char*
+    jumpIfFalse(AST::Operator::type op)
+    {
+      switch (op)
+      {
+	case AST::Operator::EQUAL:
+	  return "jne";
+	case AST::Operator::DIFF:
+	  return "je";
+	case AST::Operator::SUP:
+	  return "jle";
+	case AST::Operator::SUPEQUAL:
+	  return "jl";
+	case AST::Operator::INF:
+	  return "jge";
+	case AST::Operator::INFEQUAL:
+	  return "jg";
+	default:
+	  return 0;
+      }
+    }
+
+    /*!
+    ** Check if a factor can be used as an operand directly, without
+    ** computing anything.
+    **
+    ** @param factor The factor
+    **
+    ** @return If the factor is a variable or a literal
+    */
+    bool
+    isSimple(const AST::NodeFactor* factor)
+    {
+      assert(factor);
+      return factor->getId() || factor->getNumber() || factor->getBool() ||
+	factor->getStringExpr();
+    }
+
+    /*!
+    ** Check if an operand is an immediate value.
+    **
+    ** @param s The operand
+    **
+    ** @return If it is a number
+    */
+    bool
+    isImmediate(const std::string& s)
+    {
+      return !s.empty() && (isdigit(s[0]) || s[0] == '-');
+    }
+
+    /*!
+    ** Give its size to an operand in memory, which nasm can't guess
+    ** when the other operand isn't a register.
+    **
+    ** @param s The operand
+    **
+    ** @return The operand, with its size if it is in memory
+    */
+    std::string
+    sized(const std::string& s)
+    {
+      return !s.empty() && s[0] == '[' ? "dword " + s : s;
+    }
+
+    /*!
+    ** Get all ids declared by the given declarations, in order.
+    **
+    ** @param decls The declarations node
+    ** @param ids The list to fill
+    */
+    void
+    collectIds(const AST::NodeDeclarations* decls,
+	       std::vector<const AST::NodeId*>& ids)
+    {
+      for (; decls; decls = decls->getDeclarations())
+      {
+	const AST::NodeDeclaration* decl = decls->getDeclaration();
+	assert(decl);
+	const AST::NodeDeclarationBody* body = decl->getBody();
+	assert(body);
+	for (const AST::NodeIds* list = body->getIds(); list;
+	     list = list->getIds())
+	{
+	  assert(list->getId());
+	  ids.push_back(list->getId());
+	}
+      }
+    }
+
+    /*!
+    ** Weight every use of a variable, uses inside loops being heavier,
+    ** and count how many temporaries are needed at the same time.
+    */
+    class UsageCounter : public ConstBaseVisitor<UsageCounter>
+    {
+    public:
+      typedef std::map<const AST::NodeId*, unsigned int> Weights;
+
+    private:
+      static const unsigned int LOOP_WEIGHT = 8;
+      static const unsigned int MAX_WEIGHT = 1 << 20;
+
+    public:
+      UsageCounter()
+	: _weight(1), _nbTemporaries(0), _maxTemporaries(0), _calls(false)
+      {
+      }
+
+      using ConstBaseVisitor<UsageCounter>::visit;
+
+      void visit(const AST::NodeId* node)
+      {
+	assert(node);
+	_weights[node->getRef()] += _weight;
+      }
+
+      void visit(const AST::NodeWhile* node)
+      {
+	assert(node);
+	const unsigned int weight = _weight;
+	if (_weight < MAX_WEIGHT)
+	  _weight *= LOOP_WEIGHT;
+	ConstBaseVisitor<UsageCounter>::visit(node);
+	_weight = weight;
+      }
+
+      void visit(const AST::NodeOperation* node)
+      {
+	assert(node);
+	const AST::NodeFactor* left = node->getLeftFactor();
+	const AST::NodeFactor* right = node->getRightFactor();
+	assert(left);
+
+	visit(left);
+	if (!right)
+	  return;
+	const bool temporary = !isSimple(left) && !isSimple(right);
+	if (temporary && ++_nbTemporaries > _maxTemporaries)
+	  _maxTemporaries = _nbTemporaries;
+	visit(right);
+	if (temporary)
+	  --_nbTemporaries;
+      }
+
+      void visit(const AST::NodeCallFunc* node)
+      {
+	assert(node);
+	_calls = true;
+	ConstBaseVisitor<UsageCounter>::visit(node);
+      }
+
+      unsigned int weight(const AST::NodeId* id) const
+      {
+	Weights::const_iterator it = _weights.find(id);
+	return it == _weights.end() ? 0 : it->second;
+      }
+
+      unsigned int maxTemporaries() const
+      {
+	return _maxTemporaries;
+      }
+
+      bool calls() const
+      {
+	return _calls;
+      }
+
+    private:
+      Weights		_weights;
+      unsigned int	_weight;
+      unsigned int	_nbTemporaries;
+      unsigned int	_maxTemporaries;
+      bool		_calls;
+    };
+
+    /*!
+    ** Order variables from the most used to the least used.
+    */
+    class HeavierFirst
+    {
+    public:
+      HeavierFirst(const UsageCounter& counter)
+	: _counter(counter)
+      {
+      }
+
+      bool operator()(const AST::NodeId* a, const AST::NodeId* b) const
+      {
+	return _counter.weight(a) > _counter.weight(b);
+      }
+
+    private:
+      const UsageCounter&	_counter;
+    };
+
+    /*!
+    ** Count the labels of the ifs and of the whiles of a function, so
+    ** that the function can be generated apart with its own labels.
+    */
+    class LabelCounter : public ConstBaseVisitor<LabelCounter>
+    {
+    public:
+      LabelCounter()
+	: ifs(0), whiles(0)
+      {
+      }
+
+      using ConstBaseVisitor<LabelCounter>::visit;
+
+      void visit(const AST::NodeIf* node)
+      {
+	++ifs;
+	ConstBaseVisitor<LabelCounter>::visit(node);
+      }
+
+      void visit(const AST::NodeWhile* node)
+      {
+	++whiles;
+	ConstBaseVisitor<LabelCounter>::visit(node);
+      }
+
+    public:
+      unsigned int	ifs;
+      unsigned int	whiles;
+    };
+
+    /*!
+    ** Functions generated on a thread pool, each by its own visitor.
+    */
+    struct Functions
+    {
+      std::vector<const AST::NodeFunction*>	nodes;
+      std::vector<ASMGeneratorVisitor*>		visitors;
+      std::vector<LabelCounter>			counters;
+    };
   }
 
+  const char* const
+  ASMGeneratorVisitor::CALLEE_SAVED_REGISTERS[NB_CALLEE_SAVED_REGISTERS] =
+    { "ebx", "esi", "edi" };
+
   /*!
   ** Construct the asm convertor visitor,
   ** initializing tabulation.
   ** Also add prelude.
   */
   ASMGeneratorVisitor::ASMGeneratorVisitor()
-    : _printPrelude(false), _stackShifting(0)
+    : _printPrelude(false), _stackShifting(0),
+      _localOffset(0), _localAllocated(0),
+      _ifLabels(0), _whileLabels(0), _stringLabels(0),
+      _global(0), _jobs(1), _maxDepth(ExecutionVisitor::DEFAULT_MAX_DEPTH),
+      _frame(true), _leaf(false)
   {
     _tab = 0;
     _scope.open();
   }
 
+  /*!
+  ** Construct a visitor generating a function apart, on a thread of
+  ** the pool. Global variables are looked up in the visitor of the
+  ** program, and strings are only labeled when the function is merged.
+  **
+  ** @param global The visitor of the program
+  */
+  ASMGeneratorVisitor::ASMGeneratorVisitor(const ASMGeneratorVisitor* global)
+    : _printPrelude(global->_printPrelude), _stackShifting(0),
+      _localOffset(0), _localAllocated(0),
+      _ifLabels(0), _whileLabels(0), _stringLabels(0),
+      _global(global), _jobs(1), _maxDepth(global->_maxDepth),
+      _frame(true), _leaf(false)
+  {
+    _tab = global->_tab;
+    _scope.open();
+  }
+
   /*!
   ** Destruct the visitor.
   */
@@ -102,6 +377,216 @@ namespace MiniCompiler
     _scope.close();
   }
 
+  /*!
+  ** Choose which variables of a function live in registers. Only ebx,
+  ** esi and edi are kept by called functions, the runtime included, and
+  ** the others are used to compute expressions. Every variable lives
+  ** during the whole function, so the heaviest ones get a register, and
+  ** the others stay in the frame. Remaining registers are kept for
+  ** temporaries. Registers used by the function are saved on entry.
+  ** When all variables fit in registers, they all get one whatever their
+  ** weight, so that the function needs no frame.
+  **
+  ** @param node The function node
+  */
+  void
+  ASMGeneratorVisitor::allocateRegisters(const AST::NodeFunction* node)
+  {
+    // A register costs a save and a restore, so it must be used more
+    static const unsigned int MIN_WEIGHT = 2;
+    std::vector<const AST::NodeId*> variables;
+    UsageCounter counter;
+    unsigned int nb = 0;
+
+    assert(node);
+    assert(node->getCompoundInstr());
+    counter.visit(node->getCompoundInstr());
+    for (unsigned int i = 0; i < node->nbArgument(); ++i)
+      variables.push_back(node->getArgument(i));
+    collectIds(node->getDeclarations(), variables);
+    std::stable_sort(variables.begin(), variables.end(),
+		     HeavierFirst(counter));
+
+    // When all variables fit, the function doesn't need any frame
+    const bool fit = variables.size() + counter.maxTemporaries() <=
+      NB_CALLEE_SAVED_REGISTERS;
+
+    _registers.clear();
+    _saved.clear();
+    _freeTemporaries.clear();
+    for (std::vector<const AST::NodeId*>::const_iterator it = variables.begin();
+	 it != variables.end() && nb < NB_CALLEE_SAVED_REGISTERS &&
+	   (fit || counter.weight(*it) >= MIN_WEIGHT); ++it)
+    {
+      _registers[*it] = CALLEE_SAVED_REGISTERS[nb];
+      _saved.push_back(CALLEE_SAVED_REGISTERS[nb++]);
+    }
+    for (unsigned int i = 0; i < counter.maxTemporaries() &&
+	   nb < NB_CALLEE_SAVED_REGISTERS; ++i, ++nb)
+    {
+      _saved.push_back(CALLEE_SAVED_REGISTERS[nb]);
+      _freeTemporaries.push_back(CALLEE_SAVED_REGISTERS[nb]);
+    }
+    _frame = _registers.size() < variables.size();
+    _leaf = !counter.calls();
+  }
+
+  /*!
+  ** Get a free register to keep a temporary value.
+  **
+  ** @return The register, or 0 if the value must be spilled on the stack
+  */
+  const char*
+  ASMGeneratorVisitor::allocateTemporary()
+  {
+    if (_freeTemporaries.empty())
+      return 0;
+
+    const char* reg = _freeTemporaries.back();
+    _freeTemporaries.pop_back();
+    return reg;
+  }
+
+  /*!
+  ** Give back a register used by a temporary value.
+  **
+  ** @param reg The register, 0 if the value was spilled
+  */
+  void
+  ASMGeneratorVisitor::releaseTemporary(const char* reg)
+  {
+    if (reg)
+      _freeTemporaries.push_back(reg);
+  }
+
+  /*!
+  ** Get where a variable is, in a register, in the frame or in the
+  ** data section.
+  **
+  ** @param id The variable
+  **
+  ** @return The location of the variable
+  */
+  const std::string&
+  ASMGeneratorVisitor::location(const AST::NodeId* id) const
+  {
+    assert(id);
+    std::pair<std::string, AST::Type::type>* var =
+      _scope.getFromAll(id->getId());
+
+    if (!var && _global)
+      var = _global->_scope.getFromAll(id->getId());
+    assert(var);
+    return var->first;
+  }
+
+  /*!
+  ** Check if a factor gives the same value whenever it is computed, so
+  ** it can be computed after its right operand. Global variables may be
+  ** changed by a called function.
+  **
+  ** @param factor The factor
+  **
+  ** @return If the factor can be computed later
+  */
+  bool
+  ASMGeneratorVisitor::isStable(const AST::NodeFactor* factor)
+  {
+    assert(factor);
+    if (factor->getNumber() || factor->getBool() || factor->getStringExpr())
+      return true;
+    if (!factor->getId())
+      return false;
+
+    return !declaringGlobalVar() && _scope.getFromCurrent(factor->getId()->getId());
+  }
+
+  /*!
+  ** Get a simple factor as an operand, loading it into ecx if it can't
+  ** be used directly.
+  **
+  ** @param factor The simple factor
+  **
+  ** @return Where is the value of the factor
+  */
+  std::string
+  ASMGeneratorVisitor::operand(const AST::NodeFactor* factor)
+  {
+    assert(factor);
+    assert(isSimple(factor));
+
+    if (factor->getId())
+      return location(factor->getId());
+    if (factor->getBool())
+      return factor->getBool()->getBool() ? "1" : "0";
+    if (factor->getNumber())
+    {
+      std::stringstream ss;
+      ss << factor->getNumber()->getNumber();
+      return ss.str();
+    }
+
+    _indent << "\tmov\tecx, ";
+    visit(factor->getStringExpr());
+    _indent << "\n";
+    return "ecx";
+  }
+
+  /*!
+  ** Get where an argument was given to the current function.
+  **
+  ** @param i The number of the argument
+  ** @param pushed How many bytes were pushed since the entry of a
+  ** function without frame, saved registers excluded
+  **
+  ** @return The location of the argument on the stack
+  */
+  std::string
+  ASMGeneratorVisitor::argument(unsigned int i, unsigned int pushed) const
+  {
+    std::stringstream ss;
+
+    if (_frame)
+      ss << "[ebp + " << FIRST_ARGUMENT_OFFSET + i * LOCAL_VAR_SIZE << "]";
+    else
+      ss << "[esp + "
+	 << pushed + (_saved.size() + 1 + i) * LOCAL_VAR_SIZE << "]";
+    return ss.str();
+  }
+
+  /*!
+  ** End the call of the current function: give back its call depth,
+  ** restore the registers it saved, and remove its frame, if any.
+  */
+  void
+  ASMGeneratorVisitor::writeLeave()
+  {
+    if (!_leaf)
+      _indent << "\tinc\tdword [_calls_left]\n";
+    if (!_frame)
+    {
+      for (unsigned int i = _saved.size(); i > 0; --i)
+	_indent << "\tpop\t" << _saved[i - 1] << "\n";
+      return;
+    }
+
+    for (unsigned int i = 0; i < _saved.size(); ++i)
+      _indent << "\tmov\t" << _saved[i] << ", [ebp - "
+	      << (i + 1) * LOCAL_VAR_SIZE << "]\n";
+    _indent << "\tmov\tesp, ebp\n"
+      "\tpop\tebp\t\t; End\n";
+  }
+
+  /*!
+  ** Leave the current function, its result being in eax.
+  */
+  void
+  ASMGeneratorVisitor::writeEpilogue()
+  {
+    writeLeave();
+    _indent << "\tret\t\t\t; Return\n";
+  }
+
   /*!
   ** Convert the ids node
   **
@@ -126,11 +611,11 @@ namespace MiniCompiler
       switch (it->second->second)
       {
 	case AST::Type::STRING:
-	  _indent << "\tmov\tdword " << it->second->first << ", _empty\t; Automatic initialization\n";
+	  _indent << "\tmov\t" << sized(it->second->first) << ", _empty\t; Automatic initialization\n";
 	  break;
 	case AST::Type::BOOLEAN:
 	case AST::Type::INTEGER:
-	  _indent << "\tmov\tdword " << it->second->first << ", 0\t; Automatic initialization\n";
+	  _indent << "\tmov\t" << sized(it->second->first) << ", 0\t; Automatic initialization\n";
 	  break;
 	case AST::Type::UNDEFINED:
 	  // Special value : Just ignore it. Use to preserve arguments.
@@ -152,24 +637,28 @@ namespace MiniCompiler
     writeHeader();
     const AST::NodeDeclarations* decls = node->getDecls();
     if (decls)
-      decls->accept(*this);
+      visit(decls);
 
     _indent << "\nsection .text\n"
       "\tglobal\t_start\n"
-      "\textern  _scanf, _printf, _getchar, _putchar, _malloc, _free\n";
+      "\textern  _scanf, _printf, _getchar, _putchar, _malloc, _free, _exit\n";
     writePrelude();
     const AST::NodeFunctions* funcs = node->getFuncs();
     if (funcs)
-      funcs->accept(*this);
+      visit(funcs);
     _indent << '\n';
     const AST::NodeCompoundInstr* instrs = node->getInstrs();
+    // The entry point never returns, so all registers are free
+    _registers.clear();
+    _saved.clear();
+    _freeTemporaries.assign(CALLEE_SAVED_REGISTERS,
+			    CALLEE_SAVED_REGISTERS + NB_CALLEE_SAVED_REGISTERS);
     _indent << Utils::stringFill(SPACING_CHAR, _tab) << "_start:\n";
     initVariables();
     if (instrs)
-      instrs->accept(*this);
-    _indent << "\tmov\teax, 1\t\t; The system call for exit (sys_exit)\n"
-      "\tmov\tebx, 0\t\t; Exit with return code of 0 (no error)\n"
-      "\tint\t80h\n";
+      visit(instrs);
+    _indent << "\tpush\tdword 0\t\t; Exit with return code of 0 (no error)\n"
+      "\tcall\t_exit\t\t; Flush the standard output too\n";
     writePostlude();
   }
 
@@ -187,10 +676,10 @@ namespace MiniCompiler
     assert(id);
     assert(expr);
 
-    expr->accept(*this);
+    visit(expr);
 
     _indent << "\tmov\t";
-    id->accept(*this);
+    visit(id);
     _indent << ", edx\t; Just affect an expression\n";
   }
 
@@ -208,20 +697,18 @@ namespace MiniCompiler
     const AST::NodeCompoundInstr* elseExprs = node->getElseExprs();
     assert(cond);
     assert(body);
-    static unsigned int globaliIfLabelCount = 0;
-    globaliIfLabelCount++;
-    unsigned int ifLabelCount = globaliIfLabelCount;
-
-    cond->accept(*this);
-    _indent << "\ttest\teax, eax\n"
-      "\tjz\tif_jump_" << ifLabelCount << "\t; If expr then\n";
-    body->accept(*this);
+    unsigned int ifLabelCount = ++_ifLabels;
+
+    std::stringstream label;
+    label << "if_jump_" << ifLabelCount;
+    writeJumpIfFalse(cond, label.str());
+    visit(body);
     if (elseExprs)
       _indent << "\tjmp\tend_if_jump_" << ifLabelCount << "\t; Else\n";
     _indent << "if_jump_" << ifLabelCount << ":\n";
     if (elseExprs)
     {
-      elseExprs->accept(*this);
+      visit(elseExprs);
       _indent << "end_if_jump_" << ifLabelCount << ":\n";
     }
   }
@@ -254,7 +741,7 @@ namespace MiniCompiler
     }
     _indent << " value into the eax register\n"
       "\tmov\t";
-    id->accept(*this);
+    visit(id);
     _indent << ", eax\t; Copy back to our variable\n";
   }
 
@@ -280,9 +767,13 @@ namespace MiniCompiler
     {
       id = ids->getId();
       assert(id);
-      type->accept(*this);
+      visit(type);
       std::stringstream ss;
-      ss << "[ebp + " << _stackShifting << "]";
+      Allocation::const_iterator reg = _registers.find(id);
+      if (reg != _registers.end())
+	ss << reg->second;
+      else
+	ss << "[ebp + " << _stackShifting << "]";
       _scope.put(id->getId(), Utils::makePair(ss.str(), AST::Type::UNDEFINED));
       _stackShifting += LOCAL_VAR_SIZE;
       ids = ids->getIds();
@@ -302,15 +793,14 @@ namespace MiniCompiler
     assert(arg);
     const AST::NodeArguments* args = node->getArguments();
 
-    // Start to 8 because of "frame pointer + base pointer" = esp + ebp = 4 + 4 = 8
-    _stackShifting = 8;
+    _stackShifting = FIRST_ARGUMENT_OFFSET;
 
-    arg->accept(*this);
+    visit(arg);
     while (args)
     {
       arg = args->getArgument();
       assert(arg);
-      arg->accept(*this);
+      visit(arg);
       args = args->getArguments();
     }
 
@@ -329,11 +819,37 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
 
-    expr->accept(*this);
-    _indent << "\tmov\teax, edx\t; eax is used to put returned value\n"
-      "\tmov\tesp, ebp\n"
-      "\tpop\tebp\n"
-      "\tret\t\t\t; Return\n";
+    // A tail call reuses the frame of the current function, as long as the
+    // called function doesn't need more argument slots than we have. New
+    // arguments are all evaluated before overwriting the old ones, then we
+    // jump to the called function which returns directly to our caller.
+    const AST::NodeCallFunc* call = node->getTailCall();
+    const AST::NodeFunction* func = node->getRefFunc();
+    if (call && func && call->nbArgument() <= func->nbArgument())
+    {
+      const unsigned int size = call->nbArgument() * LOCAL_VAR_SIZE;
+      const AST::NodeExpressions* exprs = call->getExprs();
+      if (exprs)
+      {
+	_indent << "\tsub\tesp, " << size << "\t\t; Place for arguments\n";
+	visit(exprs);
+      }
+      for (unsigned int i = 0; i < call->nbArgument(); ++i)
+	_indent << "\tmov\tecx, [esp + " << i * LOCAL_VAR_SIZE << "]\n"
+	  "\tmov\t" << argument(i, size) << ", ecx\t; Overwrite argument "
+		<< i << "\n";
+      if (exprs)
+	_indent << "\tadd\tesp, " << size << "\n";
+      writeLeave();
+      _indent << "\tjmp\t";
+      visit(call->getId());
+      _indent << "\t; Tail call, reusing the current frame\n";
+      return;
+    }
+
+    visit(expr);
+    _indent << "\tmov\teax, edx\t; eax is used to put returned value\n";
+    writeEpilogue();
   }
 
   /*!
@@ -348,10 +864,9 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
 
-    expr->accept(*this);
-    _indent << "\tmov\teax, 1\t\t; The system call for exit (sys_exit)\n"
-      "\tmov\tebx, edx\t; Exit with given return code\n"
-      "\tint\t80h\n";
+    visit(expr);
+    _indent << "\tpush\tedx\t\t; Exit with given return code\n"
+      "\tcall\t_exit\t\t; Flush the standard output too\n";
   }
 
   /*!
@@ -367,129 +882,237 @@ namespace MiniCompiler
     const AST::NodeExpressions* exprs = node->getExprs();
     assert(id);
 
-    _indent << "\tpush\tebp\t\t; Create a scope to save arguments\n"
-      "\tmov\tebp, esp\n";
-
     if (exprs)
-      exprs->accept(*this);
+    {
+      _indent << "\tsub\tesp, " << node->nbArgument() * LOCAL_VAR_SIZE
+	      << "\t\t; Place for arguments\n";
+      visit(exprs);
+    }
 
     _indent << "\tcall\t";
-    id->accept(*this);
-    _indent << "\t; Just call the function using __cdecl convention\n"
-      "\tmov\tedx, eax\t; Copy result of the function into edx\n"
-      "\tmov\tesp, ebp\n"
-      "\tpop\tebp\t\t; Close the arguments scope\n";
+    visit(id);
+    _indent << "\t; Just call the function using __cdecl convention\n";
+    if (exprs)
+      _indent << "\tadd\tesp, " << node->nbArgument() * LOCAL_VAR_SIZE
+	      << "\t\t; Remove arguments\n";
+    _indent << "\tmov\tedx, eax\t; Copy result of the function into edx\n";
   }
 
   /*!
-  ** Convert the operation node
+  ** Apply an operator on the value in edx and the right operand,
+  ** putting the result in edx.
+  ** Arithmetic by a constant uses cheaper instructions when possible.
   **
-  ** @param node The operation node
+  ** @param op The operator
+  ** @param isString If operands are strings
+  ** @param right The right operand
   */
   void
-  ASMGeneratorVisitor::visit(const AST::NodeOperation* node)
+  ASMGeneratorVisitor::writeOperation(AST::Operator::type op,
+				      bool isString,
+				      const std::string& right)
   {
-    assert(node);
-    const AST::NodeFactor* leftFactor = node->getLeftFactor();
-    assert(leftFactor);
-
-    leftFactor->accept(*this);
-
-    if (node->getOpType() != AST::Operator::NONE)
+    if (isString)
     {
-      _indent << "\n\tpush\tedx\t\t; Save edx into the stack to help computing expression\n";
-      const AST::NodeFactor* rightFactor = node->getRightFactor();
-      assert(rightFactor);
-      rightFactor->accept(*this);
-      _indent << "\tmov\tecx, edx\t; Move current edx into ecx\n"
-	"\tpop\tedx\t\t; Restore edx from the stack to help computing expression\n\t";
-
-      switch (node->getOpType())
+      _indent << "\tpush\t" << sized(right) << "\t; Second string\n"
+	"\tpush\tedx\t\t; First string\n"
+	"\tcall\t";
+      switch (op)
       {
 	case AST::Operator::PLUS:
-	  switch (node->getComputedType())
-	  {
-	    case AST::Type::STRING:
-	      _indent << "mov\tesi, ecx\n"
-		"\tmov\tedi, edx\n"
-		"\tcall\t__concat\t; Concat edx and ecx\n"
-		"\tmov\tedx, eax\t; Copy resulting strings in eax\n";
-	      break;
-	    case AST::Type::INTEGER:
-	      _indent << "add\tedx, ecx\t; Compute chunk's add expression in edx\n";
-	      break;
-	    default:
-	      assert(false);
-	  }
-	  break;
-	case AST::Operator::MINUS:
-	  _indent << "sub\tedx, ecx\t; Compute chunk's sub expression in edx\n";
+	  _indent << "__concat\t; Concat edx and the second string";
 	  break;
-	case AST::Operator::DIV:
-	  _indent << "mov\teax, edx\t; The eax register must contains the left factor\n"
-	    "\txor\tedx, edx\t; Put edx to 0\n"
-	    "\tdiv\tecx\t; The ecx register must contains the right factor\n"
-	    "\tmov\tedx, eax\t; Result of the division is written into eax\n";
-	  break;
-	case AST::Operator::MUL:
-	  _indent << "mov\teax, edx\t; The eax register must contains the left factor\n"
-	    "\txor\tedx, edx\t; Put edx to 0\n"
-	    "\tmul\tecx\t\t; The ecx register must contains the right factor\n"
-	    "\tmov\tedx, eax\t; Result of the multiplication is written into eax\n";
-	  break;
-	case AST::Operator::MODULO:
-	  _indent << "mov\teax, edx\t; The eax register must contains the left factor\n"
-	    "\txor\tedx, edx\t; Put edx to 0\n"
-	    "\tdiv\tecx\t\t; The ecx register must contains the right factor\n"
-	    "\t\t\t\t; Remains of the division is written into eax, nothing to do\n";
-	  break;
-	  // FIXME : Just take care of the stack
 	case AST::Operator::EQUAL:
-	  _indent << "push\tecx\t\t; Eq cmp : second arg\n"
-	    "\tpush\tedx\t\t; Eq cmp : first arg\n"
-	    "\tcall\t"
-		  << (leftFactor->getComputedType() == AST::Type::STRING ?
-		      "__streq" : "__is_eq")
-		  << "\t\t; Check if edx == ecx, and store result in eax\n"
-	    "\tmov\tedx, eax\t; Copy resulting strings in eax\n";
-	  break;
-	case AST::Operator::SUP:
-	  _indent << "push\tecx\t\t; Sup cmp : second arg\n"
-	    "\tpush\tedx\t\t; Sup cmp : first arg\n"
-	    "\tcall\t__is_sup\t\t; Check if edx > ecx, and store result in eax\n"
-	    "\tmov\tedx, eax\t; Copy resulting strings in eax\n";
-	  break;
-	case AST::Operator::SUPEQUAL:
-	  _indent << "push\tecx\t\t; Supeq cmp : second arg\n"
-	    "\tpush\tedx\t\t; Supeq cmp : first arg\n"
-	    "\tcall\t__is_supeq\t\t; Check if edx >= ecx, and store result in eax\n"
-	    "\tmov\tedx, eax\t; Copy resulting strings in eax\n";
-	  break;
-	case AST::Operator::INF:
-	  _indent << "push\tecx\t\t; Inf cmp : second arg\n"
-	    "\tpush\tedx\t\t; Inf cmp : first arg\n"
-	    "\tcall\t__is_inf\t\t; Check if edx < ecx, and store result in eax\n"
-	    "\tmov\tedx, eax\t; Copy resulting strings in eax\n";
-	  break;
-	case AST::Operator::INFEQUAL:
-	  _indent << "push\tecx\t\t; Infeq cmp : second arg\n"
-	    "\tpush\tedx\t\t; Infeq cmp : first arg\n"
-	    "\tcall\t__is_infeq\t\t; Check if edx <= ecx, and store result in eax\n"
-	    "\tmov\tedx, eax\t; Copy resulting strings in eax\n";
+	  _indent << "__streq\t\t; Check if edx == the second string";
 	  break;
 	case AST::Operator::DIFF:
-	  _indent << "push\tecx\t\t; Diff cmp : second arg\n"
-	    "\tpush\tedx\t\t; Diff cmp : first arg\n"
-	    "\tcall\t"
-		  << (leftFactor->getComputedType() == AST::Type::STRING ?
-		      "__strdiff" : "__is_diff")
-		  << "\t\t; Check if edx != ecx, and store result in eax\n"
-	    "\tmov\tedx, eax\t; Copy resulting strings in eax\n";
+	  _indent << "__strdiff\t; Check if edx != the second string";
 	  break;
 	default:
 	  assert(false);
       }
+      _indent << "\n\tadd\tesp, 8\n"
+	"\tmov\tedx, eax\t; Copy the result in edx\n";
+      return;
+    }
+
+    int constant = 0;
+    if (isImmediate(right) && Utils::fromString(constant, right))
+    {
+      std::stringstream code;
+      if (StrengthReduction::write(code, op, constant, "eax"))
+      {
+	_indent << "\tmov\teax, edx\t; Arithmetic by a constant, in eax\n"
+		<< code.str()
+		<< "\tmov\tedx, eax\n";
+	return;
+      }
+    }
+
+    switch (op)
+    {
+      case AST::Operator::PLUS:
+	_indent << "\tadd\tedx, " << right << "\n";
+	break;
+      case AST::Operator::MINUS:
+	_indent << "\tsub\tedx, " << right << "\n";
+	break;
+      case AST::Operator::MUL:
+	_indent << "\timul\tedx, " << (isImmediate(right) ? "edx, " : "")
+		<< right << "\n";
+	break;
+      case AST::Operator::DIV:
+      case AST::Operator::MODULO:
+	if (right != "ecx")
+	  _indent << "\tmov\tecx, " << right << "\n";
+	if (!isImmediate(right) || right == "0")
+	  _indent << "\ttest\tecx, ecx\t; The right factor can't be 0\n"
+	    "\tjz\t__division_by_zero\n";
+	_indent << "\tmov\teax, edx\t; The eax register must contains the left factor\n"
+	  "\tcdq\t\t\t; Extend its sign into edx\n"
+	  "\tidiv\tecx\n";
+	if (op == AST::Operator::DIV)
+	  _indent << "\tmov\tedx, eax\t; Result of the division is written into eax\n";
+	break;
+      case AST::Operator::EQUAL:
+	_indent << "\tcmp\tedx, " << right << "\n"
+	  "\tsete\tdl\n"
+	  "\tmovzx\tedx, dl\n";
+	break;
+      case AST::Operator::DIFF:
+	_indent << "\tcmp\tedx, " << right << "\n"
+	  "\tsetne\tdl\n"
+	  "\tmovzx\tedx, dl\n";
+	break;
+      case AST::Operator::SUP:
+	_indent << "\tcmp\tedx, " << right << "\n"
+	  "\tsetg\tdl\n"
+	  "\tmovzx\tedx, dl\n";
+	break;
+      case AST::Operator::SUPEQUAL:
+	_indent << "\tcmp\tedx, " << right << "\n"
+	  "\tsetge\tdl\n"
+	  "\tmovzx\tedx, dl\n";
+	break;
+      case AST::Operator::INF:
+	_indent << "\tcmp\tedx, " << right << "\n"
+	  "\tsetl\tdl\n"
+	  "\tmovzx\tedx, dl\n";
+	break;
+      case AST::Operator::INFEQUAL:
+	_indent << "\tcmp\tedx, " << right << "\n"
+	  "\tsetle\tdl\n"
+	  "\tmovzx\tedx, dl\n";
+	break;
+      default:
+	assert(false);
+    }
+  }
+
+  /*!
+  ** Compute both factors of a binary operation.
+  ** A variable or a literal right factor is used directly as operand.
+  ** Otherwise, the left factor is kept in a free register while
+  ** computing the right one, and only spilled on the stack when no
+  ** register is left.
+  **
+  ** @param node The operation node
+  **
+  ** @return Where is the right factor, the left one being in edx
+  */
+  std::string
+  ASMGeneratorVisitor::computeOperands(const AST::NodeOperation* node)
+  {
+    assert(node);
+    const AST::NodeFactor* leftFactor = node->getLeftFactor();
+    const AST::NodeFactor* rightFactor = node->getRightFactor();
+    assert(leftFactor);
+    assert(rightFactor);
+
+    if (isSimple(rightFactor))
+    {
+      visit(leftFactor);
+      return operand(rightFactor);
+    }
+
+    if (isStable(leftFactor))
+    {
+      visit(rightFactor);
+      _indent << "\tmov\tecx, edx\t; Move current edx into ecx\n";
+      visit(leftFactor);
+      return "ecx";
+    }
+
+    visit(leftFactor);
+    const char* reg = allocateTemporary();
+    if (reg)
+      _indent << "\tmov\t" << reg << ", edx\t; Keep left factor\n";
+    else
+      _indent << "\tpush\tedx\t\t; Spill left factor\n";
+    visit(rightFactor);
+    _indent << "\tmov\tecx, edx\t; Move current edx into ecx\n";
+    if (reg)
+      _indent << "\tmov\tedx, " << reg << "\n";
+    else
+      _indent << "\tpop\tedx\n";
+    releaseTemporary(reg);
+
+    return "ecx";
+  }
+
+  /*!
+  ** Convert the operation node
+  **
+  ** @param node The operation node
+  */
+  void
+  ASMGeneratorVisitor::visit(const AST::NodeOperation* node)
+  {
+    assert(node);
+    const AST::NodeFactor* leftFactor = node->getLeftFactor();
+    assert(leftFactor);
+
+    if (node->getOpType() == AST::Operator::NONE)
+    {
+      visit(leftFactor);
+      return;
+    }
+
+    const std::string& right = computeOperands(node);
+    writeOperation(node->getOpType(),
+		   leftFactor->getComputedType() == AST::Type::STRING, right);
+  }
+
+  /*!
+  ** Jump to the given label if a condition is false.
+  ** An integer or boolean comparison is directly followed by a
+  ** conditional jump, without computing a boolean.
+  **
+  ** @param cond The condition
+  ** @param label Where to jump
+  */
+  void
+  ASMGeneratorVisitor::writeJumpIfFalse(const AST::NodeExpression* cond,
+					const std::string& label)
+  {
+    assert(cond);
+    const AST::NodeOperation* op = cond->getOperation();
+    assert(op);
+    const AST::NodeFactor* leftFactor = op->getLeftFactor();
+    assert(leftFactor);
+    const char* jump = jumpIfFalse(op->getOpType());
+
+    if (!jump || leftFactor->getComputedType() == AST::Type::STRING)
+    {
+      visit(cond);
+      _indent << "\ttest\tedx, edx\n"
+	"\tjz\t" << label << "\n";
+      return;
     }
+
+    const std::string& right = computeOperands(op);
+    _indent << "\tcmp\tedx, " << right << "\t; Compare and jump, without computing a boolean\n"
+      "\t" << jump << "\t" << label << "\n";
   }
 
   /*!
@@ -502,7 +1125,7 @@ namespace MiniCompiler
   ASMGeneratorVisitor::visit(const AST::NodeExpression* node)
   {
     assert(node);
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<ASMGeneratorVisitor>::visit(node);
   }
 
   /*!
@@ -514,14 +1137,28 @@ namespace MiniCompiler
   ASMGeneratorVisitor::visit(const AST::NodeStringExpr* node)
   {
     assert(node);
-    static unsigned int strCountLabel = 0;
-
     const std::string& s = escape_string(node->getString());
+
+    // Labels are given in order of appearance in the whole program
+    if (_global)
+      _relocations.push_back(std::make_pair(static_cast<std::string::size_type>(_indent.tellp()), s));
+    else
+      writeString(s);
+  }
+
+  /*!
+  ** Write the label of a read-only string, giving it the next label
+  ** if it is new.
+  **
+  ** @param s The escaped string
+  */
+  void
+  ASMGeneratorVisitor::writeString(const std::string& s)
+  {
     if (_strings.find(s) == _strings.end())
     {
-      strCountLabel++;
       std::stringstream ss;
-      ss << "_string" << strCountLabel;
+      ss << "_string" << ++_stringLabels;
       _strings[s] = ss.str();
     }
 
@@ -552,26 +1189,21 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
     const AST::NodeExpressions* exprs = node->getExprs();
-    std::list<const AST::NodeExpression*> list;
+    unsigned int i = 0;
 
-    // Just push each arguments in descedant order,
-    // to evaluate them from right to left.
-    list.push_front(expr);
-    while (exprs)
+    // Evaluate arguments from left to right, into the place made for them
+    // on the stack: the first one is on top, as asked by __cdecl.
+    for (;;)
     {
+      visit(expr);
+      _indent << "\tmov\t[esp + " << i++ * LOCAL_VAR_SIZE
+	      << "], edx\t; Save argument\n";
+      if (!exprs)
+	break;
       expr = exprs->getExpr();
       assert(expr);
-      list.push_front(expr);
       exprs = exprs->getExprs();
     }
-
-    // Then just evaluate them from right to left.
-    for (std::list<const AST::NodeExpression*>::const_iterator it = list.begin();
-	 it != list.end(); ++it)
-    {
-      (*it)->accept(*this);
-      _indent << "\tpush\tedx\t\t; Save argument\n";
-    }
   }
 
   /*!
@@ -607,26 +1239,26 @@ namespace MiniCompiler
 
     if (compoundInstr)
     {
-      compoundInstr->accept(*this);
+      visit(compoundInstr);
       return;
     }
 
     if (affect)
-      affect->accept(*this);
+      visit(affect);
     else if (callFunc)
-      callFunc->accept(*this);
+      visit(callFunc);
     else if (nIf)
-      nIf->accept(*this);
+      visit(nIf);
     else if (nWhile)
-      nWhile->accept(*this);
+      visit(nWhile);
     else if (nReturn)
-      nReturn->accept(*this);
+      visit(nReturn);
     else if (nExit)
-      nExit->accept(*this);
+      visit(nExit);
     else if (nPrint)
-      nPrint->accept(*this);
+      visit(nPrint);
     else if (nRead)
-      nRead->accept(*this);
+      visit(nRead);
   }
 
   /*!
@@ -643,7 +1275,7 @@ namespace MiniCompiler
     //     _indent << "\tpush\tebp\t\t; Begin\n"
     //       "\tmov\tebp, esp\n";
     if (instrs)
-      instrs->accept(*this);
+      visit(instrs);
     //     _indent << "\tmov\tesp, ebp\n"
     //       "\tpop\tebp\t\t; End\n";
   }
@@ -675,25 +1307,25 @@ namespace MiniCompiler
 
     if (callFunc)
     {
-      callFunc->accept(*this);
+      visit(callFunc);
       return;
     }
     else if (expression)
     {
-      expression->accept(*this);
+      visit(expression);
       return;
     }
 
     _indent << "\tmov\tedx, ";
 
     if (id)
-      id->accept(*this);
+      visit(id);
     else if (number)
-      number->accept(*this);
+      visit(number);
     else if (stringExpr)
-      stringExpr->accept(*this);
+      visit(stringExpr);
     else if (boolExpr)
-      boolExpr->accept(*this);
+      visit(boolExpr);
 
     _indent << "\n";
   }
@@ -707,7 +1339,7 @@ namespace MiniCompiler
   ASMGeneratorVisitor::visit(const AST::NodeInstrs* node)
   {
     assert(node);
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<ASMGeneratorVisitor>::visit(node);
   }
 
   /*!
@@ -723,7 +1355,10 @@ namespace MiniCompiler
   }
 
   /*!
-  ** Convert the function node
+  ** Convert the function node.
+  ** The call depth is checked like in the execution, counting down the
+  ** calls left in _calls_left: a leaf function calls nothing, so it
+  ** only checks that one more call is allowed.
   **
   ** @param node The function node
   */
@@ -738,17 +1373,34 @@ namespace MiniCompiler
     assert(instr);
 
     _scope.open();
-    header->accept(*this);
-    _indent << "\tpush\tebp\t\t; Begin\n"
-      "\tmov\tebp, esp\n";
+    allocateRegisters(node);
+    visit(header);
+    if (_frame)
+      _indent << "\tpush\tebp\t\t; Begin\n"
+	"\tmov\tebp, esp\n";
+    for (unsigned int i = 0; i < _saved.size(); ++i)
+      _indent << "\tpush\t" << _saved[i] << "\n";
+    if (_leaf)
+      _indent << "\tcmp\tdword [_calls_left], 0\n"
+	"\tje\t__depth_exceeded\n";
+    else
+      _indent << "\tdec\tdword [_calls_left]\n"
+	"\tjs\t__depth_exceeded\n";
+    for (unsigned int i = 0; i < node->nbArgument(); ++i)
+    {
+      Allocation::const_iterator reg = _registers.find(node->getArgument(i));
+      if (reg != _registers.end())
+	_indent << "\tmov\t" << reg->second << ", " << argument(i, 0)
+		<< "\t; Argument in a register\n";
+    }
+    _localOffset = _saved.size() * LOCAL_VAR_SIZE;
+    _localAllocated = _localOffset;
     if (decls)
-      decls->accept(*this);
+      visit(decls);
     AST::NodeInstrs* instrs = instr->getInstrs();
     if (instrs)
-      instrs->accept(*this);
-    _indent << "\tmov\tesp, ebp\n"
-      "\tpop\tebp\t\t; End\n"
-      "\tret\t\t; exit function\n";
+      visit(instrs);
+    writeEpilogue();
     _scope.close();
   }
 
@@ -765,15 +1417,14 @@ namespace MiniCompiler
     const AST::NodeCompoundInstr* body = node->getBodyExprs();
     assert(cond);
     assert(body);
-    static unsigned int globalWhileLabelCount = 0;
-    globalWhileLabelCount++;
-    unsigned int whileLabelCount = globalWhileLabelCount;
+    unsigned int whileLabelCount = ++_whileLabels;
+
+    std::stringstream label;
+    label << "end_while_" << whileLabelCount;
 
     _indent << "while_" << whileLabelCount << ":\n";
-    cond->accept(*this);
-    _indent << "\ttest\teax, eax\n"
-      "\tjz\tend_while_" << whileLabelCount << "\t; While expr do\n";
-    body->accept(*this);
+    writeJumpIfFalse(cond, label.str());
+    visit(body);
     _indent << "\tjmp\twhile_" << whileLabelCount << "\n"
       "end_while_" << whileLabelCount << ":\n";
   }
@@ -791,9 +1442,6 @@ namespace MiniCompiler
     assert(ids);
     const AST::NodeType* type = node->getType();
     assert(type);
-    // Start to 8 because of "frame pointer + base pointer" = esp + ebp = 4 + 4 = 8
-    unsigned int sizeToAllocate = 8;
-
     const AST::NodeId* id = 0;
     while (ids)
     {
@@ -809,26 +1457,35 @@ namespace MiniCompiler
 	_indent << id->getId() << ' ';
       }
 
-      type->accept(*this);
+      visit(type);
 
+      Allocation::const_iterator reg = _registers.find(id);
       if (!declaringGlobalVar())
       {
 	std::stringstream ss;
-	ss << "[ebp - " << sizeToAllocate << "]";
+	if (reg != _registers.end())
+	  ss << reg->second;
+	else
+	{
+	  _localOffset += LOCAL_VAR_SIZE;
+	  ss << "[ebp - " << _localOffset << "]";
+	}
 	_scope.put(id->getId(), Utils::makePair(ss.str(),
 						Utils::stringToType(type->getType())));
       }
       else
 	_indent << " 0\t; var " << id->getId() << " : " << type->getType() << ";\n";
 
-      sizeToAllocate += LOCAL_VAR_SIZE;
       ids = ids->getIds();
     }
 
+    // Following declarations of the function are put after these ones
     if (!declaringGlobalVar())
     {
-      _indent << "\tsub\tesp, " << sizeToAllocate
-	      << "\t; Let's allocate places for local variables\n";
+      if (_localOffset > _localAllocated)
+	_indent << "\tsub\tesp, " << _localOffset - _localAllocated
+		<< "\t; Let's allocate places for local variables\n";
+      _localAllocated = _localOffset;
       initVariables();
     }
   }
@@ -842,7 +1499,105 @@ namespace MiniCompiler
   ASMGeneratorVisitor::visit(const AST::NodeFunctions* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    if (_global || !visitInParallel(node))
+      BasicPrettyPrinterVisitor<ASMGeneratorVisitor>::visit(node);
+  }
+
+  /*!
+  ** Generate each function apart, on a thread pool, then append them
+  ** in order of declaration. The labels of the ifs and of the whiles
+  ** are counted first, so that each function starts from the labels
+  ** of the previous ones, and strings are labeled while merging: the
+  ** code is the same as the one generated by a single thread.
+  **
+  ** @param node The functions node
+  **
+  ** @return If the functions were generated, false when there is
+  ** only one function or one thread
+  */
+  bool
+  ASMGeneratorVisitor::visitInParallel(const AST::NodeFunctions* node)
+  {
+    assert(node);
+    Functions functions;
+
+    for (; node; node = node->getFuncs())
+      functions.nodes.push_back(node->getFunc());
+    if (_jobs < 2 || functions.nodes.size() < 2)
+      return false;
+
+    functions.counters.resize(functions.nodes.size());
+    ThreadPool pool(_jobs);
+    pool.run(&ASMGeneratorVisitor::countLabels, &functions,
+	     functions.nodes.size());
+    for (unsigned int i = 0; i < functions.nodes.size(); i++)
+    {
+      ASMGeneratorVisitor* visitor = new ASMGeneratorVisitor(this);
+      visitor->_ifLabels = _ifLabels;
+      visitor->_whileLabels = _whileLabels;
+      _ifLabels += functions.counters[i].ifs;
+      _whileLabels += functions.counters[i].whiles;
+      functions.visitors.push_back(visitor);
+    }
+    pool.run(&ASMGeneratorVisitor::launch, &functions,
+	     functions.nodes.size());
+    for (unsigned int i = 0; i < functions.visitors.size(); i++)
+    {
+      writeFunction(*functions.visitors[i]);
+      delete functions.visitors[i];
+    }
+
+    return true;
+  }
+
+  /*!
+  ** Count the labels of a function, from a thread of the pool.
+  **
+  ** @param data The functions
+  ** @param i The number of the function
+  */
+  void
+  ASMGeneratorVisitor::countLabels(void* data, const unsigned int i)
+  {
+    Functions* functions = static_cast<Functions*>(data);
+
+    functions->counters[i].visit(functions->nodes[i]);
+  }
+
+  /*!
+  ** Generate a function, from a thread of the pool.
+  **
+  ** @param data The functions
+  ** @param i The number of the function to generate
+  */
+  void
+  ASMGeneratorVisitor::launch(void* data, const unsigned int i)
+  {
+    Functions* functions = static_cast<Functions*>(data);
+
+    functions->visitors[i]->visit(functions->nodes[i]);
+  }
+
+  /*!
+  ** Append a function generated apart, labeling its strings.
+  **
+  ** @param function The visitor which generated the function
+  */
+  void
+  ASMGeneratorVisitor::writeFunction(const ASMGeneratorVisitor& function)
+  {
+    const std::string code = function._buffer.str();
+    std::string::size_type pos = 0;
+
+    _indent << Utils::stringFill(SPACING_CHAR, _tab);
+    for (Relocations::const_iterator it = function._relocations.begin();
+	 it != function._relocations.end(); ++it)
+    {
+      _indent.write(code.data() + pos, it->first - pos);
+      writeString(it->second);
+      pos = it->first;
+    }
+    _indent.write(code.data() + pos, code.size() - pos);
   }
 
   /*!
@@ -868,7 +1623,7 @@ namespace MiniCompiler
     assert(node);
     const AST::NodeDeclarationBody* body = node->getBody();
     assert(body);
-    body->accept(*this);
+    visit(body);
   }
 
   /*!
@@ -884,10 +1639,10 @@ namespace MiniCompiler
     const AST::NodeArguments* args = node->getArguments();
     assert(id);
 
-    id->accept(*this);
+    visit(id);
     _indent << ":\n";
     if (args)
-      args->accept(*this);
+      visit(args);
   }
 
   /*!
@@ -899,7 +1654,7 @@ namespace MiniCompiler
   ASMGeneratorVisitor::visit(const AST::NodeDeclarations* node)
   {
     assert(node);
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<ASMGeneratorVisitor>::visit(node);
   }
 
   /*!
@@ -911,7 +1666,7 @@ namespace MiniCompiler
   ASMGeneratorVisitor::visit(const AST::NodeId* node)
   {
     assert(node);
-    _indent << (*_scope.getFromAll(node->getId())).first;
+    _indent << location(node);
   }
 
   /*!
@@ -923,7 +1678,7 @@ namespace MiniCompiler
   ASMGeneratorVisitor::visit(const AST::NodeIdFunc* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<ASMGeneratorVisitor>::visit(node);
   }
 
   /*!
@@ -938,7 +1693,7 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
 
-    expr->accept(*this);
+    visit(expr);
     _indent << "\tmov eax, edx\t; Prepare to being print\n";
     _indent << "\tcall\t";
     switch (expr->getComputedType())
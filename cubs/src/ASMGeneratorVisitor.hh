@@ -1,75 +1,124 @@
 #ifndef ASMGENERATORVISITOR_HH_
 # define ASMGENERATORVISITOR_HH_
 
+# include <cassert>
 # include <iomanip>
 # include <sstream>
 # include <map>
 # include <utility>
+# include <vector>
 # include "Scope.hh"
+# include "Error.hh"
 # include "PrettyPrinterVisitor.hh"
 
 namespace MiniCompiler
 {
-  class ASMGeneratorVisitor : public PrettyPrinterVisitor
+  class ASMGeneratorVisitor :
+    public BasicPrettyPrinterVisitor<ASMGeneratorVisitor>
   {
     friend std::ostream&
     operator<<(std::ostream& o, const ASMGeneratorVisitor& v);
 
     typedef Scope<std::string, std::pair<std::string, AST::Type::type>*> ScopeVar;
     typedef std::map<std::string, std::string> ROStrings;
+    typedef std::vector<std::pair<std::string::size_type, std::string> > Relocations;
+    typedef std::map<const AST::NodeId*, const char*> Allocation;
+    typedef std::vector<const char*> Registers;
 
     static const unsigned int LOCAL_VAR_SIZE = 4;
+    // Start to 8 because of "return address + base pointer" = 4 + 4 = 8
+    static const unsigned int FIRST_ARGUMENT_OFFSET = 8;
+    static const unsigned int NB_CALLEE_SAVED_REGISTERS = 3;
+    static const char* const CALLEE_SAVED_REGISTERS[NB_CALLEE_SAVED_REGISTERS];
 
   public:
     ASMGeneratorVisitor();
-    virtual ~ASMGeneratorVisitor();
+    ~ASMGeneratorVisitor();
     void printPrelude(bool hasToBePrint);
     void initVariables();
+    void setJobs(const unsigned int jobs);
+    void setMaxDepth(const unsigned int depth);
+
+  protected:
+    ASMGeneratorVisitor(const ASMGeneratorVisitor* global);
 
   public:
-    virtual void visit(const AST::NodeIds* node);
-    virtual void visit(const AST::NodeProgram* node);
-    virtual void visit(const AST::NodeAffect* node);
-    virtual void visit(const AST::NodeIf* node);
-    virtual void visit(const AST::NodeRead* node);
-    virtual void visit(const AST::NodeArgument* node);
-    virtual void visit(const AST::NodeArguments* node);
-    virtual void visit(const AST::NodeReturn* node);
-    virtual void visit(const AST::NodeExit* node);
-    virtual void visit(const AST::NodeCallFunc* node);
-    virtual void visit(const AST::NodeOperation* node);
-    virtual void visit(const AST::NodeExpression* node);
-    virtual void visit(const AST::NodeStringExpr* node);
-    virtual void visit(const AST::NodeBoolean* node);
-    virtual void visit(const AST::NodeExpressions* node);
-    virtual void visit(const AST::NodeInstr* node);
-    virtual void visit(const AST::NodeCompoundInstr* node);
-    virtual void visit(const AST::NodeFactor* node);
-    virtual void visit(const AST::NodeInstrs* node);
-    virtual void visit(const AST::NodeType* node);
-    virtual void visit(const AST::NodeFunction* node);
-    virtual void visit(const AST::NodeWhile* node);
-    virtual void visit(const AST::NodeDeclarationBody* node);
-    virtual void visit(const AST::NodeFunctions* node);
-    virtual void visit(const AST::NodeNumber* node);
-    virtual void visit(const AST::NodeDeclaration* node);
-    virtual void visit(const AST::NodeHeaderFunc* node);
-    virtual void visit(const AST::NodeDeclarations* node);
-    virtual void visit(const AST::NodeId* node);
-    virtual void visit(const AST::NodeIdFunc* node);
-    virtual void visit(const AST::NodePrint* node);
+    void visit(const AST::NodeIds* node);
+    void visit(const AST::NodeProgram* node);
+    void visit(const AST::NodeAffect* node);
+    void visit(const AST::NodeIf* node);
+    void visit(const AST::NodeRead* node);
+    void visit(const AST::NodeArgument* node);
+    void visit(const AST::NodeArguments* node);
+    void visit(const AST::NodeReturn* node);
+    void visit(const AST::NodeExit* node);
+    void visit(const AST::NodeCallFunc* node);
+    void visit(const AST::NodeOperation* node);
+    void visit(const AST::NodeExpression* node);
+    void visit(const AST::NodeStringExpr* node);
+    void visit(const AST::NodeBoolean* node);
+    void visit(const AST::NodeExpressions* node);
+    void visit(const AST::NodeInstr* node);
+    void visit(const AST::NodeCompoundInstr* node);
+    void visit(const AST::NodeFactor* node);
+    void visit(const AST::NodeInstrs* node);
+    void visit(const AST::NodeType* node);
+    void visit(const AST::NodeFunction* node);
+    void visit(const AST::NodeWhile* node);
+    void visit(const AST::NodeDeclarationBody* node);
+    void visit(const AST::NodeFunctions* node);
+    void visit(const AST::NodeNumber* node);
+    void visit(const AST::NodeDeclaration* node);
+    void visit(const AST::NodeHeaderFunc* node);
+    void visit(const AST::NodeDeclarations* node);
+    void visit(const AST::NodeId* node);
+    void visit(const AST::NodeIdFunc* node);
+    void visit(const AST::NodePrint* node);
 
   protected:
     void writeHeader();
     void writePrelude();
     void writePostlude();
     bool declaringGlobalVar() const;
+    void writeJumpIfFalse(const AST::NodeExpression* cond,
+			  const std::string& label);
+    void allocateRegisters(const AST::NodeFunction* node);
+    const char* allocateTemporary();
+    void releaseTemporary(const char* reg);
+    const std::string& location(const AST::NodeId* id) const;
+    bool isStable(const AST::NodeFactor* factor);
+    std::string operand(const AST::NodeFactor* factor);
+    std::string computeOperands(const AST::NodeOperation* node);
+    void writeOperation(AST::Operator::type op, bool isString,
+			const std::string& right);
+    std::string argument(unsigned int i, unsigned int pushed) const;
+    void writeLeave();
+    void writeEpilogue();
+    void writeString(const std::string& s);
+    void writeFunction(const ASMGeneratorVisitor& function);
+    bool visitInParallel(const AST::NodeFunctions* node);
+    static void countLabels(void* data, const unsigned int i);
+    static void launch(void* data, const unsigned int i);
 
   protected:
     ScopeVar		_scope;
     ROStrings		_strings;
     bool		_printPrelude;
     unsigned int	_stackShifting;
+    unsigned int	_localOffset;
+    unsigned int	_localAllocated;
+    unsigned int	_ifLabels;
+    unsigned int	_whileLabels;
+    unsigned int	_stringLabels;
+    const ASMGeneratorVisitor*	_global;
+    unsigned int	_jobs;
+    unsigned int	_maxDepth;
+    Relocations		_relocations;
+    Allocation		_registers;
+    Registers		_saved;
+    Registers		_freeTemporaries;
+    bool		_frame;
+    bool		_leaf;
   };
 }
 
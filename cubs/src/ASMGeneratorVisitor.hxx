@@ -22,6 +22,29 @@ namespace MiniCompiler
     _printPrelude = hasToBePrint;
   }
 
+  /*!
+  ** Set the maximum number of threads generating functions.
+  **
+  ** @param jobs The number of threads, at least 1
+  */
+  inline void
+  ASMGeneratorVisitor::setJobs(const unsigned int jobs)
+  {
+    assert(jobs > 0);
+    _jobs = jobs;
+  }
+
+  /*!
+  ** Set the maximum number of nested function calls.
+  **
+  ** @param depth The maximum call depth
+  */
+  inline void
+  ASMGeneratorVisitor::setMaxDepth(const unsigned int depth)
+  {
+    _maxDepth = depth;
+  }
+
   /*!
   ** Just Write the prelude, ie some function needed to make it works.
   **
@@ -41,6 +64,7 @@ namespace MiniCompiler
 	"  %define _putchar putchar\n"
 	"  %define _malloc malloc\n"
 	"  %define _free free\n"
+	"  %define _exit exit\n"
 	"%endif\n"
 	"\n"
 	";\n"
@@ -53,6 +77,7 @@ namespace MiniCompiler
 	"  %define _putchar putchar_\n"
 	"  %define _malloc malloc_\n"
 	"  %define _free free_\n"
+	"  %define _exit exit_\n"
 	"%endif\n"
 	"\n"
 	"\n";
@@ -61,7 +86,14 @@ namespace MiniCompiler
       "\t_string_format db \"%s\", 0\n"
       "\t_empty db \"\", 0\n"
       "\ttrue db \"true\", 0\n"
-      "\tfalse db \"false\", 0\n";
+      "\tfalse db \"false\", 0\n"
+      "\t_division_by_zero_message db \"A division by zero has occured...\", 10\n"
+      "\t_division_by_zero_length equ $ - _division_by_zero_message\n"
+      "\t_depth_exceeded_message db \"Maximum call depth of " << _maxDepth
+	    << " exceeded...\", 10\n"
+      "\t_depth_exceeded_length equ $ - _depth_exceeded_message\n"
+      "\t_calls_left dd " << _maxDepth
+	    << "\t; Number of calls which can still be nested\n";
   }
 
   /*!
@@ -162,86 +194,6 @@ namespace MiniCompiler
       "\tleave\n"
       "\tret\n"
       "\n"
-      // is_eq
-      "__is_eq:\t\t\t; Check if first == second\n"
-      "\tpush\tebp\n"
-      "\tmov\tebp, esp\n"
-      "\tmov\teax, 0\n"
-      "\tmov\tebx, [ebp + 8]\n"
-      "\tcmp\tebx, [ebp + 12]\n"
-      "\tjne\t.quit\n"
-      "\tmov\teax, 1\n"
-      ".quit:\n"
-      "\tmov\tesp, ebp\n"
-      "\tpop\tebp\n"
-      "\tret\n"
-      // is_diff
-      "__is_diff:\t\t\t; Check if first != second\n"
-      "\tpush\tebp\n"
-      "\tmov\tebp, esp\n"
-      "\tmov\teax, 0\n"
-      "\tmov\tebx, [ebp + 8]\n"
-      "\tcmp\tebx, [ebp + 12]\n"
-      "\tje\t.quit\n"
-      "\tmov\teax, 1\n"
-      ".quit:\n"
-      "\tmov\tesp, ebp\n"
-      "\tpop\tebp\n"
-      "\tret\n"
-      // is_sup
-      "__is_sup:\t\t\t; Check if first > second\n"
-      "\tpush\tebp\n"
-      "\tmov\tebp, esp\n"
-      "\tmov\teax, 0\n"
-      "\tmov\tebx, [ebp + 8]\n"
-      "\tcmp\tebx, [ebp + 12]\n"
-      "\tjs\t.quit\n"
-      "\tje\t.quit\n"
-      "\tmov\teax, 1\n"
-      ".quit:\n"
-      "\tmov\tesp, ebp\n"
-      "\tpop\tebp\n"
-      "\tret\n"
-      // is_supeq
-      "__is_supeq:\t\t\t; Check if first >= second\n"
-      "\tpush\tebp\n"
-      "\tmov\tebp, esp\n"
-      "\tmov\teax, 0\n"
-      "\tmov\tebx, [ebp + 8]\n"
-      "\tcmp\tebx, [ebp + 12]\n"
-      "\tjs\t.quit\n"
-      "\tmov\teax, 1\n"
-      ".quit:\n"
-      "\tmov\tesp, ebp\n"
-      "\tpop\tebp\n"
-      "\tret\n"
-      // is_inf
-      "__is_inf:\t\t\t; Check if first < second\n"
-      "\tpush\tebp\n"
-      "\tmov\tebp, esp\n"
-      "\tmov\teax, 0\n"
-      "\tmov\tebx, [ebp + 8]\n"
-      "\tcmp\tebx, [ebp + 12]\n"
-      "\tjns\t.quit\n"
-      "\tmov\teax, 1\n"
-      ".quit:\n"
-      "\tmov\tesp, ebp\n"
-      "\tpop\tebp\n"
-      "\tret\n"
-      // is_infeq
-      "__is_infeq:\t\t\t; Check if first <= second\n"
-      "\tpush\tebp\n"
-      "\tmov\tebp, esp\n"
-      "\tmov\teax, 1\n"
-      "\tmov\tebx, [ebp + 8]\n"
-      "\tcmp\tebx, [ebp + 12]\n"
-      "\tje\t.quit\n"
-      "\tjs\t.quit\n"
-      "\tmov\teax, 0\n"
-      ".quit:\n"
-      "\tmov\tesp, ebp\n"
-      "\tpop\tebp\n"
-      "\tret\n"
       // print_bool
       "__print_bool:\t\t\t; Print a boolean stored in eax\n"
       "\ttest\teax, eax\n"
@@ -256,62 +208,69 @@ namespace MiniCompiler
       // strlen
       "__strlen:\t\t\t; Compute the string length contained in eax,\n"
       "\t\t\t\t; and store it in eax\n"
-      "\txor\tebx, ebx\n"
+      "\tmov\tecx, eax\n"
       ".loop:\n"
-      "\tcmp\tbyte [eax], 0\n"
+      "\tcmp\tbyte [ecx], 0\n"
       "\tje\t.quit\n"
-      "\tinc\tebx\n"
-      "\tinc\teax\n"
+      "\tinc\tecx\n"
       "\tjmp\t.loop\n"
       "\n"
       ".quit:\n"
-      "\tmov\teax, ebx\n"
+      "\tsub\tecx, eax\n"
+      "\tmov\teax, ecx\n"
       "\tret\n"
       "\n"
       // concat
-      "__concat:\t\t\t; Concat strings in eax and ebx\n"
+      "__concat:\t\t\t; Concat the strings given on the stack\n"
+      "\tpush\tebp\n"
+      "\tmov\tebp, esp\n"
+      "\tpush\tebx\n"
+      "\tpush\tesi\n"
+      "\tpush\tedi\n"
       "\n"
-      "\tmov\teax, edi\n"
+      "\tmov\teax, [ebp + 8]\n"
       "\tcall\t__strlen\t\t; Get first size\n"
-      "\tmov\tecx, eax\n"
-      "\tmov\teax, esi\n"
+      "\tmov\tebx, eax\n"
+      "\tmov\teax, [ebp + 12]\n"
       "\tcall\t__strlen\t\t; Get second size\n"
-      "\tadd\tecx, eax\n"
-      "\tinc\tecx\t\t; One more space for the \\0\n"
-      "\tmov\teax, ecx\n"
-      "\tcall\tmalloc\t\t; Allocate needed space\n"
-      "\tmov\tedx, eax\t; Make copy of the returned adress\n"
+      "\tlea\teax, [ebx + eax + 1]\t; One more space for the \\0\n"
+      "\tpush\teax\n"
+      "\tcall\t_malloc\t\t; Allocate needed space\n"
+      "\tadd\tesp, 4\n"
+      "\tmov\tedi, eax\t; eax keeps the returned adress\n"
       "\n"
-      "\tmov\tecx, edi\t; Copy the first string\n"
+      "\tmov\tesi, [ebp + 8]\t; Copy the first string\n"
       ".loop1:\n"
-      "\tcmp\tbyte [ecx], 0\n"
+      "\tmov\tcl, [esi]\n"
+      "\ttest\tcl, cl\n"
       "\tje\t.stop1\n"
-      "\tmov\tebx, [ecx]\n"
-      "\tmov\t[edx], ebx\n"
-      "\tinc\tedx\n"
-      "\tinc\tecx\n"
+      "\tmov\t[edi], cl\n"
+      "\tinc\tedi\n"
+      "\tinc\tesi\n"
       "\tjmp\t.loop1\n"
       ".stop1:\n"
       "\n"
-      "\tmov\tecx, esi\t; Copy the second string\n"
+      "\tmov\tesi, [ebp + 12]\t; Copy the second string, and its \\0\n"
       ".loop2:\n"
-      "\tcmp\tbyte [ecx], 0\n"
-      "\tje\t.stop2\n"
-      "\tmov\tebx, [ecx]\n"
-      "\tmov\t[edx], ebx\n"
-      "\tinc\tedx\n"
-      "\tinc\tecx\n"
-      "\tjmp\t.loop2\n"
-      ".stop2:\n"
-      "\n"
-      "\tmov\tbyte [edx], 0\t; Add final \\0\n"
+      "\tmov\tcl, [esi]\n"
+      "\tmov\t[edi], cl\n"
+      "\tinc\tedi\n"
+      "\tinc\tesi\n"
+      "\ttest\tcl, cl\n"
+      "\tjne\t.loop2\n"
       "\n"
+      "\tpop\tedi\n"
+      "\tpop\tesi\n"
+      "\tpop\tebx\n"
+      "\tmov\tesp, ebp\n"
+      "\tpop\tebp\n"
       "\tret\n"
       "\n"
       // streq
       "__streq:\t\t\t; Check if first == second\n"
       "\tpush\tebp\n"
       "\tmov\tebp, esp\n"
+      "\tpush\tebx\n"
       "\tmov\tebx, [ebp + 8]\n"
       "\tmov\tedx, [ebp + 12]\n"
       "\txor\teax, eax\n"
@@ -331,6 +290,7 @@ namespace MiniCompiler
       "\tjne\t.quit\n"
       "\tinc\teax\n"
       ".quit:\n"
+      "\tpop\tebx\n"
       "\tmov\tesp, ebp\n"
       "\tpop\tebp\n"
       "\tret\n"
@@ -339,6 +299,7 @@ namespace MiniCompiler
       "__strdiff:\t\t\t; Check if first != second\n"
       "\tpush\tebp\n"
       "\tmov\tebp, esp\n"
+      "\tpush\tebx\n"
       "\tmov\tebx, [ebp + 8]\n"
       "\tmov\tedx, [ebp + 12]\n"
       "\tmov\teax, 1\n"
@@ -358,10 +319,29 @@ namespace MiniCompiler
       "\tjne\t.quit\n"
       "\txor\teax, eax\n"
       ".quit:\n"
+      "\tpop\tebx\n"
       "\tmov\tesp, ebp\n"
       "\tpop\tebp\n"
       "\tret\n"
       "\n"
+      // division_by_zero
+      "__error:\t\t\t; Print the message in ecx, of length edx, on\n"
+      "\tmov\teax, 4\t\t; stderr, then fail (sys_write)\n"
+      "\tmov\tebx, 2\n"
+      "\tint\t80h\n"
+      "\tpush\tdword " << Error::EXECUTION << "\n"
+      "\tcall\t_exit\t\t; Flush the standard output too\n"
+      "\n"
+      "__division_by_zero:\n"
+      "\tmov\tecx, _division_by_zero_message\n"
+      "\tmov\tedx, _division_by_zero_length\n"
+      "\tjmp\t__error\n"
+      "\n"
+      "__depth_exceeded:\n"
+      "\tmov\tecx, _depth_exceeded_message\n"
+      "\tmov\tedx, _depth_exceeded_length\n"
+      "\tjmp\t__error\n"
+      "\n"
       // read_bool
       "__read_bool:\n"
       "\tcall\t__read_int\n"
@@ -371,6 +351,7 @@ namespace MiniCompiler
       "__read_string:\n"
       "\tpush\tebp\n"
       "\tmov\tebp, esp\n"
+      "\tpush\tebx\n"
       "\n"
       "\txor\tecx, ecx\n"
       "\tpush\tdword 0\n"
@@ -384,8 +365,7 @@ namespace MiniCompiler
       ".stop:\n"
       "\tinc\tecx\t\t; Add the space for the final \\0\n"
       "\tpush\tecx\n"
-      "\tmov\teax, ecx\n"
-      "\tcall\tmalloc\n"
+      "\tcall\t_malloc\t\t; The size is already pushed\n"
       "\tmov\tedx, eax\t; Make a copy of eax, and don't touch it\n"
       "\tpop\tecx\n"
       "\tadd\tedx, ecx\t; Go back to the end of the string, then\n"
@@ -400,6 +380,7 @@ namespace MiniCompiler
       "\tmov\t[edx], bl\n"
       "\tjmp\t.loop2\n"
       ".quit:\t\t\t\t; Eax will be setted with string\n"
+      "\tmov\tebx, [ebp - 4]\n"
       "\tmov\tesp, ebp\n"
       "\tpop\tebp\n"
       "\tret\n"
@@ -1,12 +1,21 @@
 #ifndef BASEVISITOR_HH_
 # define BASEVISITOR_HH_
 
-# include "IVisitor.hh"
+# include "Traits.hh"
+# include "Node.hh"
 
 namespace MiniCompiler
 {
-  template <template <typename T> class ConstifyTrait>
-  class BaseVisitor : public IVisitor<ConstifyTrait>
+  /*!
+  ** Visit a tree without virtual calls: Derived is the visitor itself,
+  ** and each node is given to the method of Derived for its class,
+  ** known at compile time, so that calls can be inlined. By default, a
+  ** node visits its children.
+  ** A visitor brings the methods it doesn't define in with a using
+  ** declaration.
+  */
+  template <typename Derived, template <typename T> class ConstifyTrait>
+  class BaseVisitor
   {
   protected:
     static const unsigned int INDENT_SIZE = 1;
@@ -14,42 +23,59 @@ namespace MiniCompiler
 
   public:
     BaseVisitor();
-    virtual ~BaseVisitor();
-    virtual void visit(typename ConstifyTrait<AST::NodeIds>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeProgram>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeAffect>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeIf>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeRead>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeArgument>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeArguments>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeReturn>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeExit>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeCallFunc>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeOperation>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeExpression>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeStringExpr>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeBoolean>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeExpressions>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeInstr>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeCompoundInstr>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeFactor>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeInstrs>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeType>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeFunction>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeWhile>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeDeclarationBody>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeFunctions>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeNumber>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeDeclaration>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeHeaderFunc>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeDeclarations>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeId>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodeIdFunc>::ptr node);
-    virtual void visit(typename ConstifyTrait<AST::NodePrint>::ptr node);
+    ~BaseVisitor();
+    void dispatch(typename ConstifyTrait<AST::Node>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeIds>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeProgram>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeAffect>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeIf>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeRead>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeArgument>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeArguments>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeReturn>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeExit>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeCallFunc>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeOperation>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeExpression>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeStringExpr>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeBoolean>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeExpressions>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeInstr>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeCompoundInstr>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeFactor>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeInstrs>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeType>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeFunction>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeWhile>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeDeclarationBody>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeFunctions>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeNumber>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeDeclaration>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeHeaderFunc>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeDeclarations>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeId>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodeIdFunc>::ptr node);
+    void visit(typename ConstifyTrait<AST::NodePrint>::ptr node);
+
+  protected:
+    Derived& derived();
   };
 
-  typedef BaseVisitor<Traits::Identity> NonConstBaseVisitor;
-  typedef BaseVisitor<Traits::Const> ConstBaseVisitor;
+  /*!
+  ** Visit a tree, changing it.
+  */
+  template <typename Derived>
+  class NonConstBaseVisitor : public BaseVisitor<Derived, Traits::Identity>
+  {
+  };
+
+  /*!
+  ** Visit a tree, without changing it.
+  */
+  template <typename Derived>
+  class ConstBaseVisitor : public BaseVisitor<Derived, Traits::Const>
+  {
+  };
 }
 
 # include "BaseVisitor.hxx"
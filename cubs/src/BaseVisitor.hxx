@@ -29,6 +29,7 @@
 #include "NodeHeaderFunc.hh"
 #include "NodeDeclarations.hh"
 #include "NodeId.hh"
+#include "NodeIdFunc.hh"
 #include "NodePrint.hh"
 
 namespace MiniCompiler
@@ -36,35 +37,157 @@ namespace MiniCompiler
   /*!
   ** Construct the base visitor.
   */
-  template <template <typename T> class ConstifyTrait>
-  BaseVisitor<ConstifyTrait>::BaseVisitor()
+  template <typename Derived, template <typename T> class ConstifyTrait>
+  BaseVisitor<Derived, ConstifyTrait>::BaseVisitor()
   {
   }
 
   /*!
   ** Destruct the base visitor.
   */
-  template <template <typename T> class ConstifyTrait>
-  BaseVisitor<ConstifyTrait>::~BaseVisitor()
+  template <typename Derived, template <typename T> class ConstifyTrait>
+  BaseVisitor<Derived, ConstifyTrait>::~BaseVisitor()
   {
   }
 
+  /*!
+  ** Get the visitor itself.
+  **
+  ** @return The visitor
+  */
+  template <typename Derived, template <typename T> class ConstifyTrait>
+  inline Derived&
+  BaseVisitor<Derived, ConstifyTrait>::derived()
+  {
+    return static_cast<Derived&>(*this);
+  }
+
+  /*!
+  ** Visit a node whose class is only known by its kind.
+  **
+  ** @param node The node
+  */
+  template <typename Derived, template <typename T> class ConstifyTrait>
+  void
+  BaseVisitor<Derived, ConstifyTrait>::dispatch(typename ConstifyTrait<AST::Node>::ptr node)
+  {
+    assert(node);
+    switch (node->getKind())
+    {
+      case AST::Kind::IDS:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeIds>::ptr>(node));
+	break;
+      case AST::Kind::PROGRAM:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeProgram>::ptr>(node));
+	break;
+      case AST::Kind::AFFECT:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeAffect>::ptr>(node));
+	break;
+      case AST::Kind::IF:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeIf>::ptr>(node));
+	break;
+      case AST::Kind::READ:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeRead>::ptr>(node));
+	break;
+      case AST::Kind::ARGUMENT:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeArgument>::ptr>(node));
+	break;
+      case AST::Kind::ARGUMENTS:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeArguments>::ptr>(node));
+	break;
+      case AST::Kind::RETURN:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeReturn>::ptr>(node));
+	break;
+      case AST::Kind::EXIT:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeExit>::ptr>(node));
+	break;
+      case AST::Kind::CALL_FUNC:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeCallFunc>::ptr>(node));
+	break;
+      case AST::Kind::OPERATION:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeOperation>::ptr>(node));
+	break;
+      case AST::Kind::EXPRESSION:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeExpression>::ptr>(node));
+	break;
+      case AST::Kind::STRING_EXPR:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeStringExpr>::ptr>(node));
+	break;
+      case AST::Kind::BOOLEAN:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeBoolean>::ptr>(node));
+	break;
+      case AST::Kind::EXPRESSIONS:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeExpressions>::ptr>(node));
+	break;
+      case AST::Kind::INSTR:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeInstr>::ptr>(node));
+	break;
+      case AST::Kind::COMPOUND_INSTR:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeCompoundInstr>::ptr>(node));
+	break;
+      case AST::Kind::FACTOR:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeFactor>::ptr>(node));
+	break;
+      case AST::Kind::INSTRS:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeInstrs>::ptr>(node));
+	break;
+      case AST::Kind::TYPE:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeType>::ptr>(node));
+	break;
+      case AST::Kind::FUNCTION:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeFunction>::ptr>(node));
+	break;
+      case AST::Kind::WHILE:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeWhile>::ptr>(node));
+	break;
+      case AST::Kind::DECLARATION_BODY:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeDeclarationBody>::ptr>(node));
+	break;
+      case AST::Kind::FUNCTIONS:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeFunctions>::ptr>(node));
+	break;
+      case AST::Kind::NUMBER:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeNumber>::ptr>(node));
+	break;
+      case AST::Kind::DECLARATION:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeDeclaration>::ptr>(node));
+	break;
+      case AST::Kind::HEADER_FUNC:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeHeaderFunc>::ptr>(node));
+	break;
+      case AST::Kind::DECLARATIONS:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeDeclarations>::ptr>(node));
+	break;
+      case AST::Kind::ID:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeId>::ptr>(node));
+	break;
+      case AST::Kind::ID_FUNC:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodeIdFunc>::ptr>(node));
+	break;
+      case AST::Kind::PRINT:
+	derived().visit(static_cast<typename ConstifyTrait<AST::NodePrint>::ptr>(node));
+	break;
+      default:
+	assert(false);
+    }
+  }
+
   /*!
   ** Visit an ids node.
   **
   ** @param node The ids node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeIds>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeIds>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeIds>::ptr ids = node->getIds();
     typename ConstifyTrait<AST::NodeId>::ptr id = node->getId();
     assert(id);
-    id->accept(*this);
+    derived().visit(id);
     if (ids)
-      ids->accept(*this);
+      derived().visit(ids);
   }
 
   /*!
@@ -72,20 +195,20 @@ namespace MiniCompiler
   **
   ** @param node The program node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeProgram>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeProgram>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeDeclarations>::ptr decls = node->getDecls();
     if (decls)
-      decls->accept(*this);
+      derived().visit(decls);
     typename ConstifyTrait<AST::NodeFunctions>::ptr funcs = node->getFuncs();
     if (funcs)
-      funcs->accept(*this);
+      derived().visit(funcs);
     typename ConstifyTrait<AST::NodeCompoundInstr>::ptr instrs = node->getInstrs();
     if (instrs)
-      instrs->accept(*this);
+      derived().visit(instrs);
   }
 
   /*!
@@ -93,17 +216,17 @@ namespace MiniCompiler
   **
   ** @param node The affect node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeAffect>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeAffect>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeId>::ptr id = node->getId();
     typename ConstifyTrait<AST::NodeExpression>::ptr expr = node->getExpr();
     assert(id);
     assert(expr);
-    id->accept(*this);
-    expr->accept(*this);
+    derived().visit(id);
+    derived().visit(expr);
   }
 
   /*!
@@ -111,9 +234,9 @@ namespace MiniCompiler
   **
   ** @param node The if node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeIf>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeIf>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeExpression>::ptr cond = node->getCond();
@@ -122,10 +245,10 @@ namespace MiniCompiler
     assert(cond);
     assert(body);
 
-    cond->accept(*this);
-    body->accept(*this);
+    derived().visit(cond);
+    derived().visit(body);
     if (elseExprs)
-      elseExprs->accept(*this);
+      derived().visit(elseExprs);
   }
 
   /*!
@@ -133,15 +256,15 @@ namespace MiniCompiler
   **
   ** @param node The read node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeRead>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeRead>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeId>::ptr id = node->getId();
     assert(id);
 
-    id->accept(*this);
+    derived().visit(id);
   }
 
   /*!
@@ -149,18 +272,18 @@ namespace MiniCompiler
   **
   ** @param node The argument node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeArgument>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeArgument>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeDeclarationBody>::ptr body = node->getDeclarationBody();
     typename ConstifyTrait<AST::NodeArguments>::ptr args = node->getArguments();
 
     assert(body);
-    body->accept(*this);
+    derived().visit(body);
     if (args)
-      args->accept(*this);
+      derived().visit(args);
   }
 
   /*!
@@ -168,18 +291,18 @@ namespace MiniCompiler
   **
   ** @param node The arguments node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeArguments>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeArguments>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeArgument>::ptr arg = node->getArgument();
     typename ConstifyTrait<AST::NodeArguments>::ptr args = node->getArguments();
 
     assert(arg);
-    arg->accept(*this);
+    derived().visit(arg);
     if (args)
-      args->accept(*this);
+      derived().visit(args);
   }
 
   /*!
@@ -187,15 +310,15 @@ namespace MiniCompiler
   **
   ** @param node The return node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeReturn>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeReturn>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeExpression>::ptr expr = node->getExpr();
     assert(expr);
 
-    expr->accept(*this);
+    derived().visit(expr);
   }
 
   /*!
@@ -203,15 +326,15 @@ namespace MiniCompiler
   **
   ** @param node The exit node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeExit>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeExit>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeExpression>::ptr expr = node->getExpr();
     assert(expr);
 
-    expr->accept(*this);
+    derived().visit(expr);
   }
 
   /*!
@@ -219,18 +342,18 @@ namespace MiniCompiler
   **
   ** @param node The function call node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeCallFunc>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeCallFunc>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeIdFunc>::ptr id = node->getId();
     typename ConstifyTrait<AST::NodeExpressions>::ptr exprs = node->getExprs();
     assert(id);
 
-    id->accept(*this);
+    derived().visit(id);
     if (exprs)
-      exprs->accept(*this);
+      derived().visit(exprs);
   }
 
   /*!
@@ -238,20 +361,20 @@ namespace MiniCompiler
   **
   ** @param node The operation node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeOperation>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeOperation>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeFactor>::ptr leftFactor = node->getLeftFactor();
     assert(leftFactor);
 
-    leftFactor->accept(*this);
+    derived().visit(leftFactor);
     if (node->getOpType() != AST::Operator::NONE)
     {
       typename ConstifyTrait<AST::NodeFactor>::ptr rightFactor = node->getRightFactor();
       assert(rightFactor);
-      rightFactor->accept(*this);
+      derived().visit(rightFactor);
     }
   }
 
@@ -260,14 +383,14 @@ namespace MiniCompiler
   **
   ** @param node The expression node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeExpression>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeExpression>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeOperation>::ptr op = node->getOperation();
     assert(op);
-    op->accept(*this);
+    derived().visit(op);
   }
 
   /*!
@@ -275,9 +398,9 @@ namespace MiniCompiler
   **
   ** @param node The string expression node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeStringExpr>::ptr)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeStringExpr>::ptr)
   {
   }
 
@@ -286,9 +409,9 @@ namespace MiniCompiler
   **
   ** @param node The boolean node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeBoolean>::ptr)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeBoolean>::ptr)
   {
   }
 
@@ -297,18 +420,18 @@ namespace MiniCompiler
   **
   ** @param node The expressions node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeExpressions>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeExpressions>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeExpression>::ptr expr = node->getExpr();
     typename ConstifyTrait<AST::NodeExpressions>::ptr exprs = node->getExprs();
     assert(expr);
 
-    expr->accept(*this);
+    derived().visit(expr);
     if (exprs)
-      exprs->accept(*this);
+      derived().visit(exprs);
   }
 
   /*!
@@ -316,9 +439,9 @@ namespace MiniCompiler
   **
   ** @param node The instruction node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeInstr>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeInstr>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeAffect>::ptr affect = node->getAffect();
@@ -344,31 +467,31 @@ namespace MiniCompiler
     assert(nb == 1);
 
     if (affect)
-      affect->accept(*this);
+      derived().visit(affect);
     else
       if (callFunc)
-	callFunc->accept(*this);
+	derived().visit(callFunc);
       else
 	if (compoundInstr)
-	  compoundInstr->accept(*this);
+	  derived().visit(compoundInstr);
 	else
 	  if (nIf)
-	    nIf->accept(*this);
+	    derived().visit(nIf);
 	  else
 	    if (nWhile)
-	      nWhile->accept(*this);
+	      derived().visit(nWhile);
 	    else
 	      if (nReturn)
-		nReturn->accept(*this);
+		derived().visit(nReturn);
 	      else
 		if (nExit)
-		  nExit->accept(*this);
+		  derived().visit(nExit);
 		else
 		  if (nPrint)
-		    nPrint->accept(*this);
+		    derived().visit(nPrint);
 		  else
 		    if (nRead)
-		      nRead->accept(*this);
+		      derived().visit(nRead);
   }
 
   /*!
@@ -376,14 +499,14 @@ namespace MiniCompiler
   **
   ** @param node The compound instruction node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeCompoundInstr>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeCompoundInstr>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeInstrs>::ptr instrs = node->getInstrs();
     if (instrs)
-      instrs->accept(*this);
+      derived().visit(instrs);
   }
 
   /*!
@@ -391,9 +514,9 @@ namespace MiniCompiler
   **
   ** @param node The factor node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeFactor>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeFactor>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeId>::ptr id = node->getId();
@@ -413,17 +536,17 @@ namespace MiniCompiler
     assert(nb == 1);
 
     if (id)
-      id->accept(*this);
+      derived().visit(id);
     else if (callFunc)
-      callFunc->accept(*this);
+      derived().visit(callFunc);
     else if (number)
-      number->accept(*this);
+      derived().visit(number);
     else if (stringExpr)
-      stringExpr->accept(*this);
+      derived().visit(stringExpr);
     else if (boolExpr)
-      boolExpr->accept(*this);
+      derived().visit(boolExpr);
     else if (expression)
-      expression->accept(*this);
+      derived().visit(expression);
   }
 
   /*!
@@ -431,18 +554,18 @@ namespace MiniCompiler
   **
   ** @param node The instructions node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeInstrs>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeInstrs>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeInstrs>::ptr instrs = node->getInstrs();
     typename ConstifyTrait<AST::NodeInstr>::ptr instr = node->getInstr();
     assert(instr);
 
-    instr->accept(*this);
+    derived().visit(instr);
     if (instrs)
-      instrs->accept(*this);
+      derived().visit(instrs);
   }
 
   /*!
@@ -450,9 +573,9 @@ namespace MiniCompiler
   **
   ** @param node The type node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeType>::ptr)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeType>::ptr)
   {
   }
 
@@ -461,9 +584,9 @@ namespace MiniCompiler
   **
   ** @param node The function node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeFunction>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeFunction>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeHeaderFunc>::ptr header = node->getHeaderFunc();
@@ -472,10 +595,10 @@ namespace MiniCompiler
     assert(header);
     assert(instr);
 
-    header->accept(*this);
+    derived().visit(header);
     if (decls)
-      decls->accept(*this);
-    instr->accept(*this);
+      derived().visit(decls);
+    derived().visit(instr);
   }
 
   /*!
@@ -483,9 +606,9 @@ namespace MiniCompiler
   **
   ** @param node The while node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeWhile>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeWhile>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeExpression>::ptr cond = node->getCond();
@@ -493,8 +616,8 @@ namespace MiniCompiler
     assert(cond);
     assert(body);
 
-    cond->accept(*this);
-    body->accept(*this);
+    derived().visit(cond);
+    derived().visit(body);
   }
 
   /*!
@@ -502,9 +625,9 @@ namespace MiniCompiler
   **
   ** @param node The ids node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeDeclarationBody>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeDeclarationBody>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeIds>::ptr ids = node->getIds();
@@ -512,8 +635,8 @@ namespace MiniCompiler
     assert(ids);
     assert(type);
 
-    ids->accept(*this);
-    type->accept(*this);
+    derived().visit(ids);
+    derived().visit(type);
   }
 
   /*!
@@ -521,17 +644,17 @@ namespace MiniCompiler
   **
   ** @param node The functions node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeFunctions>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeFunctions>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeFunction>::ptr func = node->getFunc();
     typename ConstifyTrait<AST::NodeFunctions>::ptr funcs = node->getFuncs();
     assert(func);
-    func->accept(*this);
+    derived().visit(func);
     if (funcs)
-      funcs->accept(*this);
+      derived().visit(funcs);
   }
 
   /*!
@@ -539,9 +662,9 @@ namespace MiniCompiler
   **
   ** @param node The number node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeNumber>::ptr)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeNumber>::ptr)
   {
   }
 
@@ -550,14 +673,14 @@ namespace MiniCompiler
   **
   ** @param node The declaration node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeDeclaration>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeDeclaration>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeDeclarationBody>::ptr body = node->getBody();
     assert(body);
-    body->accept(*this);
+    derived().visit(body);
   }
 
   /*!
@@ -565,9 +688,9 @@ namespace MiniCompiler
   **
   ** @param node The header function node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeHeaderFunc>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeHeaderFunc>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeIdFunc>::ptr id = node->getId();
@@ -576,10 +699,10 @@ namespace MiniCompiler
 
     assert(id);
     assert(type);
-    id->accept(*this);
+    derived().visit(id);
     if (args)
-      args->accept(*this);
-    type->accept(*this);
+      derived().visit(args);
+    derived().visit(type);
   }
 
   /*!
@@ -587,17 +710,17 @@ namespace MiniCompiler
   **
   ** @param node The declarations node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeDeclarations>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeDeclarations>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeDeclaration>::ptr decl = node->getDeclaration();
     assert(decl);
-    decl->accept(*this);
+    derived().visit(decl);
     typename ConstifyTrait<AST::NodeDeclarations>::ptr decls = node->getDeclarations();
     if (decls)
-      decls->accept(*this);
+      derived().visit(decls);
   }
 
   /*!
@@ -605,9 +728,9 @@ namespace MiniCompiler
   **
   ** @param node The id node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeId>::ptr)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeId>::ptr)
   {
   }
 
@@ -616,9 +739,9 @@ namespace MiniCompiler
   **
   ** @param node The function id node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeIdFunc>::ptr)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodeIdFunc>::ptr)
   {
   }
 
@@ -627,13 +750,13 @@ namespace MiniCompiler
   **
   ** @param node The print node
   */
-  template <template <typename T> class ConstifyTrait>
+  template <typename Derived, template <typename T> class ConstifyTrait>
   void
-  BaseVisitor<ConstifyTrait>::visit(typename ConstifyTrait<AST::NodePrint>::ptr node)
+  BaseVisitor<Derived, ConstifyTrait>::visit(typename ConstifyTrait<AST::NodePrint>::ptr node)
   {
     assert(node);
     typename ConstifyTrait<AST::NodeExpression>::ptr id = node->getExpr();
     assert(id);
-    id->accept(*this);
+    derived().visit(id);
   }
 }
@@ -5,9 +5,12 @@ namespace MiniCompiler
 {
   /*!
   ** Construct the binder.
+  **
+  ** @param jobs The maximum number of threads binding function bodies
   */
-  Binder::Binder()
+  Binder::Binder(const unsigned int jobs)
   {
+    _visitor.setJobs(jobs);
   }
 
   /*!
@@ -11,7 +11,7 @@ namespace MiniCompiler
   class Binder
   {
   public:
-    Binder();
+    Binder(const unsigned int jobs = 1);
     ~Binder();
     void bind(AST::NodeProgram* node);
     bool hasErrors() const;
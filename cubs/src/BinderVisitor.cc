@@ -1,4 +1,6 @@
+#include <vector>
 #include "BinderVisitor.hh"
+#include "ThreadPool.hh"
 #include "NodeIds.hh"
 #include "NodeProgram.hh"
 #include "NodeAffect.hh"
@@ -32,14 +34,43 @@
 
 namespace MiniCompiler
 {
+  namespace
+  {
+    /*!
+    ** Functions bound on a thread pool, each by its own visitor.
+    */
+    struct Functions
+    {
+      std::vector<AST::NodeFunction*>	nodes;
+      std::vector<BinderVisitor*>	visitors;
+    };
+  }
+
   /*!
   ** Construct the binder visitor, settings isDeclaration to false,
   ** _isArgument tu false and _currentFunction to null.
   ** Open the function and the variable scope.
   */
   BinderVisitor::BinderVisitor()
-    : _isDecl(false), _isArgument(false), _currentFunction(0)
+    : _isDecl(false), _isArgument(false), _currentFunction(0),
+      _global(0), _jobs(1)
+  {
+    _scopeVar.open();
+    _scopeFunc.open();
+  }
+
+  /*!
+  ** Construct a binder visitor for the body of a function only.
+  ** What isn't found in its own scopes is searched in the global
+  ** ones, which are only read.
+  **
+  ** @param global The visitor which bound globals and function headers
+  */
+  BinderVisitor::BinderVisitor(const BinderVisitor* global)
+    : _isDecl(false), _isArgument(false), _currentFunction(0),
+      _global(global), _jobs(1)
   {
+    assert(global);
     _scopeVar.open();
     _scopeFunc.open();
   }
@@ -54,6 +85,18 @@ namespace MiniCompiler
     _scopeFunc.close();
   }
 
+  /*!
+  ** Set the maximum number of threads binding function bodies.
+  **
+  ** @param jobs The number of threads, at least 1
+  */
+  void
+  BinderVisitor::setJobs(const unsigned int jobs)
+  {
+    assert(jobs > 0);
+    _jobs = jobs;
+  }
+
   /*!
   ** Get all errors encountered.
   **
@@ -100,13 +143,13 @@ namespace MiniCompiler
     _currentFunction = func;
 
     // Let's bind all function declaration
-    id->accept(*this);
+    visit(id);
 
     // If function has arguments, we bind it in advance
     _scopeVar.open();
     _isArgument = true;
     if (args)
-      args->accept(*this);
+      visit(args);
     _isArgument = false;
     _scopeVar.close();
 
@@ -118,6 +161,90 @@ namespace MiniCompiler
       visitFuncHeader(funcs);
   }
 
+  /*!
+  ** Bind each function body by its own visitor, on a thread pool.
+  ** Bodies only read the global scopes, complete once headers are
+  ** bound. Errors are then taken function by function, in order, so
+  ** they are the same as when bound by a single thread.
+  **
+  ** @param node The first functions node
+  **
+  ** @return If functions were bound, ie there are several of them
+  */
+  bool
+  BinderVisitor::visitInParallel(AST::NodeFunctions* node)
+  {
+    assert(node);
+    Functions functions;
+
+    for (; node; node = node->getFuncs())
+      functions.nodes.push_back(node->getFunc());
+    if (_jobs < 2 || functions.nodes.size() < 2)
+      return false;
+
+    for (unsigned int i = 0; i < functions.nodes.size(); i++)
+      functions.visitors.push_back(new BinderVisitor(this));
+    ThreadPool pool(_jobs);
+    pool.run(&BinderVisitor::launch, &functions, functions.nodes.size());
+    for (unsigned int i = 0; i < functions.visitors.size(); i++)
+    {
+      _errors.moveErrors(functions.visitors[i]->_errors);
+      delete functions.visitors[i];
+    }
+
+    return true;
+  }
+
+  /*!
+  ** Bind a function body, from a thread of the pool.
+  **
+  ** @param data The functions
+  ** @param i The number of the function to bind
+  */
+  void
+  BinderVisitor::launch(void* data, const unsigned int i)
+  {
+    Functions* functions = static_cast<Functions*>(data);
+
+    functions->visitors[i]->visit(functions->nodes[i]);
+  }
+
+  /*!
+  ** Find a declared variable, in all scopes.
+  **
+  ** @param name The name of the variable
+  **
+  ** @return The declaration of the variable, or null
+  */
+  AST::NodeId*
+  BinderVisitor::findVariable(const std::string& name) const
+  {
+    AST::NodeId* var = _scopeVar.getFromAll(name);
+
+    if (!var && _global)
+      var = _global->_scopeVar.getFromAll(name);
+
+    return var;
+  }
+
+  /*!
+  ** Find a declared function.
+  **
+  ** @param name The name of the function
+  **
+  ** @return The function, or null
+  */
+  AST::NodeFunction*
+  BinderVisitor::findFunction(const std::string& name) const
+  {
+    AST::NodeFunction* func = _scopeFunc.getFromAll(name);
+
+    if (!func && _global)
+      func = _global->_scopeFunc.getFromAll(name);
+
+    return func;
+  }
+
   /*!
   ** Bind the program node.
   **
@@ -129,16 +256,17 @@ namespace MiniCompiler
     assert(node);
     AST::NodeDeclarations* decls = node->getDecls();
     if (decls)
-      decls->accept(*this);
+      visit(decls);
     AST::NodeFunctions* funcs = node->getFuncs();
     if (funcs)
     {
       visitFuncHeader(funcs);
-      funcs->accept(*this);
+      if (!visitInParallel(funcs))
+	visit(funcs);
     }
     AST::NodeCompoundInstr* instrs = node->getInstrs();
     if (instrs)
-      instrs->accept(*this);
+      visit(instrs);
   }
 
   /*!
@@ -174,7 +302,7 @@ namespace MiniCompiler
     else
     {
       // Check that the function has been declared
-      AST::NodeFunction* var = _scopeFunc.getFromAll(node->getId());
+      AST::NodeFunction* var = findFunction(node->getId());
       if (var)
 	node->setRef(var);
       else
@@ -228,7 +356,7 @@ namespace MiniCompiler
     else
     {
       // Check that the variable has been declared
-      AST::NodeId* var = _scopeVar.getFromAll(node->getId());
+      AST::NodeId* var = findVariable(node->getId());
       if (var)
 	node->setRef(var);
       else
@@ -253,7 +381,7 @@ namespace MiniCompiler
 
     _isDecl = true;
     if (args)
-      args->accept(*this);
+      visit(args);
     _isDecl = false;
   }
 
@@ -267,7 +395,7 @@ namespace MiniCompiler
   {
     assert(node);
     _isDecl = true;
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
     _isDecl = false;
   }
 
@@ -283,7 +411,7 @@ namespace MiniCompiler
     assert(node);
     _scopeVar.open();
     _currentFunction = node;
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
     _currentFunction = 0;
     _scopeVar.close();
   }
@@ -309,7 +437,7 @@ namespace MiniCompiler
 
     // We are in a function, so bind return to it
     node->setRefFunc(_currentFunction);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -321,7 +449,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeCallFunc* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
 
     // So let's get all expr to fill call func arguments
     AST::NodeExpressions* exprs = node->getExprs();
@@ -367,7 +495,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeExit* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -379,7 +507,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeCompoundInstr* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -391,7 +519,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeFunctions* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -403,7 +531,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeAffect* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -415,7 +543,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeIf* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -427,7 +555,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeRead* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -439,7 +567,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeArgument* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -451,7 +579,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeArguments* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -463,7 +591,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeOperation* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -475,7 +603,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeExpression* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -487,7 +615,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeStringExpr* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -499,7 +627,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeBoolean* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -511,7 +639,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeExpressions* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -523,7 +651,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeInstr* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -535,7 +663,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeFactor* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -547,7 +675,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeInstrs* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -559,7 +687,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeType* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -571,7 +699,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeWhile* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -583,7 +711,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeDeclarationBody* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -595,7 +723,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeNumber* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -607,7 +735,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeDeclaration* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -619,7 +747,7 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodePrint* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 
   /*!
@@ -631,6 +759,6 @@ namespace MiniCompiler
   BinderVisitor::visit(AST::NodeIds* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<BinderVisitor>::visit(node);
   }
 }
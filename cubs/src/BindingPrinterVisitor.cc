@@ -88,7 +88,7 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
     _indent << cfg["return"] << " /* " << node->getRefFunc() << " */ ";
-    expr->accept(*this);
+    visit(expr);
   }
 
   /*!
@@ -108,12 +108,12 @@ namespace MiniCompiler
     assert(id);
     assert(type);
     _indent << Utils::stringFill(SPACING_CHAR, _tab);
-    id->accept(*this);
+    visit(id);
     _indent << cfg["("];
     if (args)
-      args->accept(*this);
+      visit(args);
     _indent << cfg[")"] << ' ' << cfg[":"] << ' ';
-    type->accept(*this);
+    visit(type);
     _indent << cfg[";"] << '\n';
   }
 
@@ -131,7 +131,7 @@ namespace MiniCompiler
       " */ " << cfg["("] << cfg[")"] <<
       " " << cfg[":"] << " " << cfg["int"] << cfg[";"] << "\n" <<
       cfg["begin"] << "\n";
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
     _indent << cfg["end"] << '\n';
   }
 
@@ -148,7 +148,7 @@ namespace MiniCompiler
     const AST::NodeIdFunc* id = node->getId();
     assert(id);
 
-    id->accept(*this);
+    visit(id);
     _indent << cfg["("];
 
     // Let's show all binded arguments
@@ -159,7 +159,7 @@ namespace MiniCompiler
     {
       expr = exprs->getExpr();
       assert(expr);
-      expr->accept(*this);
+      visit(expr);
       exprs = exprs->getExprs();
 
       // Firstly, check that's function was binded correctly
@@ -201,10 +201,10 @@ namespace MiniCompiler
       _indent << Utils::stringFill(SPACING_CHAR, _tab + INDENT_SIZE) << "** "
 	      << node->getArgument(i) << "\n";
     _indent << Utils::stringFill(SPACING_CHAR, _tab + INDENT_SIZE) << "*/\n";
-    header->accept(*this);
+    visit(header);
     if (decls)
-      decls->accept(*this);
-    instr->accept(*this);
+      visit(decls);
+    visit(instr);
     _indent << '\n';
   }
 
@@ -221,7 +221,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeIds* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -233,7 +233,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeExit* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -245,7 +245,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeAffect* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -257,7 +257,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeIf* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -269,7 +269,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeRead* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -281,7 +281,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeArgument* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -293,7 +293,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeArguments* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -305,7 +305,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeOperation* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -317,7 +317,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeExpression* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -329,7 +329,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeStringExpr* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -341,7 +341,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeBoolean* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -353,7 +353,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeExpressions* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -365,7 +365,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeInstr* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -377,7 +377,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeCompoundInstr* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -389,7 +389,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeFactor* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -401,7 +401,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeInstrs* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -413,7 +413,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeType* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -425,7 +425,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeWhile* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -437,7 +437,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeDeclarationBody* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -449,7 +449,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeFunctions* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -461,7 +461,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeNumber* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -473,7 +473,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeDeclaration* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -485,7 +485,7 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodeDeclarations* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -497,6 +497,6 @@ namespace MiniCompiler
   BindingPrinterVisitor::visit(const AST::NodePrint* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<BindingPrinterVisitor>::visit(node);
   }
 }
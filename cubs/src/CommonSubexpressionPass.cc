@@ -0,0 +1,42 @@
+#include <cassert>
+#include "CommonSubexpressionPass.hh"
+#include "CommonSubexpressionVisitor.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct the common subexpression pass, used from level 2.
+  ** Literals are folded first, and impure calls end a sequence, so
+  ** purity of functions is needed.
+  */
+  CommonSubexpressionPass::CommonSubexpressionPass()
+    : Pass("common-subexpression", false, 2)
+  {
+    addDependency("constant-folding");
+    addDependency("purity");
+  }
+
+  /*!
+  ** Destruct the common subexpression pass.
+  */
+  CommonSubexpressionPass::~CommonSubexpressionPass()
+  {
+  }
+
+  /*!
+  ** Reuse operations already computed in the given AST.
+  **
+  ** @param tree The root of the AST
+  **
+  ** @return The number of deduplicated nodes
+  */
+  unsigned int
+  CommonSubexpressionPass::run(AST::NodeProgram* tree)
+  {
+    assert(tree);
+    CommonSubexpressionVisitor visitor;
+    visitor.visit(tree);
+
+    return visitor.nbDeduplicated();
+  }
+}
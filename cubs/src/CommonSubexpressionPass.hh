@@ -0,0 +1,21 @@
+#ifndef COMMONSUBEXPRESSIONPASS_HH_
+# define COMMONSUBEXPRESSIONPASS_HH_
+
+# include "Pass.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Transformation reusing already computed operations,
+  ** see CommonSubexpressionVisitor.
+  */
+  class CommonSubexpressionPass : public Pass
+  {
+  public:
+    CommonSubexpressionPass();
+    virtual ~CommonSubexpressionPass();
+    virtual unsigned int run(AST::NodeProgram* tree);
+  };
+}
+
+#endif /* !COMMONSUBEXPRESSIONPASS_HH_ */
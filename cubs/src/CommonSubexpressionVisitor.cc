@@ -0,0 +1,661 @@
+#include <sstream>
+#include "CommonSubexpressionVisitor.hh"
+#include "Utils.hh"
+#include "NodeProgram.hh"
+#include "NodeFunctions.hh"
+#include "NodeFunction.hh"
+#include "NodeDeclarations.hh"
+#include "NodeDeclaration.hh"
+#include "NodeDeclarationBody.hh"
+#include "NodeIds.hh"
+#include "NodeId.hh"
+#include "NodeIdFunc.hh"
+#include "NodeType.hh"
+#include "NodeCompoundInstr.hh"
+#include "NodeInstrs.hh"
+#include "NodeInstr.hh"
+#include "NodeAffect.hh"
+#include "NodePrint.hh"
+#include "NodeRead.hh"
+#include "NodeReturn.hh"
+#include "NodeExit.hh"
+#include "NodeIf.hh"
+#include "NodeWhile.hh"
+#include "NodeCallFunc.hh"
+#include "NodeExpressions.hh"
+#include "NodeExpression.hh"
+#include "NodeOperation.hh"
+#include "NodeFactor.hh"
+#include "NodeNumber.hh"
+#include "NodeBoolean.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct the common subexpression visitor.
+  */
+  CommonSubexpressionVisitor::CommonSubexpressionVisitor()
+    : _program(0), _currentFunction(0), _nbTemporaries(0), _nbDeduplicated(0)
+  {
+  }
+
+  /*!
+  ** Destruct the common subexpression visitor.
+  */
+  CommonSubexpressionVisitor::~CommonSubexpressionVisitor()
+  {
+  }
+
+  /*!
+  ** Get the number of deleted nodes, ie nodes of repeated operations.
+  **
+  ** @return The number of deduplicated nodes
+  */
+  unsigned int
+  CommonSubexpressionVisitor::nbDeduplicated() const
+  {
+    return _nbDeduplicated;
+  }
+
+  /*!
+  ** Collect all names first, so temporaries can't hide a variable.
+  ** Then optimize each function, and the main block.
+  **
+  ** @param node The program node
+  */
+  void
+  CommonSubexpressionVisitor::visit(AST::NodeProgram* node)
+  {
+    assert(node);
+    _program = node;
+    NonConstBaseVisitor<CommonSubexpressionVisitor>::visit(node);
+
+    for (AST::NodeFunctions* funcs = node->getFuncs(); funcs;
+	 funcs = funcs->getFuncs())
+    {
+      _currentFunction = funcs->getFunc();
+      assert(_currentFunction);
+      optimize(_currentFunction->getCompoundInstr());
+    }
+    _currentFunction = 0;
+    optimize(node->getInstrs());
+  }
+
+  /*!
+  ** Remember a variable name.
+  **
+  ** @param node The id node
+  */
+  void
+  CommonSubexpressionVisitor::visit(AST::NodeId* node)
+  {
+    assert(node);
+    _names.insert(node->getId());
+  }
+
+  /*!
+  ** Remember a function name.
+  **
+  ** @param node The function id node
+  */
+  void
+  CommonSubexpressionVisitor::visit(AST::NodeIdFunc* node)
+  {
+    assert(node);
+    _names.insert(node->getId());
+  }
+
+  /*!
+  ** Number each instruction of a block. A nested block starts a new
+  ** sequence, and ends the current one.
+  **
+  ** @param node The block
+  */
+  void
+  CommonSubexpressionVisitor::optimize(AST::NodeCompoundInstr* node)
+  {
+    clear();
+    if (!node)
+      return;
+
+    AST::NodeInstrs* next = 0;
+    for (AST::NodeInstrs* instrs = node->getInstrs(); instrs; instrs = next)
+    {
+      // Temporaries may be inserted before the current instruction
+      next = instrs->getInstrs();
+      AST::NodeInstr* instr = instrs->getInstr();
+      if (!instr)
+	continue;
+      _positions[instr] = instrs;
+      optimize(instr);
+    }
+    clear();
+  }
+
+  /*!
+  ** Number expressions of an instruction, then forget values it modifies.
+  **
+  ** @param instr The instruction
+  */
+  void
+  CommonSubexpressionVisitor::optimize(AST::NodeInstr* instr)
+  {
+    assert(instr);
+    AST::NodeExpression* expr = 0;
+
+    if (instr->getAffect())
+      expr = instr->getAffect()->getExpr();
+    else if (instr->getPrint())
+      expr = instr->getPrint()->getExpr();
+    else if (instr->getReturn())
+      expr = instr->getReturn()->getExpr();
+    else if (instr->getExit())
+      expr = instr->getExit()->getExpr();
+    else if (instr->getRead())
+    {
+      assert(instr->getRead()->getId());
+      kill(instr->getRead()->getId()->getRef());
+      return;
+    }
+    else if (instr->getCallFunc())
+    {
+      if (hasSideEffects(instr->getCallFunc()))
+	clear();
+      return;
+    }
+    else if (instr->getIf())
+    {
+      optimize(instr->getIf()->getBodyExprs());
+      optimize(instr->getIf()->getElseExprs());
+      return;
+    }
+    else if (instr->getWhile())
+    {
+      optimize(instr->getWhile()->getBodyExprs());
+      return;
+    }
+    else if (instr->getCompoundInstr())
+    {
+      optimize(instr->getCompoundInstr());
+      return;
+    }
+
+    if (!expr)
+      return;
+    if (hasSideEffects(expr))
+    {
+      clear();
+      return;
+    }
+
+    number(expr, instr);
+    if (instr->getAffect())
+    {
+      assert(instr->getAffect()->getId());
+      kill(instr->getAffect()->getId()->getRef());
+    }
+  }
+
+  /*!
+  ** Replace an already computed operation by its temporary, or
+  ** number its factors and remember it.
+  **
+  ** @param expr The expression to number
+  ** @param instr The instruction it belongs to
+  */
+  void
+  CommonSubexpressionVisitor::number(AST::NodeExpression* expr,
+				     AST::NodeInstr* instr)
+  {
+    assert(expr);
+    assert(instr);
+    AST::NodeOperation* op = expr->getOperation();
+    assert(op);
+    std::string key;
+    Variables variables;
+
+    if (op->getOpType() != AST::Operator::NONE &&
+	computeKey(op, key, variables))
+    {
+      Values::iterator found = _values.find(key);
+      if (found != _values.end())
+      {
+	reuse(key, found->second, expr);
+	return;
+      }
+    }
+    else
+      key.clear();
+
+    AST::NodeFactor* left = op->getLeftFactor();
+    AST::NodeFactor* right = op->getRightFactor();
+    if (left && left->getExpression())
+      number(left->getExpression(), instr);
+    if (right && right->getExpression())
+      number(right->getExpression(), instr);
+
+    if (key.empty())
+      return;
+    Value value;
+    value.expr = expr;
+    value.instr = instr;
+    value.temporary = 0;
+    value.variables = variables;
+    _values[key] = value;
+    _keys[expr] = key;
+  }
+
+  /*!
+  ** Compute the key of an operation. Two operations with the same key
+  ** compute the same value, as long as their variables are unchanged.
+  **
+  ** @param op The operation node
+  ** @param key The key to fill
+  ** @param variables The variables used, to fill
+  **
+  ** @return False if the operation can't be reused
+  */
+  bool
+  CommonSubexpressionVisitor::computeKey(const AST::NodeOperation* op,
+					 std::string& key,
+					 Variables& variables) const
+  {
+    assert(op);
+    const AST::NodeFactor* left = op->getLeftFactor();
+    const AST::NodeFactor* right = op->getRightFactor();
+    assert(left);
+
+    if (op->getOpType() == AST::Operator::NONE)
+      return computeKey(left, key, variables);
+
+    if (op->getComputedType() != AST::Type::INTEGER &&
+	op->getComputedType() != AST::Type::BOOLEAN)
+      return false;
+    assert(right);
+    if ((op->getOpType() == AST::Operator::DIV ||
+	 op->getOpType() == AST::Operator::MODULO) &&
+	(!right->getNumber() || right->getNumber()->getNumber() == 0))
+      return false;
+
+    key += '(';
+    if (!computeKey(left, key, variables))
+      return false;
+    key += Utils::intToString(op->getOpType());
+    if (!computeKey(right, key, variables))
+      return false;
+    key += ')';
+
+    return true;
+  }
+
+  /*!
+  ** Compute the key of a factor. A temporary has the key of the
+  ** operation it stores.
+  **
+  ** @param factor The factor node
+  ** @param key The key to fill
+  ** @param variables The variables used, to fill
+  **
+  ** @return False if the factor can't be reused
+  */
+  bool
+  CommonSubexpressionVisitor::computeKey(const AST::NodeFactor* factor,
+					 std::string& key,
+					 Variables& variables) const
+  {
+    assert(factor);
+    if (factor->getId())
+    {
+      const AST::NodeId* ref = factor->getId()->getRef();
+      assert(ref);
+      Temporaries::const_iterator temporary = _temporaries.find(ref);
+      if (temporary != _temporaries.end())
+      {
+	key += temporary->second.first;
+	variables.insert(temporary->second.second.begin(),
+			 temporary->second.second.end());
+	return true;
+      }
+      std::stringstream buf;
+      buf << 'v' << ref;
+      key += buf.str();
+      variables.insert(ref);
+      return true;
+    }
+
+    if (factor->getNumber())
+    {
+      key += 'n' + Utils::intToString(factor->getNumber()->getNumber());
+      return true;
+    }
+
+    if (factor->getBool())
+    {
+      key += factor->getBool()->getBool() ? "b1" : "b0";
+      return true;
+    }
+
+    if (factor->getExpression())
+    {
+      assert(factor->getExpression()->getOperation());
+      return computeKey(factor->getExpression()->getOperation(),
+			key, variables);
+    }
+
+    return false;
+  }
+
+  /*!
+  ** Replace a repeated operation by the temporary holding its value,
+  ** creating this temporary on the first repetition.
+  **
+  ** @param key The key of the operation
+  ** @param value The first computation of the operation
+  ** @param expr The expression holding the repeated operation
+  */
+  void
+  CommonSubexpressionVisitor::reuse(const std::string& key, Value& value,
+				    AST::NodeExpression* expr)
+  {
+    assert(expr);
+    if (!value.temporary)
+      createTemporary(key, value);
+
+    AST::NodeOperation* op = expr->getOperation();
+    _nbDeduplicated += countNodes(op);
+    expr->setOperation(createReference(value.temporary));
+    delete op;
+  }
+
+  /*!
+  ** Move the first computation of an operation into a new temporary,
+  ** assigned just before the instruction using it.
+  **
+  ** @param key The key of the operation
+  ** @param value The first computation of the operation
+  */
+  void
+  CommonSubexpressionVisitor::createTemporary(const std::string& key,
+					      Value& value)
+  {
+    assert(value.expr);
+    assert(!value.temporary);
+    AST::NodeExpression* first = value.expr;
+    AST::NodeOperation* op = first->getOperation();
+    assert(op);
+    const AST::Type::type type = op->getComputedType();
+    const unsigned int line = value.instr->getLine();
+
+    std::string name;
+    do
+      name = "cse" + Utils::intToString(++_nbTemporaries);
+    while (_names.find(name) != _names.end());
+    _names.insert(name);
+
+    AST::NodeId* temporary = new AST::NodeId;
+    temporary->setId(name);
+    temporary->setDeclaration(true);
+    temporary->setRef(temporary);
+    temporary->setComputedType(type);
+    temporary->setLine(line);
+    declare(temporary);
+
+    AST::NodeExpression* moved = new AST::NodeExpression;
+    moved->setOperation(op);
+    moved->setComputedType(first->getComputedType());
+    moved->setLine(line);
+    first->setOperation(createReference(temporary));
+
+    AST::NodeId* id = new AST::NodeId;
+    id->setId(name);
+    id->setRef(temporary);
+    id->setComputedType(type);
+    id->setLine(line);
+    AST::NodeAffect* affect = new AST::NodeAffect;
+    affect->setId(id);
+    affect->setExpr(moved);
+    affect->setLine(line);
+    AST::NodeInstr* instr = new AST::NodeInstr;
+    instr->setAffect(affect);
+    instr->setLine(line);
+
+    insertBefore(value.instr, instr);
+    moveValues(moved, instr);
+    _temporaries[temporary] = Definition(key, value.variables);
+    value.temporary = temporary;
+  }
+
+  /*!
+  ** Create an operation only reading the given temporary.
+  **
+  ** @param temporary The temporary declaration
+  **
+  ** @return The new operation
+  */
+  AST::NodeOperation*
+  CommonSubexpressionVisitor::createReference(AST::NodeId* temporary) const
+  {
+    assert(temporary);
+    AST::NodeId* id = new AST::NodeId;
+    id->setId(temporary->getId());
+    id->setRef(temporary);
+    id->setComputedType(temporary->getComputedType());
+    id->setLine(temporary->getLine());
+    AST::NodeFactor* factor = new AST::NodeFactor;
+    factor->setId(id);
+    factor->setComputedType(temporary->getComputedType());
+    factor->setLine(temporary->getLine());
+    AST::NodeOperation* op = new AST::NodeOperation;
+    op->setLeftFactor(factor);
+    op->setComputedType(temporary->getComputedType());
+    op->setLine(temporary->getLine());
+
+    return op;
+  }
+
+  /*!
+  ** Declare a temporary at the end of the current function declarations,
+  ** or with global variables in the main block.
+  **
+  ** @param id The temporary declaration
+  */
+  void
+  CommonSubexpressionVisitor::declare(AST::NodeId* id)
+  {
+    assert(id);
+    assert(_program);
+    AST::NodeIds* ids = new AST::NodeIds;
+    ids->setId(id);
+    AST::NodeType* type = new AST::NodeType;
+    type->setType(Utils::typeToString(id->getComputedType()));
+    type->setComputedType(id->getComputedType());
+    AST::NodeDeclarationBody* body = new AST::NodeDeclarationBody;
+    body->setIds(ids);
+    body->setType(type);
+    AST::NodeDeclaration* decl = new AST::NodeDeclaration;
+    decl->setBody(body);
+    decl->setLine(id->getLine());
+    AST::NodeDeclarations* decls = new AST::NodeDeclarations;
+    decls->setDeclaration(decl);
+
+    AST::NodeDeclarations* last = _currentFunction ?
+      _currentFunction->getDeclarations() : _program->getDecls();
+    if (!last)
+    {
+      if (_currentFunction)
+	_currentFunction->setDeclarations(decls);
+      else
+	_program->setDecls(decls);
+      return;
+    }
+    while (last->getDeclarations())
+      last = last->getDeclarations();
+    last->setDeclarations(decls);
+  }
+
+  /*!
+  ** Insert an instruction before another one of the current sequence.
+  ** The chain node of the position now holds the new instruction.
+  **
+  ** @param position The instruction to insert before
+  ** @param instr The instruction to insert
+  */
+  void
+  CommonSubexpressionVisitor::insertBefore(AST::NodeInstr* position,
+					   AST::NodeInstr* instr)
+  {
+    Positions::iterator it = _positions.find(position);
+    assert(it != _positions.end());
+    AST::NodeInstrs* at = it->second;
+    AST::NodeInstrs* rest = new AST::NodeInstrs;
+
+    rest->setInstr(position);
+    rest->setInstrs(at->getInstrs());
+    rest->setLine(at->getLine());
+    at->setInstr(instr);
+    at->setInstrs(rest);
+    it->second = rest;
+    _positions[instr] = at;
+  }
+
+  /*!
+  ** Operations moved into a temporary assignment are now computed
+  ** by this assignment.
+  **
+  ** @param expr The moved expression
+  ** @param instr The temporary assignment
+  */
+  void
+  CommonSubexpressionVisitor::moveValues(AST::NodeExpression* expr,
+					 AST::NodeInstr* instr)
+  {
+    assert(expr);
+    Keys::const_iterator key = _keys.find(expr);
+    if (key != _keys.end())
+    {
+      Values::iterator value = _values.find(key->second);
+      if (value != _values.end() && value->second.expr == expr)
+	value->second.instr = instr;
+    }
+
+    AST::NodeOperation* op = expr->getOperation();
+    assert(op);
+    if (op->getLeftFactor() && op->getLeftFactor()->getExpression())
+      moveValues(op->getLeftFactor()->getExpression(), instr);
+    if (op->getRightFactor() && op->getRightFactor()->getExpression())
+      moveValues(op->getRightFactor()->getExpression(), instr);
+  }
+
+  /*!
+  ** Forget all values using a modified variable.
+  **
+  ** @param id The declaration of the modified variable
+  */
+  void
+  CommonSubexpressionVisitor::kill(const AST::NodeId* id)
+  {
+    assert(id);
+    Values::iterator it = _values.begin();
+    while (it != _values.end())
+      if (it->second.variables.find(id) != it->second.variables.end())
+	_values.erase(it++);
+      else
+	++it;
+  }
+
+  /*!
+  ** Forget all values, at the end of a sequence.
+  */
+  void
+  CommonSubexpressionVisitor::clear()
+  {
+    _values.clear();
+    _keys.clear();
+    _positions.clear();
+  }
+
+  /*!
+  ** Check if an expression calls an impure function.
+  **
+  ** @param expr The expression node
+  **
+  ** @return If evaluating it may modify a variable or display something
+  */
+  bool
+  CommonSubexpressionVisitor::hasSideEffects(const AST::NodeExpression* expr)
+  {
+    assert(expr);
+    const AST::NodeOperation* op = expr->getOperation();
+    assert(op);
+    const AST::NodeFactor* factors[] =
+      { op->getLeftFactor(), op->getRightFactor() };
+
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      if (!factors[i])
+	continue;
+      if (factors[i]->getExpression() &&
+	  hasSideEffects(factors[i]->getExpression()))
+	return true;
+      if (factors[i]->getCallFunc() &&
+	  hasSideEffects(factors[i]->getCallFunc()))
+	return true;
+    }
+
+    return false;
+  }
+
+  /*!
+  ** Check if a call, or one of its arguments, calls an impure function.
+  **
+  ** @param call The function call node
+  **
+  ** @return If the call may modify a variable or display something
+  */
+  bool
+  CommonSubexpressionVisitor::hasSideEffects(const AST::NodeCallFunc* call)
+  {
+    assert(call);
+    assert(call->getId());
+    const AST::NodeFunction* func = call->getId()->getRef();
+    assert(func);
+    if (!func->isPure())
+      return true;
+
+    for (const AST::NodeExpressions* exprs = call->getExprs(); exprs;
+	 exprs = exprs->getExprs())
+      if (exprs->getExpr() && hasSideEffects(exprs->getExpr()))
+	return true;
+
+    return false;
+  }
+
+  /*!
+  ** Count nodes of an operation which can be reused, ie made of
+  ** variables, literals and other operations.
+  **
+  ** @param op The operation node
+  **
+  ** @return The number of nodes
+  */
+  unsigned int
+  CommonSubexpressionVisitor::countNodes(const AST::NodeOperation* op)
+  {
+    assert(op);
+    const AST::NodeFactor* factors[] =
+      { op->getLeftFactor(), op->getRightFactor() };
+    unsigned int nb = 1;
+
+    for (unsigned int i = 0; i < 2; ++i)
+      if (factors[i])
+      {
+	if (factors[i]->getExpression())
+	  nb += 1 + countNodes(factors[i]->getExpression()->getOperation());
+	else
+	  nb += 1;
+	nb += 1;
+      }
+
+    return nb;
+  }
+}
@@ -0,0 +1,89 @@
+#ifndef COMMONSUBEXPRESSIONVISITOR_HH_
+# define COMMONSUBEXPRESSIONVISITOR_HH_
+
+# include <cassert>
+# include <map>
+# include <set>
+# include <string>
+# include <utility>
+# include "BaseVisitor.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Local value numbering: inside a sequence of instructions without
+  ** control flow, an operation computed twice on the same values is
+  ** stored into a temporary variable, computed once before its first use.
+  ** Repeated subtrees are deleted and replaced by the temporary.
+  ** Operations calling a function, or which may fail (division or modulo
+  ** by a non literal), are kept. An impure call ends the sequence.
+  ** Purity of functions must already be known.
+  */
+  class CommonSubexpressionVisitor : public NonConstBaseVisitor<CommonSubexpressionVisitor>
+  {
+    typedef std::set<const AST::NodeId*> Variables;
+    typedef std::set<std::string> Names;
+
+    /*!
+    ** An already computed operation, and where it is computed.
+    */
+    struct Value
+    {
+      AST::NodeExpression*	expr;
+      AST::NodeInstr*		instr;
+      AST::NodeId*		temporary;
+      Variables			variables;
+    };
+
+    typedef std::map<std::string, Value> Values;
+    typedef std::map<AST::NodeExpression*, std::string> Keys;
+    typedef std::map<AST::NodeInstr*, AST::NodeInstrs*> Positions;
+    typedef std::pair<std::string, Variables> Definition;
+    typedef std::map<const AST::NodeId*, Definition> Temporaries;
+
+  public:
+    CommonSubexpressionVisitor();
+    ~CommonSubexpressionVisitor();
+    using NonConstBaseVisitor<CommonSubexpressionVisitor>::visit;
+    void visit(AST::NodeProgram* node);
+    void visit(AST::NodeId* node);
+    void visit(AST::NodeIdFunc* node);
+
+  public:
+    unsigned int nbDeduplicated() const;
+
+  private:
+    void optimize(AST::NodeCompoundInstr* node);
+    void optimize(AST::NodeInstr* instr);
+    void number(AST::NodeExpression* expr, AST::NodeInstr* instr);
+    bool computeKey(const AST::NodeOperation* op, std::string& key,
+		    Variables& variables) const;
+    bool computeKey(const AST::NodeFactor* factor, std::string& key,
+		    Variables& variables) const;
+    void reuse(const std::string& key, Value& value,
+	       AST::NodeExpression* expr);
+    void createTemporary(const std::string& key, Value& value);
+    AST::NodeOperation* createReference(AST::NodeId* temporary) const;
+    void declare(AST::NodeId* id);
+    void insertBefore(AST::NodeInstr* position, AST::NodeInstr* instr);
+    void moveValues(AST::NodeExpression* expr, AST::NodeInstr* instr);
+    void kill(const AST::NodeId* id);
+    void clear();
+    static bool hasSideEffects(const AST::NodeExpression* expr);
+    static bool hasSideEffects(const AST::NodeCallFunc* call);
+    static unsigned int countNodes(const AST::NodeOperation* op);
+
+  private:
+    AST::NodeProgram*	_program;
+    AST::NodeFunction*	_currentFunction;
+    Names		_names;
+    Values		_values;
+    Keys		_keys;
+    Positions		_positions;
+    Temporaries		_temporaries;
+    unsigned int	_nbTemporaries;
+    unsigned int	_nbDeduplicated;
+  };
+}
+
+#endif /* !COMMONSUBEXPRESSIONVISITOR_HH_ */
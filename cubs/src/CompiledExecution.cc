@@ -0,0 +1,356 @@
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "CompiledExecution.hh"
+#include "ConvertToCppVisitor.hh"
+#include "Execution.hh"
+#include "ExecutionVisitor.hh"
+
+namespace MiniCompiler
+{
+  namespace
+  {
+    /*!
+    ** The compiler command, without its input and output.
+    ** Integers wrap around, like in the execution, and warnings about the
+    ** generated code are useless.
+    */
+    const char* const COMPILER[] =
+      {
+	"c++", "-O2", "-fwrapv", "-w", "-shared", "-fPIC", 0
+      };
+
+    const unsigned long long FNV_OFFSET = 14695981039346656037ULL;
+    const unsigned long long FNV_PRIME = 1099511628211ULL;
+
+    /*!
+    ** Hash a string with FNV-1a, on 64 bits.
+    **
+    ** @param s The string
+    ** @param h The hash of what precedes it
+    **
+    ** @return The new hash
+    */
+    unsigned long long
+    hash(const std::string& s, unsigned long long h)
+    {
+      for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+      {
+	h ^= static_cast<unsigned char>(*i);
+	h *= FNV_PRIME;
+      }
+      return h;
+    }
+
+    /*!
+    ** Create a directory and its parents, if missing.
+    **
+    ** @param path The directory
+    **
+    ** @return If the directory exists
+    */
+    bool
+    makeDirectory(const std::string& path)
+    {
+      for (size_t i = 1; i <= path.length(); ++i)
+	if (i == path.length() || path[i] == '/')
+	  if (mkdir(path.substr(0, i).c_str(), 0755) != 0 && errno != EEXIST)
+	    return false;
+      return true;
+    }
+
+    /*!
+    ** Read a whole file.
+    **
+    ** @param path The file
+    ** @param content The content to fill
+    **
+    ** @return If the file could be read
+    */
+    bool
+    readFile(const std::string& path, std::string& content)
+    {
+      std::ifstream file(path.c_str(), std::ios::binary);
+      std::stringstream buffer;
+
+      if (!file)
+	return false;
+      buffer << file.rdbuf();
+      content = buffer.str();
+      return true;
+    }
+
+    /*!
+    ** Write a whole file.
+    **
+    ** @param path The file
+    ** @param content The content
+    **
+    ** @return If the file could be written
+    */
+    bool
+    writeFile(const std::string& path, const std::string& content)
+    {
+      std::ofstream file(path.c_str(), std::ios::binary);
+
+      file << content;
+      file.close();
+      return !file.fail();
+    }
+  }
+
+  /*!
+  ** Construct a compiled execution, with nothing loaded.
+  */
+  CompiledExecution::CompiledExecution()
+    : _handle(0), _entry(0), _maxDepth(ExecutionVisitor::DEFAULT_MAX_DEPTH),
+      _result(0)
+  {
+  }
+
+  /*!
+  ** Destruct a compiled execution, unloading the shared object.
+  */
+  CompiledExecution::~CompiledExecution()
+  {
+    release();
+  }
+
+  /*!
+  ** Load the shared object of the code, compiling it first if it isn't
+  ** in the cache. The code is kept next to the shared object, so a hash
+  ** collision only costs a compilation.
+  **
+  ** @param code The C++ code, generated for a host
+  **
+  ** @return If the code was loaded, else see getErrorMessage
+  */
+  bool
+  CompiledExecution::load(const std::string& code)
+  {
+    release();
+    const std::string directory = cacheDirectory();
+    if (directory.empty() || !makeDirectory(directory))
+    {
+      _error = "Can't create the cache directory " + directory;
+      return false;
+    }
+
+    unsigned long long h = FNV_OFFSET;
+    for (const char* const* arg = COMPILER; *arg; ++arg)
+      h = hash(std::string(*arg) + ' ', h);
+    h = hash(code, h);
+    std::ostringstream name;
+    name << directory << '/' << std::hex << std::setw(16) << std::setfill('0')
+	 << h;
+    const std::string base = name.str();
+
+    std::string cached;
+    if (!readFile(base + ".cc", cached) || cached != code ||
+	access((base + ".so").c_str(), R_OK) != 0)
+      if (!compile(code, base))
+	return false;
+
+    _handle = dlopen((base + ".so").c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!_handle)
+    {
+      _error = dlerror();
+      return false;
+    }
+    void* entry = dlsym(_handle, ConvertToCppVisitor::ENTRY);
+    if (!entry)
+    {
+      _error = "No entry in " + base + ".so";
+      release();
+      return false;
+    }
+    _entry = reinterpret_cast<Entry>(entry);
+
+    return true;
+  }
+
+  /*!
+  ** Run the loaded program on a dedicated stack, big enough for the
+  ** maximum call depth.
+  **
+  ** @return The exiting value of the program
+  */
+  int
+  CompiledExecution::execute()
+  {
+    assert(_entry);
+    const size_t size = Execution::STACK_MARGIN +
+      static_cast<size_t>(_maxDepth) * Execution::STACK_SIZE_PER_CALL;
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    _error.clear();
+    _result = 0;
+    pthread_attr_init(&attr);
+    if (pthread_attr_setstacksize(&attr, size) == 0 &&
+	pthread_create(&thread, &attr, &CompiledExecution::launch, this) == 0)
+      pthread_join(thread, 0);
+    else
+      launch(this);
+    pthread_attr_destroy(&attr);
+
+    if (!_error.empty())
+      throw Error::EXECUTION;
+
+    return _result;
+  }
+
+  /*!
+  ** Set the maximum number of nested function calls, checked by the
+  ** program, and used to size its stack.
+  **
+  ** @param depth The maximum call depth
+  */
+  void
+  CompiledExecution::setMaxDepth(unsigned int depth)
+  {
+    _maxDepth = depth;
+  }
+
+  /*!
+  ** Get the message of the error which stopped loading or execution.
+  **
+  ** @return The error message
+  */
+  const std::string&
+  CompiledExecution::getErrorMessage() const
+  {
+    return _error;
+  }
+
+  /*!
+  ** Compile the code into the cache. Files are first written under a
+  ** name of their own, then renamed, so concurrent compilations of the
+  ** same code never see a partial file.
+  ** The output of the compiler goes to stderr.
+  **
+  ** @param code The C++ code
+  ** @param base The path of the files in the cache, without extension
+  **
+  ** @return If the code was compiled
+  */
+  bool
+  CompiledExecution::compile(const std::string& code, const std::string& base)
+  {
+    std::ostringstream temporary;
+    temporary << base << '.' << getpid();
+    const std::string source = temporary.str() + ".cc";
+    const std::string object = temporary.str() + ".so";
+
+    if (!writeFile(source, code))
+    {
+      _error = "Can't write " + source;
+      unlink(source.c_str());
+      return false;
+    }
+
+    std::vector<const char*> args;
+    for (const char* const* arg = COMPILER; *arg; ++arg)
+      args.push_back(*arg);
+    args.push_back(source.c_str());
+    args.push_back("-o");
+    args.push_back(object.c_str());
+    args.push_back(0);
+
+    std::cout.flush();
+    int status = 0;
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+      dup2(2, 1);
+      execvp(args[0], const_cast<char* const*>(&args[0]));
+      _exit(127);
+    }
+    if (pid < 0 || waitpid(pid, &status, 0) != pid ||
+	!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+      _error = "Can't compile " + source + " with " + COMPILER[0];
+      unlink(source.c_str());
+      unlink(object.c_str());
+      return false;
+    }
+
+    // The shared object comes first, since the code tells it is valid
+    if (rename(object.c_str(), (base + ".so").c_str()) != 0 ||
+	rename(source.c_str(), (base + ".cc").c_str()) != 0)
+    {
+      _error = "Can't store " + object + " in the cache";
+      unlink(source.c_str());
+      unlink(object.c_str());
+      return false;
+    }
+
+    return true;
+  }
+
+  /*!
+  ** Find the cache directory.
+  **
+  ** @return The directory, empty if there is none
+  */
+  std::string
+  CompiledExecution::cacheDirectory()
+  {
+    const char* dir = getenv("CUBS_CACHE_DIR");
+    if (dir && *dir)
+      return dir;
+    dir = getenv("XDG_CACHE_HOME");
+    if (dir && *dir)
+      return std::string(dir) + "/cubs";
+    dir = getenv("HOME");
+    if (dir && *dir)
+      return std::string(dir) + "/.cache/cubs";
+    return "";
+  }
+
+  /*!
+  ** Entry point of the execution thread.
+  **
+  ** @param data The compiled execution to launch
+  **
+  ** @return Nothing
+  */
+  void*
+  CompiledExecution::launch(void* data)
+  {
+    CompiledExecution* self = static_cast<CompiledExecution*>(data);
+    assert(self);
+    assert(self->_entry);
+    const char* error = 0;
+
+    self->_result = self->_entry(self->_maxDepth, &error);
+    if (error)
+      self->_error = error;
+
+    return 0;
+  }
+
+  /*!
+  ** Unload the shared object, if any.
+  */
+  void
+  CompiledExecution::release()
+  {
+    if (_handle)
+      dlclose(_handle);
+    _handle = 0;
+    _entry = 0;
+  }
+}
@@ -0,0 +1,48 @@
+#ifndef COMPILEDEXECUTION_HH_
+# define COMPILEDEXECUTION_HH_
+
+# include <string>
+# include "Error.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Run a program converted to C++, compiled ahead of time by the system
+  ** C++ compiler into a shared object, then loaded in the current process.
+  ** Shared objects are kept in a cache directory, named after a hash of
+  ** the code and of the compiler command, so an unchanged program is
+  ** compiled only once. The directory is $CUBS_CACHE_DIR, else
+  ** $XDG_CACHE_HOME/cubs, else $HOME/.cache/cubs.
+  ** Like the interpreter, the program runs on its own stack, sized
+  ** according to the maximum call depth.
+  */
+  class CompiledExecution
+  {
+    typedef int (*Entry)(unsigned int maxDepth, const char** error);
+
+  public:
+    CompiledExecution();
+    ~CompiledExecution();
+
+  public:
+    bool load(const std::string& code);
+    int execute();
+    void setMaxDepth(unsigned int depth);
+    const std::string& getErrorMessage() const;
+
+  private:
+    bool compile(const std::string& code, const std::string& base);
+    static std::string cacheDirectory();
+    static void* launch(void* data);
+    void release();
+
+  private:
+    void*		_handle;
+    Entry		_entry;
+    unsigned int	_maxDepth;
+    int			_result;
+    std::string		_error;
+  };
+}
+
+#endif /* !COMPILEDEXECUTION_HH_ */
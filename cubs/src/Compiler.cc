@@ -1,6 +1,7 @@
 #include <cassert>
 #include <iostream>
 #include <stdexcept>
+#include <unistd.h>
 #include "Compiler.hh"
 #include "PrettyPrinterVisitor.hh"
 #include "GenerateAST.hh"
@@ -10,9 +11,44 @@
 #include "GenerateDotASTVisitor.hh"
 #include "ConvertToCppVisitor.hh"
 #include "ASMGeneratorVisitor.hh"
+#include "ASM64GeneratorVisitor.hh"
+#include "PurityPass.hh"
+#include "ConstantFoldingPass.hh"
+#include "DeadCodePass.hh"
+#include "CommonSubexpressionPass.hh"
+#include "Peephole.hh"
+#include "PeepholePatterns.hh"
+#include "ASM64Assembler.hh"
+#include "ELFWriter.hh"
+#include "NativeExecution.hh"
+#include "CompiledExecution.hh"
 
 namespace MiniCompiler
 {
+  namespace
+  {
+    /*!
+    ** Make a printing visitor write to a stream while it generates, by
+    ** blocks. The standard output is written straight to its file
+    ** descriptor, without going through a second buffer.
+    **
+    ** @param visitor The visitor
+    ** @param o The stream
+    */
+    template <typename Visitor>
+    void
+    streamTo(Visitor& visitor, std::ostream& o)
+    {
+      if (&o == &std::cout)
+      {
+	std::cout.flush();
+	visitor.setOutput(STDOUT_FILENO);
+      }
+      else
+	visitor.setOutput(o);
+    }
+  }
+
   /*!
   ** Construct the compiler for a given file.
   **
@@ -20,8 +56,11 @@ namespace MiniCompiler
   */
   Compiler::Compiler(const std::string& fileName)
     : _fileName(fileName), _lexer(0), _parser(0),
-      _binder(0), _typeChecker(0), _execution(0),
-      _option('x'), _returnValue(0)
+      _binder(0), _typeChecker(0), _execution(0), _nativeExecution(0),
+      _compiledExecution(0), _passManager(0),
+      _option('x'), _maxDepth(ExecutionVisitor::DEFAULT_MAX_DEPTH),
+      _optimizationLevel(0), _printAfter(""), _timePasses(false),
+      _native(false), _generation(), _output(""), _jobs(1), _returnValue(0)
   {
   }
 
@@ -35,6 +74,9 @@ namespace MiniCompiler
     delete _binder;
     delete _typeChecker;
     delete _execution;
+    delete _nativeExecution;
+    delete _compiledExecution;
+    delete _passManager;
   }
 
   /*!
@@ -48,6 +90,97 @@ namespace MiniCompiler
     _option = option;
   }
 
+  /*!
+  ** Set the maximum number of nested function calls during execution.
+  **
+  ** @param depth The maximum call depth
+  */
+  void
+  Compiler::setMaxDepth(const unsigned int depth)
+  {
+    _maxDepth = depth;
+  }
+
+  /*!
+  ** Set the optimization level, ie which passes are launched.
+  **
+  ** @param level The optimization level
+  */
+  void
+  Compiler::setOptimizationLevel(const unsigned int level)
+  {
+    _optimizationLevel = level;
+  }
+
+  /*!
+  ** Set the pass after which the tree is displayed.
+  **
+  ** @param pass The name of the pass, or an empty string
+  */
+  void
+  Compiler::setPrintAfter(const std::string& pass)
+  {
+    _printAfter = pass;
+  }
+
+  /*!
+  ** Set if time and changes of each pass have to be displayed.
+  **
+  ** @param time If passes statistics are displayed
+  */
+  void
+  Compiler::setTimePasses(const bool time)
+  {
+    _timePasses = time;
+  }
+
+  /*!
+  ** Set if execution is compiled by the system C++ compiler, instead of
+  ** interpreted.
+  **
+  ** @param native If execution is compiled
+  */
+  void
+  Compiler::setNative(const bool native)
+  {
+    _native = native;
+  }
+
+  /*!
+  ** Set the shape of programs made by the grammar generator.
+  **
+  ** @param params The parameters of the generator
+  */
+  void
+  Compiler::setGeneration(const GenerateAST::Parameters& params)
+  {
+    _generation = params;
+  }
+
+  /*!
+  ** Set the file where generated programs are written, instead of the
+  ** standard output.
+  **
+  ** @param fileName The name of the file, empty for the standard output
+  */
+  void
+  Compiler::setOutput(const std::string& fileName)
+  {
+    _output = fileName;
+  }
+
+  /*!
+  ** Set the maximum number of threads working on a same stage.
+  **
+  ** @param jobs The number of threads, at least 1
+  */
+  void
+  Compiler::setJobs(const unsigned int jobs)
+  {
+    assert(jobs > 0);
+    _jobs = jobs;
+  }
+
   /*!
   ** Launch lexing of the given file.
   **
@@ -65,7 +198,7 @@ namespace MiniCompiler
     buffer << file.rdbuf();
     file.close();
 
-    _lexer = new Lexer(buffer);
+    _lexer = new Lexer(buffer, _jobs);
   }
 
   /*!
@@ -93,8 +226,9 @@ namespace MiniCompiler
     AST::NodeProgram* tree = _parser->getSyntaxTree();
     assert(tree);
     PrettyPrinterVisitor visitor;
+    streamTo(visitor, o);
     visitor.visit(tree);
-    o << visitor;
+    visitor.flush();
   }
 
   /*!
@@ -105,22 +239,21 @@ namespace MiniCompiler
   Compiler::parseFile()
   {
     assert(_lexer);
-    _parser = new Parser(*_lexer);
+    _parser = new Parser(*_lexer, _jobs);
     _parser->construct();
   }
 
   /*!
-  ** Launch grammar generation.
+  ** Launch grammar generation, writing a random program.
+  **
+  ** @param o The stream where to write it
   */
   void
   Compiler::generateGrammar(std::ostream& o) const
   {
-    AST::NodeProgram* generatedGrammar = new AST::NodeProgram();
     GenerateAST grammar;
-    grammar.construct(generatedGrammar);
-    PrettyPrinterVisitor visitor;
-    visitor.visit(generatedGrammar);
-    o << visitor;
+    grammar.setParameters(_generation);
+    grammar.generate(o);
   }
 
   /*!
@@ -133,7 +266,7 @@ namespace MiniCompiler
     assert(_parser);
     AST::NodeProgram* tree = _parser->getSyntaxTree();
     assert(tree);
-    _binder = new Binder();
+    _binder = new Binder(_jobs);
     _binder->bind(tree);
   }
 
@@ -148,10 +281,40 @@ namespace MiniCompiler
     assert(_binder);
     AST::NodeProgram* tree = _parser->getSyntaxTree();
     assert(tree);
-    _typeChecker = new TypeChecker();
+    _typeChecker = new TypeChecker(_jobs);
     _typeChecker->checkTypes(tree);
   }
 
+  /*!
+  ** Launch passes of the optimization level on the AST.
+  ** Type checker must be correct.
+  **
+  ** @return False if the pass to display doesn't exist
+  */
+  bool
+  Compiler::optimize()
+  {
+    assert(_parser);
+    assert(_typeChecker);
+    AST::NodeProgram* tree = _parser->getSyntaxTree();
+    assert(tree);
+
+    _passManager = new PassManager();
+    _passManager->registerPass(new PurityPass());
+    _passManager->registerPass(new ConstantFoldingPass());
+    _passManager->registerPass(new DeadCodePass());
+    _passManager->registerPass(new CommonSubexpressionPass());
+    if (!_printAfter.empty() && !_passManager->hasPass(_printAfter))
+    {
+      std::cerr << _printAfter << " : Unknown pass !" << std::endl;
+      return false;
+    }
+    _passManager->setPrintAfter(_printAfter);
+    _passManager->run(tree, _optimizationLevel);
+
+    return true;
+  }
+
   /*!
   ** Launch the execution.
   ** Type checker must be correct.
@@ -167,11 +330,68 @@ namespace MiniCompiler
     AST::NodeProgram* tree = _parser->getSyntaxTree();
     assert(tree);
 
+    // Memoization needs to know which functions are pure
+    if (launchMemoization())
+    {
+      assert(_passManager);
+      _passManager->require("purity", tree);
+    }
+
     _execution = new Execution();
     _execution->activeVerbose(viewExecution());
+    _execution->activeMemoization(launchMemoization());
+    _execution->setMaxDepth(_maxDepth);
     return _execution->execute(tree);
   }
 
+  /*!
+  ** Launch the execution, compiled to x86-64 code in memory.
+  ** Type checker must be correct.
+  **
+  ** @return 0 if no errors occured, else a different value.
+  */
+  int
+  Compiler::nativeExecution()
+  {
+    std::stringstream code;
+    generateASM64(code, true);
+
+    _nativeExecution = new NativeExecution();
+    _nativeExecution->setMaxDepth(_maxDepth);
+    if (!_nativeExecution->load(code.str()))
+      throw Error::EXECUTION;
+    // The program writes directly on stdout
+    std::cout.flush();
+    return _nativeExecution->execute();
+  }
+
+  /*!
+  ** Launch the execution, converted to C++ then compiled by the system
+  ** C++ compiler, or taken from the cache.
+  ** Type checker must be correct.
+  **
+  ** @return 0 if no errors occured, else a different value.
+  */
+  int
+  Compiler::compiledExecution()
+  {
+    AST::NodeProgram* tree = _parser->getSyntaxTree();
+    assert(tree);
+    ConvertToCppVisitor visitor;
+    std::stringstream code;
+    visitor.setHosted(true);
+    visitor.setOptimized(_optimizationLevel > 0);
+    visitor.setJobs(_jobs);
+    visitor.visit(tree);
+    code << visitor;
+
+    _compiledExecution = new CompiledExecution();
+    _compiledExecution->setMaxDepth(_maxDepth);
+    if (!_compiledExecution->load(code.str()))
+      throw Error::EXECUTION;
+    return _compiledExecution->execute();
+  }
+
   /*!
   ** Launch the execution in debug mode.
   ** Type checker must be correct.
@@ -189,6 +409,7 @@ namespace MiniCompiler
 
     _execution = new Execution();
     _execution->activeVerbose(viewDebug());
+    _execution->setMaxDepth(_maxDepth);
     return _execution->debug(tree);
   }
 
@@ -241,8 +462,12 @@ namespace MiniCompiler
     AST::NodeProgram* tree = _parser->getSyntaxTree();
     assert(tree);
     ConvertToCppVisitor visitor;
+    // Computed types are only known when the tree is type checked
+    visitor.setOptimized(checkBeforeConvertToCpp() && _optimizationLevel > 0);
+    visitor.setJobs(_jobs);
+    streamTo(visitor, o);
     visitor.visit(tree);
-    o << visitor;
+    visitor.flush();
   }
 
   /*!
@@ -256,9 +481,110 @@ namespace MiniCompiler
     AST::NodeProgram* tree = _parser->getSyntaxTree();
     assert(tree);
     ASMGeneratorVisitor visitor;
+    std::stringstream code;
     visitor.printPrelude(launchConvertToASMWithPrelude());
+    visitor.setJobs(_jobs);
+    visitor.setMaxDepth(_maxDepth);
+    // The peephole optimizer needs the whole code
+    if (_optimizationLevel == 0)
+      streamTo(visitor, o);
     visitor.visit(tree);
-    o << visitor;
+    visitor.flush();
+    if (_optimizationLevel > 0)
+    {
+      code << visitor;
+      printASM(o, code.str(), ';', false);
+    }
+  }
+
+  /*!
+  ** Convert parsed grammar to x86-64 asm
+  **
+  ** @param o The stream where to display it
+  */
+  void
+  Compiler::convertToASM64(std::ostream& o)
+  {
+    generateASM64(o, launchConvertToASM64WithRuntime());
+  }
+
+  /*!
+  ** Convert parsed grammar to a static x86-64 Linux executable, without
+  ** any external assembler or linker.
+  **
+  ** @param o The stream where to write it
+  **
+  ** @return If the executable was written
+  */
+  bool
+  Compiler::convertToELF64(std::ostream& o)
+  {
+    std::stringstream code;
+    generateASM64(code, true);
+
+    ASM64Assembler assembler;
+    ELFWriter writer(assembler);
+    if (!assembler.assemble(code.str()))
+    {
+      std::cerr << assembler.getError() << std::endl;
+      return false;
+    }
+    if (!writer.write(o, "_start"))
+    {
+      std::cerr << writer.getError() << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  /*!
+  ** Generate x86-64 asm, going through the peephole optimizer if needed.
+  **
+  ** @param o The stream where to display it
+  ** @param runtime If the runtime is also generated
+  */
+  void
+  Compiler::generateASM64(std::ostream& o, const bool runtime)
+  {
+    AST::NodeProgram* tree = _parser->getSyntaxTree();
+    assert(tree);
+    ASM64GeneratorVisitor visitor;
+    visitor.printRuntime(runtime);
+    visitor.setHosted(launchNativeExecution());
+    std::stringstream code;
+    visitor.setMaxDepth(_maxDepth);
+    visitor.visit(tree);
+    code << visitor;
+    printASM(o, code.str(), '#', true);
+  }
+
+  /*!
+  ** Print generated assembly. When optimizing, it first goes through
+  ** the peephole optimizer.
+  **
+  ** @param o The stream where to display it
+  ** @param code The generated assembly
+  ** @param commentChar The char beginning a comment
+  ** @param longMode If the code is 64 bits
+  */
+  void
+  Compiler::printASM(std::ostream& o, const std::string& code,
+		     const char commentChar, const bool longMode)
+  {
+    if (_optimizationLevel == 0)
+    {
+      o << code;
+      return;
+    }
+
+    Peephole peephole(commentChar, longMode);
+    PeepholePatterns::registerAll(peephole);
+    peephole.load(code);
+    peephole.run();
+    peephole.print(o);
+    if (_timePasses)
+      peephole.printStatistics(std::cerr);
   }
 
   /*!
@@ -274,8 +600,9 @@ namespace MiniCompiler
     AST::NodeProgram* tree = _parser->getSyntaxTree();
     assert(tree);
     GenerateDotASTVisitor visitor;
+    streamTo(visitor, o);
     visitor.visit(tree);
-    o << visitor;
+    visitor.flush();
   }
 
   /*!
@@ -347,6 +674,9 @@ namespace MiniCompiler
       }
     }
 
+    if (launchOptimization() && !optimize())
+      return Error::INVALID_OPTION;
+
     if (launchExecution())
     {
       try
@@ -355,7 +685,34 @@ namespace MiniCompiler
       }
       catch (const Error::type)
       {
-	std::cerr << "A division by zero has occured..." << std::endl;
+	std::cerr << _execution->getErrorMessage() << std::endl;
+	return Error::EXECUTION;
+      }
+    }
+
+    if (launchNativeExecution())
+    {
+      try
+      {
+	_returnValue = nativeExecution();
+      }
+      catch (const Error::type)
+      {
+	if (!_nativeExecution->getErrorMessage().empty())
+	  std::cerr << _nativeExecution->getErrorMessage() << std::endl;
+	return Error::EXECUTION;
+      }
+    }
+
+    if (launchCompiledExecution())
+    {
+      try
+      {
+	_returnValue = compiledExecution();
+      }
+      catch (const Error::type)
+      {
+	std::cerr << _compiledExecution->getErrorMessage() << std::endl;
 	return Error::EXECUTION;
       }
     }
@@ -368,7 +725,7 @@ namespace MiniCompiler
       }
       catch (const Error::type)
       {
-	std::cerr << "A division by zero has occured..." << std::endl;
+	std::cerr << _execution->getErrorMessage() << std::endl;
 	return Error::EXECUTION;
       }
     }
@@ -377,7 +734,17 @@ namespace MiniCompiler
       convertToCpp(std::cout);
 
     if (launchGrammarGeneration())
-      generateGrammar(std::cout);
+    {
+      if (_output.empty())
+	generateGrammar(std::cout);
+      else
+      {
+	std::ofstream file(_output.c_str());
+	if (!file)
+	  return Error::FILE_NOT_FOUND;
+	generateGrammar(file);
+      }
+    }
 
     if (launchDotAST())
       generateDotAST(std::cout);
@@ -385,6 +752,15 @@ namespace MiniCompiler
     if (launchConvertToASM())
       convertToASM(std::cout);
 
+    if (launchConvertToASM64())
+      convertToASM64(std::cout);
+
+    if (launchConvertToELF64() && !convertToELF64(std::cout))
+      return Error::UNKNOW;
+
+    if (_timePasses && _passManager)
+      _passManager->printStatistics(std::cerr);
+
     return Error::NONE;
   }
 }
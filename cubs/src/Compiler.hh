@@ -11,6 +11,10 @@
 # include "Binder.hh"
 # include "TypeChecker.hh"
 # include "Execution.hh"
+# include "NativeExecution.hh"
+# include "CompiledExecution.hh"
+# include "GenerateAST.hh"
+# include "PassManager.hh"
 
 namespace MiniCompiler
 {
@@ -23,12 +27,22 @@ namespace MiniCompiler
   public:
     Error::type execute();
     void setOption(const unsigned char option);
+    void setMaxDepth(const unsigned int depth);
+    void setOptimizationLevel(const unsigned int level);
+    void setPrintAfter(const std::string& pass);
+    void setTimePasses(const bool time);
+    void setNative(const bool native);
+    void setGeneration(const GenerateAST::Parameters& params);
+    void setOutput(const std::string& fileName);
+    void setJobs(const unsigned int jobs);
     void displayLexedSymbols(std::ostream& o);
     void displaySyntaxTree(std::ostream& o);
     void displayBinding(std::ostream& o);
     void displayTypeChecking(std::ostream& o);
     void convertToCpp(std::ostream& o);
     void convertToASM(std::ostream& o);
+    void convertToASM64(std::ostream& o);
+    bool convertToELF64(std::ostream& o);
     void generateDotAST(std::ostream& o);
     void generateGrammar(std::ostream& o) const;
 
@@ -37,19 +51,31 @@ namespace MiniCompiler
     void parseFile();
     void bind();
     void typeCheck();
+    bool optimize();
     int execution();
+    int nativeExecution();
+    int compiledExecution();
     int debugging();
 
   private:
+    void generateASM64(std::ostream& o, const bool runtime);
+    void printASM(std::ostream& o, const std::string& code,
+		  const char commentChar, const bool longMode);
     static bool isValidOption(const unsigned char option);
     bool launchLexing();
     bool launchParsing();
     bool launchBinding();
     bool launchTypeChecking();
+    bool launchOptimization();
     bool launchExecution();
+    bool launchMemoization();
+    bool launchNativeExecution();
+    bool launchCompiledExecution();
     bool launchDebugging();
     bool launchConvertToCpp();
     bool launchConvertToASM();
+    bool launchConvertToASM64();
+    bool launchConvertToELF64();
     bool launchGrammarGeneration();
     bool launchDotAST();
     bool viewLexer();
@@ -60,6 +86,7 @@ namespace MiniCompiler
     bool viewDebug();
     bool checkBeforeConvertToCpp();
     bool launchConvertToASMWithPrelude();
+    bool launchConvertToASM64WithRuntime();
     bool viewGrammarGeneration();
     bool launchAll();
 
@@ -73,7 +100,18 @@ namespace MiniCompiler
     Binder*		_binder;
     TypeChecker*	_typeChecker;
     Execution*		_execution;
+    NativeExecution*	_nativeExecution;
+    CompiledExecution*	_compiledExecution;
+    PassManager*	_passManager;
     unsigned char	_option;
+    unsigned int	_maxDepth;
+    unsigned int	_optimizationLevel;
+    std::string		_printAfter;
+    bool		_timePasses;
+    bool		_native;
+    GenerateAST::Parameters	_generation;
+    std::string		_output;
+    unsigned int	_jobs;
     int			_returnValue;
   };
 }
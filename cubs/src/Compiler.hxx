@@ -18,9 +18,13 @@ namespace MiniCompiler
 	'O',      // AST viewer
 	'c', 'C', // Converting to C++
 	's', 'S', // Convert to ASM
+	'a', 'A', // Convert to x86-64 ASM
+	'e',      // Convert to x86-64 executable
 	'b', 'B', // Binding
 	't', 'T', // Type checking
 	'x', 'X', // Execution
+	'm',      // Execution with memoization
+	'j',      // Execution compiled to native code
 	'd', 'D', // Debug
 	'V',      // Launch and show all
 	0
@@ -47,8 +51,10 @@ namespace MiniCompiler
   {
     return _option == 'l' || viewLexer() ||
       launchParsing() || launchConvertToCpp() || launchConvertToASM() ||
-      launchBinding() || launchTypeChecking() || launchDotAST() ||
-      launchExecution() || launchDebugging() || launchAll();
+      launchConvertToASM64() || launchConvertToELF64() || launchBinding() ||
+      launchTypeChecking() || launchDotAST() ||
+      launchExecution() || launchNativeExecution() ||
+      launchCompiledExecution() || launchDebugging() || launchAll();
   }
 
   /*!
@@ -61,8 +67,10 @@ namespace MiniCompiler
   {
     return _option == 'p' || viewParser() ||
       launchConvertToCpp() || launchBinding() || launchConvertToASM() ||
-      launchTypeChecking() || launchExecution() || launchDotAST() ||
-      launchDebugging() || launchAll();
+      launchConvertToASM64() || launchConvertToELF64() || launchTypeChecking() ||
+      launchExecution() || launchNativeExecution() ||
+      launchCompiledExecution() || launchDotAST() || launchDebugging() ||
+      launchAll();
   }
 
   /*!
@@ -74,8 +82,10 @@ namespace MiniCompiler
   Compiler::launchBinding()
   {
     return _option == 'b' || viewBinder() || launchConvertToASM() ||
+      launchConvertToASM64() || launchConvertToELF64() ||
       checkBeforeConvertToCpp() || launchTypeChecking() ||
-      launchExecution() || launchDebugging() || launchAll();
+      launchExecution() || launchNativeExecution() ||
+      launchCompiledExecution() || launchDebugging() || launchAll();
   }
 
   /*!
@@ -87,9 +97,24 @@ namespace MiniCompiler
   Compiler::launchTypeChecking()
   {
     return _option == 't' || viewTypeChecker() ||
-      launchExecution() || launchConvertToASM() ||
-      checkBeforeConvertToCpp() ||
-      launchDebugging() || launchAll();
+      launchExecution() || launchNativeExecution() ||
+      launchCompiledExecution() || launchConvertToASM() ||
+      launchConvertToASM64() || launchConvertToELF64() ||
+      checkBeforeConvertToCpp() || launchDebugging() || launchAll();
+  }
+
+  /*!
+  ** Check if optimization passes have to be launch, ie if a type checked
+  ** tree is used after.
+  **
+  ** @return if we launch optimization
+  */
+  inline bool
+  Compiler::launchOptimization()
+  {
+    return launchExecution() || launchNativeExecution() ||
+      launchCompiledExecution() || launchDebugging() || launchConvertToASM() || launchConvertToASM64() ||
+      launchConvertToELF64() || checkBeforeConvertToCpp();
   }
 
   /*!
@@ -100,8 +125,42 @@ namespace MiniCompiler
   inline bool
   Compiler::launchExecution()
   {
-    return _option == 'x' || viewExecution() ||
-      launchAll();
+    return (_option == 'x' && !_native) || viewExecution() ||
+      launchMemoization() || launchAll();
+  }
+
+  /*!
+  ** Check if execution compiled to native code has to be launch.
+  **
+  ** @return if we launch native execution
+  */
+  inline bool
+  Compiler::launchNativeExecution()
+  {
+    return _option == 'j';
+  }
+
+  /*!
+  ** Check if execution compiled by the system C++ compiler has to be
+  ** launch, instead of the interpreted one.
+  **
+  ** @return if we launch compiled execution
+  */
+  inline bool
+  Compiler::launchCompiledExecution()
+  {
+    return _option == 'x' && _native;
+  }
+
+  /*!
+  ** Check if pure function calls have to be memoized during execution.
+  **
+  ** @return if we launch execution with memoization
+  */
+  inline bool
+  Compiler::launchMemoization()
+  {
+    return _option == 'm';
   }
 
   /*!
@@ -137,6 +196,28 @@ namespace MiniCompiler
     return _option == 's' || launchConvertToASMWithPrelude();
   }
 
+  /*!
+  ** Check if conversion to x86-64 ASM has to be launch.
+  **
+  ** @return if we launch conversion to x86-64 ASM
+  */
+  inline bool
+  Compiler::launchConvertToASM64()
+  {
+    return _option == 'a' || launchConvertToASM64WithRuntime();
+  }
+
+  /*!
+  ** Check if conversion to an x86-64 executable has to be launch.
+  **
+  ** @return if we launch conversion to an x86-64 executable
+  */
+  inline bool
+  Compiler::launchConvertToELF64()
+  {
+    return _option == 'e';
+  }
+
   /*!
   ** Check if dot generation has to be launched.
   **
@@ -247,6 +328,17 @@ namespace MiniCompiler
     return _option == 'S';
   }
 
+  /*!
+  ** Check if we also print runtime
+  **
+  ** @return if we also print runtime when generating x86-64 asm
+  */
+  inline bool
+  Compiler::launchConvertToASM64WithRuntime()
+  {
+    return _option == 'A';
+  }
+
   /*!
   ** Check if generated grammar has to be printed.
   **
@@ -0,0 +1,38 @@
+#include <cassert>
+#include "ConstantFoldingPass.hh"
+#include "ConstantFoldingVisitor.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct the constant folding pass, used from level 1.
+  */
+  ConstantFoldingPass::ConstantFoldingPass()
+    : Pass("constant-folding", false, 1)
+  {
+  }
+
+  /*!
+  ** Destruct the constant folding pass.
+  */
+  ConstantFoldingPass::~ConstantFoldingPass()
+  {
+  }
+
+  /*!
+  ** Compute constant expressions of the given AST.
+  **
+  ** @param tree The root of the AST
+  **
+  ** @return The number of changes
+  */
+  unsigned int
+  ConstantFoldingPass::run(AST::NodeProgram* tree)
+  {
+    assert(tree);
+    ConstantFoldingVisitor visitor;
+    visitor.visit(tree);
+
+    return visitor.nbChanges();
+  }
+}
@@ -0,0 +1,20 @@
+#ifndef CONSTANTFOLDINGPASS_HH_
+# define CONSTANTFOLDINGPASS_HH_
+
+# include "Pass.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Transformation computing constant expressions, see ConstantFoldingVisitor.
+  */
+  class ConstantFoldingPass : public Pass
+  {
+  public:
+    ConstantFoldingPass();
+    virtual ~ConstantFoldingPass();
+    virtual unsigned int run(AST::NodeProgram* tree);
+  };
+}
+
+#endif /* !CONSTANTFOLDINGPASS_HH_ */
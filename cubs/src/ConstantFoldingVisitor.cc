@@ -0,0 +1,212 @@
+#include <climits>
+#include "ConstantFoldingVisitor.hh"
+#include "NodeOperation.hh"
+#include "NodeExpression.hh"
+#include "NodeFactor.hh"
+#include "NodeNumber.hh"
+#include "NodeBoolean.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct the constant folding visitor.
+  */
+  ConstantFoldingVisitor::ConstantFoldingVisitor()
+    : _nbChanges(0)
+  {
+  }
+
+  /*!
+  ** Destruct the constant folding visitor.
+  */
+  ConstantFoldingVisitor::~ConstantFoldingVisitor()
+  {
+  }
+
+  /*!
+  ** Get the number of simplified nodes.
+  **
+  ** @return The number of changes
+  */
+  unsigned int
+  ConstantFoldingVisitor::nbChanges() const
+  {
+    return _nbChanges;
+  }
+
+  /*!
+  ** Factors are simplified first, then the operation itself.
+  **
+  ** @param node The operation node
+  */
+  void
+  ConstantFoldingVisitor::visit(AST::NodeOperation* node)
+  {
+    assert(node);
+    NonConstBaseVisitor<ConstantFoldingVisitor>::visit(node);
+
+    AST::NodeFactor* left = node->getLeftFactor();
+    AST::NodeFactor* right = node->getRightFactor();
+    assert(left);
+    unwrap(left);
+    if (!right)
+      return;
+    unwrap(right);
+
+    if (left->getNumber() && right->getNumber())
+      foldIntegers(node);
+    else
+      if (left->getBool() && right->getBool())
+	foldBooleans(node);
+  }
+
+  /*!
+  ** Replace a parenthesized literal by the literal itself.
+  **
+  ** @param factor The factor node
+  */
+  void
+  ConstantFoldingVisitor::unwrap(AST::NodeFactor* factor)
+  {
+    assert(factor);
+    AST::NodeExpression* expr = factor->getExpression();
+    if (!expr)
+      return;
+    AST::NodeOperation* op = expr->getOperation();
+    assert(op);
+    if (op->getOpType() != AST::Operator::NONE)
+      return;
+    AST::NodeFactor* inner = op->getLeftFactor();
+    assert(inner);
+
+    AST::NodeNumber* number = inner->getNumber();
+    AST::NodeBoolean* boolean = inner->getBool();
+    if (!number && !boolean)
+      return;
+
+    inner->setNumber(0);
+    inner->setBool(0);
+    factor->setExpression(0);
+    delete expr;
+    factor->setNumber(number);
+    factor->setBool(boolean);
+    _nbChanges++;
+  }
+
+  /*!
+  ** Compute an operation on two integers. Overflow wraps around,
+  ** as it does at runtime.
+  **
+  ** @param node The operation node
+  */
+  void
+  ConstantFoldingVisitor::foldIntegers(AST::NodeOperation* node)
+  {
+    AST::NodeNumber* left = node->getLeftFactor()->getNumber();
+    const int a = left->getNumber();
+    const int b = node->getRightFactor()->getNumber()->getNumber();
+    const unsigned int ua = a;
+    const unsigned int ub = b;
+    int result = 0;
+
+    switch (node->getOpType())
+    {
+      case AST::Operator::PLUS:
+	result = ua + ub;
+	break;
+      case AST::Operator::MINUS:
+	result = ua - ub;
+	break;
+      case AST::Operator::MUL:
+	result = ua * ub;
+	break;
+      case AST::Operator::DIV:
+	if (b == 0 || (a == INT_MIN && b == -1))
+	  return;
+	result = a / b;
+	break;
+      case AST::Operator::MODULO:
+	if (b == 0 || (a == INT_MIN && b == -1))
+	  return;
+	result = a % b;
+	break;
+      case AST::Operator::EQUAL:
+	replaceByBoolean(node, a == b);
+	return;
+      case AST::Operator::DIFF:
+	replaceByBoolean(node, a != b);
+	return;
+      case AST::Operator::SUP:
+	replaceByBoolean(node, a > b);
+	return;
+      case AST::Operator::SUPEQUAL:
+	replaceByBoolean(node, a >= b);
+	return;
+      case AST::Operator::INF:
+	replaceByBoolean(node, a < b);
+	return;
+      case AST::Operator::INFEQUAL:
+	replaceByBoolean(node, a <= b);
+	return;
+      default:
+	return;
+    }
+
+    left->setNumber(result);
+    delete node->getRightFactor();
+    node->setRightFactor(0);
+    node->setOpType(AST::Operator::NONE);
+    _nbChanges++;
+  }
+
+  /*!
+  ** Compare two booleans.
+  **
+  ** @param node The operation node
+  */
+  void
+  ConstantFoldingVisitor::foldBooleans(AST::NodeOperation* node)
+  {
+    const bool a = node->getLeftFactor()->getBool()->getBool();
+    const bool b = node->getRightFactor()->getBool()->getBool();
+
+    switch (node->getOpType())
+    {
+      case AST::Operator::EQUAL:
+	replaceByBoolean(node, a == b);
+	break;
+      case AST::Operator::DIFF:
+	replaceByBoolean(node, a != b);
+	break;
+      default:
+	break;
+    }
+  }
+
+  /*!
+  ** Replace a comparison by its boolean result.
+  **
+  ** @param node The operation node
+  ** @param value The result of the comparison
+  */
+  void
+  ConstantFoldingVisitor::replaceByBoolean(AST::NodeOperation* node,
+					   const bool value)
+  {
+    AST::NodeFactor* left = node->getLeftFactor();
+    AST::NodeBoolean* boolean = new AST::NodeBoolean();
+
+    boolean->setBool(value);
+    boolean->setComputedType(AST::Type::BOOLEAN);
+    boolean->setLine(left->getLine());
+    delete left->getNumber();
+    left->setNumber(0);
+    delete left->getBool();
+    left->setBool(boolean);
+    left->setComputedType(AST::Type::BOOLEAN);
+    delete node->getRightFactor();
+    node->setRightFactor(0);
+    node->setOpType(AST::Operator::NONE);
+    _nbChanges++;
+  }
+}
@@ -0,0 +1,36 @@
+#ifndef CONSTANTFOLDINGVISITOR_HH_
+# define CONSTANTFOLDINGVISITOR_HH_
+
+# include <cassert>
+# include "BaseVisitor.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Compute operations whose factors are both literals, and remove
+  ** parenthesis around a single literal.
+  ** A division or a modulo by zero is kept, so it still fails at runtime.
+  */
+  class ConstantFoldingVisitor : public NonConstBaseVisitor<ConstantFoldingVisitor>
+  {
+  public:
+    ConstantFoldingVisitor();
+    ~ConstantFoldingVisitor();
+    using NonConstBaseVisitor<ConstantFoldingVisitor>::visit;
+    void visit(AST::NodeOperation* node);
+
+  public:
+    unsigned int nbChanges() const;
+
+  private:
+    void unwrap(AST::NodeFactor* factor);
+    void foldIntegers(AST::NodeOperation* node);
+    void foldBooleans(AST::NodeOperation* node);
+    void replaceByBoolean(AST::NodeOperation* node, const bool value);
+
+  private:
+    unsigned int	_nbChanges;
+  };
+}
+
+#endif /* !CONSTANTFOLDINGVISITOR_HH_ */
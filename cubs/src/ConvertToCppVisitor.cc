@@ -1,5 +1,7 @@
 #include <cassert>
+#include <limits>
 #include "ConvertToCppVisitor.hh"
+#include "ThreadPool.hh"
 #include "Utils.hh"
 #include "NodeIds.hh"
 #include "NodeProgram.hh"
@@ -35,15 +37,159 @@
 
 namespace MiniCompiler
 {
+  namespace
+  {
+    bool hasCall(const AST::NodeExpression* node);
+
+    /*!
+    ** Find the variables assigned by some instructions.
+    **
+    ** @param node The instructions node
+    ** @param assigned The declarations of assigned variables, to fill
+    */
+    void
+    findAssignedIn(const AST::NodeInstrs* node,
+		   std::set<const AST::NodeId*>& assigned)
+    {
+      for (; node; node = node->getInstrs())
+      {
+	const AST::NodeInstr* instr = node->getInstr();
+	assert(instr);
+	const AST::NodeCompoundInstr* compound = instr->getCompoundInstr();
+	const AST::NodeIf* nIf = instr->getIf();
+	const AST::NodeWhile* nWhile = instr->getWhile();
+
+	if (instr->getAffect())
+	  assigned.insert(instr->getAffect()->getId()->getRef());
+	if (instr->getRead())
+	  assigned.insert(instr->getRead()->getId()->getRef());
+	if (compound)
+	  findAssignedIn(compound->getInstrs(), assigned);
+	if (nIf && nIf->getBodyExprs())
+	  findAssignedIn(nIf->getBodyExprs()->getInstrs(), assigned);
+	if (nIf && nIf->getElseExprs())
+	  findAssignedIn(nIf->getElseExprs()->getInstrs(), assigned);
+	if (nWhile && nWhile->getBodyExprs())
+	  findAssignedIn(nWhile->getBodyExprs()->getInstrs(), assigned);
+      }
+    }
+
+    /*!
+    ** Check if a factor calls a function, so it may have side effects.
+    **
+    ** @param node The factor node
+    **
+    ** @return If there is a call in the factor
+    */
+    bool
+    hasCall(const AST::NodeFactor* node)
+    {
+      assert(node);
+      if (node->getCallFunc())
+	return true;
+      return node->getExpression() && hasCall(node->getExpression());
+    }
+
+    /*!
+    ** Check if an expression calls a function, so it may have side effects.
+    **
+    ** @param node The expression node
+    **
+    ** @return If there is a call in the expression
+    */
+    bool
+    hasCall(const AST::NodeExpression* node)
+    {
+      assert(node);
+      const AST::NodeOperation* op = node->getOperation();
+      assert(op);
+      return hasCall(op->getLeftFactor()) ||
+	(op->getRightFactor() && hasCall(op->getRightFactor()));
+    }
+
+    /*!
+    ** Check if a factor is a literal, so it can be evaluated at any time.
+    **
+    ** @param node The factor node
+    **
+    ** @return If the factor is a literal
+    */
+    bool
+    isLiteral(const AST::NodeFactor* node)
+    {
+      assert(node);
+      return node->getNumber() || node->getStringExpr() || node->getBool();
+    }
+
+    /*!
+    ** Number the string literals of a program in order of appearance,
+    ** so that they are declared before the program is written.
+    */
+    class StringCollector : public ConstBaseVisitor<StringCollector>
+    {
+    public:
+      StringCollector(std::map<std::string, unsigned int>& strings)
+	: strings(strings)
+      {
+      }
+
+      using ConstBaseVisitor<StringCollector>::visit;
+
+      void visit(const AST::NodeStringExpr* node)
+      {
+	const std::string s = Utils::activeSpecialChar(node->getString());
+	if (strings.find(s) == strings.end())
+	{
+	  const unsigned int nb = strings.size();
+	  strings.insert(std::make_pair(s, nb));
+	}
+      }
+
+    public:
+      std::map<std::string, unsigned int>&	strings;
+    };
+
+    /*!
+    ** Functions converted on a thread pool, each by its own visitor.
+    */
+    struct Functions
+    {
+      std::vector<const AST::NodeFunction*>	nodes;
+      std::vector<ConvertToCppVisitor*>		visitors;
+    };
+  }
+
+  /*!
+  ** The function running a hosted program.
+  ** Its prototype is int (unsigned int maxDepth, const char** error).
+  */
+  const char* const ConvertToCppVisitor::ENTRY = "cubs_main";
+
   /*!
   ** Construct the cpp convertor visitor,
   ** initializing tabulation.
   */
   ConvertToCppVisitor::ConvertToCppVisitor()
+    : _currentFunction(0), _hosted(false), _tailCall(0), _optimized(false),
+      _global(0), _jobs(1)
   {
     _tab = 0;
   }
 
+  /*!
+  ** Construct a visitor converting a function apart, on a thread of the
+  ** pool. Global variables and string literals are looked up in the
+  ** visitor of the program.
+  **
+  ** @param global The visitor of the program
+  */
+  ConvertToCppVisitor::ConvertToCppVisitor(const ConvertToCppVisitor* global)
+    : _currentFunction(0), _hosted(global->_hosted), _tailCall(0),
+      _optimized(global->_optimized), _global(global), _jobs(1)
+  {
+    _tab = global->_tab;
+  }
+
   /*!
   ** Destruct the visitor.
   */
@@ -51,6 +197,348 @@ namespace MiniCompiler
   {
   }
 
+  /*!
+  ** Choose if the program is run by a host, in its own process, once
+  ** compiled as a shared object. Then it is entered by ENTRY, exiting and
+  ** errors go back to the host, and it behaves like the execution:
+  ** variables are initialized, booleans are printed as keywords, and the
+  ** call depth and divisions by zero are checked. Identifiers are
+  ** prefixed, so they can't collide with C++ ones.
+  ** The call depth is given to each function as a first parameter, which
+  ** costs much less than a global counter.
+  **
+  ** @param hosted If the program is run by a host
+  */
+  void
+  ConvertToCppVisitor::setHosted(const bool hosted)
+  {
+    _hosted = hosted;
+  }
+
+  /*!
+  ** Choose if the C++ is written for speed, using types computed by the
+  ** type checker: integers have a fixed width, functions are static
+  ** inline, string literals are built once, strings which are not
+  ** assigned are given by reference, and appending to a string doesn't
+  ** copy it.
+  **
+  ** @param optimized If the C++ is written for speed
+  */
+  void
+  ConvertToCppVisitor::setOptimized(const bool optimized)
+  {
+    _optimized = optimized;
+  }
+
+  /*!
+  ** Set the maximum number of threads converting functions.
+  **
+  ** @param jobs The number of threads, at least 1
+  */
+  void
+  ConvertToCppVisitor::setJobs(const unsigned int jobs)
+  {
+    assert(jobs > 0);
+    _jobs = jobs;
+  }
+
+  /*!
+  ** Find the parameters of a function which can be given by reference,
+  ** since they are never assigned, even by a self tail call.
+  **
+  ** @param func The function node
+  */
+  void
+  ConvertToCppVisitor::findAssigned(const AST::NodeFunction* func)
+  {
+    assert(func);
+    const AST::NodeFunction* current = _currentFunction;
+    const AST::NodeInstrs* instrs = func->getCompoundInstr()->getInstrs();
+
+    _assigned.clear();
+    findAssignedIn(instrs, _assigned);
+    _currentFunction = func;
+    if (hasSelfTailCall(instrs))
+    {
+      Parameters params;
+      getParameters(func, params);
+      for (unsigned int i = 0; i < params.size(); ++i)
+	_assigned.insert(params[i].second);
+    }
+    _currentFunction = current;
+  }
+
+  /*!
+  ** Write an argument of a function call. A global string is copied,
+  ** since the called function could change it while using the argument
+  ** by reference.
+  **
+  ** @param expr The argument
+  */
+  void
+  ConvertToCppVisitor::writeArgument(const AST::NodeExpression* expr)
+  {
+    assert(expr);
+    const AST::NodeOperation* op = expr->getOperation();
+    assert(op);
+    const AST::NodeId* id = op->getLeftFactor()->getId();
+    const std::set<const AST::NodeId*>& globals =
+      _global ? _global->_globals : _globals;
+
+    if (_optimized && op->getOpType() == AST::Operator::NONE && id &&
+	id->getComputedType() == AST::Type::STRING &&
+	globals.find(id->getRef()) != globals.end())
+    {
+      _indent << "std::string(";
+      visit(expr);
+      _indent << ')';
+    }
+    else
+      visit(expr);
+  }
+
+  /*!
+  ** Write string literals used by the program, so that each one is built
+  ** only once.
+  */
+  void
+  ConvertToCppVisitor::writeStrings()
+  {
+    if (_strings.empty())
+      return;
+
+    std::vector<std::string> strings(_strings.size());
+    for (std::map<std::string, unsigned int>::const_iterator i =
+	   _strings.begin(); i != _strings.end(); ++i)
+      strings[i->second] = i->first;
+
+    _indent << "namespace cubs\n"
+      "{\n";
+    for (unsigned int i = 0; i < strings.size(); ++i)
+    {
+      _indent << Utils::stringFill(SPACING_CHAR, INDENT_SIZE)
+	      << "const std::string string" << i << '(';
+      writeString(strings[i]);
+      _indent << ", " << strings[i].length() << ");\n";
+    }
+    _indent << "}\n"
+      "\n";
+  }
+
+  /*!
+  ** Append a function converted apart.
+  **
+  ** @param function The visitor which converted the function
+  */
+  void
+  ConvertToCppVisitor::writeFunction(const ConvertToCppVisitor& function)
+  {
+    _indent << Utils::stringFill(SPACING_CHAR, _tab) << function._buffer.str();
+  }
+
+  /*!
+  ** Write the runtime of a hosted program, ie the functions needed to
+  ** behave like the execution. The runtime and the program are in an
+  ** anonymous namespace, closed by the entry, so everything can be
+  ** inlined by the C++ compiler.
+  */
+  void
+  ConvertToCppVisitor::writeRuntime()
+  {
+    Configuration& cfg = Configuration::getInstance();
+
+    _indent <<
+      (_optimized ? "#include <cstdint>\n" : "") <<
+      "#include <iostream>\n"
+      "#include <sstream>\n"
+      "#include <string>\n"
+      "\n"
+      "namespace\n"
+      "{\n"
+      "namespace cubs\n"
+      "{\n"
+      "  struct Exit\n"
+      "  {\n"
+      "    Exit(int v) : value(v) {}\n"
+      "    int value;\n"
+      "  };\n"
+      "\n"
+      "  struct Failure\n"
+      "  {\n"
+      "  };\n"
+      "\n"
+      "  unsigned int maxDepth = 0;\n"
+      "  std::string message;\n"
+      "\n"
+      "  [[noreturn]] void fail(const std::string& msg)\n"
+      "  {\n"
+      "    message = msg;\n"
+      "    throw Failure();\n"
+      "  }\n"
+      "\n"
+      "  void exit(int value)\n"
+      "  {\n"
+      "    throw Exit(value);\n"
+      "  }\n"
+      "\n"
+      "  [[noreturn]] void exceeded()\n"
+      "  {\n"
+      "    std::ostringstream msg;\n"
+      "    msg << \"Maximum call depth of \" << maxDepth << \" exceeded...\";\n"
+      "    fail(msg.str());\n"
+      "  }\n"
+      "\n"
+      "  inline void enter(unsigned int depth)\n"
+      "  {\n"
+      "    if (__builtin_expect(depth >= maxDepth, 0))\n"
+      "      exceeded();\n"
+      "  }\n"
+      "\n"
+      "  inline int divide(int a, int b)\n"
+      "  {\n"
+      "    if (b == 0)\n"
+      "      fail(\"A division by zero has occured...\");\n"
+      "    return a / b;\n"
+      "  }\n"
+      "\n"
+      "  inline int modulo(int a, int b)\n"
+      "  {\n"
+      "    if (b == 0)\n"
+      "      fail(\"A division by zero has occured...\");\n"
+      "    return a % b;\n"
+      "  }\n"
+      "\n"
+      "  inline void print(int value)\n"
+      "  {\n"
+      "    std::cout << value;\n"
+      "  }\n"
+      "\n"
+      "  inline void print(bool value)\n"
+      "  {\n"
+      "    std::cout << (value ? ";
+    writeString(cfg["true"]);
+    _indent << " : ";
+    writeString(cfg["false"]);
+    _indent << ");\n"
+      "  }\n"
+      "\n"
+      "  inline void print(const std::string& value)\n"
+      "  {\n"
+      "    std::cout << value;\n"
+      "  }\n"
+      "\n"
+      "  void read(int& value)\n"
+      "  {\n"
+      "    std::string in = \"\";\n"
+      "    int nb = 0;\n"
+      "    std::cin >> in;\n"
+      "    std::istringstream iss(in);\n"
+      "    iss >> std::dec >> nb;\n"
+      "    value = nb;\n"
+      "  }\n"
+      "\n"
+      "  void read(bool& value)\n"
+      "  {\n"
+      "    std::string in = \"\";\n"
+      "    std::cin >> in;\n"
+      "    if (in == \"true\" || in == \"1\")\n"
+      "      value = true;\n"
+      "    else\n"
+      "      if (in == \"false\" || in == \"0\")\n"
+      "        value = false;\n"
+      "  }\n"
+      "\n"
+      "  void read(std::string& value)\n"
+      "  {\n"
+      "    std::string in = \"\";\n"
+      "    std::cin >> in;\n"
+      "    value = in;\n"
+      "  }\n"
+      "}\n"
+      "\n";
+  }
+
+  /*!
+  ** Write the entry of a hosted program: it closes the anonymous
+  ** namespace, then runs the main instructions. Globals are reset first,
+  ** since a loaded program can be run many times.
+  ** It returns the exiting value, or sets the error message.
+  **
+  ** @param node The program node
+  */
+  void
+  ConvertToCppVisitor::writeEntry(const AST::NodeProgram* node)
+  {
+    assert(node);
+    const std::string tab = Utils::stringFill(SPACING_CHAR, INDENT_SIZE);
+
+    _indent << "}\n\n"
+      "extern \"C\" int " << ENTRY << "(unsigned int maxDepth, const char** error)\n"
+      "{\n" <<
+      tab << "cubs::maxDepth = maxDepth;\n";
+    for (const AST::NodeDeclarations* decls = node->getDecls();
+	 decls; decls = decls->getDeclarations())
+    {
+      const AST::NodeDeclaration* decl = decls->getDeclaration();
+      assert(decl);
+      const AST::NodeDeclarationBody* body = decl->getBody();
+      assert(body);
+      for (const AST::NodeIds* ids = body->getIds(); ids; ids = ids->getIds())
+      {
+	_indent << tab;
+	visit(ids->getId());
+	_indent << " = ";
+	visit(body->getType());
+	_indent << "();\n";
+      }
+    }
+
+    _indent << tab << "try\n";
+    _tab += INDENT_SIZE;
+    const AST::NodeCompoundInstr* instrs = node->getInstrs();
+    if (instrs)
+      visit(instrs);
+    else
+      _indent << tab << "{\n" << tab << "}\n";
+    _tab -= INDENT_SIZE;
+    _indent <<
+      tab << "catch (const cubs::Exit& e)\n" <<
+      tab << "{\n" <<
+      tab << tab << "return e.value;\n" <<
+      tab << "}\n" <<
+      tab << "catch (const cubs::Failure&)\n" <<
+      tab << "{\n" <<
+      tab << tab << "*error = cubs::message.c_str();\n" <<
+      tab << "}\n" <<
+      tab << "return 0;\n"
+      "}\n";
+  }
+
+  /*!
+  ** Write a C++ string literal. Non printable chars are escaped in octal,
+  ** on 3 digits, so they can't be mixed with following ones.
+  **
+  ** @param s The string, with special chars already interpreted
+  */
+  void
+  ConvertToCppVisitor::writeString(const std::string& s)
+  {
+    _indent << '"';
+    for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+    {
+      const unsigned char c = *i;
+      if (c == '"' || c == '\\')
+	_indent << '\\' << c;
+      else
+	if (c < ' ' || c > '~')
+	  _indent << '\\' << std::oct << std::setw(3) << std::setfill('0')
+		  << static_cast<unsigned int>(c) << std::dec << std::setfill(' ');
+	else
+	  _indent << c;
+    }
+    _indent << '"';
+  }
+
   /*!
   ** This function is used to get all function prototypes.
   **
@@ -65,24 +553,28 @@ namespace MiniCompiler
     const AST::NodeHeaderFunc* header = func->getHeaderFunc();
     assert(header);
 
-    _indent << Utils::stringFill(SPACING_CHAR, _tab);
+    findAssigned(func);
+    _indent << Utils::stringFill(SPACING_CHAR, _tab)
+	    << (_optimized ? "static inline " : "");
 
     // Get the return type
     const AST::NodeType* retType = header->getType();
     assert(retType);
-    retType->accept(*this);
+    visit(retType);
     _indent << ' ';
 
     // Get the function id
     const AST::NodeIdFunc* id = header->getId();
     assert(id);
-    id->accept(*this);
+    visit(id);
     _indent << '(';
 
     // Get all arguments of this function
     const AST::NodeArguments* args = header->getArguments();
+    if (_hosted)
+      _indent << "unsigned int depth" << (args ? ", " : "");
     if (args)
-      args->accept(*this);
+      visit(args);
     _indent << ");\n";
 
     // Go to the next function declaration
@@ -91,6 +583,128 @@ namespace MiniCompiler
       visitFuncHeader(funcs);
   }
 
+  /*!
+  ** Get the type and id of each parameter of a function, in order.
+  ** Only the header is used, so no binding is needed.
+  **
+  ** @param func The function node
+  ** @param params The parameters to fill
+  */
+  void
+  ConvertToCppVisitor::getParameters(const AST::NodeFunction* func,
+				     Parameters& params) const
+  {
+    assert(func);
+    const AST::NodeHeaderFunc* header = func->getHeaderFunc();
+    assert(header);
+
+    for (const AST::NodeArguments* args = header->getArguments();
+	 args; args = args->getArguments())
+    {
+      const AST::NodeArgument* arg = args->getArgument();
+      assert(arg);
+      const AST::NodeDeclarationBody* body = arg->getDeclarationBody();
+      assert(body);
+      for (const AST::NodeIds* ids = body->getIds(); ids; ids = ids->getIds())
+	params.push_back(Parameter(body->getType(), ids->getId()));
+    }
+  }
+
+  /*!
+  ** Check if a return directly returns a call to the current function,
+  ** with the right number of arguments.
+  **
+  ** @param node The return node
+  **
+  ** @return If the call can be replaced by a jump
+  */
+  bool
+  ConvertToCppVisitor::isSelfTailCall(const AST::NodeReturn* node) const
+  {
+    assert(node);
+    const AST::NodeCallFunc* call = node->getTailCall();
+    if (!call || !_currentFunction)
+      return false;
+
+    const AST::NodeHeaderFunc* header = _currentFunction->getHeaderFunc();
+    assert(header);
+    assert(header->getId());
+    assert(call->getId());
+    if (call->getId()->getId() != header->getId()->getId())
+      return false;
+
+    Parameters params;
+    getParameters(_currentFunction, params);
+    unsigned int nb = 0;
+    for (const AST::NodeExpressions* exprs = call->getExprs();
+	 exprs; exprs = exprs->getExprs())
+      nb++;
+
+    return nb == params.size();
+  }
+
+  /*!
+  ** Check if some instructions contain a self tail call.
+  **
+  ** @param node The instructions node
+  **
+  ** @return If a self tail call has been found
+  */
+  bool
+  ConvertToCppVisitor::hasSelfTailCall(const AST::NodeInstrs* node) const
+  {
+    for (; node; node = node->getInstrs())
+    {
+      const AST::NodeInstr* instr = node->getInstr();
+      assert(instr);
+      const AST::NodeCompoundInstr* compound = instr->getCompoundInstr();
+      const AST::NodeIf* nIf = instr->getIf();
+      const AST::NodeWhile* nWhile = instr->getWhile();
+
+      if (instr->getReturn() && isSelfTailCall(instr->getReturn()))
+	return true;
+      if (compound && hasSelfTailCall(compound->getInstrs()))
+	return true;
+      if (nIf)
+      {
+	if (nIf->getBodyExprs() &&
+	    hasSelfTailCall(nIf->getBodyExprs()->getInstrs()))
+	  return true;
+	if (nIf->getElseExprs() &&
+	    hasSelfTailCall(nIf->getElseExprs()->getInstrs()))
+	  return true;
+      }
+      if (nWhile && nWhile->getBodyExprs() &&
+	  hasSelfTailCall(nWhile->getBodyExprs()->getInstrs()))
+	return true;
+    }
+
+    return false;
+  }
+
+  /*!
+  ** Write the call depth given to a called function in a hosted program,
+  ** followed by a comma if there are arguments.
+  ** Like in the execution, it is the number of running functions, and a
+  ** tail call replaces the current function.
+  **
+  ** @param call The function call
+  */
+  void
+  ConvertToCppVisitor::writeDepth(const AST::NodeCallFunc* call)
+  {
+    assert(call);
+    if (!_hosted)
+      return;
+
+    if (!_currentFunction)
+      _indent << '0';
+    else
+      _indent << (call == _tailCall ? "depth" : "depth + 1");
+    if (call->getExprs())
+      _indent << ", ";
+  }
+
   /*!
   ** Convert the ids node
   **
@@ -113,23 +727,52 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeProgram* node)
   {
     assert(node);
-    _indent << Utils::stringFill(SPACING_CHAR, _tab) << "#include <iostream>\n\n";
     const AST::NodeDeclarations* decls = node->getDecls();
+    _globals.clear();
+    _strings.clear();
+    for (const AST::NodeDeclarations* d = decls; d; d = d->getDeclarations())
+      for (const AST::NodeIds* ids = d->getDeclaration()->getBody()->getIds();
+	   ids; ids = ids->getIds())
+	_globals.insert(ids->getId());
+
+    if (_optimized)
+    {
+      StringCollector collector(_strings);
+      collector.visit(node);
+    }
+
+    if (_hosted)
+      writeRuntime();
+    else
+    {
+      _indent << Utils::stringFill(SPACING_CHAR, _tab) << "#include <iostream>\n";
+      if (_optimized)
+	_indent << "#include <cstdint>\n"
+	  "#include <string>\n";
+      _indent << '\n';
+    }
+    writeStrings();
+
     if (decls)
-      decls->accept(*this);
+      visit(decls);
     _indent << '\n';
     const AST::NodeFunctions* funcs = node->getFuncs();
     if (funcs)
     {
       visitFuncHeader(funcs);
       _indent << '\n';
-      funcs->accept(*this);
+      visit(funcs);
     }
     _indent << '\n';
-    const AST::NodeCompoundInstr* instrs = node->getInstrs();
-    _indent << Utils::stringFill(SPACING_CHAR, _tab) << "int main()\n" ;
-    if (instrs)
-      instrs->accept(*this);
+    if (_hosted)
+      writeEntry(node);
+    else
+    {
+      const AST::NodeCompoundInstr* instrs = node->getInstrs();
+      _indent << Utils::stringFill(SPACING_CHAR, _tab) << "int main()\n" ;
+      if (instrs)
+	visit(instrs);
+    }
   }
 
   /*!
@@ -145,9 +788,24 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(id);
     assert(expr);
-    id->accept(*this);
+
+    // Appending to a string doesn't copy it
+    const AST::NodeOperation* op = expr->getOperation();
+    assert(op);
+    const AST::NodeId* left = op->getLeftFactor()->getId();
+    if (_optimized && id->getComputedType() == AST::Type::STRING &&
+	op->getOpType() == AST::Operator::PLUS && left &&
+	left->getRef() == id->getRef() && !hasCall(op->getRightFactor()))
+    {
+      visit(id);
+      _indent << " += ";
+      visit(op->getRightFactor());
+      return;
+    }
+
+    visit(id);
     _indent << " = ";
-    expr->accept(*this);
+    visit(expr);
   }
 
   /*!
@@ -166,13 +824,13 @@ namespace MiniCompiler
     assert(body);
 
     _indent << "if (";
-    cond->accept(*this);
+    visit(cond);
     _indent << ")\n";
-    body->accept(*this);
+    visit(body);
     if (elseExprs)
     {
       _indent << Utils::stringFill(SPACING_CHAR, _tab) << "else\n";
-      elseExprs->accept(*this);
+      visit(elseExprs);
     }
   }
 
@@ -188,8 +846,15 @@ namespace MiniCompiler
     const AST::NodeId* id = node->getId();
     assert(id);
 
+    if (_hosted)
+    {
+      _indent << "cubs::read(";
+      visit(id);
+      _indent << ')';
+      return;
+    }
     _indent << "std::cin >> ";
-    id->accept(*this);
+    visit(id);
   }
 
   /*!
@@ -204,7 +869,7 @@ namespace MiniCompiler
     const AST::NodeDeclarationBody* body = node->getDeclarationBody();
     assert(body);
 
-    body->accept(*this);
+    visit(body);
   }
 
   /*!
@@ -220,11 +885,11 @@ namespace MiniCompiler
     assert(arg);
     const AST::NodeArguments* args = node->getArguments();
 
-    arg->accept(*this);
+    visit(arg);
     if (args)
     {
       _indent << ", ";
-      args->accept(*this);
+      visit(args);
     }
   }
 
@@ -239,8 +904,48 @@ namespace MiniCompiler
     assert(node);
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
-    _indent << "return ";
-    expr->accept(*this);
+
+    if (!isSelfTailCall(node))
+    {
+      // Like in the execution, a tail call doesn't make the depth grow
+      _tailCall = node->getTailCall();
+      _indent << "return ";
+      visit(expr);
+      _indent << ";\n";
+      _tailCall = 0;
+      return;
+    }
+
+    // A self tail call is a jump to the beginning of the function, with new
+    // arguments. They are all evaluated before being assigned, because they
+    // can use each others.
+    const AST::NodeCallFunc* call = node->getTailCall();
+    assert(call);
+    Parameters params;
+    getParameters(_currentFunction, params);
+    const AST::NodeExpressions* exprs = call->getExprs();
+
+    _indent << "{\n";
+    _tab += INDENT_SIZE;
+    for (unsigned int i = 0; i < params.size(); ++i)
+    {
+      assert(exprs);
+      _indent << Utils::stringFill(SPACING_CHAR, _tab);
+      visit(params[i].first);
+      _indent << " _tail_arg" << i << " = ";
+      visit(exprs->getExpr());
+      _indent << ";\n";
+      exprs = exprs->getExprs();
+    }
+    for (unsigned int i = 0; i < params.size(); ++i)
+    {
+      _indent << Utils::stringFill(SPACING_CHAR, _tab);
+      visit(params[i].second);
+      _indent << " = _tail_arg" << i << ";\n";
+    }
+    _indent << Utils::stringFill(SPACING_CHAR, _tab) << "goto _tail_call;\n";
+    _tab -= INDENT_SIZE;
+    _indent << Utils::stringFill(SPACING_CHAR, _tab) << "}\n";
   }
 
   /*!
@@ -254,8 +959,8 @@ namespace MiniCompiler
     assert(node);
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
-    _indent << "exit(";
-    expr->accept(*this);
+    _indent << (_hosted ? "cubs::exit(" : "exit(");
+    visit(expr);
     _indent << ')';
   }
 
@@ -272,10 +977,39 @@ namespace MiniCompiler
     const AST::NodeExpressions* exprs = node->getExprs();
     assert(id);
 
-    id->accept(*this);
+    // Like in the execution, arguments are evaluated from left to right
+    unsigned int nb = 0;
+    bool ordered = false;
+    for (const AST::NodeExpressions* e = exprs; e; e = e->getExprs())
+    {
+      ordered = ordered || hasCall(e->getExpr());
+      nb++;
+    }
+    if (_hosted && ordered && nb > 1)
+    {
+      _indent << "[&]() { ";
+      nb = 0;
+      for (const AST::NodeExpressions* e = exprs; e; e = e->getExprs())
+      {
+	_indent << "const auto arg" << nb++ << " = ";
+	writeArgument(e->getExpr());
+	_indent << "; ";
+      }
+      _indent << "return ";
+      visit(id);
+      _indent << '(';
+      writeDepth(node);
+      for (unsigned int i = 0; i < nb; ++i)
+	_indent << (i ? ", " : "") << "arg" << i;
+      _indent << "); }()";
+      return;
+    }
+
+    visit(id);
     _indent << '(';
+    writeDepth(node);
     if (exprs)
-      exprs->accept(*this);
+      visit(exprs);
     _indent << ')';
   }
 
@@ -288,7 +1022,48 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeOperation* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    const AST::Operator::type op = node->getOpType();
+    if (!_hosted || op == AST::Operator::NONE)
+    {
+      BasicPrettyPrinterVisitor<ConvertToCppVisitor>::visit(node);
+      return;
+    }
+
+    // Like in the execution, the left operand is evaluated first, and a
+    // division by zero stops the execution. C++ doesn't order operands, so
+    // a call on either side, which may change a global read by the other
+    // one, needs the left operand in a temporary
+    const AST::NodeFactor* left = node->getLeftFactor();
+    const AST::NodeFactor* right = node->getRightFactor();
+    assert(left);
+    assert(right);
+    const bool ordered = (hasCall(left) || hasCall(right)) &&
+      !isLiteral(left) && !isLiteral(right);
+    const bool checked =
+      (op == AST::Operator::DIV || op == AST::Operator::MODULO) &&
+      !(right->getNumber() && right->getNumber()->getNumber() != 0);
+
+    if (ordered)
+    {
+      _indent << "[&]() { const auto left = ";
+      visit(left);
+      _indent << "; return ";
+    }
+    if (checked)
+      _indent << (op == AST::Operator::DIV ? "cubs::divide(" : "cubs::modulo(");
+    if (ordered)
+      _indent << "left";
+    else
+      visit(left);
+    if (checked)
+      _indent << ", ";
+    else
+      _indent << ' ' << Utils::OpToString(op) << ' ';
+    visit(right);
+    if (checked)
+      _indent << ')';
+    if (ordered)
+      _indent << "; }()";
   }
 
   /*!
@@ -300,7 +1075,7 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeExpression* node)
   {
     assert(node);
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<ConvertToCppVisitor>::visit(node);
   }
 
   /*!
@@ -312,6 +1087,24 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeStringExpr* node)
   {
     assert(node);
+    if (_optimized)
+    {
+      const std::map<std::string, unsigned int>& strings =
+	_global ? _global->_strings : _strings;
+      std::map<std::string, unsigned int>::const_iterator i =
+	strings.find(Utils::activeSpecialChar(node->getString()));
+      assert(i != strings.end());
+      _indent << "cubs::string" << i->second;
+      return;
+    }
+    if (_hosted)
+    {
+      const std::string s = Utils::activeSpecialChar(node->getString());
+      _indent << "std::string(";
+      writeString(s);
+      _indent << ", " << s.length() << ')';
+      return;
+    }
     _indent << "std::string(\"";
     _indent << node->getString();
     _indent << "\")";
@@ -342,11 +1135,11 @@ namespace MiniCompiler
     const AST::NodeExpressions* exprs = node->getExprs();
     assert(expr);
 
-    expr->accept(*this);
+    writeArgument(expr);
     if (exprs)
     {
       _indent <<", ";
-      exprs->accept(*this);
+      visit(exprs);
     }
   }
 
@@ -383,50 +1176,47 @@ namespace MiniCompiler
 
     if (compoundInstr)
     {
-      compoundInstr->accept(*this);
+      visit(compoundInstr);
       return;
     }
 
     _indent << Utils::stringFill(SPACING_CHAR, _tab);
     if (affect)
     {
-      affect->accept(*this);
+      visit(affect);
       _indent << ";\n";
     }
     else
       if (callFunc)
       {
-	callFunc->accept(*this);
+	visit(callFunc);
 	_indent << ";\n";
       }
       else
 	if (nIf)
-	  nIf->accept(*this);
+	  visit(nIf);
 	else
 	  if (nWhile)
-	    nWhile->accept(*this);
+	    visit(nWhile);
 	  else
 	    if (nReturn)
-	    {
-	      nReturn->accept(*this);
-	      _indent << ";\n";
-	    }
+	      visit(nReturn);
 	    else
 	      if (nExit)
 	      {
-		nExit->accept(*this);
+		visit(nExit);
 		_indent << ";\n";
 	      }
 	      else
 		if (nPrint)
 		{
-		  nPrint->accept(*this);
+		  visit(nPrint);
 		  _indent << ";\n";
 		}
 		else
 		  if (nRead)
 		  {
-		    nRead->accept(*this);
+		    visit(nRead);
 		    _indent << ";\n";
 		  }
   }
@@ -445,7 +1235,7 @@ namespace MiniCompiler
     _indent << Utils::stringFill(SPACING_CHAR, _tab) << "{\n";
     _tab += INDENT_SIZE;
     if (instrs)
-      instrs->accept(*this);
+      visit(instrs);
     _tab -= INDENT_SIZE;
     _indent << Utils::stringFill(SPACING_CHAR, _tab) <<  "}\n";
   }
@@ -463,11 +1253,11 @@ namespace MiniCompiler
     if (expression)
     {
       _indent << '(';
-      expression->accept(*this);
+      visit(expression);
       _indent << ')';
     }
     else
-      ConstBaseVisitor::visit(node);
+      ConstBaseVisitor<ConvertToCppVisitor>::visit(node);
   }
 
   /*!
@@ -479,7 +1269,7 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeInstrs* node)
   {
     assert(node);
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<ConvertToCppVisitor>::visit(node);
   }
 
   /*!
@@ -493,7 +1283,7 @@ namespace MiniCompiler
     assert(node);
     Configuration& cfg = Configuration::getInstance();
     if (node->getType() == cfg["int"])
-      _indent << "int";
+      _indent << (_optimized ? "std::int32_t" : "int");
     else
       if (node->getType() == cfg["bool"])
 	_indent << "bool";
@@ -519,16 +1309,32 @@ namespace MiniCompiler
     assert(header);
     assert(instr);
 
-    header->accept(*this);
+    _currentFunction = node;
+    findAssigned(node);
+    visit(header);
     _indent << Utils::stringFill(SPACING_CHAR, _tab) << "{\n";
     _tab += INDENT_SIZE;
-    if (decls)
-      decls->accept(*this);
     AST::NodeInstrs* instrs = instr->getInstrs();
+    if (_hosted)
+      _indent << Utils::stringFill(SPACING_CHAR, _tab)
+	      << "cubs::enter(depth);\n";
+    // Locals are initialized again by a self tail call, like in the
+    // execution, but the call depth is unchanged
+    if (hasSelfTailCall(instrs))
+      _indent << "_tail_call:\n";
+    if (decls)
+      visit(decls);
     if (instrs)
-      instrs->accept(*this);
+      visit(instrs);
+    if (_hosted)
+    {
+      _indent << Utils::stringFill(SPACING_CHAR, _tab) << "return ";
+      visit(header->getType());
+      _indent << "();\n";
+    }
     _tab -= INDENT_SIZE;
     _indent << Utils::stringFill(SPACING_CHAR, _tab) << "}\n";
+    _currentFunction = 0;
   }
 
   /*!
@@ -546,9 +1352,9 @@ namespace MiniCompiler
     assert(body);
 
     _indent << "while (";
-    cond->accept(*this);
+    visit(cond);
     _indent << ")\n";
-    body->accept(*this);
+    visit(body);
   }
 
   /*!
@@ -568,11 +1374,16 @@ namespace MiniCompiler
     const AST::NodeId* id = 0;
     while (ids)
     {
-      type->accept(*this);
-      _indent << ' ';
       id = ids->getId();
       assert(id);
-      id->accept(*this);
+      const bool reference = _optimized &&
+	id->getComputedType() == AST::Type::STRING &&
+	_assigned.find(id) == _assigned.end();
+      if (reference)
+	_indent << "const ";
+      visit(type);
+      _indent << (reference ? "& " : " ");
+      visit(id);
       ids = ids->getIds();
       if (ids)
 	_indent << ", ";
@@ -588,7 +1399,57 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeFunctions* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    if (_global || !visitInParallel(node))
+      BasicPrettyPrinterVisitor<ConvertToCppVisitor>::visit(node);
+  }
+
+  /*!
+  ** Convert each function apart, on a thread pool, then append them in
+  ** order of declaration, so the C++ is the same as the one written by
+  ** a single thread.
+  **
+  ** @param node The functions node
+  **
+  ** @return If the functions were converted, false when there is only
+  ** one function or one thread
+  */
+  bool
+  ConvertToCppVisitor::visitInParallel(const AST::NodeFunctions* node)
+  {
+    assert(node);
+    Functions functions;
+
+    for (; node; node = node->getFuncs())
+      functions.nodes.push_back(node->getFunc());
+    if (_jobs < 2 || functions.nodes.size() < 2)
+      return false;
+
+    for (unsigned int i = 0; i < functions.nodes.size(); i++)
+      functions.visitors.push_back(new ConvertToCppVisitor(this));
+    ThreadPool pool(_jobs);
+    pool.run(&ConvertToCppVisitor::launch, &functions,
+	     functions.nodes.size());
+    for (unsigned int i = 0; i < functions.visitors.size(); i++)
+    {
+      writeFunction(*functions.visitors[i]);
+      delete functions.visitors[i];
+    }
+
+    return true;
+  }
+
+  /*!
+  ** Convert a function, from a thread of the pool.
+  **
+  ** @param data The functions
+  ** @param i The number of the function to convert
+  */
+  void
+  ConvertToCppVisitor::launch(void* data, const unsigned int i)
+  {
+    Functions* functions = static_cast<Functions*>(data);
+
+    functions->visitors[i]->visit(functions->nodes[i]);
   }
 
   /*!
@@ -600,11 +1461,18 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeNumber* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    // The smallest integer can only be written as an expression in C++
+    if (_hosted && node->getNumber() == std::numeric_limits<int>::min())
+    {
+      _indent << '(' << node->getNumber() + 1 << " - 1)";
+      return;
+    }
+    BasicPrettyPrinterVisitor<ConvertToCppVisitor>::visit(node);
   }
 
   /*!
-  ** Convert the declaration node
+  ** Convert the declaration node. Variables are initialized like in
+  ** the execution.
   **
   ** @param node The declaration node
   */
@@ -623,11 +1491,14 @@ namespace MiniCompiler
     while (ids)
     {
       _indent << Utils::stringFill(SPACING_CHAR, _tab);
-      type->accept(*this);
+      visit(type);
       _indent << ' ';
       id = ids->getId();
       assert(id);
-      id->accept(*this);
+      visit(id);
+      _indent << " = ";
+      visit(type);
+      _indent << "()";
       ids = ids->getIds();
       _indent << ";\n";
     }
@@ -649,12 +1520,16 @@ namespace MiniCompiler
     assert(id);
     assert(type);
 
-    type->accept(*this);
+    if (_optimized)
+      _indent << "static inline ";
+    visit(type);
     _indent << ' ';
-    id->accept(*this);
+    visit(id);
     _indent << '(';
+    if (_hosted)
+      _indent << "unsigned int depth" << (args ? ", " : "");
     if (args)
-      args->accept(*this);
+      visit(args);
     _indent << ")\n";
   }
 
@@ -667,7 +1542,7 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeDeclarations* node)
   {
     assert(node);
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<ConvertToCppVisitor>::visit(node);
   }
 
   /*!
@@ -679,7 +1554,9 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeId* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    if (_hosted)
+      _indent << "v_";
+    BasicPrettyPrinterVisitor<ConvertToCppVisitor>::visit(node);
   }
 
   /*!
@@ -691,7 +1568,9 @@ namespace MiniCompiler
   ConvertToCppVisitor::visit(const AST::NodeIdFunc* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    if (_hosted)
+      _indent << "f_";
+    BasicPrettyPrinterVisitor<ConvertToCppVisitor>::visit(node);
   }
 
   /*!
@@ -706,8 +1585,25 @@ namespace MiniCompiler
     const AST::NodeExpression* id = node->getExpr();
     assert(id);
 
+    if (_hosted)
+    {
+      _indent << "cubs::print(";
+      visit(id);
+      _indent << ')';
+      return;
+    }
+    // A comparison binds less than <<, and a checked boolean is printed
+    // like the execution does
+    const bool boolean = id->getComputedType() == AST::Type::BOOLEAN;
+    const bool operation = id->getOperation()->getOpType() != AST::Operator::NONE;
     _indent << "std::cout << ";
-    id->accept(*this);
+    if (boolean || operation)
+      _indent << '(';
+    visit(id);
+    if (boolean)
+      _indent << " ? \"true\" : \"false\"";
+    if (boolean || operation)
+      _indent << ')';
   }
 
   /*!
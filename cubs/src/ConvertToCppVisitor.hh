@@ -2,55 +2,99 @@
 # define CONVERTTOCPPVISITOR_HH_
 
 # include <iomanip>
+# include <map>
+# include <set>
 # include <sstream>
+# include <vector>
+# include <utility>
 # include "PrettyPrinterVisitor.hh"
 
 namespace MiniCompiler
 {
-  class ConvertToCppVisitor : public PrettyPrinterVisitor
+  class ConvertToCppVisitor :
+    public BasicPrettyPrinterVisitor<ConvertToCppVisitor>
   {
     friend std::ostream&
     operator<<(std::ostream& o, const ConvertToCppVisitor& v);
 
+    typedef std::pair<const AST::NodeType*, const AST::NodeId*> Parameter;
+    typedef std::vector<Parameter> Parameters;
+
+  public:
+    static const char* const ENTRY;
+
   public:
     ConvertToCppVisitor();
-    virtual ~ConvertToCppVisitor();
+    ~ConvertToCppVisitor();
 
   public:
-    virtual void visit(const AST::NodeIds* node);
-    virtual void visit(const AST::NodeProgram* node);
-    virtual void visit(const AST::NodeAffect* node);
-    virtual void visit(const AST::NodeIf* node);
-    virtual void visit(const AST::NodeRead* node);
-    virtual void visit(const AST::NodeArgument* node);
-    virtual void visit(const AST::NodeArguments* node);
-    virtual void visit(const AST::NodeReturn* node);
-    virtual void visit(const AST::NodeExit* node);
-    virtual void visit(const AST::NodeCallFunc* node);
-    virtual void visit(const AST::NodeOperation* node);
-    virtual void visit(const AST::NodeExpression* node);
-    virtual void visit(const AST::NodeStringExpr* node);
-    virtual void visit(const AST::NodeBoolean* node);
-    virtual void visit(const AST::NodeExpressions* node);
-    virtual void visit(const AST::NodeInstr* node);
-    virtual void visit(const AST::NodeCompoundInstr* node);
-    virtual void visit(const AST::NodeFactor* node);
-    virtual void visit(const AST::NodeInstrs* node);
-    virtual void visit(const AST::NodeType* node);
-    virtual void visit(const AST::NodeFunction* node);
-    virtual void visit(const AST::NodeWhile* node);
-    virtual void visit(const AST::NodeDeclarationBody* node);
-    virtual void visit(const AST::NodeFunctions* node);
-    virtual void visit(const AST::NodeNumber* node);
-    virtual void visit(const AST::NodeDeclaration* node);
-    virtual void visit(const AST::NodeHeaderFunc* node);
-    virtual void visit(const AST::NodeDeclarations* node);
-    virtual void visit(const AST::NodeId* node);
-    virtual void visit(const AST::NodeIdFunc* node);
-    virtual void visit(const AST::NodePrint* node);
+    void setHosted(const bool hosted);
+    void setOptimized(const bool optimized);
+    void setJobs(const unsigned int jobs);
+
+  private:
+    ConvertToCppVisitor(const ConvertToCppVisitor* global);
+
+  public:
+    void visit(const AST::NodeIds* node);
+    void visit(const AST::NodeProgram* node);
+    void visit(const AST::NodeAffect* node);
+    void visit(const AST::NodeIf* node);
+    void visit(const AST::NodeRead* node);
+    void visit(const AST::NodeArgument* node);
+    void visit(const AST::NodeArguments* node);
+    void visit(const AST::NodeReturn* node);
+    void visit(const AST::NodeExit* node);
+    void visit(const AST::NodeCallFunc* node);
+    void visit(const AST::NodeOperation* node);
+    void visit(const AST::NodeExpression* node);
+    void visit(const AST::NodeStringExpr* node);
+    void visit(const AST::NodeBoolean* node);
+    void visit(const AST::NodeExpressions* node);
+    void visit(const AST::NodeInstr* node);
+    void visit(const AST::NodeCompoundInstr* node);
+    void visit(const AST::NodeFactor* node);
+    void visit(const AST::NodeInstrs* node);
+    void visit(const AST::NodeType* node);
+    void visit(const AST::NodeFunction* node);
+    void visit(const AST::NodeWhile* node);
+    void visit(const AST::NodeDeclarationBody* node);
+    void visit(const AST::NodeFunctions* node);
+    void visit(const AST::NodeNumber* node);
+    void visit(const AST::NodeDeclaration* node);
+    void visit(const AST::NodeHeaderFunc* node);
+    void visit(const AST::NodeDeclarations* node);
+    void visit(const AST::NodeId* node);
+    void visit(const AST::NodeIdFunc* node);
+    void visit(const AST::NodePrint* node);
 
   private:
     void visitFuncHeader(const AST::NodeFunctions* node);
+    void getParameters(const AST::NodeFunction* func,
+		       Parameters& params) const;
+    bool isSelfTailCall(const AST::NodeReturn* node) const;
+    bool hasSelfTailCall(const AST::NodeInstrs* node) const;
+    void writeRuntime();
+    void writeEntry(const AST::NodeProgram* node);
+    void writeString(const std::string& s);
+    void writeDepth(const AST::NodeCallFunc* call);
+    void writeArgument(const AST::NodeExpression* expr);
+    void writeStrings();
+    void findAssigned(const AST::NodeFunction* func);
+    void writeFunction(const ConvertToCppVisitor& function);
+    bool visitInParallel(const AST::NodeFunctions* node);
+    static void launch(void* data, const unsigned int i);
+
+  private:
+    const AST::NodeFunction*	_currentFunction;
+    bool			_hosted;
+    const AST::NodeCallFunc*	_tailCall;
+    bool			_optimized;
+    std::set<const AST::NodeId*>	_assigned;
+    std::set<const AST::NodeId*>	_globals;
+    std::map<std::string, unsigned int>	_strings;
+    const ConvertToCppVisitor*	_global;
+    unsigned int		_jobs;
   };
 }
 
@@ -11,10 +11,25 @@ namespace MiniCompiler
   ** @param lexer The given lexer
   */
   CreateAST::CreateAST(const Lexer& lexer)
-    : _lexer(lexer), _pos(0), _size(lexer.length())
+    : _lexer(lexer), _pos(0), _size(lexer.length()), _jobs(1)
   {
   }
 
+  /*!
+  ** Construct the CreateAST for a part of a Lexer only.
+  ** Tokens after the end are seen as the end of file.
+  **
+  ** @param lexer The given lexer
+  ** @param begin The position of the first token
+  ** @param end The position after the last token
+  */
+  CreateAST::CreateAST(const Lexer& lexer, const unsigned int begin,
+		       const unsigned int end)
+    : _lexer(lexer), _pos(begin), _size(end), _jobs(1)
+  {
+    assert(begin <= end && end <= lexer.length());
+  }
+
   /*!
   ** Destruct the CreateAST
   */
@@ -22,6 +37,128 @@ namespace MiniCompiler
   {
   }
 
+  /*!
+  ** Set the maximum number of threads parsing functions.
+  **
+  ** @param jobs The number of threads, at least 1
+  */
+  void
+  CreateAST::setJobs(const unsigned int jobs)
+  {
+    assert(jobs > 0);
+    _jobs = jobs;
+  }
+
+  /*!
+  ** Find the tokens of each function, from the current one, without
+  ** parsing them: a function ends with the end matching the first begin
+  ** after its function keyword.
+  **
+  ** @return If there are several functions, all with a complete body
+  */
+  bool
+  CreateAST::scanFunctions()
+  {
+    unsigned int pos = _pos;
+
+    _functions.clear();
+    while (pos < _size && isFunctions(_lexer[pos]))
+    {
+      Function function = { pos, pos, 0, false };
+      unsigned int depth = 0;
+
+      while (pos < _size && !isBegin(_lexer[pos]))
+	++pos;
+      for (; pos < _size; ++pos)
+	if (isBegin(_lexer[pos]))
+	  ++depth;
+	else
+	  if (isEnd(_lexer[pos]) && --depth == 0)
+	    break;
+      if (pos >= _size)
+      {
+	_functions.clear();
+	return false;
+      }
+      function.end = ++pos;
+      _functions.push_back(function);
+    }
+
+    return _functions.size() > 1;
+  }
+
+  /*!
+  ** Parse each function on a thread pool, then link them in order.
+  ** Only correct functions are kept: as soon as one of them has an
+  ** error, nothing is kept, so that the sequential parser finds the
+  ** same errors as without threads.
+  **
+  ** @param node The functions node
+  **
+  ** @return If all functions were parsed
+  */
+  bool
+  CreateAST::constructInParallel(AST::NodeFunctions* node)
+  {
+    assert(node);
+    if (_jobs < 2 || !scanFunctions())
+      return false;
+
+    typedef std::vector<Function>::iterator iter;
+    ThreadPool pool(_jobs);
+    bool parsed = true;
+
+    pool.run(&CreateAST::launch, this, _functions.size());
+    for (iter function = _functions.begin();
+	 function != _functions.end(); ++function)
+      parsed = parsed && function->parsed;
+
+    if (!parsed)
+    {
+      for (iter function = _functions.begin();
+	   function != _functions.end(); ++function)
+	delete function->node;
+      _functions.clear();
+      return false;
+    }
+
+    for (iter function = _functions.begin();
+	 function != _functions.end(); ++function)
+    {
+      if (function != _functions.begin())
+      {
+	AST::NodeFunctions* funcs = new AST::NodeFunctions();
+	node->setFuncs(funcs);
+	node = funcs;
+      }
+      node->setLine(_lexer[function->begin].getLine());
+      node->setFunc(function->node);
+    }
+    _pos = _functions.back().end;
+    _functions.clear();
+
+    return true;
+  }
+
+  /*!
+  ** Parse a function, from a thread of the pool.
+  **
+  ** @param data The CreateAST
+  ** @param i The number of the function to parse
+  */
+  void
+  CreateAST::launch(void* data, const unsigned int i)
+  {
+    CreateAST* creator = static_cast<CreateAST*>(data);
+    Function& function = creator->_functions[i];
+    CreateAST range(creator->_lexer, function.begin, function.end);
+
+    function.node = new AST::NodeFunction();
+    range.construct(function.node);
+    function.parsed = !range._errors.hasErrors() &&
+      range._pos == function.end;
+  }
+
   /*!
   ** Create all necessary nodes own by ids node.
   **
@@ -89,7 +226,8 @@ namespace MiniCompiler
     {
       AST::NodeFunctions* funcs = new AST::NodeFunctions();
       node->setFuncs(funcs);
-      construct(funcs);
+      if (!constructInParallel(funcs))
+	construct(funcs);
       if (!valid())
 	return;
     }
@@ -2,6 +2,7 @@
 # define CREATEAST_HH_
 
 # include <cassert>
+# include <vector>
 # include "Lexer.hh"
 # include "Configuration.hh"
 # include "NodeIds.hh"
@@ -37,6 +38,7 @@
 # include "NodePrint.hh"
 # include "ErrorHandler.hh"
 # include "Error.hh"
+# include "ThreadPool.hh"
 
 namespace MiniCompiler
 {
@@ -45,6 +47,7 @@ namespace MiniCompiler
   public:
     CreateAST(const Lexer& lexer);
     ~CreateAST();
+    void setJobs(const unsigned int jobs);
     void construct(AST::NodeIds* node);
     void construct(AST::NodeProgram* node);
     void construct(AST::NodeAffect* node);
@@ -80,6 +83,25 @@ namespace MiniCompiler
   public:
     const ErrorHandler& getErrors() const;
 
+  private:
+    /*!
+    ** The tokens of a function, from function to the end of its body.
+    */
+    struct Function
+    {
+      unsigned int		begin;
+      unsigned int		end;
+      AST::NodeFunction*	node;
+      bool			parsed;
+    };
+
+  private:
+    CreateAST(const Lexer& lexer, const unsigned int begin,
+	      const unsigned int end);
+    bool scanFunctions();
+    bool constructInParallel(AST::NodeFunctions* node);
+    static void launch(void* data, const unsigned int i);
+
   private:
     void error(std::string attempted,
 	       const Symbol& symb);
@@ -145,6 +167,8 @@ namespace MiniCompiler
     unsigned int	_pos;
     const unsigned int	_size;
     ErrorHandler	_errors;
+    unsigned int	_jobs;
+    std::vector<Function>	_functions;
   };
 }
 
@@ -0,0 +1,40 @@
+#include <cassert>
+#include "DeadCodePass.hh"
+#include "DeadCodeVisitor.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct the dead code pass, used from level 2.
+  ** Conditions are folded first, so more code is known as dead.
+  */
+  DeadCodePass::DeadCodePass()
+    : Pass("dead-code", false, 2)
+  {
+    addDependency("constant-folding");
+  }
+
+  /*!
+  ** Destruct the dead code pass.
+  */
+  DeadCodePass::~DeadCodePass()
+  {
+  }
+
+  /*!
+  ** Remove dead code of the given AST.
+  **
+  ** @param tree The root of the AST
+  **
+  ** @return The number of changes
+  */
+  unsigned int
+  DeadCodePass::run(AST::NodeProgram* tree)
+  {
+    assert(tree);
+    DeadCodeVisitor visitor;
+    visitor.visit(tree);
+
+    return visitor.nbChanges();
+  }
+}
@@ -0,0 +1,21 @@
+#ifndef DEADCODEPASS_HH_
+# define DEADCODEPASS_HH_
+
+# include "Pass.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Transformation removing code which is never executed,
+  ** see DeadCodeVisitor.
+  */
+  class DeadCodePass : public Pass
+  {
+  public:
+    DeadCodePass();
+    virtual ~DeadCodePass();
+    virtual unsigned int run(AST::NodeProgram* tree);
+  };
+}
+
+#endif /* !DEADCODEPASS_HH_ */
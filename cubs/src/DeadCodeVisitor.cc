@@ -0,0 +1,130 @@
+#include "DeadCodeVisitor.hh"
+#include "NodeInstrs.hh"
+#include "NodeInstr.hh"
+#include "NodeIf.hh"
+#include "NodeWhile.hh"
+#include "NodeCompoundInstr.hh"
+#include "NodeExpression.hh"
+#include "NodeOperation.hh"
+#include "NodeFactor.hh"
+#include "NodeBoolean.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct the dead code visitor.
+  */
+  DeadCodeVisitor::DeadCodeVisitor()
+    : _nbChanges(0)
+  {
+  }
+
+  /*!
+  ** Destruct the dead code visitor.
+  */
+  DeadCodeVisitor::~DeadCodeVisitor()
+  {
+  }
+
+  /*!
+  ** Get the number of removed or simplified instructions.
+  **
+  ** @return The number of changes
+  */
+  unsigned int
+  DeadCodeVisitor::nbChanges() const
+  {
+    return _nbChanges;
+  }
+
+  /*!
+  ** Simplify each instruction of a block, and cut the block after
+  ** a return or an exit.
+  **
+  ** @param node The instructions node
+  */
+  void
+  DeadCodeVisitor::visit(AST::NodeInstrs* node)
+  {
+    assert(node);
+    for (AST::NodeInstrs* instrs = node; instrs; instrs = instrs->getInstrs())
+    {
+      AST::NodeInstr* instr = instrs->getInstr();
+      assert(instr);
+      simplify(instr);
+      visit(instr);
+
+      if ((instr->getReturn() || instr->getExit()) && instrs->getInstrs())
+      {
+	delete instrs->getInstrs();
+	instrs->setInstrs(0);
+	_nbChanges++;
+      }
+    }
+  }
+
+  /*!
+  ** Check if an expression is a boolean literal.
+  **
+  ** @param expr The expression node
+  ** @param value The value of the literal, if found
+  **
+  ** @return If the expression is a boolean literal
+  */
+  bool
+  DeadCodeVisitor::isLiteral(const AST::NodeExpression* expr, bool& value)
+  {
+    assert(expr);
+    const AST::NodeOperation* op = expr->getOperation();
+    assert(op);
+    if (op->getOpType() != AST::Operator::NONE)
+      return false;
+    const AST::NodeFactor* factor = op->getLeftFactor();
+    assert(factor);
+    if (!factor->getBool())
+      return false;
+
+    value = factor->getBool()->getBool();
+    return true;
+  }
+
+  /*!
+  ** Replace an if or a while with a literal condition
+  ** by the only block which can be executed.
+  **
+  ** @param instr The instruction node
+  */
+  void
+  DeadCodeVisitor::simplify(AST::NodeInstr* instr)
+  {
+    assert(instr);
+    AST::NodeIf* nIf = instr->getIf();
+    AST::NodeWhile* nWhile = instr->getWhile();
+    AST::NodeCompoundInstr* kept = 0;
+    bool value = false;
+
+    if (nIf && isLiteral(nIf->getCond(), value))
+    {
+      kept = value ? nIf->getBodyExprs() : nIf->getElseExprs();
+      if (value)
+	nIf->setBodyExprs(0);
+      else
+	nIf->setElseExprs(0);
+      instr->setIf(0);
+      delete nIf;
+    }
+    else
+      if (nWhile && isLiteral(nWhile->getCond(), value) && !value)
+      {
+	instr->setWhile(0);
+	delete nWhile;
+      }
+      else
+	return;
+
+    if (!kept)
+      kept = new AST::NodeCompoundInstr();
+    instr->setCompoundInstr(kept);
+    _nbChanges++;
+  }
+}
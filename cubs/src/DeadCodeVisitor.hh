@@ -0,0 +1,34 @@
+#ifndef DEADCODEVISITOR_HH_
+# define DEADCODEVISITOR_HH_
+
+# include <cassert>
+# include "BaseVisitor.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Remove instructions which can't be executed: those following a
+  ** return or an exit in the same block, branches of an if whose
+  ** condition is a literal, and loops whose condition is false.
+  */
+  class DeadCodeVisitor : public NonConstBaseVisitor<DeadCodeVisitor>
+  {
+  public:
+    DeadCodeVisitor();
+    ~DeadCodeVisitor();
+    using NonConstBaseVisitor<DeadCodeVisitor>::visit;
+    void visit(AST::NodeInstrs* node);
+
+  public:
+    unsigned int nbChanges() const;
+
+  private:
+    static bool isLiteral(const AST::NodeExpression* expr, bool& value);
+    void simplify(AST::NodeInstr* instr);
+
+  private:
+    unsigned int	_nbChanges;
+  };
+}
+
+#endif /* !DEADCODEVISITOR_HH_ */
@@ -0,0 +1,194 @@
+#include "ELFWriter.hh"
+
+namespace MiniCompiler
+{
+  namespace
+  {
+    const unsigned int ELF_HEADER_SIZE = 64;
+    const unsigned int PROGRAM_HEADER_SIZE = 56;
+    const unsigned int NB_PROGRAM_HEADERS = 2;
+    const unsigned int SECTION_ALIGN = 16;
+
+    /*!
+    ** Round a size up to a multiple of the given alignment.
+    **
+    ** @param size The size
+    ** @param align The alignment, a power of 2
+    **
+    ** @return The rounded size
+    */
+    unsigned int
+    alignUp(const unsigned int size, const unsigned int align)
+    {
+      return (size + align - 1) & ~(align - 1);
+    }
+  }
+
+  /*!
+  ** Construct a writer for the given code.
+  **
+  ** @param assembler The assembled code, linked by write
+  */
+  ELFWriter::ELFWriter(ASM64Assembler& assembler)
+    : _assembler(assembler)
+  {
+  }
+
+  /*!
+  ** Destruct the writer.
+  */
+  ELFWriter::~ELFWriter()
+  {
+  }
+
+  /*!
+  ** Place sections, link the code, then write the executable.
+  ** Text and rodata follow the headers in the first segment. Data
+  ** follows them in the file too, but is mapped at another address, so
+  ** that it can be writable.
+  **
+  ** @param o The stream, which must be binary
+  ** @param entry The symbol where execution begins
+  **
+  ** @return If the code could be linked, else see getError
+  */
+  bool
+  ELFWriter::write(std::ostream& o, const std::string& entry)
+  {
+    typedef ASM64Assembler A;
+    const unsigned int headers =
+      ELF_HEADER_SIZE + NB_PROGRAM_HEADERS * PROGRAM_HEADER_SIZE;
+    unsigned int offsets[A::NB_SECTIONS];
+    A::Address bases[A::NB_SECTIONS];
+
+    offsets[A::TEXT] = alignUp(headers, SECTION_ALIGN);
+    offsets[A::RODATA] = alignUp(offsets[A::TEXT] +
+				 _assembler.getSize(A::TEXT), SECTION_ALIGN);
+    offsets[A::DATA] = alignUp(offsets[A::RODATA] +
+			       _assembler.getSize(A::RODATA), SECTION_ALIGN);
+    offsets[A::BSS] = alignUp(offsets[A::DATA] +
+			      _assembler.getSize(A::DATA), SECTION_ALIGN);
+    // Mapped address and file offset must be equal modulo the page size
+    for (unsigned int i = 0; i < A::NB_SECTIONS; ++i)
+    {
+      bases[i] = offsets[i];
+      if (i < A::DATA)
+	bases[i] += BASE_ADDRESS;
+      else
+	bases[i] += DATA_ADDRESS;
+    }
+
+    if (!_assembler.link(bases))
+    {
+      _error = _assembler.getError();
+      return false;
+    }
+    A::section where;
+    unsigned int offset = 0;
+    if (!_assembler.getSymbol(entry, where, offset) || where != A::TEXT)
+    {
+      _error = "Undefined entry point: " + entry;
+      return false;
+    }
+
+    const unsigned int codeSize = offsets[A::DATA];
+    const unsigned int dataSize = offsets[A::BSS] - offsets[A::DATA];
+    const unsigned int memorySize = dataSize + _assembler.getSize(A::BSS);
+
+    // ELF header
+    o << "\x7F" "ELF";
+    writeValue(o, 2, 1);		// 64 bits
+    writeValue(o, 1, 1);		// Little endian
+    writeValue(o, 1, 1);		// Version
+    writeValue(o, 0, 1);		// System V ABI
+    writeValue(o, 0, 8);		// Padding
+    writeValue(o, 2, 2);		// Executable
+    writeValue(o, 62, 2);		// x86-64
+    writeValue(o, 1, 4);		// Version
+    writeValue(o, bases[A::TEXT] + offset, 8);
+    writeValue(o, ELF_HEADER_SIZE, 8);	// Program headers
+    writeValue(o, 0, 8);		// No section header
+    writeValue(o, 0, 4);		// Flags
+    writeValue(o, ELF_HEADER_SIZE, 2);
+    writeValue(o, PROGRAM_HEADER_SIZE, 2);
+    writeValue(o, NB_PROGRAM_HEADERS, 2);
+    writeValue(o, 64, 2);		// Size of a section header
+    writeValue(o, 0, 2);
+    writeValue(o, 0, 2);
+
+    // Code segment: headers, text and rodata, readable and executable
+    writeValue(o, 1, 4);		// Loadable
+    writeValue(o, 5, 4);
+    writeValue(o, 0, 8);
+    writeValue(o, BASE_ADDRESS, 8);
+    writeValue(o, BASE_ADDRESS, 8);
+    writeValue(o, codeSize, 8);
+    writeValue(o, codeSize, 8);
+    writeValue(o, PAGE_SIZE, 8);
+
+    // Data segment: data and bss, readable and writable
+    writeValue(o, 1, 4);
+    writeValue(o, 6, 4);
+    writeValue(o, offsets[A::DATA], 8);
+    writeValue(o, bases[A::DATA], 8);
+    writeValue(o, bases[A::DATA], 8);
+    writeValue(o, dataSize, 8);
+    writeValue(o, memorySize, 8);
+    writeValue(o, PAGE_SIZE, 8);
+
+    writeBytes(o, A::Bytes(), offsets[A::TEXT] - headers);
+    writeBytes(o, _assembler.getSection(A::TEXT),
+	       offsets[A::RODATA] - offsets[A::TEXT]);
+    writeBytes(o, _assembler.getSection(A::RODATA),
+	       offsets[A::DATA] - offsets[A::RODATA]);
+    writeBytes(o, _assembler.getSection(A::DATA), dataSize);
+
+    return o.good();
+  }
+
+  /*!
+  ** Get the last error.
+  **
+  ** @return The error message
+  */
+  const std::string&
+  ELFWriter::getError() const
+  {
+    return _error;
+  }
+
+  /*!
+  ** Write a value in little endian.
+  **
+  ** @param o The stream
+  ** @param value The value
+  ** @param size Its size in bytes
+  */
+  void
+  ELFWriter::writeValue(std::ostream& o, unsigned long long value,
+			const unsigned int size) const
+  {
+    for (unsigned int i = 0; i < size; ++i)
+    {
+      o.put(static_cast<char>(value & 0xFF));
+      value >>= 8;
+    }
+  }
+
+  /*!
+  ** Write bytes, padded with zeros up to the given size.
+  **
+  ** @param o The stream
+  ** @param bytes The bytes
+  ** @param size The size to write, at least the number of bytes
+  */
+  void
+  ELFWriter::writeBytes(std::ostream& o, const ASM64Assembler::Bytes& bytes,
+			const unsigned int size) const
+  {
+    if (!bytes.empty())
+      o.write(reinterpret_cast<const char*>(&bytes[0]), bytes.size());
+    for (unsigned int i = bytes.size(); i < size; ++i)
+      o.put(0);
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef ELFWRITER_HH_
+# define ELFWRITER_HH_
+
+# include <iostream>
+# include <string>
+# include "ASM64Assembler.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Write a minimal static ELF executable for x86-64 Linux, from
+  ** assembled code. There are no section headers, only two segments:
+  ** the code and read-only data, then the data and bss.
+  ** Nothing depends on the time or the environment, so the same code
+  ** always gives the same file.
+  */
+  class ELFWriter
+  {
+  public:
+    static const ASM64Assembler::Address BASE_ADDRESS = 0x400000;
+    static const ASM64Assembler::Address DATA_ADDRESS = 0x600000;
+    static const unsigned int PAGE_SIZE = 0x1000;
+
+  public:
+    ELFWriter(ASM64Assembler& assembler);
+    ~ELFWriter();
+
+  public:
+    bool write(std::ostream& o, const std::string& entry);
+    const std::string& getError() const;
+
+  private:
+    void writeValue(std::ostream& o, unsigned long long value,
+		    const unsigned int size) const;
+    void writeBytes(std::ostream& o, const ASM64Assembler::Bytes& bytes,
+		    const unsigned int size) const;
+
+  private:
+    ASM64Assembler&	_assembler;
+    std::string		_error;
+  };
+}
+
+#endif /* !ELFWRITER_HH_ */
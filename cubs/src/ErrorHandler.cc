@@ -63,6 +63,20 @@ namespace MiniCompiler
     _errors.push_back(new Error(type, msg, line));
   }
 
+  /*!
+  ** Move all errors of another error handler after ours, keeping
+  ** their order. The other error handler becomes empty.
+  **
+  ** @param errors The error handler to empty
+  */
+  void
+  ErrorHandler::moveErrors(ErrorHandler& errors)
+  {
+    _errors.insert(_errors.end(), errors._errors.begin(),
+		   errors._errors.end());
+    errors._errors.clear();
+  }
+
   /*!
   ** Display all errors into the given stream.
   **
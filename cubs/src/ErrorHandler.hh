@@ -16,6 +16,7 @@ namespace MiniCompiler
   public:
     bool hasErrors() const;
     void addError(const Error::type type, const std::string msg, const int line);
+    void moveErrors(ErrorHandler& errors);
     std::ostream& displayErrors(std::ostream& o) const;
     char getErrorType();
 
@@ -1,13 +1,17 @@
 #include <cassert>
+#include <pthread.h>
+#include <sys/mman.h>
 #include "Execution.hh"
 
 namespace MiniCompiler
 {
   /*!
-  ** Construct an Execution, setting verbose to false.
+  ** Construct an Execution, setting verbose and memoization to false,
+  ** and maximum call depth to default.
   */
   Execution::Execution()
-    : _verbose(false)
+    : _program(0), _maxDepth(ExecutionVisitor::DEFAULT_MAX_DEPTH),
+      _verbose(false), _memoization(false), _failed(false)
   {
   }
 
@@ -32,7 +36,8 @@ namespace MiniCompiler
     _visitor.setShowCode(_verbose);
     _visitor.setShowVariables(false);
     _visitor.setShowSpecialVariables(false);
-    _visitor.visit(node);
+    _visitor.setMemoization(_memoization);
+    run(node);
 
     return _visitor.getReturnValue();
   }
@@ -52,7 +57,7 @@ namespace MiniCompiler
     _visitor.setShowCode(true);
     _visitor.setShowVariables(true);
     _visitor.setShowSpecialVariables(_verbose);
-    _visitor.visit(node);
+    run(node);
 
     return _visitor.getReturnValue();
   }
@@ -67,4 +72,111 @@ namespace MiniCompiler
   {
     _verbose = v;
   }
+
+  /*!
+  ** Choose if calls to pure functions are memoized.
+  **
+  ** @param m Can memoization be activated ?
+  */
+  void
+  Execution::activeMemoization(bool m)
+  {
+    _memoization = m;
+  }
+  /*!
+  ** Set the maximum number of nested function calls.
+  **
+  ** @param depth The maximum call depth
+  */
+  void
+  Execution::setMaxDepth(unsigned int depth)
+  {
+    _maxDepth = depth;
+    _visitor.setMaxDepth(depth);
+  }
+
+  /*!
+  ** Get the message of the error which stopped the execution.
+  **
+  ** @return The error message
+  */
+  const std::string&
+  Execution::getErrorMessage() const
+  {
+    return _visitor.getErrorMessage();
+  }
+
+  /*!
+  ** Visit the program on a dedicated stack, big enough for the maximum
+  ** call depth. The stack is mapped without reserving memory, which is
+  ** only really used when the stack grows. Without a dedicated stack,
+  ** only the call depth is checked.
+  ** An execution error is thrown back in the calling thread.
+  **
+  ** @param node The root of the AST
+  */
+  void
+  Execution::run(AST::NodeProgram* node)
+  {
+    assert(node);
+    const size_t size = STACK_MARGIN +
+      static_cast<size_t>(_maxDepth) * STACK_SIZE_PER_CALL;
+    void* stack = mmap(0, size, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK,
+		       -1, 0);
+    pthread_attr_t attr;
+    pthread_t thread;
+    bool launched = false;
+
+    _program = node;
+    _failed = false;
+    pthread_attr_init(&attr);
+    if (stack != MAP_FAILED)
+    {
+      _visitor.setStackLimit(static_cast<char*>(stack) + STACK_MARGIN);
+      if (pthread_attr_setstack(&attr, stack, size) == 0 &&
+	  pthread_create(&thread, &attr, &Execution::launch, this) == 0)
+      {
+	pthread_join(thread, 0);
+	launched = true;
+      }
+    }
+    if (!launched)
+    {
+      _visitor.setStackLimit(0);
+      launch(this);
+    }
+    pthread_attr_destroy(&attr);
+    if (stack != MAP_FAILED)
+      munmap(stack, size);
+
+    if (_failed)
+      throw Error::EXECUTION;
+  }
+
+  /*!
+  ** Entry point of the execution thread.
+  ** Exceptions can't cross threads, so an error is just remembered.
+  **
+  ** @param data The execution to launch
+  **
+  ** @return Nothing
+  */
+  void*
+  Execution::launch(void* data)
+  {
+    Execution* self = static_cast<Execution*>(data);
+    assert(self);
+    assert(self->_program);
+    try
+    {
+      self->_visitor.visit(self->_program);
+    }
+    catch (const Error::type)
+    {
+      self->_failed = true;
+    }
+
+    return 0;
+  }
 }
@@ -8,18 +8,38 @@
 
 namespace MiniCompiler
 {
+  /*!
+  ** Launch the execution visitor on its own heap allocated stack,
+  ** sized according to the maximum call depth, so a deep recursion
+  ** ends with an execution error instead of a crash.
+  */
   class Execution
   {
+  public:
+    static const unsigned int STACK_SIZE_PER_CALL = 4096;
+    static const unsigned int STACK_MARGIN = 256 * 1024;
+
   public:
     Execution();
     ~Execution();
     int execute(AST::NodeProgram* node);
     int debug(AST::NodeProgram* node);
     void activeVerbose(bool v);
+    void activeMemoization(bool m);
+    void setMaxDepth(unsigned int depth);
+    const std::string& getErrorMessage() const;
+
+  private:
+    void run(AST::NodeProgram* node);
+    static void* launch(void* data);
 
   private:
     ExecutionVisitor	_visitor;
+    AST::NodeProgram*	_program;
+    unsigned int	_maxDepth;
     bool		_verbose;
+    bool		_memoization;
+    bool		_failed;
   };
 }
 
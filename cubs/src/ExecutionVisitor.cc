@@ -1,4 +1,5 @@
 #include <cassert>
+#include <vector>
 #include "ExecutionVisitor.hh"
 #include "Utils.hh"
 #include "NodeIds.hh"
@@ -38,11 +39,13 @@ namespace MiniCompiler
   /*!
   ** Construct an execution visitor, settting tabulation to default,
   ** show Code, variables and special variables to false, isBreak and isExit
-  ** to false, and return value to 0.
+  ** to false, memoization to false, no pending tail call, call depth to 0
+  ** with the default limit and no stack limit, and return value to 0.
   */
   ExecutionVisitor::ExecutionVisitor()
-    : _tab(INDENT_SIZE), _break(false), _exit(false), _showCode(false),
-      _showVariables(false), _showSpecialVariables(false), _returnValue(0)
+    : _tab(INDENT_SIZE), _tailCall(0), _break(false), _exit(false), _showCode(false),
+      _showVariables(false), _showSpecialVariables(false), _memoize(false),
+      _depth(0), _maxDepth(DEFAULT_MAX_DEPTH), _stackLimit(0), _returnValue(0)
   {
     _registry.open();
   }
@@ -99,6 +102,88 @@ namespace MiniCompiler
     _showSpecialVariables = show;
   }
 
+  /*!
+  ** Set if results of pure functions have to be memoized.
+  ** Functions must have been marked by the purity analysis.
+  **
+  ** @param memoize If pure function calls are memoized
+  */
+  void
+  ExecutionVisitor::setMemoization(bool memoize)
+  {
+    _memoize = memoize;
+  }
+
+  /*!
+  ** Set the maximum number of nested function calls.
+  ** Tail calls don't count, since they replace the calling function.
+  **
+  ** @param depth The maximum call depth
+  */
+  void
+  ExecutionVisitor::setMaxDepth(unsigned int depth)
+  {
+    _maxDepth = depth;
+  }
+
+  /*!
+  ** Set the lowest address the stack can reach before a call.
+  ** Beyond this limit, calling a function is an execution error.
+  **
+  ** @param limit The stack limit, or null for no limit
+  */
+  void
+  ExecutionVisitor::setStackLimit(const char* limit)
+  {
+    _stackLimit = limit;
+  }
+
+  /*!
+  ** Get the message of the error which stopped the execution.
+  **
+  ** @return The error message
+  */
+  const std::string&
+  ExecutionVisitor::getErrorMessage() const
+  {
+    return _errorMessage;
+  }
+
+  /*!
+  ** Stop the execution, keeping the reason.
+  **
+  ** @param msg The error message
+  */
+  void
+  ExecutionVisitor::raiseError(const std::string& msg)
+  {
+    _errorMessage = msg;
+    throw Error::EXECUTION;
+  }
+
+  /*!
+  ** Get the name of the special variable holding an evaluated argument.
+  ** Names are built once, since they are needed at each call.
+  **
+  ** @param pos The position of the argument
+  **
+  ** @return The name of the argument variable
+  */
+  const std::string&
+  ExecutionVisitor::argumentName(const unsigned int pos)
+  {
+    static std::vector<std::string> names;
+
+    while (names.size() <= pos)
+    {
+      std::stringstream buf;
+      buf << Exec::NODE_ARG << names.size() << Exec::SEPARATOR;
+      names.push_back(buf.str());
+    }
+
+    return names[pos];
+  }
+
   /*!
   ** Get the return value of the executed code.
   **
@@ -116,12 +201,12 @@ namespace MiniCompiler
   void
   ExecutionVisitor::flushToScreen()
   {
+    // Buffered code is dropped even when not displayed, so it doesn't
+    // grow with the number of executed instructions.
     if (_showCode)
-    {
       print(std::cout);
-      _indent.str("");
-      _indent.clear();
-    }
+    _indent.str("");
+    _indent.clear();
     if (_showVariables)
     {
       if (!_showSpecialVariables)
@@ -141,7 +226,13 @@ namespace MiniCompiler
   {
     Variable* curvar = _registry.getFromCurrent(name);
 
-    // if we found a variable, we delete it.
+    // If we found a variable of the same type, we just reuse it,
+    // else we delete it.
+    if (curvar && curvar->getType() == var.getType())
+    {
+      *curvar = var;
+      return;
+    }
     delete curvar;
 
     _registry.put(name, new Variable(var));
@@ -207,13 +298,13 @@ namespace MiniCompiler
     const AST::NodeDeclarations* decls = node->getDecls();
     if (decls)
     {
-      decls->accept(*this);
+      visit(decls);
       _indent << '\n';
     }
     const AST::NodeCompoundInstr* instrs = node->getInstrs();
     if (instrs)
     {
-      instrs->accept(*this);
+      visit(instrs);
       _indent << '\n';
     }
   }
@@ -236,9 +327,9 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(id);
     assert(expr);
-    id->accept(*this);
+    visit(id);
     _indent << ' ' << cfg["="] << ' ';
-    expr->accept(*this);
+    visit(expr);
 
     // Assign value to the variable.
     // To do that, we get the variable in the registry,
@@ -266,7 +357,7 @@ namespace MiniCompiler
 
     _indent << cfg["read"];
     _indent << cfg["("];
-    id->accept(*this);
+    visit(id);
 
     // Let's get variable to detect type.
     Variable var = *getVar(id->getId());
@@ -343,7 +434,7 @@ namespace MiniCompiler
     if (args)
     {
       _indent << cfg[";"] << ' ';
-      args->accept(*this);
+      visit(args);
     }
   }
 
@@ -365,11 +456,11 @@ namespace MiniCompiler
     const AST::NodeArguments* args = node->getArguments();
 
     assert(arg);
-    arg->accept(*this);
+    visit(arg);
     if (args)
     {
       _indent << cfg[";"] << ' ';
-      args->accept(*this);
+      visit(args);
     }
   }
 
@@ -390,7 +481,27 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
     _indent << cfg["return"] << ' ';
-    expr->accept(*this);
+
+    // Only arguments of a tail call are evaluated here. The call itself
+    // is done by the caller, in place of the current function.
+    const AST::NodeCallFunc* tailCall = node->getTailCall();
+    if (tailCall)
+    {
+      const AST::NodeIdFunc* id = tailCall->getId();
+      const AST::NodeExpressions* exprs = tailCall->getExprs();
+      assert(id);
+      visit(id);
+      _indent << cfg["("];
+      if (exprs)
+	visit(exprs);
+      _indent << cfg[")"];
+      flushToScreen();
+      _tailCall = tailCall;
+      _break = true;
+      return;
+    }
+
+    visit(expr);
     flushToScreen();
     addVar(Exec::NODE_RETURN, *getVar(Exec::NODE_EXPR));
     _break = true;
@@ -413,7 +524,7 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
     _indent << cfg["exit"] << ' ';
-    expr->accept(*this);
+    visit(expr);
     Variable var = *getVar(Exec::NODE_EXPR);
     _returnValue = var.getInt();
     _exit = true;
@@ -437,10 +548,10 @@ namespace MiniCompiler
     const AST::NodeExpressions* exprs = node->getExprs();
     assert(id);
 
-    id->accept(*this);
+    visit(id);
     _indent << cfg["("];
     if (exprs)
-      exprs->accept(*this);
+      visit(exprs);
     _indent << cfg[")"];
     flushToScreen();
 
@@ -451,6 +562,8 @@ namespace MiniCompiler
 
     // Fill a scope directly, searching only arg's name
     _registry.open();
+    const bool memoize = _memoize && refFunc->isPure();
+    std::string memoArgs;
     const AST::NodeExpression* exprValue = 0;
     const AST::NodeId* idValue = 0;
     Variable* var = 0;
@@ -460,26 +573,90 @@ namespace MiniCompiler
       assert(exprValue);
       idValue = refFunc->getArgument(i);
       assert(idValue);
-      std::stringstream buf;
-      buf << Exec::NODE_ARG << i << Exec::SEPARATOR;
-      var = _registry.getFromAll(buf.str());
+      var = _registry.getFromAll(argumentName(i));
       assert(var);
       addVar(idValue->getId(), *var);
+      if (memoize)
+	Memoizer::appendArgument(memoArgs, *var);
     }
 
     _indent << ";\n";
-    // Jump to the referenced function
-    refFunc->accept(*this);
+
+    // A pure function called with the same arguments
+    // gives the same result, so don't compute it twice.
+    const Variable* memoized = memoize ? _memoizer.get(refFunc, memoArgs) : 0;
+    if (memoized)
+    {
+      Variable varReturn = *memoized;
+      _registry.closeAndDelete();
+      addVar(Exec::NODE_CALLFUNC, varReturn);
+      return;
+    }
+
+    // Jump to the referenced function, then to each function it
+    // ends by, without growing the stack.
+    const char here = 0;
+    if (_depth >= _maxDepth)
+      raiseError("Maximum call depth of " + Utils::intToString(_maxDepth) +
+		 " exceeded...");
+    if (_stackLimit && &here < _stackLimit)
+      raiseError("Execution stack exhausted...");
+    _depth++;
+    visit(refFunc);
+    while (_tailCall && !_exit)
+    {
+      const AST::NodeFunction* tailFunc = _tailCall->getId()->getRef();
+      assert(tailFunc);
+      assert(tailFunc->nbArgument() == _tailCall->nbArgument());
+      _tailCall = 0;
+      replaceFrame(tailFunc);
+      _indent << ";\n";
+      visit(tailFunc);
+    }
+    _tailCall = 0;
+    _depth--;
 
     // We store the return value
     assert(getVar(Exec::NODE_RETURN));
     Variable varReturn = *getVar(Exec::NODE_RETURN);
     _registry.closeAndDelete();
+    if (memoize)
+      _memoizer.put(refFunc, memoArgs, varReturn);
 
     // Then assign it
     addVar(Exec::NODE_CALLFUNC, varReturn);
   }
 
+  /*!
+  ** Replace the scope of the current function by a new one, for a tail
+  ** called function. Arguments are evaluated in the current scope, so they
+  ** are copied before closing it.
+  **
+  ** @param func The tail called function
+  */
+  void
+  ExecutionVisitor::replaceFrame(const AST::NodeFunction* func)
+  {
+    assert(func);
+    std::vector<Variable*> values(func->nbArgument());
+    for (unsigned int i = 0; i < func->nbArgument(); ++i)
+    {
+      Variable* var = _registry.getFromCurrent(argumentName(i));
+      assert(var);
+      values[i] = new Variable(*var);
+    }
+
+    _registry.closeAndDelete();
+    _registry.open();
+    for (unsigned int i = 0; i < func->nbArgument(); ++i)
+    {
+      const AST::NodeId* idValue = func->getArgument(i);
+      assert(idValue);
+      delete _registry.getFromCurrent(idValue->getId());
+      _registry.put(idValue->getId(), values[i]);
+    }
+  }
+
   /*!
   ** Execute an operation node.
   **
@@ -497,7 +674,7 @@ namespace MiniCompiler
     // Go in left factor
     const AST::NodeFactor* leftFactor = node->getLeftFactor();
     assert(leftFactor);
-    leftFactor->accept(*this);
+    visit(leftFactor);
     Variable var = *getVar(Exec::NODE_FACTOR);
 
     // Search if there are a right factor for this operation
@@ -507,7 +684,7 @@ namespace MiniCompiler
       const AST::NodeFactor* rightFactor = node->getRightFactor();
       assert(rightFactor);
       _indent << ' ' << Utils::OpToString(node->getOpType()) << ' ';
-      rightFactor->accept(*this);
+      visit(rightFactor);
 
       Variable boolVar = false;
       Variable rightVar = *getVar(Exec::NODE_FACTOR);
@@ -521,7 +698,7 @@ namespace MiniCompiler
 	  break;
 	case AST::Operator::DIV:
 	  if (rightVar == 0)
-	    throw Error::EXECUTION;
+	    raiseError("A division by zero has occured...");
 	  var /= rightVar;
 	  break;
 	case AST::Operator::MUL:
@@ -529,7 +706,7 @@ namespace MiniCompiler
 	  break;
 	case AST::Operator::MODULO:
 	  if (rightVar == 0)
-	    throw Error::EXECUTION;
+	    raiseError("A division by zero has occured...");
 	  var %= rightVar;
 	  break;
 
@@ -581,7 +758,7 @@ namespace MiniCompiler
       return;
     const AST::NodeOperation* op = node->getOperation();
     assert(op);
-    op->accept(*this);
+    visit(op);
     Variable opVar = *getVar(Exec::NODE_OPERATION);
     addVar(Exec::NODE_EXPR, opVar);
   }
@@ -647,9 +824,9 @@ namespace MiniCompiler
     const AST::NodeExpressions* exprs = node->getExprs();
     assert(expr);
 
-    expr->accept(*this);
+    visit(expr);
     Variable var = *getVar(Exec::NODE_EXPR);
-    addVar("%arg0%", var);
+    addVar(argumentName(0), var);
 
     // Check if there are other arguments to the call func
     unsigned int i = 1;
@@ -658,11 +835,9 @@ namespace MiniCompiler
       _indent << cfg[","] << ' ';
       expr = exprs->getExpr();
       assert(expr);
-      expr->accept(*this);
+      visit(expr);
       Variable var = *getVar(Exec::NODE_EXPR);
-      std::stringstream buf;
-      buf << Exec::NODE_ARG << i << Exec::SEPARATOR;
-      addVar(buf.str(), var);
+      addVar(argumentName(i), var);
       i++;
       exprs = exprs->getExprs();
     }
@@ -706,50 +881,50 @@ namespace MiniCompiler
 
     if (compoundInstr)
     {
-      compoundInstr->accept(*this);
+      visit(compoundInstr);
       return;
     }
 
     _indent << Utils::stringFill(SPACING_CHAR, _tab);
     if (affect)
     {
-      affect->accept(*this);
+      visit(affect);
       _indent << '\n';
     }
     else
       if (callFunc)
       {
-	callFunc->accept(*this);
+	visit(callFunc);
 	// No ; because it was done in Node CallFunc
       }
       else
 	if (nIf)
-	  nIf->accept(*this);
+	  visit(nIf);
 	else
 	  if (nWhile)
-	    nWhile->accept(*this);
+	    visit(nWhile);
 	  else
 	    if (nReturn)
 	    {
-	      nReturn->accept(*this);
+	      visit(nReturn);
 	      _indent << '\n';
 	    }
 	    else
 	      if (nExit)
 	      {
-		nExit->accept(*this);
+		visit(nExit);
 		_indent << cfg[";"] << '\n';
 	      }
 	      else
 		if (nPrint)
 		{
-		  nPrint->accept(*this);
+		  visit(nPrint);
 		  _indent << cfg[";"] << '\n';
 		}
 		else
 		  if (nRead)
 		  {
-		    nRead->accept(*this);
+		    visit(nRead);
 		    _indent << cfg[";"] << '\n';
 		  }
     flushToScreen();
@@ -775,7 +950,7 @@ namespace MiniCompiler
     _tab += INDENT_SIZE;
     flushToScreen();
     if (instrs)
-      instrs->accept(*this);
+      visit(instrs);
     _tab -= INDENT_SIZE;
     _indent << Utils::stringFill(SPACING_CHAR, _tab) << cfg["end"] << '\n';
     flushToScreen();
@@ -811,31 +986,31 @@ namespace MiniCompiler
 
     if (id)
     {
-      id->accept(*this);
+      visit(id);
       addVar(Exec::NODE_FACTOR, *getVar(Exec::NODE_ID));
       return;
     }
     if (callFunc)
     {
-      callFunc->accept(*this);
+      visit(callFunc);
       addVar(Exec::NODE_FACTOR, *getVar(Exec::NODE_CALLFUNC));
       return;
     }
     if (number)
     {
-      number->accept(*this);
+      visit(number);
       addVar(Exec::NODE_FACTOR, *getVar(Exec::NODE_NUMBER));
       return;
     }
     if (stringExpr)
     {
-      stringExpr->accept(*this);
+      visit(stringExpr);
       addVar(Exec::NODE_FACTOR, *getVar(Exec::NODE_STRING));
       return;
     }
     if (boolExpr)
     {
-      boolExpr->accept(*this);
+      visit(boolExpr);
       addVar(Exec::NODE_FACTOR, *getVar(Exec::NODE_BOOL));
       return;
     }
@@ -843,7 +1018,7 @@ namespace MiniCompiler
     {
       Configuration& cfg = Configuration::getInstance();
       _indent << cfg["("];
-      expression->accept(*this);
+      visit(expression);
       _indent << cfg[")"];
       addVar(Exec::NODE_FACTOR, *getVar(Exec::NODE_EXPR));
       return;
@@ -863,7 +1038,16 @@ namespace MiniCompiler
       return;
     if (_exit)
       return;
-    ConstBaseVisitor::visit(node);
+
+    // Instructions are chained, walk them iteratively to avoid
+    // a new frame for each instruction of a block.
+    while (node && !_break && !_exit)
+    {
+      const AST::NodeInstr* instr = node->getInstr();
+      assert(instr);
+      visit(instr);
+      node = node->getInstrs();
+    }
   }
 
   /*!
@@ -902,7 +1086,7 @@ namespace MiniCompiler
     assert(header);
     assert(instr);
 
-    header->accept(*this);
+    visit(header);
     const AST::NodeType* type = header->getType();
     assert(type);
     const std::string t = type->getType();
@@ -920,8 +1104,8 @@ namespace MiniCompiler
 	  assert(false);
 
     if (decls)
-      decls->accept(*this);
-    instr->accept(*this);
+      visit(decls);
+    visit(instr);
     _indent << '\n';
 
     // Function is finished so, no break is possible.
@@ -949,7 +1133,7 @@ namespace MiniCompiler
     assert(body);
 
     _indent << cfg["if"] << ' ';
-    cond->accept(*this);
+    visit(cond);
     _indent << ' ' << cfg["then"] << '\n';
     flushToScreen();
 
@@ -958,13 +1142,13 @@ namespace MiniCompiler
     const Variable* var = getVar(Exec::NODE_EXPR);
     assert(var);
     if (*var == true)
-      body->accept(*this);
+      visit(body);
     else
       if (elseExprs)
       {
 	_indent << Utils::stringFill(SPACING_CHAR, _tab) << cfg["else"] << '\n';
 	flushToScreen();
-	elseExprs->accept(*this);
+	visit(elseExprs);
       }
   }
 
@@ -992,14 +1176,14 @@ namespace MiniCompiler
     while (continueLoop && !_exit && !_break)
     {
       _indent << Utils::stringFill(SPACING_CHAR, _tab) << cfg["while"] << ' ';
-      cond->accept(*this);
+      visit(cond);
       var = getVar(Exec::NODE_EXPR);
       assert(var);
       continueLoop = *var == true;
       _indent << ' ' << cfg["do"] << '\n';
       flushToScreen();
       if (continueLoop)
-	body->accept(*this);
+	visit(body);
     }
   }
 
@@ -1022,9 +1206,9 @@ namespace MiniCompiler
     assert(ids);
     assert(type);
 
-    ids->accept(*this);
+    visit(ids);
     _indent << ' ' << cfg[":"] << ' ';
-    type->accept(*this);
+    visit(type);
   }
 
   /*!
@@ -1041,7 +1225,7 @@ namespace MiniCompiler
     if (_exit)
       return;
     _indent << Utils::stringFill(SPACING_CHAR, _tab);
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<ExecutionVisitor>::visit(node);
   }
 
   /*!
@@ -1080,7 +1264,7 @@ namespace MiniCompiler
     const AST::NodeDeclarationBody* body = node->getBody();
     assert(body);
     _indent << cfg["var"] << ' ';
-    body->accept(*this);
+    visit(body);
     _indent << cfg[";"] << '\n';
     flushToScreen();
   }
@@ -1106,12 +1290,12 @@ namespace MiniCompiler
     assert(id);
     assert(type);
     _indent << Utils::stringFill(SPACING_CHAR, _tab) << cfg["function"] << ' ';
-    id->accept(*this);
+    visit(id);
     _indent << cfg["("];
     if (args)
-      args->accept(*this);
+      visit(args);
     _indent << cfg[")"] << ' ' << cfg[":"] << ' ';
-    type->accept(*this);
+    visit(type);
     _indent << cfg[";"] << '\n';
   }
 
@@ -1129,7 +1313,7 @@ namespace MiniCompiler
     if (_exit)
       return;
     _indent << Utils::stringFill(SPACING_CHAR, _tab);
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<ExecutionVisitor>::visit(node);
   }
 
   /*!
@@ -1209,7 +1393,7 @@ namespace MiniCompiler
     assert(id);
 
     _indent << cfg["print"] << cfg["("];
-    id->accept(*this);
+    visit(id);
     Variable v = *getVar(Exec::NODE_EXPR);
     v.print(std::cout);
     _indent << cfg[")"];
@@ -1232,12 +1416,12 @@ namespace MiniCompiler
     const AST::NodeIds* ids = node->getIds();
     const AST::NodeId* id = node->getId();
     assert(id);
-    id->accept(*this);
+    visit(id);
 
     if (ids)
     {
       _indent << cfg[","] << ' ';
-      ids->accept(*this);
+      visit(ids);
     }
   }
 }
@@ -9,6 +9,7 @@
 # include "BaseVisitor.hh"
 # include "Variable.hh"
 # include "Scope.hh"
+# include "Memoizer.hh"
 
 namespace MiniCompiler
 {
@@ -27,55 +28,63 @@ namespace MiniCompiler
     static const std::string NODE_ID		= SEPARATOR + "nodeid" + SEPARATOR;
   }
 
-  class ExecutionVisitor : public ConstBaseVisitor
+  class ExecutionVisitor : public ConstBaseVisitor<ExecutionVisitor>
   {
     friend std::ostream&
     operator<<(std::ostream& o, const ExecutionVisitor& v);
 
     typedef Scope<std::string, Variable*> Registry;
 
+  public:
+    static const unsigned int DEFAULT_MAX_DEPTH = 100000;
+    static const unsigned int LIMIT_MAX_DEPTH = 10000000;
+
   public:
     ExecutionVisitor();
-    virtual ~ExecutionVisitor();
+    ~ExecutionVisitor();
 
   public:
-    virtual void visit(const AST::NodeIds* node);
-    virtual void visit(const AST::NodeProgram* node);
-    virtual void visit(const AST::NodeAffect* node);
-    virtual void visit(const AST::NodeIf* node);
-    virtual void visit(const AST::NodeRead* node);
-    virtual void visit(const AST::NodeArgument* node);
-    virtual void visit(const AST::NodeArguments* node);
-    virtual void visit(const AST::NodeReturn* node);
-    virtual void visit(const AST::NodeExit* node);
-    virtual void visit(const AST::NodeCallFunc* node);
-    virtual void visit(const AST::NodeOperation* node);
-    virtual void visit(const AST::NodeExpression* node);
-    virtual void visit(const AST::NodeStringExpr* node);
-    virtual void visit(const AST::NodeBoolean* node);
-    virtual void visit(const AST::NodeExpressions* node);
-    virtual void visit(const AST::NodeInstr* node);
-    virtual void visit(const AST::NodeCompoundInstr* node);
-    virtual void visit(const AST::NodeFactor* node);
-    virtual void visit(const AST::NodeInstrs* node);
-    virtual void visit(const AST::NodeType* node);
-    virtual void visit(const AST::NodeFunction* node);
-    virtual void visit(const AST::NodeWhile* node);
-    virtual void visit(const AST::NodeDeclarationBody* node);
-    virtual void visit(const AST::NodeFunctions* node);
-    virtual void visit(const AST::NodeNumber* node);
-    virtual void visit(const AST::NodeDeclaration* node);
-    virtual void visit(const AST::NodeHeaderFunc* node);
-    virtual void visit(const AST::NodeDeclarations* node);
-    virtual void visit(const AST::NodeId* node);
-    virtual void visit(const AST::NodeIdFunc* node);
-    virtual void visit(const AST::NodePrint* node);
+    void visit(const AST::NodeIds* node);
+    void visit(const AST::NodeProgram* node);
+    void visit(const AST::NodeAffect* node);
+    void visit(const AST::NodeIf* node);
+    void visit(const AST::NodeRead* node);
+    void visit(const AST::NodeArgument* node);
+    void visit(const AST::NodeArguments* node);
+    void visit(const AST::NodeReturn* node);
+    void visit(const AST::NodeExit* node);
+    void visit(const AST::NodeCallFunc* node);
+    void visit(const AST::NodeOperation* node);
+    void visit(const AST::NodeExpression* node);
+    void visit(const AST::NodeStringExpr* node);
+    void visit(const AST::NodeBoolean* node);
+    void visit(const AST::NodeExpressions* node);
+    void visit(const AST::NodeInstr* node);
+    void visit(const AST::NodeCompoundInstr* node);
+    void visit(const AST::NodeFactor* node);
+    void visit(const AST::NodeInstrs* node);
+    void visit(const AST::NodeType* node);
+    void visit(const AST::NodeFunction* node);
+    void visit(const AST::NodeWhile* node);
+    void visit(const AST::NodeDeclarationBody* node);
+    void visit(const AST::NodeFunctions* node);
+    void visit(const AST::NodeNumber* node);
+    void visit(const AST::NodeDeclaration* node);
+    void visit(const AST::NodeHeaderFunc* node);
+    void visit(const AST::NodeDeclarations* node);
+    void visit(const AST::NodeId* node);
+    void visit(const AST::NodeIdFunc* node);
+    void visit(const AST::NodePrint* node);
 
   public:
     void setShowCode(bool show);
     void setShowVariables(bool show);
     void setShowSpecialVariables(bool show);
+    void setMemoization(bool memoize);
+    void setMaxDepth(unsigned int depth);
+    void setStackLimit(const char* limit);
     int getReturnValue() const;
+    const std::string& getErrorMessage() const;
 
   protected:
     void addVar(const std::string& name, const Variable& var);
@@ -83,17 +92,27 @@ namespace MiniCompiler
     Variable* getVar(const std::string& name);
     void print(std::ostream& o) const;
     void flushToScreen();
+    void replaceFrame(const AST::NodeFunction* func);
+    void raiseError(const std::string& msg);
+    static const std::string& argumentName(const unsigned int pos);
 
   protected:
     std::stringstream	_indent;
     unsigned int	_tab;
     Registry		_registry;
+    Memoizer		_memoizer;
+    const AST::NodeCallFunc*	_tailCall;
     bool		_break;
     bool		_exit;
     bool		_showCode;
     bool		_showVariables;
     bool		_showSpecialVariables;
+    bool		_memoize;
+    unsigned int	_depth;
+    unsigned int	_maxDepth;
+    const char*		_stackLimit;
     int			_returnValue;
+    std::string		_errorMessage;
   };
 }
 
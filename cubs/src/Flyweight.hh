@@ -3,6 +3,7 @@
 
 # include <set>
 # include <cassert>
+# include <pthread.h>
 
 namespace mystd
 {
@@ -36,6 +37,7 @@ namespace mystd
 
   protected:
     static std::set<T>& getInstance();
+    static pthread_mutex_t& getMutex();
     const T* add(const T& s);
 
   protected:
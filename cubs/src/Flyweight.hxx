@@ -83,6 +83,19 @@ namespace mystd
     return set;
   }
 
+  /*!
+  ** Get the lock of the flyweight instance.
+  **
+  ** @return A reference on the lock
+  */
+  template <typename T>
+  inline pthread_mutex_t&
+  Flyweight<T>::getMutex()
+  {
+    static pthread_mutex_t	mutex = PTHREAD_MUTEX_INITIALIZER;
+    return mutex;
+  }
+
   /*!
   ** Just affect a new element. Change local element, and add it
   ** to the flyweight if necessary.
@@ -125,6 +138,9 @@ namespace mystd
   ** Add a given string to the flyweight. All element is unique.
   ** Then, return an adress on the element.
   **
+  ** Elements can be added from several threads at once: they only
+  ** share the lock, pointers on elements are never invalidated.
+  **
   ** @param s The string to add to the flyweight
   **
   ** @return Adress of the inserted, or existant string
@@ -134,10 +150,13 @@ namespace mystd
   Flyweight<T>::add(const T& s)
   {
     std::set<T>& set = getInstance();
-    set.insert(s);
-    const_iterator it = set.find(s);
-    assert(it != set.end());
-    return &*it;
+    pthread_mutex_t& mutex = getMutex();
+
+    pthread_mutex_lock(&mutex);
+    const T* elt = &*set.insert(s).first;
+    pthread_mutex_unlock(&mutex);
+
+    return elt;
   }
 
   /*!
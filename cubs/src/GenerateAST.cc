@@ -1,674 +1,630 @@
-#include <ctime>
 #include "GenerateAST.hh"
+#include "PrettyPrinterVisitor.hh"
 
 namespace MiniCompiler
 {
-  /*!
-  ** Construct the GenerateAST, intializing random seed.
-  */
-  GenerateAST::GenerateAST()
-  {
-    srand(time(0));
-  }
-
-  /*!
-  ** Destruct the GenerateAST.
-  */
-  GenerateAST::~GenerateAST()
-  {
-  }
-
-  /*!
-  ** Construct ids node randomly.
-  **
-  ** @param node The ids node
-  */
-  void
-  GenerateAST::construct(AST::NodeIds* node)
-  {
-    assert(node);
-
-    AST::NodeId* id = new AST::NodeId();
-    node->setId(id);
-    construct(id);
-
-    if (randomConstruct())
+  namespace
+  {
+    /*!
+    ** Number of tokens of the program per function, when the number of
+    ** functions isn't given.
+    */
+    const unsigned long long TOKENS_PER_FUNCTION = 1000;
+
+    /*!
+    ** Number of different string literals.
+    */
+    const unsigned int NB_STRINGS = 100;
+
+    /*!
+    ** Print a node, then delete it.
+    **
+    ** @param o The stream
+    ** @param node The node
+    ** @param level The indentation level
+    */
+    template <typename T>
+    void
+    write(std::ostream& o, T* node, const unsigned int level)
     {
-      AST::NodeIds* ids = new AST::NodeIds();
-      node->setIds(ids);
-      construct(ids);
+      PrettyPrinterVisitor printer;
+      printer.setLevel(level);
+      printer.visit(node);
+      o << printer;
+      delete node;
     }
   }
 
   /*!
-  ** Construct program node randomly.
-  **
-  ** @param node The ids node
+  ** Construct the default parameters: a small program.
   */
-  void
-  GenerateAST::construct(AST::NodeProgram* node)
+  GenerateAST::Parameters::Parameters()
+    : seed(1), tokens(TOKENS_PER_FUNCTION), functions(0), nesting(3),
+      fanOut(4)
   {
-    assert(node);
-
-    AST::NodeDeclarations* decls = new AST::NodeDeclarations();
-    node->setDecls(decls);
-    construct(decls);
-
-
-    AST::NodeFunctions* funcs = new AST::NodeFunctions();
-    node->setFuncs(funcs);
-    construct(funcs);
-
-    AST::NodeCompoundInstr* instrs = new AST::NodeCompoundInstr();
-    node->setInstrs(instrs);
-    construct(instrs);
   }
 
   /*!
-  ** Construct affectation node randomly.
-  **
-  ** @param node The affectation node
+  ** Construct the GenerateAST, with default parameters.
   */
-  void
-  GenerateAST::construct(AST::NodeAffect* node)
+  GenerateAST::GenerateAST()
+    : _state(0), _tokens(0), _current(0)
   {
-    assert(node);
-    AST::NodeId* id = new AST::NodeId();
-    node->setId(id);
-    construct(id);
-
-    AST::NodeExpression* expr = new AST::NodeExpression();
-    node->setExpr(expr);
-    construct(expr);
   }
 
   /*!
-  ** Construct if node randomly.
-  **
-  ** @param node The if node
+  ** Destruct the GenerateAST.
   */
-  void
-  GenerateAST::construct(AST::NodeIf* node)
+  GenerateAST::~GenerateAST()
   {
-    assert(node);
-    AST::NodeExpression* expr = new AST::NodeExpression();
-    node->setCond(expr);
-    construct(expr);
-
-    AST::NodeCompoundInstr* body = new AST::NodeCompoundInstr();
-    node->setBodyExprs(body);
-    construct(body);
-
-    if (randomConstruct())
-    {
-      AST::NodeCompoundInstr* elseExprs = new AST::NodeCompoundInstr();
-      node->setElseExprs(elseExprs);
-      construct(elseExprs);
-    }
   }
 
   /*!
-  ** Construct read node randomly.
+  ** Set the shape of generated programs.
   **
-  ** @param node The read node
+  ** @param params The parameters
   */
   void
-  GenerateAST::construct(AST::NodeRead* node)
+  GenerateAST::setParameters(const Parameters& params)
   {
-    assert(node);
-    AST::NodeId* id = new AST::NodeId();
-    node->setId(id);
-    construct(id);
+    assert(params.fanOut > 0);
+    _params = params;
   }
 
   /*!
-  ** Construct arguments node randomly.
+  ** Generate a program, and write it. Signatures of functions are chosen
+  ** first, so that any function can call any other one. The tokens are
+  ** shared evenly between functions and the main instructions.
   **
-  ** @param node The arguments node
+  ** @param o The stream where to write it
   */
   void
-  GenerateAST::construct(AST::NodeArguments* node)
-  {
-    assert(node);
-    AST::NodeArgument* arg = new AST::NodeArgument();
-    node->setArgument(arg);
-    construct(arg);
-
-    if (randomConstruct())
+  GenerateAST::generate(std::ostream& o)
+  {
+    Configuration& cfg = Configuration::getInstance();
+    const unsigned int nbFunctions = _params.functions ? _params.functions :
+      _params.tokens / TOKENS_PER_FUNCTION + 1;
+
+    _state = _params.seed;
+    _tokens = 0;
+    _current = 0;
+    _functions.clear();
+    for (unsigned int i = 0; i <= AST::Type::STRING; ++i)
+      _functionsByType[i].clear();
+    for (unsigned int i = 0; i < nbFunctions; ++i)
     {
-      AST::NodeArguments* args = new AST::NodeArguments();
-      node->setArguments(args);
-      construct(args);
+      const AST::Type::type type = randomType();
+      _functions.push_back(Signature(type,
+				     randomTypes(random(_params.fanOut + 1))));
+      _functionsByType[type].push_back(i);
     }
-  }
 
-  /*!
-  ** Construct argument node randomly.
-  **
-  ** @param node The argument node
-  */
-  void
-  GenerateAST::construct(AST::NodeArgument* node)
-  {
-    assert(node);
-    AST::NodeDeclarationBody* body = new AST::NodeDeclarationBody();
-    node->setDeclarationBody(body);
-    construct(body);
+    const Types globals = randomTypes(1 + random(2 * _params.fanOut));
+    write(o, constructDeclarations("g", globals), 1);
+    o << '\n';
 
-    if (randomConstruct())
+    const unsigned long long budget = _params.tokens / (nbFunctions + 1);
+    for (unsigned int i = 0; i < nbFunctions; ++i)
     {
-      AST::NodeArguments* args = new AST::NodeArguments();
-      node->setArguments(args);
-      construct(args);
+      for (unsigned int t = 0; t <= AST::Type::STRING; ++t)
+	_variablesByType[t].clear();
+      declare("g", globals);
+      writeFunction(o, i, budget);
     }
-  }
 
-  /*!
-  ** Construct return node randomly.
-  **
-  ** @param node The return node
-  */
-  void
-  GenerateAST::construct(AST::NodeReturn* node)
-  {
-    assert(node);
-    AST::NodeExpression* expr = new AST::NodeExpression();
-    node->setExpr(expr);
-    construct(expr);
+    _current = 0;
+    for (unsigned int t = 0; t <= AST::Type::STRING; ++t)
+      _variablesByType[t].clear();
+    declare("g", globals);
+    o << '\t' << cfg["begin"] << '\n';
+    _tokens += 2;
+    writeBody(o, _params.tokens);
+    o << '\t' << cfg["end"] << '\n';
   }
 
   /*!
-  ** Construct exit node randomly.
+  ** Write a function, ending with a return.
   **
-  ** @param node The exit node
+  ** @param o The stream
+  ** @param index The index of the function
+  ** @param budget The number of tokens of the function
   */
   void
-  GenerateAST::construct(AST::NodeExit* node)
+  GenerateAST::writeFunction(std::ostream& o, const unsigned int index,
+			     const unsigned long long budget)
   {
-    assert(node);
-    AST::NodeExpression* expr = new AST::NodeExpression();
-    node->setExpr(expr);
-    construct(expr);
-  }
+    Configuration& cfg = Configuration::getInstance();
+    const Signature& signature = _functions[index];
+    const unsigned long long end = _tokens + budget;
+    const Types locals = randomTypes(random(_params.fanOut + 1));
 
-  /*!
-  ** Construct call function node randomly.
-  **
-  ** @param node The call function node
-  */
-  void
-  GenerateAST::construct(AST::NodeCallFunc* node)
-  {
-    assert(node);
+    _current = &signature;
+    declare("p", signature.second);
+    declare("l", locals);
 
+    AST::NodeHeaderFunc* header = new AST::NodeHeaderFunc();
     AST::NodeIdFunc* id = new AST::NodeIdFunc();
-    node->setId(id);
-    construct(id);
-
-    if (randomConstruct())
-    {
-      AST::NodeExpressions* exprs = new AST::NodeExpressions();
-      node->setExprs(exprs);
-      construct(exprs);
-    }
+    id->setId(name("f", index));
+    header->setId(id);
+    header->setArguments(constructArguments(signature.second, 0));
+    header->setType(constructType(signature.first));
+    _tokens += 5;
+    o << '\t';
+    write(o, header, 1);
+    AST::NodeDeclarations* decls = constructDeclarations("l", locals);
+    if (decls)
+      write(o, decls, 1);
+
+    o << '\t' << cfg["begin"] << '\n';
+    _tokens += 2;
+    writeBody(o, end);
+    AST::NodeInstr* instr = new AST::NodeInstr();
+    AST::NodeReturn* ret = new AST::NodeReturn();
+    ret->setExpr(constructExpression(signature.first, _params.nesting));
+    instr->setReturn(ret);
+    _tokens += 2;
+    write(o, instr, 2);
+    o << '\t' << cfg["end"] << "\n\n";
   }
 
   /*!
-  ** Construct operation node randomly.
+  ** Write instructions of a body, one at a time, until the number of
+  ** generated tokens reaches the given end. There is at least one.
   **
-  ** @param node The operation node
+  ** @param o The stream
+  ** @param end The number of tokens to reach
   */
   void
-  GenerateAST::construct(AST::NodeOperation* node)
+  GenerateAST::writeBody(std::ostream& o, const unsigned long long end)
   {
-    assert(node);
-
-    AST::NodeFactor* factor = new AST::NodeFactor();
-    node->setLeftFactor(factor);
-    construct(factor);
-    node->setOpType(AST::Operator::NONE);
-
-    if (randomConstruct())
-    {
-      node->setOpType(randomOperator());
-      AST::NodeFactor* factor = new AST::NodeFactor();
-      node->setRightFactor(factor);
-      construct(factor);
-    }
+    do
+      write(o, constructInstr(_params.nesting), 2);
+    while (_tokens < end);
   }
 
   /*!
-  ** Construct expression node randomly.
+  ** Make variables usable by the generated code.
   **
-  ** @param node The expression node
+  ** @param prefix The prefix of their names
+  ** @param types Their types
   */
   void
-  GenerateAST::construct(AST::NodeExpression* node)
+  GenerateAST::declare(const std::string& prefix, const Types& types)
   {
-    assert(node);
-
-    AST::NodeOperation* op = new AST::NodeOperation();
-    node->setOperation(op);
-    construct(op);
+    for (unsigned int i = 0; i < types.size(); ++i)
+      _variablesByType[types[i]].push_back(name(prefix, i));
   }
 
   /*!
-  ** Construct string expression node randomly.
+  ** Construct declarations, one per variable.
   **
-  ** @param node The string expression node
-  */
-  void
-  GenerateAST::construct(AST::NodeStringExpr* node)
-  {
-    assert(node);
-    node->setString("String Expression");
-  }
-
-  /*!
-  ** Construct boolean node randomly.
+  ** @param prefix The prefix of the names of variables
+  ** @param types Their types
   **
-  ** @param node The boolean node
+  ** @return The declarations, or 0 if there is no variable
   */
-  void
-  GenerateAST::construct(AST::NodeBoolean* node)
-  {
-    assert(node);
-    node->setBool(randomConstruct());
-  }
-
-  /*!
-  ** Construct expressions node randomly.
-  **
-  ** @param node The expressions node
-  */
-  void
-  GenerateAST::construct(AST::NodeExpressions* node)
+  AST::NodeDeclarations*
+  GenerateAST::constructDeclarations(const std::string& prefix,
+				     const Types& types)
   {
-    assert(node);
-
-    AST::NodeExpression* expr = new AST::NodeExpression();
-    node->setExpr(expr);
-    construct(expr);
+    AST::NodeDeclarations* res = 0;
 
-    if (randomConstruct())
+    for (unsigned int i = types.size(); i > 0; --i)
     {
-      AST::NodeExpressions* exprs = new AST::NodeExpressions();
-      node->setExprs(exprs);
-      construct(exprs);
+      AST::NodeIds* ids = new AST::NodeIds();
+      ids->setId(constructId(name(prefix, i - 1)));
+      AST::NodeDeclarationBody* body = new AST::NodeDeclarationBody();
+      body->setIds(ids);
+      body->setType(constructType(types[i - 1]));
+      AST::NodeDeclaration* decl = new AST::NodeDeclaration();
+      decl->setBody(body);
+      AST::NodeDeclarations* decls = new AST::NodeDeclarations();
+      decls->setDeclaration(decl);
+      decls->setDeclarations(res);
+      res = decls;
+      _tokens += 2;
     }
+
+    return res;
   }
 
   /*!
-  ** Construct instructions node randomly.
+  ** Construct the parameters of a function, from the given one.
+  **
+  ** @param types The types of all parameters
+  ** @param index The first parameter to construct
   **
-  ** @param node The instructions node
+  ** @return The parameters, or 0 if there is none
   */
-  void
-  GenerateAST::construct(AST::NodeInstr* node)
+  AST::NodeArguments*
+  GenerateAST::constructArguments(const Types& types,
+				  const unsigned int index)
   {
-    assert(node);
+    if (index >= types.size())
+      return 0;
 
-    if (randomConstruct())
-    {
-      AST::NodeAffect* aff = new AST::NodeAffect();
-      node->setAffect(aff);
-      construct(aff);
-      return;
-    }
-
-    if (randomConstruct())
-    {
-      AST::NodeCallFunc* call = new AST::NodeCallFunc();
-      node->setCallFunc(call);
-      construct(call);
-      return;
-    }
-
-    if (randomConstruct())
-    {
-      AST::NodeCompoundInstr* compoundInstr = new AST::NodeCompoundInstr();
-      node->setCompoundInstr(compoundInstr);
-      construct(compoundInstr);
-      return;
-    }
-
-    if (randomConstruct())
-    {
-      AST::NodeReturn* ret = new AST::NodeReturn();
-      node->setReturn(ret);
-      construct(ret);
-      return;
-    }
-
-    if (randomConstruct())
-    {
-      AST::NodePrint* print = new AST::NodePrint();
-      node->setPrint(print);
-      construct(print);
-      return;
-    }
-
-    if (randomConstruct())
-    {
-      AST::NodeRead* read = new AST::NodeRead();
-      node->setRead(read);
-      construct(read);
-      return;
-    }
-
-    if (randomConstruct())
-    {
-      AST::NodeIf* nIf = new AST::NodeIf();
-      node->setIf(nIf);
-      construct(nIf);
-      return;
-    }
+    AST::NodeIds* ids = new AST::NodeIds();
+    ids->setId(constructId(name("p", index)));
+    AST::NodeDeclarationBody* body = new AST::NodeDeclarationBody();
+    body->setIds(ids);
+    body->setType(constructType(types[index]));
+    AST::NodeArgument* arg = new AST::NodeArgument();
+    arg->setDeclarationBody(body);
+    AST::NodeArguments* node = new AST::NodeArguments();
+    node->setArgument(arg);
+    node->setArguments(constructArguments(types, index + 1));
+    ++_tokens;
 
-    AST::NodeWhile* nWhile = new AST::NodeWhile();
-    node->setWhile(nWhile);
-    construct(nWhile);
+    return node;
   }
 
   /*!
-  ** Construct compound instruction node randomly.
+  ** Construct an instruction randomly. Blocks are only nested while the
+  ** depth allows it.
   **
-  ** @param node The compound instruction node
-  */
-  void
-  GenerateAST::construct(AST::NodeCompoundInstr* node)
-  {
-    assert(node);
-
-    AST::NodeInstrs* instrs = new AST::NodeInstrs();
-    node->setInstrs(instrs);
-    construct(instrs);
-  }
-
-  /*!
-  ** Construct factor node randomly.
+  ** @param depth The number of blocks which can still be nested
   **
-  ** @param node The factor node
+  ** @return The instruction
   */
-  void
-  GenerateAST::construct(AST::NodeFactor* node)
+  AST::NodeInstr*
+  GenerateAST::constructInstr(const unsigned int depth)
   {
-    assert(node);
-
-    if (randomConstruct())
-    {
-      AST::NodeCallFunc* call = new AST::NodeCallFunc();
-      node->setCallFunc(call);
-      construct(call);
-      return;
-    }
+    AST::NodeInstr* node = new AST::NodeInstr();
+    const AST::Type::type type = randomType();
+    const Names& variables = _variablesByType[type];
 
-    if (randomConstruct())
+    switch (random(depth > 0 ? 12 : 8))
     {
-      AST::NodeId* id = new AST::NodeId();
-      node->setId(id);
-      construct(id);
-      return;
+      case 0:
+      case 1:
+      case 2:
+	if (!variables.empty())
+	{
+	  AST::NodeAffect* affect = new AST::NodeAffect();
+	  affect->setId(constructId(variables[random(variables.size())]));
+	  affect->setExpr(constructExpression(type, depth));
+	  node->setAffect(affect);
+	  _tokens += 2;
+	  return node;
+	}
+	break;
+      case 3:
+	if (!_functions.empty())
+	{
+	  node->setCallFunc(constructCallFunc(random(_functions.size()),
+					      depth));
+	  ++_tokens;
+	  return node;
+	}
+	break;
+      case 4:
+	if (!variables.empty())
+	{
+	  AST::NodeRead* read = new AST::NodeRead();
+	  read->setId(constructId(variables[random(variables.size())]));
+	  node->setRead(read);
+	  _tokens += 4;
+	  return node;
+	}
+	break;
+      case 5:
+	if (_current)
+	{
+	  AST::NodeReturn* ret = new AST::NodeReturn();
+	  ret->setExpr(constructExpression(_current->first, depth));
+	  node->setReturn(ret);
+	  _tokens += 2;
+	  return node;
+	}
+	if (random(4) == 0)
+	{
+	  AST::NodeExit* nExit = new AST::NodeExit();
+	  nExit->setExpr(constructExpression(AST::Type::INTEGER, depth));
+	  node->setExit(nExit);
+	  _tokens += 2;
+	  return node;
+	}
+	break;
+      case 8:
+      case 9:
+	{
+	  AST::NodeIf* nIf = new AST::NodeIf();
+	  nIf->setCond(constructExpression(AST::Type::BOOLEAN, depth));
+	  nIf->setBodyExprs(constructCompoundInstr(depth - 1));
+	  _tokens += 2;
+	  if (random(2))
+	  {
+	    nIf->setElseExprs(constructCompoundInstr(depth - 1));
+	    ++_tokens;
+	  }
+	  node->setIf(nIf);
+	  return node;
+	}
+      case 10:
+	{
+	  AST::NodeWhile* nWhile = new AST::NodeWhile();
+	  nWhile->setCond(constructExpression(AST::Type::BOOLEAN, depth));
+	  nWhile->setBodyExprs(constructCompoundInstr(depth - 1));
+	  node->setWhile(nWhile);
+	  _tokens += 2;
+	  return node;
+	}
+      case 11:
+	node->setCompoundInstr(constructCompoundInstr(depth - 1));
+	return node;
+      default:
+	break;
     }
 
-    if (randomConstruct())
-    {
-      AST::NodeNumber* num = new AST::NodeNumber();
-      node->setNumber(num);
-      construct(num);
-      return;
-    }
-
-    if (randomConstruct())
-    {
-      AST::NodeStringExpr* str = new AST::NodeStringExpr();
-      node->setStringExpr(str);
-      construct(str);
-      return;
-    }
-
-    if (randomConstruct())
-    {
-      AST::NodeBoolean* boolExpr = new AST::NodeBoolean();
-      node->setBool(boolExpr);
-      construct(boolExpr);
-      return;
-    }
-
-    AST::NodeExpression* expr = new AST::NodeExpression();
-    node->setExpression(expr);
-    construct(expr);
+    // Printing is always possible
+    AST::NodePrint* print = new AST::NodePrint();
+    print->setExpr(constructExpression(type, depth));
+    node->setPrint(print);
+    _tokens += 4;
+    return node;
   }
 
   /*!
-  ** Construct instructions node randomly.
+  ** Construct a block of instructions randomly, with at most fan-out
+  ** instructions.
   **
-  ** @param node The instructions node
+  ** @param depth The number of blocks which can still be nested in it
+  **
+  ** @return The block
   */
-  void
-  GenerateAST::construct(AST::NodeInstrs* node)
+  AST::NodeCompoundInstr*
+  GenerateAST::constructCompoundInstr(const unsigned int depth)
   {
-    assert(node);
-    AST::NodeInstr* instr = new AST::NodeInstr();
-    node->setInstr(instr);
-    construct(instr);
+    AST::NodeCompoundInstr* node = new AST::NodeCompoundInstr();
+    AST::NodeInstrs* instrs = 0;
 
-    if (randomConstruct())
+    for (unsigned int i = 1 + random(_params.fanOut); i > 0; --i)
     {
-      AST::NodeInstrs* instrs = new AST::NodeInstrs();
-      node->setInstrs(instrs);
-      construct(instrs);
+      AST::NodeInstrs* next = new AST::NodeInstrs();
+      next->setInstr(constructInstr(depth));
+      next->setInstrs(instrs);
+      instrs = next;
     }
+    node->setInstrs(instrs);
+    _tokens += 2;
+
+    return node;
   }
 
   /*!
-  ** Construct type node randomly.
+  ** Construct an expression of the given type randomly.
   **
-  ** @param node The type node
+  ** @param type The type of the expression
+  ** @param depth The number of expressions which can still be nested
+  **
+  ** @return The expression
   */
-  void
-  GenerateAST::construct(AST::NodeType* node)
+  AST::NodeExpression*
+  GenerateAST::constructExpression(const AST::Type::type type,
+				   const unsigned int depth)
   {
-    assert(node);
-    node->setType(randomType());
+    AST::NodeExpression* node = new AST::NodeExpression();
+    node->setOperation(constructOperation(type, depth));
+    return node;
   }
 
   /*!
-  ** Construct function node randomly.
+  ** Construct an operation of the given type randomly, with operands of
+  ** types compatible with the operator.
   **
-  ** @param node The function node
-  */
-  void
-  GenerateAST::construct(AST::NodeFunction* node)
-  {
-    assert(node);
-
-    AST::NodeHeaderFunc* header = new AST::NodeHeaderFunc();
-    node->setHeaderFunc(header);
-    construct(header);
-
-    if (randomConstruct())
+  ** @param type The type of the operation
+  ** @param depth The number of expressions which can still be nested
+  **
+  ** @return The operation
+  */
+  AST::NodeOperation*
+  GenerateAST::constructOperation(const AST::Type::type type,
+				  const unsigned int depth)
+  {
+    static const AST::Operator::type arithmetic[] =
+      {
+	AST::Operator::PLUS, AST::Operator::MINUS, AST::Operator::MUL,
+	AST::Operator::DIV, AST::Operator::MODULO
+      };
+    static const AST::Operator::type comparison[] =
+      {
+	AST::Operator::EQUAL, AST::Operator::DIFF, AST::Operator::SUP,
+	AST::Operator::SUPEQUAL, AST::Operator::INF, AST::Operator::INFEQUAL
+      };
+    AST::NodeOperation* node = new AST::NodeOperation();
+    AST::Operator::type op = AST::Operator::NONE;
+    AST::Type::type operands = type;
+
+    if (random(2))
+      switch (type)
+      {
+	case AST::Type::INTEGER:
+	  op = arithmetic[random(5)];
+	  break;
+	case AST::Type::STRING:
+	  op = AST::Operator::PLUS;
+	  break;
+	default:
+	  // Any type can be compared, but only integers can be ordered
+	  operands = randomType();
+	  op = comparison[random(operands == AST::Type::INTEGER ? 6 : 2)];
+	  break;
+      }
+
+    node->setOpType(op);
+    node->setLeftFactor(constructFactor(operands, depth));
+    if (op != AST::Operator::NONE)
     {
-      AST::NodeDeclarations* decls = new AST::NodeDeclarations();
-      node->setDeclarations(decls);
-      construct(decls);
+      node->setRightFactor(constructFactor(operands, depth));
+      ++_tokens;
     }
 
-    AST::NodeCompoundInstr* instr = new AST::NodeCompoundInstr();
-    node->setCompoundInstr(instr);
-    construct(instr);
+    return node;
   }
 
   /*!
-  ** Construct while node randomly.
+  ** Construct a factor of the given type randomly: a literal, a
+  ** variable, or, if the depth allows it, a function call or an
+  ** expression between parenthesis.
   **
-  ** @param node The while node
-  */
-  void
-  GenerateAST::construct(AST::NodeWhile* node)
-  {
-    assert(node);
-
-    AST::NodeExpression* expr = new AST::NodeExpression();
-    node->setCond(expr);
-    construct(expr);
-
-    AST::NodeCompoundInstr* body = new AST::NodeCompoundInstr();
-    node->setBodyExprs(body);
-    construct(body);
-  }
-
-  /*!
-  ** Construct declaration body node randomly.
+  ** @param type The type of the factor
+  ** @param depth The number of expressions which can still be nested
   **
-  ** @param node The declaration body node
+  ** @return The factor
   */
-  void
-  GenerateAST::construct(AST::NodeDeclarationBody* node)
-  {
-    assert(node);
-
-    AST::NodeIds* ids = new AST::NodeIds();
-    node->setIds(ids);
-    construct(ids);
-
-    AST::NodeType* type = new AST::NodeType();
-    node->setType(type);
-    construct(type);
-  }
-
-  /*!
-  ** Construct function node randomly.
-  **
-  ** @param node The function node
-  */
-  void
-  GenerateAST::construct(AST::NodeFunctions* node)
+  AST::NodeFactor*
+  GenerateAST::constructFactor(const AST::Type::type type,
+			       const unsigned int depth)
   {
-    assert(node);
+    AST::NodeFactor* node = new AST::NodeFactor();
+    const Names& variables = _variablesByType[type];
+    const std::vector<unsigned int>& functions = _functionsByType[type];
+    const unsigned int choice = random(depth > 0 ? 6 : 4);
 
-    AST::NodeFunction* func = new AST::NodeFunction();
-    node->setFunc(func);
-    construct(func);
+    if (choice == 4 && !functions.empty())
+    {
+      node->setCallFunc(constructCallFunc(functions[random(functions.size())],
+					  depth - 1));
+      return node;
+    }
+    if (choice >= 4)
+    {
+      node->setExpression(constructExpression(type, depth - 1));
+      _tokens += 2;
+      return node;
+    }
+    if (choice >= 2 && !variables.empty())
+    {
+      node->setId(constructId(variables[random(variables.size())]));
+      return node;
+    }
 
-    if (randomConstruct())
+    ++_tokens;
+    switch (type)
     {
-      AST::NodeFunctions* funcs = new AST::NodeFunctions();
-      node->setFuncs(funcs);
-      construct(funcs);
+      case AST::Type::INTEGER:
+	{
+	  // Not 0, so that constant folding never divides by zero
+	  AST::NodeNumber* number = new AST::NodeNumber();
+	  number->setNumber(1 + random(999));
+	  node->setNumber(number);
+	}
+	break;
+      case AST::Type::STRING:
+	{
+	  AST::NodeStringExpr* str = new AST::NodeStringExpr();
+	  str->setString(name("text", random(NB_STRINGS)));
+	  node->setStringExpr(str);
+	}
+	break;
+      default:
+	{
+	  AST::NodeBoolean* boolean = new AST::NodeBoolean();
+	  boolean->setBool(random(2));
+	  node->setBool(boolean);
+	}
+	break;
     }
-  }
 
-  /*!
-  ** Construct number node randomly.
-  **
-  ** @param node The number node
-  */
-  void
-  GenerateAST::construct(AST::NodeNumber* node)
-  {
-    assert(node);
-    node->setNumber(rand() % 1000);
+    return node;
   }
 
   /*!
-  ** Construct declaration node randomly.
+  ** Construct a call of a function, with arguments of the types of its
+  ** parameters.
   **
-  ** @param node The declaration node
-  */
-  void
-  GenerateAST::construct(AST::NodeDeclaration* node)
-  {
-    assert(node);
-
-    AST::NodeDeclarationBody* bodyDecl = new AST::NodeDeclarationBody();
-    node->setBody(bodyDecl);
-    construct(bodyDecl);
-  }
-
-  /*!
-  ** Construct header function node randomly.
+  ** @param index The index of the function
+  ** @param depth The number of expressions which can still be nested in
+  ** the arguments
   **
-  ** @param node The header function node
+  ** @return The call
   */
-  void
-  GenerateAST::construct(AST::NodeHeaderFunc* node)
+  AST::NodeCallFunc*
+  GenerateAST::constructCallFunc(const unsigned int index,
+				 const unsigned int depth)
   {
-    assert(node);
-
+    assert(index < _functions.size());
+    const Types& params = _functions[index].second;
+    AST::NodeCallFunc* node = new AST::NodeCallFunc();
     AST::NodeIdFunc* id = new AST::NodeIdFunc();
-    node->setId(id);
-    construct(id);
+    AST::NodeExpressions* exprs = 0;
 
-    if (randomConstruct())
+    id->setId(name("f", index));
+    node->setId(id);
+    for (unsigned int i = params.size(); i > 0; --i)
     {
-      AST::NodeArguments* args = new AST::NodeArguments();
-      node->setArguments(args);
-      construct(args);
+      AST::NodeExpressions* next = new AST::NodeExpressions();
+      next->setExpr(constructExpression(params[i - 1], depth));
+      next->setExprs(exprs);
+      exprs = next;
+      ++_tokens;
     }
+    node->setExprs(exprs);
+    _tokens += 3;
 
-    AST::NodeType* type = new AST::NodeType();
-    node->setType(type);
-    construct(type);
+    return node;
   }
 
   /*!
-  ** Construct declarations node randomly.
+  ** Construct an id node.
   **
-  ** @param node The declarations node
-  */
-  void
-  GenerateAST::construct(AST::NodeDeclarations* node)
-  {
-    assert(node);
-
-    AST::NodeDeclaration* decl = new AST::NodeDeclaration();
-    node->setDeclaration(decl);
-    construct(decl);
-
-    if (randomConstruct())
-    {
-      AST::NodeDeclarations* decls = new AST::NodeDeclarations();
-      node->setDeclarations(decls);
-      construct(decls);
-    }
-  }
-
-  /*!
-  ** Construct id node randomly.
+  ** @param name The name of the variable
   **
-  ** @param node The id node
+  ** @return The id node
   */
-  void
-  GenerateAST::construct(AST::NodeId* node)
+  AST::NodeId*
+  GenerateAST::constructId(const std::string& name)
   {
-    assert(node);
-    node->setId("id");
+    AST::NodeId* node = new AST::NodeId();
+    node->setId(name);
+    ++_tokens;
+    return node;
   }
 
   /*!
-  ** Construct function id node randomly.
+  ** Construct a type node.
+  **
+  ** @param type The type
   **
-  ** @param node The function id node
+  ** @return The type node
   */
-  void
-  GenerateAST::construct(AST::NodeIdFunc* node)
+  AST::NodeType*
+  GenerateAST::constructType(const AST::Type::type type)
   {
-    assert(node);
-    node->setId("FuncId");
+    Configuration& cfg = Configuration::getInstance();
+    AST::NodeType* node = new AST::NodeType();
+
+    switch (type)
+    {
+      case AST::Type::INTEGER:
+	node->setType(cfg["int"]);
+	break;
+      case AST::Type::STRING:
+	node->setType(cfg["string"]);
+	break;
+      default:
+	node->setType(cfg["bool"]);
+	break;
+    }
+    _tokens += 2;
+
+    return node;
   }
 
   /*!
-  ** Construct print node randomly.
+  ** Get random types.
+  **
+  ** @param nb The number of types
   **
-  ** @param node The print node
+  ** @return The types
   */
-  void
-  GenerateAST::construct(AST::NodePrint* node)
+  GenerateAST::Types
+  GenerateAST::randomTypes(const unsigned int nb)
   {
-    assert(node);
+    Types res;
 
-    AST::NodeExpression* expr = new AST::NodeExpression();
-    node->setExpr(expr);
-    construct(expr);
+    for (unsigned int i = 0; i < nb; ++i)
+      res.push_back(randomType());
+    return res;
   }
 }
@@ -2,8 +2,10 @@
 # define GENERATEAST_HH_
 
 # include <cassert>
-# include <cstdlib>
-# include "IVisitor.hh"
+# include <iostream>
+# include <string>
+# include <utility>
+# include <vector>
 # include "NodeIds.hh"
 # include "NodeProgram.hh"
 # include "NodeAffect.hh"
@@ -40,48 +42,80 @@
 
 namespace MiniCompiler
 {
+  /*!
+  ** Generate random programs which bind and type check, to stress the
+  ** compiler. A same seed always gives a same program, on every host.
+  ** The program is written while it is generated, one instruction of
+  ** the top level of a function at a time, so that its size is only
+  ** bounded by the output.
+  ** Generated programs are not meant to be run: they can loop forever.
+  */
   class GenerateAST
   {
+  public:
+    /*!
+    ** The shape of generated programs.
+    */
+    struct Parameters
+    {
+      Parameters();
+
+      unsigned int		seed;
+      unsigned long long	tokens;
+      unsigned int		functions;
+      unsigned int		nesting;
+      unsigned int		fanOut;
+    };
+
+  private:
+    typedef std::vector<AST::Type::type> Types;
+    typedef std::pair<AST::Type::type, Types> Signature;
+    typedef std::vector<std::string> Names;
+
   public:
     GenerateAST();
     ~GenerateAST();
-    void construct(AST::NodeIds* node);
-    void construct(AST::NodeProgram* node);
-    void construct(AST::NodeAffect* node);
-    void construct(AST::NodeIf* node);
-    void construct(AST::NodeRead* node);
-    void construct(AST::NodeArgument* node);
-    void construct(AST::NodeArguments* node);
-    void construct(AST::NodeReturn* node);
-    void construct(AST::NodeExit* node);
-    void construct(AST::NodeCallFunc* node);
-    void construct(AST::NodeOperation* node);
-    void construct(AST::NodeExpression* node);
-    void construct(AST::NodeStringExpr* node);
-    void construct(AST::NodeBoolean* node);
-    void construct(AST::NodeExpressions* node);
-    void construct(AST::NodeInstr* node);
-    void construct(AST::NodeCompoundInstr* node);
-    void construct(AST::NodeFactor* node);
-    void construct(AST::NodeInstrs* node);
-    void construct(AST::NodeType* node);
-    void construct(AST::NodeFunction* node);
-    void construct(AST::NodeWhile* node);
-    void construct(AST::NodeDeclarationBody* node);
-    void construct(AST::NodeFunctions* node);
-    void construct(AST::NodeNumber* node);
-    void construct(AST::NodeDeclaration* node);
-    void construct(AST::NodeHeaderFunc* node);
-    void construct(AST::NodeDeclarations* node);
-    void construct(AST::NodeId* node);
-    void construct(AST::NodeIdFunc* node);
-    void construct(AST::NodePrint* node);
+
+  public:
+    void setParameters(const Parameters& params);
+    void generate(std::ostream& o);
+
+  private:
+    void writeFunction(std::ostream& o, const unsigned int index,
+		       const unsigned long long budget);
+    void writeBody(std::ostream& o, const unsigned long long end);
+    void declare(const std::string& prefix, const Types& types);
+    AST::NodeDeclarations* constructDeclarations(const std::string& prefix,
+						 const Types& types);
+    AST::NodeArguments* constructArguments(const Types& types,
+					   const unsigned int index);
+    AST::NodeInstr* constructInstr(const unsigned int depth);
+    AST::NodeCompoundInstr* constructCompoundInstr(const unsigned int depth);
+    AST::NodeExpression* constructExpression(const AST::Type::type type,
+					     const unsigned int depth);
+    AST::NodeOperation* constructOperation(const AST::Type::type type,
+					   const unsigned int depth);
+    AST::NodeFactor* constructFactor(const AST::Type::type type,
+				     const unsigned int depth);
+    AST::NodeCallFunc* constructCallFunc(const unsigned int index,
+					 const unsigned int depth);
+    AST::NodeId* constructId(const std::string& name);
+    AST::NodeType* constructType(const AST::Type::type type);
+
+  private:
+    unsigned int random(const unsigned int mod);
+    AST::Type::type randomType();
+    Types randomTypes(const unsigned int nb);
+    static std::string name(const std::string& prefix, const unsigned int i);
 
   private:
-    bool randomConstruct() const;
-    bool randomConstruct(const unsigned int mod) const;
-    AST::Operator::type randomOperator() const;
-    const std::string& randomType() const;
+    Parameters			_params;
+    unsigned long long		_state;
+    unsigned long long		_tokens;
+    std::vector<Signature>	_functions;
+    std::vector<unsigned int>	_functionsByType[AST::Type::STRING + 1];
+    Names			_variablesByType[AST::Type::STRING + 1];
+    const Signature*		_current;
   };
 }
 
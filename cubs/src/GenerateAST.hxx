@@ -1,38 +1,23 @@
 namespace MiniCompiler
 {
   /*!
-  ** Get a random value modulo the given value.
+  ** Get a random value lower than the given value, from a SplitMix64
+  ** generator, so that a seed gives the same values on every host.
   **
-  ** @param mod The modulo
+  ** @param mod The modulo, not 0
   **
-  ** @return A random value modulo a given value
+  ** @return A random value lower than mod
   */
-  inline bool
-  GenerateAST::randomConstruct(const unsigned int mod) const
+  inline unsigned int
+  GenerateAST::random(const unsigned int mod)
   {
-    return rand() % mod;
-  }
-
-  /*!
-  ** Get a random value modulo 2
-  **
-  ** @return A random value modulo 2
-  */
-  inline bool
-  GenerateAST::randomConstruct() const
-  {
-    return randomConstruct(2);
-  }
-
-  /*!
-  ** Get a random operator.
-  **
-  ** @return A random operator
-  */
-  inline AST::Operator::type
-  GenerateAST::randomOperator() const
-  {
-    return AST::Operator::type((rand() % 11) + 1);
+    assert(mod > 0);
+    _state += 0x9E3779B97F4A7C15ULL;
+    unsigned long long z = _state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return static_cast<unsigned int>(z % mod);
   }
 
   /*!
@@ -40,20 +25,31 @@ namespace MiniCompiler
   **
   ** @return A random type
   */
-  inline const std::string&
-  GenerateAST::randomType() const
+  inline AST::Type::type
+  GenerateAST::randomType()
   {
-    Configuration& cfg = Configuration::getInstance();
-    switch (rand() % 3)
+    switch (random(3))
     {
       case 0:
-	return cfg["int"];
+	return AST::Type::INTEGER;
       case 1:
-	return cfg["string"];
-      case 2:
-	return cfg["bool"];
+	return AST::Type::STRING;
       default:
-	return cfg["int"];
+	return AST::Type::BOOLEAN;
     }
   }
+
+  /*!
+  ** Build the name of a variable or of a function.
+  **
+  ** @param prefix The prefix, telling where it is declared
+  ** @param i Its number
+  **
+  ** @return The name
+  */
+  inline std::string
+  GenerateAST::name(const std::string& prefix, const unsigned int i)
+  {
+    return prefix + Utils::intToString(i);
+  }
 }
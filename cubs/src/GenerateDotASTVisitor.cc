@@ -40,14 +40,56 @@ namespace MiniCompiler
   ** initializing tabulation.
   */
   GenerateDotASTVisitor::GenerateDotASTVisitor()
+    : _output(0), _indent(&_buffer)
   {
   }
 
   /*!
-  ** Destruct the visitor.
+  ** Destruct the visitor, writing what remains of the output.
   */
   GenerateDotASTVisitor::~GenerateDotASTVisitor()
   {
+    flush();
+    delete _output;
+  }
+
+  /*!
+  ** Write the graph to a stream while it is generated, by blocks,
+  ** instead of keeping it until it is printed.
+  **
+  ** @param o The stream
+  */
+  void
+  GenerateDotASTVisitor::setOutput(std::ostream& o)
+  {
+    flush();
+    delete _output;
+    _output = new OutputBuffer(o);
+    _indent.rdbuf(_output);
+  }
+
+  /*!
+  ** Write the graph to a file descriptor while it is generated, by
+  ** blocks, instead of keeping it until it is printed.
+  **
+  ** @param fd The file descriptor
+  */
+  void
+  GenerateDotASTVisitor::setOutput(const int fd)
+  {
+    flush();
+    delete _output;
+    _output = new OutputBuffer(fd);
+    _indent.rdbuf(_output);
+  }
+
+  /*!
+  ** Write the graph generated so far to the output, if there is one.
+  */
+  void
+  GenerateDotASTVisitor::flush()
+  {
+    _indent.flush();
   }
 
   /*!
@@ -69,11 +111,11 @@ namespace MiniCompiler
     const AST::NodeId* id = node->getId();
     assert(id);
     _rootName = name;
-    id->accept(*this);
+    visit(id);
     if (ids)
     {
       _rootName = name;
-      ids->accept(*this);
+      visit(ids);
     }
   }
 
@@ -94,21 +136,21 @@ namespace MiniCompiler
     if (decls)
     {
       _rootName = NodeName::PROGRAM;
-      decls->accept(*this);
+      visit(decls);
     }
 
     const AST::NodeFunctions* funcs = node->getFuncs();
     if (funcs)
     {
       _rootName = NodeName::PROGRAM;
-      funcs->accept(*this);
+      visit(funcs);
     }
 
     const AST::NodeCompoundInstr* instrs = node->getInstrs();
     if (instrs)
     {
       _rootName = NodeName::PROGRAM;
-      instrs->accept(*this);
+      visit(instrs);
     }
     _indent << "\n}\n";
   }
@@ -133,9 +175,9 @@ namespace MiniCompiler
     assert(id);
     assert(expr);
     _rootName = name;
-    id->accept(*this);
+    visit(id);
     _rootName = name;
-    expr->accept(*this);
+    visit(expr);
   }
 
   /*!
@@ -160,13 +202,13 @@ namespace MiniCompiler
     assert(body);
 
     _rootName = name;
-    cond->accept(*this);
+    visit(cond);
     _rootName = name;
-    body->accept(*this);
+    visit(body);
     if (elseExprs)
     {
       _rootName = name;
-      elseExprs->accept(*this);
+      visit(elseExprs);
     }
   }
 
@@ -189,7 +231,7 @@ namespace MiniCompiler
     assert(id);
 
     _rootName = name;
-    id->accept(*this);
+    visit(id);
   }
 
   /*!
@@ -212,11 +254,11 @@ namespace MiniCompiler
 
     assert(body);
     _rootName = name;
-    body->accept(*this);
+    visit(body);
     if (args)
     {
       _rootName = name;
-      args->accept(*this);
+      visit(args);
     }
   }
 
@@ -239,11 +281,11 @@ namespace MiniCompiler
     const AST::NodeArguments* args = node->getArguments();
     assert(arg);
     _rootName = name;
-    arg->accept(*this);
+    visit(arg);
     if (args)
     {
       _rootName = name;
-      args->accept(*this);
+      visit(args);
     }
   }
 
@@ -265,7 +307,7 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
     _rootName = name;
-    expr->accept(*this);
+    visit(expr);
   }
 
   /*!
@@ -286,7 +328,7 @@ namespace MiniCompiler
     const AST::NodeExpression* expr = node->getExpr();
     assert(expr);
     _rootName = name;
-    expr->accept(*this);
+    visit(expr);
   }
 
   /*!
@@ -309,11 +351,11 @@ namespace MiniCompiler
     assert(id);
 
     _rootName = name;
-    id->accept(*this);
+    visit(id);
     if (exprs)
     {
       _rootName = name;
-      exprs->accept(*this);
+      visit(exprs);
     }
   }
 
@@ -339,13 +381,13 @@ namespace MiniCompiler
     assert(leftFactor);
 
     _rootName = name;
-    leftFactor->accept(*this);
+    visit(leftFactor);
     if (node->getOpType() != AST::Operator::NONE)
     {
       const AST::NodeFactor* rightFactor = node->getRightFactor();
       assert(rightFactor);
       _rootName = name;
-      rightFactor->accept(*this);
+      visit(rightFactor);
     }
   }
 
@@ -365,7 +407,7 @@ namespace MiniCompiler
     linkNode(name, _rootName);
 
     _rootName = name;
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<GenerateDotASTVisitor>::visit(node);
   }
 
   /*!
@@ -420,11 +462,11 @@ namespace MiniCompiler
     assert(expr);
 
     _rootName = name;
-    expr->accept(*this);
+    visit(expr);
     if (exprs)
     {
       _rootName = name;
-      exprs->accept(*this);
+      visit(exprs);
     }
   }
 
@@ -444,7 +486,7 @@ namespace MiniCompiler
     linkNode(name, _rootName);
 
     _rootName = name;
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<GenerateDotASTVisitor>::visit(node);
   }
 
   /*!
@@ -466,7 +508,7 @@ namespace MiniCompiler
     if (instrs)
     {
       _rootName = name;
-      instrs->accept(*this);
+      visit(instrs);
     }
   }
 
@@ -486,7 +528,7 @@ namespace MiniCompiler
     linkNode(name, _rootName);
 
     _rootName = name;
-    ConstBaseVisitor::visit(node);
+    ConstBaseVisitor<GenerateDotASTVisitor>::visit(node);
   }
 
   /*!
@@ -509,11 +551,11 @@ namespace MiniCompiler
     assert(instr);
 
     _rootName = name;
-    instr->accept(*this);
+    visit(instr);
     if (instrs)
     {
       _rootName = name;
-      instrs->accept(*this);
+      visit(instrs);
     }
   }
 
@@ -555,14 +597,14 @@ namespace MiniCompiler
     assert(instr);
 
     _rootName = name;
-    header->accept(*this);
+    visit(header);
     if (decls)
     {
       _rootName = name;
-      decls->accept(*this);
+      visit(decls);
     }
     _rootName = name;
-    instr->accept(*this);
+    visit(instr);
   }
 
   /*!
@@ -586,9 +628,9 @@ namespace MiniCompiler
     assert(body);
 
     _rootName = name;
-    cond->accept(*this);
+    visit(cond);
     _rootName = name;
-    body->accept(*this);
+    visit(body);
   }
 
   /*!
@@ -612,9 +654,9 @@ namespace MiniCompiler
     assert(type);
 
     _rootName = name;
-    ids->accept(*this);
+    visit(ids);
     _rootName = name;
-    type->accept(*this);
+    visit(type);
   }
 
   /*!
@@ -636,11 +678,11 @@ namespace MiniCompiler
     AST::NodeFunctions* funcs = node->getFuncs();
     assert(func);
     _rootName = name;
-    func->accept(*this);
+    visit(func);
     if (funcs)
     {
       _rootName = name;
-      funcs->accept(*this);
+      visit(funcs);
     }
   }
 
@@ -678,7 +720,7 @@ namespace MiniCompiler
     const AST::NodeDeclarationBody* body = node->getBody();
     assert(body);
     _rootName = name;
-    body->accept(*this);
+    visit(body);
   }
 
   /*!
@@ -703,14 +745,14 @@ namespace MiniCompiler
     assert(type);
 
     _rootName = name;
-    id->accept(*this);
+    visit(id);
     if (args)
     {
       _rootName = name;
-      args->accept(*this);
+      visit(args);
     }
     _rootName = name;
-    type->accept(*this);
+    visit(type);
   }
 
   /*!
@@ -731,11 +773,11 @@ namespace MiniCompiler
     AST::NodeDeclaration* decl = node->getDeclaration();
     assert(decl);
     _rootName = name;
-    decl->accept(*this);
+    visit(decl);
     AST::NodeDeclarations* decls = node->getDeclarations();
     _rootName = name;
     if (decls)
-      decls->accept(*this);
+      visit(decls);
   }
 
   /*!
@@ -790,7 +832,7 @@ namespace MiniCompiler
     const AST::NodeExpression* id = node->getExpr();
     assert(id);
     _rootName = name;
-    id->accept(*this);
+    visit(id);
   }
 
   /*!
@@ -801,7 +843,7 @@ namespace MiniCompiler
   void
   GenerateDotASTVisitor::print(std::ostream& o) const
   {
-    o << _indent.str();
+    o << _buffer.str();
   }
 
   /*!
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <algorithm>
 #include "Lexer.hh"
 
 namespace MiniCompiler
@@ -45,18 +46,31 @@ namespace MiniCompiler
   }
 
   /*!
-  ** Browse the file line by line,
-  ** and extract tokens.
+  ** Browse the file line by line, and extract tokens.
+  ** Tokens never span lines, so a large file can be cut in chunks of
+  ** whole lines, lexed by several threads. Symbols and errors are then
+  ** the same, and in the same order, as when lexed by a single thread.
   **
   ** @param file The stream to lex
+  ** @param jobs The maximum number of threads
   */
-  Lexer::Lexer(std::stringstream& file)
+  Lexer::Lexer(std::stringstream& file, const unsigned int jobs)
   {
-    std::string line;
-    int lineNumber = 0;
+    const std::string buffer = file.str();
+    const unsigned int chunks =
+      std::min<std::string::size_type>(jobs, buffer.size() / MIN_CHUNK_SIZE);
+
+    if (chunks > 1)
+      lexInParallel(buffer, chunks);
+    else
+      lex(buffer, 0, buffer.size(), 1);
+  }
 
-    while (std::getline(file, line))
-      extractTokenFromLine(line, ++lineNumber);
+  /*!
+  ** Construct an empty lexer, for a chunk of a file.
+  */
+  Lexer::Lexer()
+  {
   }
 
   /*!
@@ -71,6 +85,127 @@ namespace MiniCompiler
       delete *symbol;
   }
 
+  /*!
+  ** Extract tokens of the lines in a part of a buffer.
+  ** The part ends after its last line break, or at the end of the buffer.
+  **
+  ** @param buffer The whole file
+  ** @param begin The position of the first line
+  ** @param end The position after the last line
+  ** @param lineNumber The number of the first line
+  */
+  void
+  Lexer::lex(const std::string& buffer, std::string::size_type begin,
+	     const std::string::size_type end, int lineNumber)
+  {
+    std::string line;
+
+    while (begin < end)
+    {
+      std::string::size_type next = buffer.find('\n', begin);
+      if (next == std::string::npos || next > end)
+	next = end;
+      line.assign(buffer, begin, next - begin);
+      extractTokenFromLine(line, lineNumber++);
+      begin = next + 1;
+    }
+  }
+
+  /*!
+  ** Cut the buffer in chunks of whole lines, of about the same size,
+  ** and lex each of them on a thread pool.
+  ** Then take symbols and errors of chunks, in order.
+  **
+  ** @param buffer The whole file
+  ** @param jobs The number of chunks
+  */
+  void
+  Lexer::lexInParallel(const std::string& buffer, const unsigned int jobs)
+  {
+    const std::string::size_type size = buffer.size();
+    std::vector<Chunk> chunks(jobs);
+    std::string::size_type begin = 0;
+    int line = 1;
+
+    for (unsigned int i = 0; i < jobs; i++)
+    {
+      std::string::size_type end = size;
+      if (i + 1 < jobs)
+      {
+	end = buffer.find('\n', std::max(begin, size / jobs * (i + 1)));
+	end = end == std::string::npos ? size : end + 1;
+      }
+      chunks[i].lexer = new Lexer();
+      chunks[i].buffer = &buffer;
+      chunks[i].begin = begin;
+      chunks[i].end = end;
+      chunks[i].line = line;
+      line += std::count(buffer.begin() + begin, buffer.begin() + end, '\n');
+      begin = end;
+    }
+
+    ThreadPool pool(jobs);
+    pool.run(&Lexer::launch, &chunks, jobs);
+
+    for (unsigned int i = 0; i < jobs; i++)
+    {
+      Lexer* lexer = chunks[i].lexer;
+      _symbols.insert(_symbols.end(), lexer->_symbols.begin(),
+		      lexer->_symbols.end());
+      lexer->_symbols.clear();
+      _errors.moveErrors(lexer->_errors);
+      delete lexer;
+    }
+  }
+
+  /*!
+  ** Lex a chunk, from a thread of the pool.
+  **
+  ** @param data The chunks
+  ** @param i The number of the chunk to lex
+  */
+  void
+  Lexer::launch(void* data, const unsigned int i)
+  {
+    Chunk& chunk = (*static_cast<std::vector<Chunk>*>(data))[i];
+
+    chunk.lexer->lex(*chunk.buffer, chunk.begin, chunk.end, chunk.line);
+  }
+
+  /*!
+  ** Create a symbol, and add it in the lexer. A token already found
+  ** is copied from its first symbol: this saves guessing its type,
+  ** and sharing its text, which is locked when lexing in parallel.
+  **
+  ** @param token The text of the symbol
+  ** @param line The line where the symbol is
+  ** @param stringExpr If the symbol is a string expression
+  **
+  ** @return The symbol
+  */
+  Symbol*
+  Lexer::createSymbol(const std::string& token, const int line,
+		      const bool stringExpr)
+  {
+    Known& known = stringExpr ? _knownStrings : _knownSymbols;
+    Known::const_iterator found = known.find(token);
+    Symbol* symbol = 0;
+
+    if (found != known.end())
+      symbol = new Symbol(*found->second, line);
+    else
+    {
+      if (stringExpr)
+	symbol = new Symbol(token, line, Symbol::STRING_EXPR);
+      else
+	symbol = new Symbol(token, line);
+      known[token] = symbol;
+    }
+    _symbols.push_back(symbol);
+
+    return symbol;
+  }
+
   /*!
   ** Check if a character is present in the given table.
   **
@@ -159,7 +294,7 @@ namespace MiniCompiler
   void
   Lexer::storeSymbol(const char c, const int line)
   {
-    _symbols.push_back(new Symbol(Utils::charToString(c), line));
+    createSymbol(Utils::charToString(c), line, false);
   }
 
   /*!
@@ -173,8 +308,8 @@ namespace MiniCompiler
   Lexer::mergeAndStoreSymbol(const char cl, const char cr,
 			     const int line)
   {
-    _symbols.push_back(new Symbol(Utils::charToString(cl) +
-				  Utils::charToString(cr), line));
+    createSymbol(Utils::charToString(cl) + Utils::charToString(cr),
+		 line, false);
   }
 
   /*!
@@ -187,8 +322,7 @@ namespace MiniCompiler
   Lexer::storeStringExpr(const std::string& stringExpr,
 			 const int line)
   {
-    _symbols.push_back(new Symbol(stringExpr,
-				  line, Symbol::STRING_EXPR));
+    createSymbol(stringExpr, line, true);
   }
 
   /*!
@@ -201,8 +335,7 @@ namespace MiniCompiler
   void
   Lexer::storeExpr(const std::string& Expr, const int line)
   {
-    Symbol* symb = new Symbol(Expr, line);
-    _symbols.push_back(symb);
+    Symbol* symb = createSymbol(Expr, line, false);
     if (!symb->check())
       _errors.addError(Error::LEXER, "\"" + Expr + "\" is invalid : an ID must have a valid name, ie [a-zA-Z][a-zA-Z0-9_]* and no builtin name", line);
   }
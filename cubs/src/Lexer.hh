@@ -2,6 +2,7 @@
 # define LEXER_HH_
 
 # include <vector>
+# include <map>
 # include <string>
 # include <sstream>
 # include <fstream>
@@ -10,15 +11,37 @@
 # include "Utils.hh"
 # include "Symbol.hh"
 # include "ErrorHandler.hh"
+# include "ThreadPool.hh"
 
 namespace MiniCompiler
 {
   class Lexer
   {
   public:
-    Lexer(std::stringstream& file);
+    Lexer(std::stringstream& file, const unsigned int jobs = 1);
     ~Lexer();
 
+  private:
+    Lexer();
+
+  private:
+    /*!
+    ** A part of the file, made of whole lines, lexed by its own lexer.
+    */
+    struct Chunk
+    {
+      Lexer*			lexer;
+      const std::string*	buffer;
+      std::string::size_type	begin;
+      std::string::size_type	end;
+      int			line;
+    };
+
+    typedef std::map<std::string, const Symbol*> Known;
+
+    /// Under this size, a chunk isn't worth a thread
+    static const std::string::size_type MIN_CHUNK_SIZE = 1 << 16;
+
   public:
     bool hasErrors() const;
     void displayErrors() const;
@@ -27,6 +50,12 @@ namespace MiniCompiler
     unsigned int length() const;
 
   private:
+    void lex(const std::string& buffer, std::string::size_type begin,
+	     const std::string::size_type end, int lineNumber);
+    void lexInParallel(const std::string& buffer, const unsigned int jobs);
+    static void launch(void* data, const unsigned int i);
+    Symbol* createSymbol(const std::string& token, const int line,
+			 const bool stringExpr);
     bool charInTab(const char c, const char* tab);
     bool isSpace(const char c);
     void extractTokenFromLine(const std::string& line, const int lineNumber);
@@ -51,6 +80,8 @@ namespace MiniCompiler
   private:
     std::vector<Symbol*>	_symbols;
     ErrorHandler		_errors;
+    Known			_knownSymbols;
+    Known			_knownStrings;
   };
 
   std::ostream&
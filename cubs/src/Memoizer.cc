@@ -0,0 +1,180 @@
+#include <cassert>
+#include <sstream>
+#include "Memoizer.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct an empty memoizer, with the default maximum size.
+  */
+  Memoizer::Memoizer()
+    : _maxSize(DEFAULT_MAX_SIZE), _hits(0), _misses(0)
+  {
+  }
+
+  /*!
+  ** Destruct the memoizer, deleting all stored results.
+  */
+  Memoizer::~Memoizer()
+  {
+    clear();
+  }
+
+  /*!
+  ** Append an argument value to the given key.
+  ** Each value is prefixed by its type, and strings by their length,
+  ** so two different argument lists can't give the same key.
+  **
+  ** @param args The key to fill
+  ** @param var The argument value
+  */
+  void
+  Memoizer::appendArgument(std::string& args, const Variable& var)
+  {
+    std::stringstream buf;
+
+    switch (var.getType())
+    {
+      case AST::Type::INTEGER:
+	buf << 'i' << var.getInt() << ';';
+	break;
+      case AST::Type::BOOLEAN:
+	buf << 'b' << (var.getBool() ? 1 : 0) << ';';
+	break;
+      case AST::Type::STRING:
+	buf << 's' << var.getString().length() << ':' << var.getString();
+	break;
+      default:
+	assert(false);
+    }
+    args += buf.str();
+  }
+
+  /*!
+  ** Get an already computed result.
+  **
+  ** @param func The called function
+  ** @param args The arguments key, built with appendArgument
+  **
+  ** @return The result, or null if not computed yet
+  */
+  const Variable*
+  Memoizer::get(const AST::NodeFunction* func, const std::string& args)
+  {
+    Values::const_iterator it = _values.find(Key(func, args));
+
+    if (it == _values.end())
+    {
+      _misses++;
+      return 0;
+    }
+
+    _hits++;
+    return it->second;
+  }
+
+  /*!
+  ** Store a computed result, forgetting the oldest one if full.
+  **
+  ** @param func The called function
+  ** @param args The arguments key, built with appendArgument
+  ** @param value The result of the call
+  */
+  void
+  Memoizer::put(const AST::NodeFunction* func,
+		const std::string& args,
+		const Variable& value)
+  {
+    const Key key(func, args);
+    Values::iterator it = _values.find(key);
+
+    if (it != _values.end())
+    {
+      delete it->second;
+      it->second = new Variable(value);
+      return;
+    }
+
+    if (_maxSize == 0)
+      return;
+
+    shrink(_maxSize - 1);
+    _values[key] = new Variable(value);
+    _history.push_back(key);
+  }
+
+  /*!
+  ** Forget all stored results.
+  */
+  void
+  Memoizer::clear()
+  {
+    for (Values::iterator it = _values.begin(); it != _values.end(); ++it)
+      delete it->second;
+    _values.clear();
+    _history.clear();
+  }
+
+  /*!
+  ** Set the maximum number of stored results.
+  **
+  ** @param size The maximum number of results
+  */
+  void
+  Memoizer::setMaxSize(const unsigned int size)
+  {
+    _maxSize = size;
+    shrink(_maxSize);
+  }
+
+  /*!
+  ** Forget the oldest results until there are no more than the given size.
+  **
+  ** @param size The number of results to keep
+  */
+  void
+  Memoizer::shrink(const unsigned int size)
+  {
+    while (_values.size() > size)
+    {
+      Values::iterator old = _values.find(_history.front());
+      assert(old != _values.end());
+      delete old->second;
+      _values.erase(old);
+      _history.pop_front();
+    }
+  }
+
+  /*!
+  ** Get the number of stored results.
+  **
+  ** @return The number of stored results
+  */
+  unsigned int
+  Memoizer::size() const
+  {
+    return _values.size();
+  }
+
+  /*!
+  ** Get the number of calls found in the cache.
+  **
+  ** @return The number of hits
+  */
+  unsigned int
+  Memoizer::getHits() const
+  {
+    return _hits;
+  }
+
+  /*!
+  ** Get the number of calls not found in the cache.
+  **
+  ** @return The number of misses
+  */
+  unsigned int
+  Memoizer::getMisses() const
+  {
+    return _misses;
+  }
+}
@@ -0,0 +1,60 @@
+#ifndef MEMOIZER_HH_
+# define MEMOIZER_HH_
+
+# include <map>
+# include <list>
+# include <string>
+# include <utility>
+# include "Variable.hh"
+
+namespace MiniCompiler
+{
+  namespace AST
+  {
+    class NodeFunction;
+  }
+
+  /*!
+  ** Cache of already computed pure function calls.
+  ** Results are keyed by the called function and its arguments values.
+  ** When full, the oldest result is forgotten.
+  */
+  class Memoizer
+  {
+    typedef std::pair<const AST::NodeFunction*, std::string> Key;
+    typedef std::map<Key, Variable*> Values;
+    typedef std::list<Key> History;
+
+  public:
+    static const unsigned int DEFAULT_MAX_SIZE = 65536;
+
+  public:
+    Memoizer();
+    ~Memoizer();
+
+  public:
+    static void appendArgument(std::string& args, const Variable& var);
+    const Variable* get(const AST::NodeFunction* func,
+			const std::string& args);
+    void put(const AST::NodeFunction* func,
+	     const std::string& args,
+	     const Variable& value);
+    void clear();
+    void setMaxSize(const unsigned int size);
+    unsigned int size() const;
+    unsigned int getHits() const;
+    unsigned int getMisses() const;
+
+  private:
+    void shrink(const unsigned int size);
+
+  private:
+    Values		_values;
+    History		_history;
+    unsigned int	_maxSize;
+    unsigned int	_hits;
+    unsigned int	_misses;
+  };
+}
+
+#endif /* !MEMOIZER_HH_ */
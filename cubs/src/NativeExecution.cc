@@ -0,0 +1,214 @@
+#include <cassert>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "NativeExecution.hh"
+#include "Execution.hh"
+#include "ExecutionVisitor.hh"
+
+namespace MiniCompiler
+{
+  namespace
+  {
+    const size_t SECTION_ALIGN = 16;
+
+    /*!
+    ** Round a size up to a multiple of the given alignment.
+    **
+    ** @param size The size
+    ** @param align The alignment, a power of 2
+    **
+    ** @return The rounded size
+    */
+    size_t
+    alignUp(const size_t size, const size_t align)
+    {
+      return (size + align - 1) & ~(align - 1);
+    }
+  }
+
+  /*!
+  ** Construct a native execution, with nothing loaded.
+  */
+  NativeExecution::NativeExecution()
+    : _memory(0), _size(0), _maxDepth(ExecutionVisitor::DEFAULT_MAX_DEPTH)
+  {
+  }
+
+  /*!
+  ** Destruct a native execution, unmapping the loaded code.
+  */
+  NativeExecution::~NativeExecution()
+  {
+    release();
+  }
+
+  /*!
+  ** Assemble the code into memory. Text and rodata are made executable
+  ** and read-only, data and bss writable, on their own pages.
+  **
+  ** @param code The code, generated with a hosted runtime
+  **
+  ** @return If the code was loaded, else see getErrorMessage
+  */
+  bool
+  NativeExecution::load(const std::string& code)
+  {
+    typedef ASM64Assembler A;
+    const size_t page = sysconf(_SC_PAGESIZE);
+
+    release();
+    if (!_assembler.assemble(code))
+    {
+      _error = _assembler.getError();
+      return false;
+    }
+
+    _offsets[A::TEXT] = 0;
+    _offsets[A::RODATA] = alignUp(_assembler.getSize(A::TEXT), SECTION_ALIGN);
+    _offsets[A::DATA] = alignUp(_offsets[A::RODATA] +
+				_assembler.getSize(A::RODATA), page);
+    _offsets[A::BSS] = alignUp(_offsets[A::DATA] +
+			       _assembler.getSize(A::DATA), SECTION_ALIGN);
+    _size = alignUp(_offsets[A::BSS] + _assembler.getSize(A::BSS) + 1, page);
+
+    void* memory = mmap(0, _size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+      _error = "Not enough memory to load the code";
+      return false;
+    }
+    _memory = static_cast<char*>(memory);
+
+    A::Address bases[A::NB_SECTIONS];
+    for (unsigned int i = 0; i < A::NB_SECTIONS; ++i)
+      bases[i] = reinterpret_cast<A::Address>(_memory + _offsets[i]);
+    if (!_assembler.link(bases))
+    {
+      _error = _assembler.getError();
+      release();
+      return false;
+    }
+
+    for (unsigned int i = A::TEXT; i < A::DATA; ++i)
+      if (!_assembler.getSection(static_cast<A::section>(i)).empty())
+	memcpy(_memory + _offsets[i],
+	       &_assembler.getSection(static_cast<A::section>(i))[0],
+	       _assembler.getSection(static_cast<A::section>(i)).size());
+    if (mprotect(_memory, _offsets[A::DATA], PROT_READ | PROT_EXEC) != 0)
+    {
+      _error = "Can't make the code executable";
+      release();
+      return false;
+    }
+
+    return true;
+  }
+
+  /*!
+  ** Run the loaded program, from fresh data, on a dedicated stack.
+  ** Memory allocated by the program is given back at the end.
+  **
+  ** @return The exiting value of the program
+  */
+  int
+  NativeExecution::execute()
+  {
+    typedef ASM64Assembler A;
+    assert(_memory);
+
+    const A::Bytes& data = _assembler.getSection(A::DATA);
+    memset(_memory + _offsets[A::DATA], 0, _size - _offsets[A::DATA]);
+    if (!data.empty())
+      memcpy(_memory + _offsets[A::DATA], &data[0], data.size());
+
+    // Only really used when the stack grows
+    const size_t size = Execution::STACK_MARGIN +
+      static_cast<size_t>(_maxDepth) * Execution::STACK_SIZE_PER_CALL;
+    void* stack = mmap(0, size, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (stack == MAP_FAILED)
+    {
+      _error = "Not enough memory for the stack";
+      throw Error::EXECUTION;
+    }
+
+    Entry entry = reinterpret_cast<Entry>(address("__cubs_enter"));
+    const int res = entry(static_cast<char*>(stack) + size);
+    munmap(stack, size);
+
+    // Chunks of the heap are linked, with their size after the link
+    char* chunk = *reinterpret_cast<char**>(address("__cubs_chunks"));
+    while (chunk)
+    {
+      char* previous = *reinterpret_cast<char**>(chunk);
+      munmap(chunk, *reinterpret_cast<size_t*>(chunk + sizeof (char*)));
+      chunk = previous;
+    }
+
+    // The runtime already printed why it failed
+    if (*address("__cubs_failed"))
+    {
+      _error.clear();
+      throw Error::EXECUTION;
+    }
+
+    return res;
+  }
+
+  /*!
+  ** Set the maximum number of nested function calls, to size the stack.
+  ** The limit itself is checked by the generated code.
+  **
+  ** @param depth The maximum call depth
+  */
+  void
+  NativeExecution::setMaxDepth(unsigned int depth)
+  {
+    _maxDepth = depth;
+  }
+
+  /*!
+  ** Get the message of the error which stopped loading or execution.
+  **
+  ** @return The error message, empty if already printed by the program
+  */
+  const std::string&
+  NativeExecution::getErrorMessage() const
+  {
+    return _error;
+  }
+
+  /*!
+  ** Get the address of a symbol of the loaded code.
+  **
+  ** @param symbol The symbol, which must be defined
+  **
+  ** @return Its address
+  */
+  char*
+  NativeExecution::address(const std::string& symbol) const
+  {
+    ASM64Assembler::section where;
+    unsigned int offset = 0;
+
+    if (!_assembler.getSymbol(symbol, where, offset))
+    {
+      assert(false);
+      return 0;
+    }
+    return _memory + _offsets[where] + offset;
+  }
+
+  /*!
+  ** Unmap the loaded code, if any.
+  */
+  void
+  NativeExecution::release()
+  {
+    if (_memory)
+      munmap(_memory, _size);
+    _memory = 0;
+  }
+}
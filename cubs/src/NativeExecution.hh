@@ -0,0 +1,45 @@
+#ifndef NATIVEEXECUTION_HH_
+# define NATIVEEXECUTION_HH_
+
+# include <string>
+# include "Error.hh"
+# include "ASM64Assembler.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Run x86-64 code in the current process, without writing any file.
+  ** The code, generated with a hosted runtime, is assembled into
+  ** executable memory, then called on its own stack, sized according to
+  ** the maximum call depth like the interpreter one.
+  ** Once loaded, the program can be executed many times.
+  */
+  class NativeExecution
+  {
+    typedef int (*Entry)(char* stack);
+
+  public:
+    NativeExecution();
+    ~NativeExecution();
+
+  public:
+    bool load(const std::string& code);
+    int execute();
+    void setMaxDepth(unsigned int depth);
+    const std::string& getErrorMessage() const;
+
+  private:
+    char* address(const std::string& symbol) const;
+    void release();
+
+  private:
+    ASM64Assembler	_assembler;
+    char*		_memory;
+    size_t		_offsets[ASM64Assembler::NB_SECTIONS];
+    size_t		_size;
+    unsigned int	_maxDepth;
+    std::string		_error;
+  };
+}
+
+#endif /* !NATIVEEXECUTION_HH_ */
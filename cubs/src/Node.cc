@@ -7,9 +7,11 @@ namespace MiniCompiler
   {
     /*!
     ** Construct a node, initializing line to 0.
+    **
+    ** @param kind The kind of the node
     */
-    Node::Node()
-      : _line(0)
+    Node::Node(const Kind::type kind)
+      : _kind(kind), _line(0)
     {
     }
 
@@ -3,28 +3,103 @@
 
 # include <iostream>
 # include <vector>
-# include "IVisitable.hh"
 # include "Lexer.hh"
 
 namespace MiniCompiler
 {
   namespace AST
   {
-    class Node : public IVisitable
+    /*!
+    ** The kind of a node, so that visitors can find its class without
+    ** a virtual call.
+    */
+    namespace Kind
+    {
+      enum type
+	{
+	  IDS,
+	  PROGRAM,
+	  AFFECT,
+	  IF,
+	  READ,
+	  ARGUMENT,
+	  ARGUMENTS,
+	  RETURN,
+	  EXIT,
+	  CALL_FUNC,
+	  OPERATION,
+	  EXPRESSION,
+	  STRING_EXPR,
+	  BOOLEAN,
+	  EXPRESSIONS,
+	  INSTR,
+	  COMPOUND_INSTR,
+	  FACTOR,
+	  INSTRS,
+	  TYPE,
+	  FUNCTION,
+	  WHILE,
+	  DECLARATION_BODY,
+	  FUNCTIONS,
+	  NUMBER,
+	  DECLARATION,
+	  HEADER_FUNC,
+	  DECLARATIONS,
+	  ID,
+	  ID_FUNC,
+	  PRINT
+	};
+    }
+
+    class NodeIds;
+    class NodeProgram;
+    class NodeAffect;
+    class NodeIf;
+    class NodeRead;
+    class NodeArgument;
+    class NodeArguments;
+    class NodeReturn;
+    class NodeExit;
+    class NodeCallFunc;
+    class NodeOperation;
+    class NodeExpression;
+    class NodeStringExpr;
+    class NodeBoolean;
+    class NodeExpressions;
+    class NodeInstr;
+    class NodeCompoundInstr;
+    class NodeFactor;
+    class NodeInstrs;
+    class NodeType;
+    class NodeFunction;
+    class NodeWhile;
+    class NodeDeclarationBody;
+    class NodeFunctions;
+    class NodeNumber;
+    class NodeDeclaration;
+    class NodeHeaderFunc;
+    class NodeDeclarations;
+    class NodeId;
+    class NodeIdFunc;
+    class NodePrint;
+
+    class Node
     {
     public:
       typedef std::vector<Node*>::const_iterator iter;
-      Node();
+      Node(const Kind::type kind);
       virtual ~Node();
+      Kind::type getKind() const;
       unsigned int getLine() const;
       void setLine(const unsigned int line);
-      virtual void accept(Visitor& visitor) = 0;
-      virtual void accept(ConstVisitor& visitor) const = 0;
 
     protected:
+      const Kind::type	_kind;
       unsigned int	_line;
     };
   }
 }
 
+# include "Node.hxx"
+
 #endif /* !NODE_HH_ */
@@ -0,0 +1,16 @@
+namespace MiniCompiler
+{
+  namespace AST
+  {
+    /*!
+    ** Get the kind of the node.
+    **
+    ** @return The kind
+    */
+    inline Kind::type
+    Node::getKind() const
+    {
+      return _kind;
+    }
+  }
+}
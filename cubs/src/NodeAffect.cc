@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the affect node, initializing all nodes to null.
     */
     NodeAffect::NodeAffect()
-      : _id(0), _expr(0)
+      : Node(Kind::AFFECT), _id(0), _expr(0)
     {
     }
 
@@ -21,28 +21,6 @@ namespace MiniCompiler
       delete _expr;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeAffect::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeAffect::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the id node.
     **
@@ -17,8 +17,6 @@ namespace MiniCompiler
     public:
       NodeAffect();
       virtual ~NodeAffect();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeId* getId() const;
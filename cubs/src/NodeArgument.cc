@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the argument node, initializing all nodes to null.
     */
     NodeArgument::NodeArgument()
-      : _declarationBody(0), _arguments(0)
+      : Node(Kind::ARGUMENT), _declarationBody(0), _arguments(0)
     {
     }
 
@@ -21,28 +21,6 @@ namespace MiniCompiler
       delete _arguments;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeArgument::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeArgument::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the declaration body node.
     **
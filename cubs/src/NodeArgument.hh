@@ -18,8 +18,6 @@ namespace MiniCompiler
     public:
       NodeArgument();
       virtual ~NodeArgument();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeDeclarationBody* getDeclarationBody() const;
@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the arguments node, initializing all nodes to null.
     */
     NodeArguments::NodeArguments()
-      : _argument(0), _arguments(0)
+      : Node(Kind::ARGUMENTS), _argument(0), _arguments(0)
     {
     }
 
@@ -21,28 +21,6 @@ namespace MiniCompiler
       delete _arguments;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeArguments::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeArguments::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the argument node.
     **
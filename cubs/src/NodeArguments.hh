@@ -17,8 +17,6 @@ namespace MiniCompiler
     public:
       NodeArguments();
       virtual ~NodeArguments();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeArgument* getArgument() const;
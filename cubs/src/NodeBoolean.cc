@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the boolean node, initializing value to false
     */
     NodeBoolean::NodeBoolean()
-      : _bool(false)
+      : TypedNode(Kind::BOOLEAN), _bool(false)
     {
     }
 
@@ -19,28 +19,6 @@ namespace MiniCompiler
     {
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeBoolean::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeBoolean::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the boolean node.
     **
@@ -16,8 +16,6 @@ namespace MiniCompiler
     public:
       NodeBoolean();
       virtual ~NodeBoolean();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       bool getBool() const;
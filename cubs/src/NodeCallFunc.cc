@@ -9,7 +9,7 @@ namespace MiniCompiler
     ** Construct the call function node, initializing all nodes to null.
     */
     NodeCallFunc::NodeCallFunc()
-      : _id(0), _exprs(0)
+      : TypedNode(Kind::CALL_FUNC), _id(0), _exprs(0)
     {
     }
 
@@ -22,28 +22,6 @@ namespace MiniCompiler
       delete _exprs;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeCallFunc::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeCallFunc::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the function id node.
     **
@@ -19,8 +19,6 @@ namespace MiniCompiler
     public:
       NodeCallFunc();
       virtual ~NodeCallFunc();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeIdFunc* getId() const;
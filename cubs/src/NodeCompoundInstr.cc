@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the compound instruction node, initializing all nodes.
     */
     NodeCompoundInstr::NodeCompoundInstr()
-      : _instrs(0)
+      : Node(Kind::COMPOUND_INSTR), _instrs(0)
     {
     }
 
@@ -20,28 +20,6 @@ namespace MiniCompiler
       delete _instrs;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeCompoundInstr::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeCompoundInstr::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the instructions node.
     **
@@ -18,8 +18,6 @@ namespace MiniCompiler
     public:
       NodeCompoundInstr();
       virtual ~NodeCompoundInstr();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeInstrs* getInstrs() const;
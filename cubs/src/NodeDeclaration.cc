@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the declaration node, initializing all nodes.
     */
     NodeDeclaration::NodeDeclaration()
-      : _body(0)
+      : Node(Kind::DECLARATION), _body(0)
     {
     }
 
@@ -20,28 +20,6 @@ namespace MiniCompiler
       delete _body;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeDeclaration::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeDeclaration::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the declaration body node.
     **
@@ -17,8 +17,6 @@ namespace MiniCompiler
     public:
       NodeDeclaration();
       virtual ~NodeDeclaration();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeDeclarationBody* getBody() const;
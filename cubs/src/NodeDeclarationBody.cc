@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the declaration body node, initializing all nodes.
     */
     NodeDeclarationBody::NodeDeclarationBody()
-      : _ids(0), _type(0)
+      : Node(Kind::DECLARATION_BODY), _ids(0), _type(0)
     {
     }
 
@@ -21,28 +21,6 @@ namespace MiniCompiler
       delete _type;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeDeclarationBody::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeDeclarationBody::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the ids node.
     **
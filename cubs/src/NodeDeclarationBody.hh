@@ -17,8 +17,6 @@ namespace MiniCompiler
     public:
       NodeDeclarationBody();
       virtual ~NodeDeclarationBody();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeIds* getIds() const;
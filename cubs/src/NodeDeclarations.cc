@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the declarations node, initializing all nodes.
     */
     NodeDeclarations::NodeDeclarations()
-      : _decl(0), _decls(0)
+      : Node(Kind::DECLARATIONS), _decl(0), _decls(0)
     {
     }
 
@@ -21,28 +21,6 @@ namespace MiniCompiler
       delete _decls;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeDeclarations::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeDeclarations::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the declaration node.
     **
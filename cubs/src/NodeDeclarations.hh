@@ -18,8 +18,6 @@ namespace MiniCompiler
     public:
       NodeDeclarations();
       virtual ~NodeDeclarations();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeDeclaration* getDeclaration() const;
@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the exit node.
     */
     NodeExit::NodeExit()
-      : _expr(0)
+      : TypedNode(Kind::EXIT), _expr(0)
     {
     }
 
@@ -20,28 +20,6 @@ namespace MiniCompiler
       delete _expr;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeExit::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeExit::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the expression node.
     **
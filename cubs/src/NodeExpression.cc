@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the expression node, settings all node to null.
     */
     NodeExpression::NodeExpression()
-      : _op(0)
+      : TypedNode(Kind::EXPRESSION), _op(0)
     {
     }
 
@@ -20,28 +20,6 @@ namespace MiniCompiler
       delete _op;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeExpression::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeExpression::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the operation node.
     **
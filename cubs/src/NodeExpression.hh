@@ -16,8 +16,6 @@ namespace MiniCompiler
     public:
       NodeExpression();
       virtual ~NodeExpression();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeOperation* getOperation() const;
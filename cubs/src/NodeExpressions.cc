@@ -9,7 +9,7 @@ namespace MiniCompiler
     ** Construct the expressions node, initializing all nodes to null.
     */
     NodeExpressions::NodeExpressions()
-      : _expr(0), _exprs(0)
+      : Node(Kind::EXPRESSIONS), _expr(0), _exprs(0)
     {
     }
 
@@ -22,28 +22,6 @@ namespace MiniCompiler
       delete _exprs;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeExpressions::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeExpressions::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the expression node.
     **
@@ -17,8 +17,6 @@ namespace MiniCompiler
     public:
       NodeExpressions();
       virtual ~NodeExpressions();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeExpression* getExpr() const;
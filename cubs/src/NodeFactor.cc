@@ -9,7 +9,7 @@ namespace MiniCompiler
     ** Construct the node factor, initializing all nodes to null.
     */
     NodeFactor::NodeFactor()
-      : _id(0),_callFunc(0),
+      : TypedNode(Kind::FACTOR), _id(0),_callFunc(0),
 	_number(0), _stringExpr(0),
 	_expression(0), _bool(0)
     {
@@ -28,28 +28,6 @@ namespace MiniCompiler
       delete _bool;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeFactor::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeFactor::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the id node.
     **
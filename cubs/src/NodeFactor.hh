@@ -26,8 +26,6 @@ namespace MiniCompiler
     public:
       NodeFactor();
       virtual ~NodeFactor();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeId* getId() const;
@@ -6,11 +6,12 @@ namespace MiniCompiler
   namespace AST
   {
     /*!
-    ** Construct the function node, initializing all node to null.
+    ** Construct the function node, initializing all node to null,
+    ** and marking it as impure until purity analysis says otherwise.
     */
     NodeFunction::NodeFunction()
-      : _headerFunc(0),
-	_declarations(0), _compoundInstr(0)
+      : TypedNode(Kind::FUNCTION), _headerFunc(0),
+	_declarations(0), _compoundInstr(0), _isPure(false)
     {
     }
 
@@ -24,28 +25,6 @@ namespace MiniCompiler
       delete _compoundInstr;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeFunction::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeFunction::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the declarations node.
     **
@@ -147,5 +126,28 @@ namespace MiniCompiler
     {
       _args.push_back(node);
     }
+
+    /*!
+    ** Check if the function is pure, ie its result only depends
+    ** on its arguments and it has no side effect.
+    **
+    ** @return If the function is pure
+    */
+    bool
+    NodeFunction::isPure() const
+    {
+      return _isPure;
+    }
+
+    /*!
+    ** Set if the function is pure.
+    **
+    ** @param pure If the function is pure
+    */
+    void
+    NodeFunction::setPure(bool pure)
+    {
+      _isPure = pure;
+    }
   }
 }
@@ -20,8 +20,6 @@ namespace MiniCompiler
     public:
       NodeFunction();
       virtual ~NodeFunction();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeHeaderFunc* getHeaderFunc() const;
@@ -36,11 +34,16 @@ namespace MiniCompiler
       unsigned int nbArgument() const;
       void addArgument(NodeId* node);
 
+    public:
+      bool isPure() const;
+      void setPure(bool pure);
+
     private:
       NodeHeaderFunc*		_headerFunc;
       NodeDeclarations*		_declarations;
       NodeCompoundInstr*	_compoundInstr;
       std::vector<NodeId*>	_args;
+      bool			_isPure;
     };
   }
 }
@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the functions node, initializing all nodes to null.
     */
     NodeFunctions::NodeFunctions()
-      : _funcs(0), _func(0)
+      : Node(Kind::FUNCTIONS), _funcs(0), _func(0)
     {
     }
 
@@ -21,28 +21,6 @@ namespace MiniCompiler
       delete _func;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeFunctions::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeFunctions::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the functions node.
     **
@@ -17,8 +17,6 @@ namespace MiniCompiler
     public:
       NodeFunctions();
       virtual ~NodeFunctions();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeFunctions* getFuncs() const;
@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the header function node, initializing all nodes to null.
     */
     NodeHeaderFunc::NodeHeaderFunc()
-      : _id(0), _type(0), _arguments(0)
+      : TypedNode(Kind::HEADER_FUNC), _id(0), _type(0), _arguments(0)
     {
     }
 
@@ -22,28 +22,6 @@ namespace MiniCompiler
       delete _arguments;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeHeaderFunc::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeHeaderFunc::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the function id node.
     **
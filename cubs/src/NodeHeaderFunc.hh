@@ -18,8 +18,6 @@ namespace MiniCompiler
     public:
       NodeHeaderFunc();
       virtual ~NodeHeaderFunc();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeIdFunc* getId() const;
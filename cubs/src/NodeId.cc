@@ -9,7 +9,7 @@ namespace MiniCompiler
     ** and initializing referenced id node to null.
     */
     NodeId::NodeId()
-      : _isDecl(false), _ref(0)
+      : TypedNode(Kind::ID), _isDecl(false), _ref(0)
     {
     }
 
@@ -22,28 +22,6 @@ namespace MiniCompiler
       // Do not delete _ref here, it's just a pointer
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeId::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeId::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the string id.
     **
@@ -16,8 +16,6 @@ namespace MiniCompiler
     public:
       NodeId();
       virtual ~NodeId();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       const std::string& getId() const;
@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the id function node, initializing all nodes to null.
     */
     NodeIdFunc::NodeIdFunc()
-      : _isDecl(false), _ref(0)
+      : TypedNode(Kind::ID_FUNC), _isDecl(false), _ref(0)
     {
     }
 
@@ -20,28 +20,6 @@ namespace MiniCompiler
       // Do not delete _ref here, it's just a pointer
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeIdFunc::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeIdFunc::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the string id node.
     **
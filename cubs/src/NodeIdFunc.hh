@@ -17,8 +17,6 @@ namespace MiniCompiler
     public:
       NodeIdFunc();
       virtual ~NodeIdFunc();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       const std::string& getId() const;
@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the ids node, initializing all nodes to null.
     */
     NodeIds::NodeIds()
-      : _id(0), _ids(0)
+      : Node(Kind::IDS), _id(0), _ids(0)
     {
     }
 
@@ -21,28 +21,6 @@ namespace MiniCompiler
       delete _ids;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeIds::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeIds::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the id node.
     **
@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the if node, initializing all nodes to null.
     */
     NodeIf::NodeIf()
-      : _cond(0), _bodyExprs(0), _elseExprs(0)
+      : Node(Kind::IF), _cond(0), _bodyExprs(0), _elseExprs(0)
     {
     }
 
@@ -22,28 +22,6 @@ namespace MiniCompiler
       delete _elseExprs;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeIf::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeIf::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the condition node.
     **
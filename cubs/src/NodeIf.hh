@@ -18,8 +18,6 @@ namespace MiniCompiler
     public:
       NodeIf();
       virtual ~NodeIf();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeExpression* getCond() const;
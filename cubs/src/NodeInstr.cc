@@ -9,7 +9,7 @@ namespace MiniCompiler
     ** Construct the instruction node, setting all nodes to null. 
     */
     NodeInstr::NodeInstr()
-      : _affect(0), _callFunc(0), _compoundInstr(0),
+      : Node(Kind::INSTR), _affect(0), _callFunc(0), _compoundInstr(0),
 	_if(0), _while(0), _return(0), _exit(0),
 	_print(0), _read(0)
     {
@@ -31,28 +31,6 @@ namespace MiniCompiler
       delete _read;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeInstr::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeInstr::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the affect node.
     **
@@ -33,8 +33,6 @@ namespace MiniCompiler
     public:
       NodeInstr();
       virtual ~NodeInstr();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeAffect* getAffect() const;
@@ -9,7 +9,7 @@ namespace MiniCompiler
     ** instructions and instruction to null.
     */
     NodeInstrs::NodeInstrs()
-      : _instrs(0), _instr(0)
+      : Node(Kind::INSTRS), _instrs(0), _instr(0)
     {
     }
 
@@ -22,28 +22,6 @@ namespace MiniCompiler
       delete _instr;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeInstrs::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeInstrs::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the instructions node.
     **
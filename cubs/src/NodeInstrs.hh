@@ -18,8 +18,6 @@ namespace MiniCompiler
     public:
       NodeInstrs();
       virtual ~NodeInstrs();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeInstrs* getInstrs() const;
@@ -8,6 +8,7 @@ namespace MiniCompiler
     ** Construct the number node.
     */
     NodeNumber::NodeNumber()
+      : TypedNode(Kind::NUMBER)
     {
     }
 
@@ -18,28 +19,6 @@ namespace MiniCompiler
     {
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeNumber::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeNumber::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the number value.
     **
@@ -16,8 +16,6 @@ namespace MiniCompiler
     public:
       NodeNumber();
       virtual ~NodeNumber();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       int getNumber() const;
@@ -9,7 +9,8 @@ namespace MiniCompiler
     ** to null, and setting operation type to NONE.
      */
     NodeOperation::NodeOperation()
-      : _leftFactor(0), _rightFactor(0), _opType(Operator::NONE)
+      : TypedNode(Kind::OPERATION), _leftFactor(0), _rightFactor(0),
+	_opType(Operator::NONE)
     {
     }
 
@@ -22,28 +23,6 @@ namespace MiniCompiler
       delete _rightFactor;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeOperation::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeOperation::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the left factor node.
     **
@@ -19,8 +19,6 @@ namespace MiniCompiler
     public:
       NodeOperation();
       virtual ~NodeOperation();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeFactor* getLeftFactor() const;
@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the print node, initializing expression node to null.
      */
     NodePrint::NodePrint()
-      : _expr(0)
+      : Node(Kind::PRINT), _expr(0)
     {
     }
 
@@ -20,28 +20,6 @@ namespace MiniCompiler
       delete _expr;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodePrint::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodePrint::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the expression node.
     **
@@ -16,8 +16,6 @@ namespace MiniCompiler
     public:
       NodePrint();
       virtual ~NodePrint();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeExpression* getExpr() const;
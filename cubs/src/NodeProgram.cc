@@ -9,7 +9,7 @@ namespace MiniCompiler
     ** declarations, functions and instructions node to null.
     */
     NodeProgram::NodeProgram()
-      : _decls(0), _funcs(0), _instrs(0)
+      : Node(Kind::PROGRAM), _decls(0), _funcs(0), _instrs(0)
     {
     }
 
@@ -23,28 +23,6 @@ namespace MiniCompiler
       delete _instrs;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeProgram::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeProgram::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the declarations node.
     **
@@ -19,8 +19,6 @@ namespace MiniCompiler
     public:
       NodeProgram();
       virtual ~NodeProgram();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeDeclarations*		getDecls() const;
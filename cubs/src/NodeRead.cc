@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct the read node.
     */
     NodeRead::NodeRead()
-      : _id(0)
+      : Node(Kind::READ), _id(0)
     {
     }
 
@@ -20,28 +20,6 @@ namespace MiniCompiler
       delete _id;
     }
 
-    /*!
-    ** Accept a classic visitor
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeRead::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeRead::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the id node.
     **
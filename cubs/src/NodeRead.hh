@@ -16,8 +16,6 @@ namespace MiniCompiler
     public:
       NodeRead();
       virtual ~NodeRead();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeId* getId() const;
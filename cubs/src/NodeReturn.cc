@@ -1,4 +1,7 @@
 #include "NodeReturn.hh"
+#include "NodeOperation.hh"
+#include "NodeFactor.hh"
+#include "NodeCallFunc.hh"
 
 namespace MiniCompiler
 {
@@ -8,7 +11,7 @@ namespace MiniCompiler
     ** Construct the return node.
     */
     NodeReturn::NodeReturn()
-      : _expr(0)
+      : TypedNode(Kind::RETURN), _expr(0)
     {
     }
 
@@ -20,28 +23,6 @@ namespace MiniCompiler
       delete _expr;
     }
 
-    /*!
-    ** Accept a classic visitor
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeReturn::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeReturn::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the expression node.
     **
@@ -85,5 +66,32 @@ namespace MiniCompiler
     {
       _linkedFunction = node;
     }
+
+    /*!
+    ** Get the function call whose result is directly returned.
+    ** Such a call is the last thing done by the function, so its
+    ** frame can be reused by the called function.
+    **
+    ** @return The tail call, or null if the expression isn't a single call
+    */
+    NodeCallFunc*
+    NodeReturn::getTailCall() const
+    {
+      NodeExpression* expr = _expr;
+
+      // Parenthesis around the call are just skipped
+      while (expr)
+      {
+	NodeOperation* op = expr->getOperation();
+	if (!op || op->getOpType() != Operator::NONE || !op->getLeftFactor())
+	  return 0;
+	NodeFactor* factor = op->getLeftFactor();
+	if (factor->getCallFunc())
+	  return factor->getCallFunc();
+	expr = factor->getExpression();
+      }
+
+      return 0;
+    }
   }
 }
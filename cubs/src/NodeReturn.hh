@@ -17,14 +17,13 @@ namespace MiniCompiler
     public:
       NodeReturn();
       virtual ~NodeReturn();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeExpression* getExpr() const;
       void setExpr(NodeExpression* node);
       NodeFunction* getRefFunc() const;
       void setRefFunc(NodeFunction* node);
+      NodeCallFunc* getTailCall() const;
 
     private:
       NodeExpression*	_expr;
@@ -8,6 +8,7 @@ namespace MiniCompiler
     ** Construct the string expression node.
     */
     NodeStringExpr::NodeStringExpr()
+      : TypedNode(Kind::STRING_EXPR)
     {
     }
 
@@ -18,28 +19,6 @@ namespace MiniCompiler
     {
     }
 
-    /*!
-    ** Accept a classic visitor
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeStringExpr::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeStringExpr::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the string expression.
     **
@@ -16,8 +16,6 @@ namespace MiniCompiler
     public:
       NodeStringExpr();
       virtual ~NodeStringExpr();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       const std::string& getString() const;
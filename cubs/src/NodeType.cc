@@ -8,6 +8,7 @@ namespace MiniCompiler
     ** Construct the type node.
     */
     NodeType::NodeType()
+      : TypedNode(Kind::TYPE)
     {
     }
 
@@ -18,28 +19,6 @@ namespace MiniCompiler
     {
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeType::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeType::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the string type of the node.
     **
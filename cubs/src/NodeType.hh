@@ -15,8 +15,6 @@ namespace MiniCompiler
     public:
       NodeType();
       virtual ~NodeType();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       const std::string& getType() const;
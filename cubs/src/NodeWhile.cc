@@ -8,7 +8,7 @@ namespace MiniCompiler
     ** Construct a while node.
     */
     NodeWhile::NodeWhile()
-      : _cond(0), _bodyExprs(0)
+      : Node(Kind::WHILE), _cond(0), _bodyExprs(0)
     {
     }
 
@@ -21,28 +21,6 @@ namespace MiniCompiler
       delete _bodyExprs;
     }
 
-    /*!
-    ** Accept a classic visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeWhile::accept(Visitor& visitor)
-    {
-      visitor.visit(this);
-    }
-
-    /*!
-    ** Accept a const visitor.
-    **
-    ** @param visitor The visitor
-    */
-    void
-    NodeWhile::accept(ConstVisitor& visitor) const
-    {
-      visitor.visit(this);
-    }
-
     /*!
     ** Get the condition node.
     **
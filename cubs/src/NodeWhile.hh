@@ -16,8 +16,6 @@ namespace MiniCompiler
     public:
       NodeWhile();
       virtual ~NodeWhile();
-      virtual void accept(Visitor& visitor);
-      virtual void accept(ConstVisitor& visitor) const;
 
     public:
       NodeExpression*	getCond() const;
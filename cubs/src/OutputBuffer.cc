@@ -0,0 +1,99 @@
+#include <cassert>
+#include <cerrno>
+#include <unistd.h>
+#include "OutputBuffer.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct a buffer writing to a file descriptor.
+  **
+  ** @param fd The file descriptor, left open
+  */
+  OutputBuffer::OutputBuffer(const int fd)
+    : _fd(fd), _stream(0)
+  {
+    assert(fd >= 0);
+    setp(_block, _block + BLOCK_SIZE);
+  }
+
+  /*!
+  ** Construct a buffer writing to a stream.
+  **
+  ** @param o The stream
+  */
+  OutputBuffer::OutputBuffer(std::ostream& o)
+    : _fd(-1), _stream(&o)
+  {
+    setp(_block, _block + BLOCK_SIZE);
+  }
+
+  /*!
+  ** Destruct the buffer, writing what remains.
+  */
+  OutputBuffer::~OutputBuffer()
+  {
+    writeBlock();
+  }
+
+  /*!
+  ** Write the full block, then buffer a char.
+  **
+  ** @param c The char which didn't fit, or eof
+  **
+  ** @return Not eof, or eof if the block couldn't be written
+  */
+  OutputBuffer::int_type
+  OutputBuffer::overflow(int_type c)
+  {
+    if (!writeBlock())
+      return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  /*!
+  ** Write the buffered text, when the stream is flushed.
+  **
+  ** @return 0, or -1 if it couldn't be written
+  */
+  int
+  OutputBuffer::sync()
+  {
+    if (!writeBlock())
+      return -1;
+    if (_stream)
+      _stream->flush();
+    return 0;
+  }
+
+  /*!
+  ** Write the buffered text, and empty the buffer.
+  **
+  ** @return If all was written
+  */
+  bool
+  OutputBuffer::writeBlock()
+  {
+    const char* begin = pbase();
+    const char* end = pptr();
+
+    setp(_block, _block + BLOCK_SIZE);
+    if (_stream)
+      return _stream->write(begin, end - begin).good();
+    while (begin < end)
+    {
+      const ssize_t written = ::write(_fd, begin, end - begin);
+      if (written < 0 && errno == EINTR)
+	continue;
+      if (written <= 0)
+	return false;
+      begin += written;
+    }
+    return true;
+  }
+}
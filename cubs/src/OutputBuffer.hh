@@ -0,0 +1,39 @@
+#ifndef OUTPUTBUFFER_HH_
+# define OUTPUTBUFFER_HH_
+
+# include <ostream>
+# include <streambuf>
+
+namespace MiniCompiler
+{
+  /*!
+  ** Buffer the text written by a stream, and write it by blocks of a
+  ** fixed size, either to a file descriptor or to another stream. Text
+  ** is written while it is generated: the memory used doesn't depend
+  ** on the size of the output.
+  */
+  class OutputBuffer : public std::streambuf
+  {
+  public:
+    static const unsigned int BLOCK_SIZE = 1 << 16;
+
+  public:
+    OutputBuffer(const int fd);
+    OutputBuffer(std::ostream& o);
+    virtual ~OutputBuffer();
+
+  protected:
+    virtual int_type overflow(int_type c);
+    virtual int sync();
+
+  private:
+    bool writeBlock();
+
+  private:
+    const int		_fd;
+    std::ostream*	_stream;
+    char		_block[BLOCK_SIZE];
+  };
+}
+
+#endif /* !OUTPUTBUFFER_HH_ */
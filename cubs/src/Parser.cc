@@ -19,10 +19,12 @@ namespace MiniCompiler
   ** set node program to null.
   **
   ** @param lexer The lexer
+  ** @param jobs The maximum number of threads parsing functions
   */
-  Parser::Parser(const Lexer& lexer)
+  Parser::Parser(const Lexer& lexer, const unsigned int jobs)
     : _astCreator(lexer), _node(0)
   {
+    _astCreator.setJobs(jobs);
   }
 
   /*!
@@ -12,7 +12,7 @@ namespace MiniCompiler
   class Parser
   {
   public:
-    Parser(const Lexer& lexer);
+    Parser(const Lexer& lexer, const unsigned int jobs = 1);
     ~Parser();
     void construct();
     bool hasErrors() const;
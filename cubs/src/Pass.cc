@@ -0,0 +1,80 @@
+#include "Pass.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct a pass.
+  **
+  ** @param name The name of the pass
+  ** @param analysis If the pass doesn't modify the tree
+  ** @param level The lowest optimization level using this pass,
+  ** or 0 if it is only launched when needed
+  */
+  Pass::Pass(const std::string& name, const bool analysis,
+	     const unsigned int level)
+    : _name(name), _analysis(analysis), _level(level)
+  {
+  }
+
+  /*!
+  ** Destruct the pass.
+  */
+  Pass::~Pass()
+  {
+  }
+
+  /*!
+  ** Get the name of the pass.
+  **
+  ** @return The name
+  */
+  const std::string&
+  Pass::getName() const
+  {
+    return _name;
+  }
+
+  /*!
+  ** Check if the pass is an analysis, ie doesn't modify the tree.
+  **
+  ** @return If the pass is an analysis
+  */
+  bool
+  Pass::isAnalysis() const
+  {
+    return _analysis;
+  }
+
+  /*!
+  ** Get the lowest optimization level using this pass.
+  **
+  ** @return The level, or 0 if the pass is only launched when needed
+  */
+  unsigned int
+  Pass::getLevel() const
+  {
+    return _level;
+  }
+
+  /*!
+  ** Get the passes which must be launched before this one.
+  **
+  ** @return The names of the needed passes
+  */
+  const Pass::Names&
+  Pass::getDependencies() const
+  {
+    return _dependencies;
+  }
+
+  /*!
+  ** Add a pass which must be launched before this one.
+  **
+  ** @param name The name of the needed pass
+  */
+  void
+  Pass::addDependency(const std::string& name)
+  {
+    _dependencies.push_back(name);
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef PASS_HH_
+# define PASS_HH_
+
+# include <string>
+# include <vector>
+# include "NodeProgram.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** A named step applied on a type checked AST.
+  ** An analysis only stores information into the tree, whereas a
+  ** transformation modifies it, invalidating all analyses.
+  ** A transformation belongs to every pipeline from its level.
+  */
+  class Pass
+  {
+  public:
+    typedef std::vector<std::string> Names;
+
+  public:
+    Pass(const std::string& name, const bool analysis,
+	 const unsigned int level);
+    virtual ~Pass();
+
+  public:
+    const std::string& getName() const;
+    bool isAnalysis() const;
+    unsigned int getLevel() const;
+    const Names& getDependencies() const;
+    virtual unsigned int run(AST::NodeProgram* tree) = 0;
+
+  protected:
+    void addDependency(const std::string& name);
+
+  private:
+    const std::string	_name;
+    const bool		_analysis;
+    const unsigned int	_level;
+    Names		_dependencies;
+  };
+}
+
+#endif /* !PASS_HH_ */
@@ -0,0 +1,215 @@
+#include <cassert>
+#include <ctime>
+#include <iomanip>
+#include "PassManager.hh"
+#include "PrettyPrinterVisitor.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct empty statistics.
+  */
+  PassManager::Statistics::Statistics()
+    : runs(0), changes(0), time(0)
+  {
+  }
+
+  /*!
+  ** Construct a pass manager, without any pass.
+  */
+  PassManager::PassManager()
+  {
+  }
+
+  /*!
+  ** Destruct the pass manager, deleting all registered passes.
+  */
+  PassManager::~PassManager()
+  {
+    for (Passes::iterator it = _passes.begin(); it != _passes.end(); ++it)
+      delete *it;
+  }
+
+  /*!
+  ** Register a pass. The manager takes ownership of it.
+  ** Its dependencies must already be registered.
+  **
+  ** @param pass The pass to register
+  */
+  void
+  PassManager::registerPass(Pass* pass)
+  {
+    assert(pass);
+    assert(!find(pass->getName()));
+    for (Pass::Names::const_iterator it = pass->getDependencies().begin();
+	 it != pass->getDependencies().end(); ++it)
+      assert(find(*it));
+    _passes.push_back(pass);
+  }
+
+  /*!
+  ** Check if a pass is registered.
+  **
+  ** @param name The name of the pass
+  **
+  ** @return If the pass exists
+  */
+  bool
+  PassManager::hasPass(const std::string& name) const
+  {
+    return find(name) != 0;
+  }
+
+  /*!
+  ** Set the pass after which the tree is displayed.
+  **
+  ** @param name The name of the pass, or an empty string
+  */
+  void
+  PassManager::setPrintAfter(const std::string& name)
+  {
+    _printAfter = name;
+  }
+
+  /*!
+  ** Launch all transformations of the given optimization level,
+  ** with the analyses they need.
+  **
+  ** @param tree The root of the AST
+  ** @param level The optimization level
+  **
+  ** @return The number of changes made on the tree
+  */
+  unsigned int
+  PassManager::run(AST::NodeProgram* tree, const unsigned int level)
+  {
+    assert(tree);
+    unsigned int changes = 0;
+
+    for (Passes::const_iterator it = _passes.begin(); it != _passes.end(); ++it)
+      if (!(*it)->isAnalysis() &&
+	  (*it)->getLevel() > 0 && (*it)->getLevel() <= level)
+	changes += require((*it)->getName(), tree);
+
+    return changes;
+  }
+
+  /*!
+  ** Launch a pass and its dependencies, unless their results
+  ** are still valid.
+  **
+  ** @param name The name of the pass
+  ** @param tree The root of the AST
+  **
+  ** @return The number of changes made on the tree
+  */
+  unsigned int
+  PassManager::require(const std::string& name, AST::NodeProgram* tree)
+  {
+    Pass* pass = find(name);
+    assert(pass);
+    assert(_running.find(name) == _running.end());
+    if (_upToDate.find(name) != _upToDate.end())
+      return 0;
+
+    unsigned int changes = 0;
+    _running.insert(name);
+    for (Pass::Names::const_iterator it = pass->getDependencies().begin();
+	 it != pass->getDependencies().end(); ++it)
+      changes += require(*it, tree);
+    changes += launch(pass, tree);
+    _running.erase(name);
+
+    return changes;
+  }
+
+  /*!
+  ** Display time spent and changes made by each launched pass.
+  **
+  ** @param o The stream where to display it
+  */
+  void
+  PassManager::printStatistics(std::ostream& o) const
+  {
+    o << std::left << std::setw(20) << "Pass"
+      << std::right << std::setw(6) << "Runs"
+      << std::setw(10) << "Changes"
+      << std::setw(12) << "Time (ms)" << '\n';
+    for (Passes::const_iterator it = _passes.begin(); it != _passes.end(); ++it)
+    {
+      StatisticsByPass::const_iterator stats =
+	_statistics.find((*it)->getName());
+      if (stats == _statistics.end())
+	continue;
+      o << std::left << std::setw(20) << (*it)->getName()
+	<< std::right << std::setw(6) << stats->second.runs
+	<< std::setw(10) << stats->second.changes
+	<< std::setw(12) << std::fixed << std::setprecision(3)
+	<< stats->second.time << '\n';
+    }
+  }
+
+  /*!
+  ** Find a registered pass.
+  **
+  ** @param name The name of the pass
+  **
+  ** @return The pass, or null if it doesn't exist
+  */
+  Pass*
+  PassManager::find(const std::string& name) const
+  {
+    for (Passes::const_iterator it = _passes.begin(); it != _passes.end(); ++it)
+      if ((*it)->getName() == name)
+	return *it;
+
+    return 0;
+  }
+
+  /*!
+  ** Launch a pass, measuring it. A transformation which modified
+  ** the tree invalidates all analyses.
+  **
+  ** @param pass The pass to launch
+  ** @param tree The root of the AST
+  **
+  ** @return The number of changes made on the tree
+  */
+  unsigned int
+  PassManager::launch(Pass* pass, AST::NodeProgram* tree)
+  {
+    assert(pass);
+    assert(tree);
+    const clock_t start = clock();
+    const unsigned int changes = pass->run(tree);
+    Statistics& stats = _statistics[pass->getName()];
+
+    stats.runs++;
+    stats.changes += changes;
+    stats.time += 1000.0 * (clock() - start) / CLOCKS_PER_SEC;
+
+    if (!pass->isAnalysis() && changes > 0)
+      invalidateAnalyses();
+    _upToDate.insert(pass->getName());
+
+    if (pass->getName() == _printAfter)
+    {
+      PrettyPrinterVisitor printer;
+      printer.visit(tree);
+      std::cout << "# After " << pass->getName() << '\n' << printer;
+    }
+
+    return changes;
+  }
+
+  /*!
+  ** Forget results of all analyses, because the tree has changed.
+  */
+  void
+  PassManager::invalidateAnalyses()
+  {
+    for (Passes::const_iterator it = _passes.begin(); it != _passes.end(); ++it)
+      if ((*it)->isAnalysis())
+	_upToDate.erase((*it)->getName());
+  }
+}
@@ -0,0 +1,62 @@
+#ifndef PASSMANAGER_HH_
+# define PASSMANAGER_HH_
+
+# include <iostream>
+# include <map>
+# include <set>
+# include <string>
+# include <vector>
+# include "Pass.hh"
+# include "NodeProgram.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Launch passes on the AST, in registration order.
+  ** Analyses are only launched when needed, and their results are kept
+  ** until a transformation modifies the tree.
+  */
+  class PassManager
+  {
+    /*!
+    ** What a pass did during the compilation.
+    */
+    struct Statistics
+    {
+      Statistics();
+      unsigned int	runs;
+      unsigned int	changes;
+      double		time;
+    };
+
+    typedef std::vector<Pass*> Passes;
+    typedef std::set<std::string> Names;
+    typedef std::map<std::string, Statistics> StatisticsByPass;
+
+  public:
+    PassManager();
+    ~PassManager();
+
+  public:
+    void registerPass(Pass* pass);
+    bool hasPass(const std::string& name) const;
+    void setPrintAfter(const std::string& name);
+    unsigned int run(AST::NodeProgram* tree, const unsigned int level);
+    unsigned int require(const std::string& name, AST::NodeProgram* tree);
+    void printStatistics(std::ostream& o) const;
+
+  private:
+    Pass* find(const std::string& name) const;
+    unsigned int launch(Pass* pass, AST::NodeProgram* tree);
+    void invalidateAnalyses();
+
+  private:
+    Passes		_passes;
+    Names		_upToDate;
+    Names		_running;
+    StatisticsByPass	_statistics;
+    std::string		_printAfter;
+  };
+}
+
+#endif /* !PASSMANAGER_HH_ */
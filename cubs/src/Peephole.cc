@@ -0,0 +1,270 @@
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+#include "Peephole.hh"
+
+namespace MiniCompiler
+{
+  namespace
+  {
+    /*!
+    ** Remove spaces at both ends of a string.
+    **
+    ** @param s The string
+    **
+    ** @return The trimmed string
+    */
+    std::string
+    trim(const std::string& s)
+    {
+      const std::string::size_type begin = s.find_first_not_of(" \t");
+      if (begin == std::string::npos)
+	return "";
+      const std::string::size_type end = s.find_last_not_of(" \t");
+      return s.substr(begin, end - begin + 1);
+    }
+  }
+
+  /*!
+  ** Construct an empty line.
+  */
+  Peephole::Instruction::Instruction()
+    : type(BLANK)
+  {
+  }
+
+  /*!
+  ** Construct a new instruction, which will be formatted when printed.
+  **
+  ** @param mnemonic The mnemonic
+  ** @param operands The operands
+  */
+  Peephole::Instruction::Instruction(const std::string& mnemonic,
+				     const Operands& operands)
+    : type(INSTRUCTION), mnemonic(mnemonic), operands(operands)
+  {
+    std::stringstream ss;
+    ss << '\t' << mnemonic;
+    for (unsigned int i = 0; i < operands.size(); ++i)
+      ss << (i == 0 ? "\t" : ", ") << operands[i];
+    text = ss.str();
+  }
+
+  /*!
+  ** Construct a peephole optimizer, without any pattern.
+  **
+  ** @param commentChar The char beginning a comment
+  ** @param longMode If the code is 64 bits
+  */
+  Peephole::Peephole(const char commentChar, const bool longMode)
+    : _commentChar(commentChar), _longMode(longMode)
+  {
+  }
+
+  /*!
+  ** Destruct the peephole optimizer.
+  */
+  Peephole::~Peephole()
+  {
+  }
+
+  /*!
+  ** Register a pattern. Patterns are tried in registration order.
+  **
+  ** @param name The name of the pattern
+  ** @param pattern The pattern
+  */
+  void
+  Peephole::registerPattern(const std::string& name, Pattern pattern)
+  {
+    assert(pattern);
+    Rule rule;
+    rule.name = name;
+    rule.pattern = pattern;
+    rule.hits = 0;
+    _rules.push_back(rule);
+  }
+
+  /*!
+  ** Load the code to optimize.
+  **
+  ** @param code The generated assembly
+  */
+  void
+  Peephole::load(const std::string& code)
+  {
+    std::istringstream in(code);
+    std::string line;
+
+    _code.clear();
+    while (std::getline(in, line))
+      _code.push_back(parse(line));
+  }
+
+  /*!
+  ** Split a line into a label, or a mnemonic and its operands.
+  ** Lines containing strings are not parsed.
+  **
+  ** @param line The line
+  **
+  ** @return The instruction
+  */
+  Peephole::Instruction
+  Peephole::parse(const std::string& line) const
+  {
+    Instruction instr;
+    instr.text = line;
+
+    if (line.find_first_of("\"'`") != std::string::npos)
+    {
+      instr.type = Instruction::OPAQUE;
+      return instr;
+    }
+
+    const std::string& code = trim(line.substr(0, line.find(_commentChar)));
+    if (code.empty())
+      return instr;
+
+    const std::string::size_type space = code.find_first_of(" \t");
+    if (space == std::string::npos && code[code.size() - 1] == ':')
+    {
+      instr.type = Instruction::LABEL;
+      instr.mnemonic = code.substr(0, code.size() - 1);
+      return instr;
+    }
+
+    instr.type = Instruction::INSTRUCTION;
+    instr.mnemonic = code.substr(0, space);
+    if (space == std::string::npos)
+      return instr;
+
+    // Commas inside an address can't happen in intel syntax
+    std::istringstream operands(code.substr(space));
+    std::string operand;
+    while (std::getline(operands, operand, ','))
+      instr.operands.push_back(trim(operand));
+
+    return instr;
+  }
+
+  /*!
+  ** Get the next line which isn't blank.
+  **
+  ** @param code The code
+  ** @param it The current line
+  **
+  ** @return The next line, or the end of the code
+  */
+  Peephole::iterator
+  Peephole::next(Instructions& code, iterator it)
+  {
+    if (it == code.end())
+      return it;
+    for (++it; it != code.end() && it->type == Instruction::BLANK; ++it)
+      ;
+    return it;
+  }
+
+  /*!
+  ** Try every pattern at the given position.
+  **
+  ** @param first The position
+  **
+  ** @return If a pattern was applied
+  */
+  bool
+  Peephole::apply(iterator first)
+  {
+    for (Rules::iterator it = _rules.begin(); it != _rules.end(); ++it)
+      if (it->pattern(*this, _code, first))
+      {
+	++it->hits;
+	return true;
+      }
+
+    return false;
+  }
+
+  /*!
+  ** Apply patterns until none of them matches.
+  ** A pattern only modifies lines from its position, so after a change
+  ** the search goes back one line, to catch newly created matches.
+  **
+  ** @return How many times patterns were applied
+  */
+  unsigned int
+  Peephole::run()
+  {
+    unsigned int nb = 0;
+    bool changed = true;
+
+    while (changed)
+    {
+      changed = false;
+      iterator it = _code.begin();
+      while (it != _code.end())
+      {
+	if (it->type != Instruction::INSTRUCTION)
+	{
+	  ++it;
+	  continue;
+	}
+
+	const bool atBegin = it == _code.begin();
+	iterator previous = it;
+	if (!atBegin)
+	  --previous;
+	if (apply(it))
+	{
+	  changed = true;
+	  ++nb;
+	  it = atBegin ? _code.begin() : previous;
+	}
+	else
+	  ++it;
+      }
+    }
+
+    return nb;
+  }
+
+  /*!
+  ** Print the optimized code.
+  **
+  ** @param o The stream
+  */
+  void
+  Peephole::print(std::ostream& o) const
+  {
+    for (Instructions::const_iterator it = _code.begin();
+	 it != _code.end(); ++it)
+      o << it->text << '\n';
+  }
+
+  /*!
+  ** Print how many times each pattern was applied.
+  **
+  ** @param o The stream
+  */
+  void
+  Peephole::printStatistics(std::ostream& o) const
+  {
+    o << std::left << std::setw(20) << "Peephole pattern"
+      << std::right << std::setw(6) << "Hits" << '\n';
+    for (Rules::const_iterator it = _rules.begin(); it != _rules.end(); ++it)
+      o << std::left << std::setw(20) << it->name
+	<< std::right << std::setw(6) << it->hits << '\n';
+  }
+
+  /*!
+  ** Check if the code is 64 bits. Writing a 32 bits register then also
+  ** clears the upper half of the 64 bits one.
+  **
+  ** @return If the code is 64 bits
+  */
+  bool
+  Peephole::isLongMode() const
+  {
+    return _longMode;
+  }
+}
@@ -0,0 +1,85 @@
+#ifndef PEEPHOLE_HH_
+# define PEEPHOLE_HH_
+
+# include <iostream>
+# include <list>
+# include <string>
+# include <vector>
+
+namespace MiniCompiler
+{
+  /*!
+  ** Peephole optimizer over generated assembly, in intel syntax.
+  ** The code is loaded into a list of instructions, then every registered
+  ** pattern is tried at every position, until none of them applies.
+  ** Unchanged lines are printed back as they were generated.
+  */
+  class Peephole
+  {
+  public:
+    /*!
+    ** A line of assembly.
+    */
+    struct Instruction
+    {
+      enum kind
+      {
+	BLANK,		// Empty or only a comment
+	LABEL,
+	INSTRUCTION,
+	OPAQUE		// Kept as is, like data containing strings
+      };
+      typedef std::vector<std::string> Operands;
+
+      Instruction();
+      Instruction(const std::string& mnemonic, const Operands& operands);
+      kind		type;
+      std::string	text;
+      std::string	mnemonic;
+      Operands		operands;
+    };
+
+    typedef std::list<Instruction> Instructions;
+    typedef Instructions::iterator iterator;
+    typedef bool (*Pattern)(const Peephole& peephole, Instructions& code,
+			    iterator first);
+
+  private:
+    /*!
+    ** A registered pattern, and how many times it was applied.
+    */
+    struct Rule
+    {
+      std::string	name;
+      Pattern		pattern;
+      unsigned int	hits;
+    };
+
+    typedef std::vector<Rule> Rules;
+
+  public:
+    Peephole(const char commentChar, const bool longMode);
+    ~Peephole();
+
+  public:
+    void registerPattern(const std::string& name, Pattern pattern);
+    void load(const std::string& code);
+    unsigned int run();
+    void print(std::ostream& o) const;
+    void printStatistics(std::ostream& o) const;
+    bool isLongMode() const;
+    static iterator next(Instructions& code, iterator it);
+
+  private:
+    Instruction parse(const std::string& line) const;
+    bool apply(iterator first);
+
+  private:
+    const char		_commentChar;
+    const bool		_longMode;
+    Instructions	_code;
+    Rules		_rules;
+  };
+}
+
+#endif /* !PEEPHOLE_HH_ */
@@ -0,0 +1,389 @@
+#include <cassert>
+#include <cctype>
+#include "PeepholePatterns.hh"
+
+namespace MiniCompiler
+{
+  namespace PeepholePatterns
+  {
+    namespace
+    {
+      typedef Peephole::Instruction Instruction;
+
+      /*!
+      ** Get the register a name is part of, eg "ax", "eax" and "rax"
+      ** all are part of the same register.
+      **
+      ** @param name The name
+      **
+      ** @return The register number, or -1 if it isn't a register
+      */
+      int
+      family(const std::string& name)
+      {
+	static const char* const NAMES[][5] =
+	  {
+	    { "al", "ah", "ax", "eax", "rax" },
+	    { "bl", "bh", "bx", "ebx", "rbx" },
+	    { "cl", "ch", "cx", "ecx", "rcx" },
+	    { "dl", "dh", "dx", "edx", "rdx" },
+	    { "sil", "si", "esi", "rsi", 0 },
+	    { "dil", "di", "edi", "rdi", 0 },
+	    { "bpl", "bp", "ebp", "rbp", 0 },
+	    { "spl", "sp", "esp", "rsp", 0 }
+	  };
+	static const int NB_NAMES = sizeof (NAMES) / sizeof (NAMES[0]);
+
+	for (int i = 0; i < NB_NAMES; ++i)
+	  for (int j = 0; j < 5 && NAMES[i][j]; ++j)
+	    if (name == NAMES[i][j])
+	      return i;
+
+	// r8 to r15, with an optional b, w or d suffix
+	if (name.size() < 2 || name[0] != 'r' || !isdigit(name[1]))
+	  return -1;
+	std::string::size_type end = 1;
+	int nb = 0;
+	for (; end < name.size() && isdigit(name[end]); ++end)
+	  nb = nb * 10 + name[end] - '0';
+	if (nb < 8 || nb > 15)
+	  return -1;
+	if (end == name.size() ||
+	    (end + 1 == name.size() &&
+	     (name[end] == 'b' || name[end] == 'w' || name[end] == 'd')))
+	  return nb;
+	return -1;
+      }
+
+      /*!
+      ** Check if an operand is a register.
+      **
+      ** @param operand The operand
+      **
+      ** @return If it is a register
+      */
+      bool
+      isRegister(const std::string& operand)
+      {
+	return family(operand) >= 0;
+      }
+
+      /*!
+      ** Check if an operand is a memory reference.
+      **
+      ** @param operand The operand
+      **
+      ** @return If it is in memory
+      */
+      bool
+      isMemory(const std::string& operand)
+      {
+	return operand.find('[') != std::string::npos;
+      }
+
+      /*!
+      ** Check if an operand uses a register, eg "[ebp + 8]" uses "ebp".
+      **
+      ** @param operand The operand
+      ** @param reg The register
+      **
+      ** @return If the operand uses a part of the register
+      */
+      bool
+      uses(const std::string& operand, const std::string& reg)
+      {
+	const int nb = family(reg);
+	std::string word;
+
+	assert(nb >= 0);
+	for (std::string::size_type i = 0; i <= operand.size(); ++i)
+	{
+	  if (i < operand.size() && (isalnum(operand[i]) || operand[i] == '_'))
+	  {
+	    word += operand[i];
+	    continue;
+	  }
+	  if (family(word) == nb)
+	    return true;
+	  word.clear();
+	}
+
+	return false;
+      }
+
+      /*!
+      ** Check if writing a register leaves its other parts unchanged.
+      ** In 64 bits, writing a 32 bits register clears the upper half,
+      ** so writing it again with the same value isn't useless.
+      **
+      ** @param peephole The peephole optimizer
+      ** @param reg The written register
+      **
+      ** @return If writing the same value again does nothing
+      */
+      bool
+      isRewriteUseless(const Peephole& peephole, const std::string& reg)
+      {
+	if (!peephole.isLongMode() || !isRegister(reg))
+	  return true;
+	return reg[0] != 'e' && reg[reg.size() - 1] != 'd';
+      }
+
+      /*!
+      ** Check if an instruction has the given mnemonic and number of
+      ** operands.
+      **
+      ** @param code The code
+      ** @param it The instruction
+      ** @param mnemonic The mnemonic
+      ** @param nb The number of operands
+      **
+      ** @return If the instruction matches
+      */
+      bool
+      is(const Instructions& code, iterator it, const char* mnemonic,
+	 unsigned int nb)
+      {
+	return it != code.end() && it->type == Instruction::INSTRUCTION &&
+	  it->mnemonic == mnemonic && it->operands.size() == nb;
+      }
+
+      /*!
+      ** Create a mov instruction.
+      **
+      ** @param dst The destination
+      ** @param src The source
+      **
+      ** @return The instruction
+      */
+      Instruction
+      move(const std::string& dst, const std::string& src)
+      {
+	Instruction::Operands operands;
+	operands.push_back(dst);
+	operands.push_back(src);
+	return Instruction("mov", operands);
+      }
+    }
+
+    /*!
+    ** mov a, a => nothing
+    **
+    ** @param peephole The peephole optimizer
+    ** @param code The code
+    ** @param first The position
+    **
+    ** @return If the code was modified
+    */
+    bool
+    selfMove(const Peephole& peephole, Instructions& code, iterator first)
+    {
+      if (!is(code, first, "mov", 2) ||
+	  first->operands[0] != first->operands[1] ||
+	  !isRegister(first->operands[0]) ||
+	  !isRewriteUseless(peephole, first->operands[0]))
+	return false;
+
+      code.erase(first);
+      return true;
+    }
+
+    /*!
+    ** mov a, b
+    ** mov b, a => mov a, b
+    **
+    ** @param peephole The peephole optimizer
+    ** @param code The code
+    ** @param first The position
+    **
+    ** @return If the code was modified
+    */
+    bool
+    moveBack(const Peephole& peephole, Instructions& code, iterator first)
+    {
+      iterator second = Peephole::next(code, first);
+      if (!is(code, first, "mov", 2) || !is(code, second, "mov", 2))
+	return false;
+
+      const std::string& a = first->operands[0];
+      const std::string& b = first->operands[1];
+      if (second->operands[0] != b || second->operands[1] != a ||
+	  !(isRegister(a) || isRegister(b)) ||
+	  (isRegister(a) && uses(b, a)) ||
+	  !isRewriteUseless(peephole, b))
+	return false;
+
+      code.erase(second);
+      return true;
+    }
+
+    /*!
+    ** mov [m], r
+    ** mov r, [m] => mov [m], r
+    **
+    ** @param peephole The peephole optimizer
+    ** @param code The code
+    ** @param first The position
+    **
+    ** @return If the code was modified
+    */
+    bool
+    storeReload(const Peephole& peephole, Instructions& code, iterator first)
+    {
+      iterator second = Peephole::next(code, first);
+      if (!is(code, first, "mov", 2) || !is(code, second, "mov", 2))
+	return false;
+
+      const std::string& m = first->operands[0];
+      const std::string& r = first->operands[1];
+      if (!isMemory(m) || !isRegister(r) || uses(m, r) ||
+	  second->operands[0] != r || second->operands[1] != m ||
+	  !isRewriteUseless(peephole, r))
+	return false;
+
+      code.erase(second);
+      return true;
+    }
+
+    /*!
+    ** push a
+    ** pop b => mov b, a
+    **
+    ** @param peephole The peephole optimizer
+    ** @param code The code
+    ** @param first The position
+    **
+    ** @return If the code was modified
+    */
+    bool
+    pushPop(const Peephole&, Instructions& code, iterator first)
+    {
+      iterator second = Peephole::next(code, first);
+      if (!is(code, first, "push", 1) || !is(code, second, "pop", 1))
+	return false;
+
+      const std::string& a = first->operands[0];
+      const std::string& b = second->operands[0];
+      if (a == b)
+      {
+	code.erase(second);
+	code.erase(first);
+	return true;
+      }
+      if (!isRegister(b) || uses(a, "esp"))
+	return false;
+
+      *first = move(b, a);
+      code.erase(second);
+      return true;
+    }
+
+    /*!
+    ** push r
+    ** mov r, x
+    ** mov s, r
+    ** pop r => mov s, x
+    **
+    ** @param peephole The peephole optimizer
+    ** @param code The code
+    ** @param first The position
+    **
+    ** @return If the code was modified
+    */
+    bool
+    pushLoadPop(const Peephole&, Instructions& code, iterator first)
+    {
+      iterator load = Peephole::next(code, first);
+      iterator copy = Peephole::next(code, load);
+      iterator last = Peephole::next(code, copy);
+      if (!is(code, first, "push", 1) || !is(code, load, "mov", 2) ||
+	  !is(code, copy, "mov", 2) || !is(code, last, "pop", 1))
+	return false;
+
+      const std::string& r = first->operands[0];
+      const std::string& x = load->operands[1];
+      const std::string& s = copy->operands[0];
+      if (!isRegister(r) || load->operands[0] != r ||
+	  copy->operands[1] != r || last->operands[0] != r ||
+	  !isRegister(s) || uses(s, r) || uses(x, "esp"))
+	return false;
+
+      const Instruction& instr = move(s, x);
+      code.erase(load, ++last);
+      *first = instr;
+      return true;
+    }
+
+    /*!
+    ** xor edx, edx
+    ** mul x => mul x
+    ** Unsigned multiplication overwrites edx, without reading it.
+    **
+    ** @param peephole The peephole optimizer
+    ** @param code The code
+    ** @param first The position
+    **
+    ** @return If the code was modified
+    */
+    bool
+    deadClear(const Peephole&, Instructions& code, iterator first)
+    {
+      iterator second = Peephole::next(code, first);
+      if (!is(code, first, "xor", 2) || !is(code, second, "mul", 1))
+	return false;
+
+      const std::string& r = first->operands[0];
+      if (r != first->operands[1] || (r != "edx" && r != "rdx") ||
+	  uses(second->operands[0], r))
+	return false;
+
+      code.erase(first);
+      return true;
+    }
+
+    /*!
+    ** jmp l
+    ** l: => l:
+    **
+    ** @param peephole The peephole optimizer
+    ** @param code The code
+    ** @param first The position
+    **
+    ** @return If the code was modified
+    */
+    bool
+    jumpToNext(const Peephole&, Instructions& code, iterator first)
+    {
+      if (!is(code, first, "jmp", 1))
+	return false;
+
+      for (iterator it = Peephole::next(code, first);
+	   it != code.end() && it->type == Instruction::LABEL;
+	   it = Peephole::next(code, it))
+	if (it->mnemonic == first->operands[0])
+	{
+	  code.erase(first);
+	  return true;
+	}
+
+      return false;
+    }
+
+    /*!
+    ** Register all patterns of the library.
+    **
+    ** @param peephole The peephole optimizer
+    */
+    void
+    registerAll(Peephole& peephole)
+    {
+      peephole.registerPattern("self-move", selfMove);
+      peephole.registerPattern("move-back", moveBack);
+      peephole.registerPattern("store-reload", storeReload);
+      peephole.registerPattern("push-pop", pushPop);
+      peephole.registerPattern("push-load-pop", pushLoadPop);
+      peephole.registerPattern("dead-clear", deadClear);
+      peephole.registerPattern("jump-to-next", jumpToNext);
+    }
+  }
+}
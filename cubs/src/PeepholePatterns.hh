@@ -0,0 +1,36 @@
+#ifndef PEEPHOLEPATTERNS_HH_
+# define PEEPHOLEPATTERNS_HH_
+
+# include "Peephole.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Library of peephole patterns, usable by every backend.
+  ** A pattern only looks at instructions from its position, and returns
+  ** if it modified the code.
+  */
+  namespace PeepholePatterns
+  {
+    typedef Peephole::Instructions Instructions;
+    typedef Peephole::iterator iterator;
+
+    bool selfMove(const Peephole& peephole, Instructions& code,
+		  iterator first);
+    bool moveBack(const Peephole& peephole, Instructions& code,
+		  iterator first);
+    bool storeReload(const Peephole& peephole, Instructions& code,
+		     iterator first);
+    bool pushPop(const Peephole& peephole, Instructions& code,
+		 iterator first);
+    bool pushLoadPop(const Peephole& peephole, Instructions& code,
+		     iterator first);
+    bool deadClear(const Peephole& peephole, Instructions& code,
+		   iterator first);
+    bool jumpToNext(const Peephole& peephole, Instructions& code,
+		    iterator first);
+    void registerAll(Peephole& peephole);
+  }
+}
+
+#endif /* !PEEPHOLEPATTERNS_HH_ */
@@ -4,58 +4,88 @@
 # include <iomanip>
 # include <sstream>
 # include "BaseVisitor.hh"
+# include "OutputBuffer.hh"
 
 namespace MiniCompiler
 {
-  class PrettyPrinterVisitor : public ConstBaseVisitor
+  /*!
+  ** Print a tree back as a program. Derived is the final visitor, so
+  ** that the generators deriving from the printer get their own
+  ** methods called on children, without virtual calls.
+  */
+  template <typename Derived>
+  class BasicPrettyPrinterVisitor : public ConstBaseVisitor<Derived>
   {
+    template <typename D>
     friend std::ostream&
-    operator<<(std::ostream& o, const PrettyPrinterVisitor& v);
+    operator<<(std::ostream& o, const BasicPrettyPrinterVisitor<D>& v);
 
   public:
-    PrettyPrinterVisitor();
-    virtual ~PrettyPrinterVisitor();
+    BasicPrettyPrinterVisitor();
+    ~BasicPrettyPrinterVisitor();
+
+  public:
+    void setLevel(const unsigned int level);
+    void setOutput(std::ostream& o);
+    void setOutput(const int fd);
+    void flush();
 
   public:
-    virtual void visit(const AST::NodeIds* node);
-    virtual void visit(const AST::NodeProgram* node);
-    virtual void visit(const AST::NodeAffect* node);
-    virtual void visit(const AST::NodeIf* node);
-    virtual void visit(const AST::NodeRead* node);
-    virtual void visit(const AST::NodeArgument* node);
-    virtual void visit(const AST::NodeArguments* node);
-    virtual void visit(const AST::NodeReturn* node);
-    virtual void visit(const AST::NodeExit* node);
-    virtual void visit(const AST::NodeCallFunc* node);
-    virtual void visit(const AST::NodeOperation* node);
-    virtual void visit(const AST::NodeExpression* node);
-    virtual void visit(const AST::NodeStringExpr* node);
-    virtual void visit(const AST::NodeBoolean* node);
-    virtual void visit(const AST::NodeExpressions* node);
-    virtual void visit(const AST::NodeInstr* node);
-    virtual void visit(const AST::NodeCompoundInstr* node);
-    virtual void visit(const AST::NodeFactor* node);
-    virtual void visit(const AST::NodeInstrs* node);
-    virtual void visit(const AST::NodeType* node);
-    virtual void visit(const AST::NodeFunction* node);
-    virtual void visit(const AST::NodeWhile* node);
-    virtual void visit(const AST::NodeDeclarationBody* node);
-    virtual void visit(const AST::NodeFunctions* node);
-    virtual void visit(const AST::NodeNumber* node);
-    virtual void visit(const AST::NodeDeclaration* node);
-    virtual void visit(const AST::NodeHeaderFunc* node);
-    virtual void visit(const AST::NodeDeclarations* node);
-    virtual void visit(const AST::NodeId* node);
-    virtual void visit(const AST::NodeIdFunc* node);
-    virtual void visit(const AST::NodePrint* node);
+    void visit(const AST::NodeIds* node);
+    void visit(const AST::NodeProgram* node);
+    void visit(const AST::NodeAffect* node);
+    void visit(const AST::NodeIf* node);
+    void visit(const AST::NodeRead* node);
+    void visit(const AST::NodeArgument* node);
+    void visit(const AST::NodeArguments* node);
+    void visit(const AST::NodeReturn* node);
+    void visit(const AST::NodeExit* node);
+    void visit(const AST::NodeCallFunc* node);
+    void visit(const AST::NodeOperation* node);
+    void visit(const AST::NodeExpression* node);
+    void visit(const AST::NodeStringExpr* node);
+    void visit(const AST::NodeBoolean* node);
+    void visit(const AST::NodeExpressions* node);
+    void visit(const AST::NodeInstr* node);
+    void visit(const AST::NodeCompoundInstr* node);
+    void visit(const AST::NodeFactor* node);
+    void visit(const AST::NodeInstrs* node);
+    void visit(const AST::NodeType* node);
+    void visit(const AST::NodeFunction* node);
+    void visit(const AST::NodeWhile* node);
+    void visit(const AST::NodeDeclarationBody* node);
+    void visit(const AST::NodeFunctions* node);
+    void visit(const AST::NodeNumber* node);
+    void visit(const AST::NodeDeclaration* node);
+    void visit(const AST::NodeHeaderFunc* node);
+    void visit(const AST::NodeDeclarations* node);
+    void visit(const AST::NodeId* node);
+    void visit(const AST::NodeIdFunc* node);
+    void visit(const AST::NodePrint* node);
+
+  protected:
+    using ConstBaseVisitor<Derived>::INDENT_SIZE;
+    using ConstBaseVisitor<Derived>::SPACING_CHAR;
 
   protected:
     void print(std::ostream& o) const;
 
   protected:
-    std::stringstream	_indent;
+    std::stringbuf	_buffer;
+    OutputBuffer*	_output;
+    std::ostream	_indent;
     unsigned int	_tab;
   };
+
+  class PrettyPrinterVisitor :
+    public BasicPrettyPrinterVisitor<PrettyPrinterVisitor>
+  {
+  public:
+    PrettyPrinterVisitor();
+    ~PrettyPrinterVisitor();
+  };
 }
 
+# include "PrettyPrinterVisitor.hxx"
+
 #endif /* !PRETTYPRINTERVISITOR_HH_ */
@@ -0,0 +1,794 @@
+#include <cassert>
+#include "PrettyPrinterVisitor.hh"
+#include "Configuration.hh"
+#include "Utils.hh"
+#include "NodeIds.hh"
+#include "NodeProgram.hh"
+#include "NodeAffect.hh"
+#include "NodeIf.hh"
+#include "NodeRead.hh"
+#include "NodeArgument.hh"
+#include "NodeArguments.hh"
+#include "NodeReturn.hh"
+#include "NodeExit.hh"
+#include "NodeCallFunc.hh"
+#include "NodeOperation.hh"
+#include "NodeExpression.hh"
+#include "NodeStringExpr.hh"
+#include "NodeBoolean.hh"
+#include "NodeExpressions.hh"
+#include "NodeInstr.hh"
+#include "NodeCompoundInstr.hh"
+#include "NodeFactor.hh"
+#include "NodeInstrs.hh"
+#include "NodeType.hh"
+#include "NodeFunction.hh"
+#include "NodeWhile.hh"
+#include "NodeDeclarationBody.hh"
+#include "NodeFunctions.hh"
+#include "NodeNumber.hh"
+#include "NodeDeclaration.hh"
+#include "NodeHeaderFunc.hh"
+#include "NodeDeclarations.hh"
+#include "NodeId.hh"
+#include "NodeIdFunc.hh"
+#include "NodePrint.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct the pretty printer visitor,
+  ** initializing tabulation.
+  */
+  template <typename Derived>
+  BasicPrettyPrinterVisitor<Derived>::BasicPrettyPrinterVisitor()
+    : _output(0), _indent(&_buffer), _tab(INDENT_SIZE)
+  {
+  }
+
+  /*!
+  ** Destruct the visitor, writing what remains of the output.
+  */
+  template <typename Derived>
+  BasicPrettyPrinterVisitor<Derived>::~BasicPrettyPrinterVisitor()
+  {
+    flush();
+    delete _output;
+  }
+
+  /*!
+  ** Set the indentation level of the next printed node, to print a
+  ** part of a tree.
+  **
+  ** @param level The number of indentations
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::setLevel(const unsigned int level)
+  {
+    _tab = level * INDENT_SIZE;
+  }
+
+  /*!
+  ** Write the text to a stream while it is generated, by blocks,
+  ** instead of keeping it until it is printed.
+  **
+  ** @param o The stream
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::setOutput(std::ostream& o)
+  {
+    flush();
+    delete _output;
+    _output = new OutputBuffer(o);
+    _indent.rdbuf(_output);
+  }
+
+  /*!
+  ** Write the text to a file descriptor while it is generated, by
+  ** blocks, instead of keeping it until it is printed.
+  **
+  ** @param fd The file descriptor
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::setOutput(const int fd)
+  {
+    flush();
+    delete _output;
+    _output = new OutputBuffer(fd);
+    _indent.rdbuf(_output);
+  }
+
+  /*!
+  ** Write the text generated so far to the output, if there is one.
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::flush()
+  {
+    _indent.flush();
+  }
+
+  /*!
+  ** Print the ids node
+  **
+  ** @param node The ids node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeIds* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeIds* ids = node->getIds();
+    const AST::NodeId* id = node->getId();
+    assert(id);
+    this->derived().visit(id);
+    if (ids)
+    {
+      _indent << cfg[","] << ' ';
+      this->derived().visit(ids);
+    }
+  }
+
+  /*!
+  ** Print the program node
+  **
+  ** @param node The program node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeProgram* node)
+  {
+    assert(node);
+    const AST::NodeDeclarations* decls = node->getDecls();
+    if (decls)
+    {
+      this->derived().visit(decls);
+      _indent << '\n';
+    }
+    const AST::NodeFunctions* funcs = node->getFuncs();
+    if (funcs)
+    {
+      this->derived().visit(funcs);
+      _indent << '\n';
+    }
+    const AST::NodeCompoundInstr* instrs = node->getInstrs();
+    if (instrs)
+    {
+      this->derived().visit(instrs);
+      _indent << '\n';
+    }
+  }
+
+  /*!
+  ** Print the affectation node
+  **
+  ** @param node The affectation node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeAffect* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeId* id = node->getId();
+    const AST::NodeExpression* expr = node->getExpr();
+    assert(id);
+    assert(expr);
+    this->derived().visit(id);
+    _indent << ' ' << cfg["="] << ' ';
+    this->derived().visit(expr);
+  }
+
+  /*!
+  ** Print the if node
+  **
+  ** @param node The if node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeIf* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeExpression* cond = node->getCond();
+    const AST::NodeCompoundInstr* body = node->getBodyExprs();
+    const AST::NodeCompoundInstr* elseExprs = node->getElseExprs();
+    assert(cond);
+    assert(body);
+
+    _indent << cfg["if"] << ' ';
+    this->derived().visit(cond);
+    _indent << ' ' << cfg["then"] << '\n';
+    this->derived().visit(body);
+    if (elseExprs)
+    {
+      _indent << Utils::stringFill(SPACING_CHAR, _tab) << cfg["else"] << '\n';
+      this->derived().visit(elseExprs);
+    }
+  }
+
+  /*!
+  ** Print the read node
+  **
+  ** @param node The read node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeRead* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeId* id = node->getId();
+    assert(id);
+
+    _indent << cfg["read"];
+    _indent << cfg["("];
+    this->derived().visit(id);
+    _indent << cfg[")"];
+  }
+
+  /*!
+  ** Print the argument node
+  **
+  ** @param node The argument node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeArgument* node)
+  {
+    assert(node);
+    const AST::NodeDeclarationBody* body = node->getDeclarationBody();
+    const AST::NodeArguments* args = node->getArguments();
+
+    assert(body);
+    this->derived().visit(body);
+    if (args)
+    {
+      Configuration& cfg = Configuration::getInstance();
+      _indent << cfg[";"] << ' ';
+      this->derived().visit(args);
+    }
+  }
+
+  /*!
+  ** Print the arguments node
+  **
+  ** @param node The arguments node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeArguments* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeArgument* arg = node->getArgument();
+    const AST::NodeArguments* args = node->getArguments();
+
+    assert(arg);
+    this->derived().visit(arg);
+    if (args)
+    {
+      _indent << cfg[";"] << ' ';
+      this->derived().visit(args);
+    }
+  }
+
+  /*!
+  ** Print the return node
+  **
+  ** @param node The return node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeReturn* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeExpression* expr = node->getExpr();
+    assert(expr);
+    _indent << cfg["return"] << ' ';
+    this->derived().visit(expr);
+  }
+
+  /*!
+  ** Print the exit node
+  **
+  ** @param node The exit node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeExit* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeExpression* expr = node->getExpr();
+    assert(expr);
+    _indent << cfg["exit"] << ' ';
+    this->derived().visit(expr);
+  }
+
+  /*!
+  ** Print the function call node
+  **
+  ** @param node The function call node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeCallFunc* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeIdFunc* id = node->getId();
+    const AST::NodeExpressions* exprs = node->getExprs();
+    assert(id);
+
+    this->derived().visit(id);
+    _indent << cfg["("];
+    if (exprs)
+      this->derived().visit(exprs);
+    _indent << cfg[")"];
+  }
+
+  /*!
+  ** Print the operation node
+  **
+  ** @param node The operation node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeOperation* node)
+  {
+    assert(node);
+    const AST::NodeFactor* leftFactor = node->getLeftFactor();
+    assert(leftFactor);
+
+    this->derived().visit(leftFactor);
+    if (node->getOpType() != AST::Operator::NONE)
+    {
+      const AST::NodeFactor* rightFactor = node->getRightFactor();
+      assert(rightFactor);
+      _indent << ' ' << Utils::OpToString(node->getOpType()) << ' ';
+      this->derived().visit(rightFactor);
+    }
+  }
+
+  /*!
+  ** Print the expression node
+  **
+  ** @param node The expression node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeExpression* node)
+  {
+    assert(node);
+    ConstBaseVisitor<Derived>::visit(node);
+  }
+
+  /*!
+  ** Print the string expression node
+  **
+  ** @param node The string expression node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeStringExpr* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    _indent << cfg["str"];
+    _indent << node->getString();
+    _indent << cfg["str"];
+  }
+
+  /*!
+  ** Print the boolean node
+  **
+  ** @param node The boolean node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeBoolean* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    _indent << (node->getBool() ? cfg["true"] : cfg["false"]);
+  }
+
+  /*!
+  ** Print the expressions node
+  **
+  ** @param node The expressions node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeExpressions* node)
+  {
+    assert(node);
+    const AST::NodeExpression* expr = node->getExpr();
+    const AST::NodeExpressions* exprs = node->getExprs();
+    assert(expr);
+
+    this->derived().visit(expr);
+    if (exprs)
+    {
+      Configuration& cfg = Configuration::getInstance();
+      _indent << cfg[","] << ' ';
+      this->derived().visit(exprs);
+    }
+  }
+
+  /*!
+  ** Print the instruction node
+  **
+  ** @param node The instruction node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeInstr* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeAffect* affect = node->getAffect();
+    const AST::NodeCallFunc* callFunc = node->getCallFunc();
+    const AST::NodeCompoundInstr* compoundInstr = node->getCompoundInstr();
+    const AST::NodeIf* nIf = node->getIf();
+    const AST::NodeWhile* nWhile = node->getWhile();
+    const AST::NodeReturn* nReturn = node->getReturn();
+    const AST::NodeExit* nExit = node->getExit();
+    const AST::NodePrint* nPrint = node->getPrint();
+    const AST::NodeRead* nRead = node->getRead();
+    unsigned int nb = 0;
+
+    nb += affect ? 1 : 0;
+    nb += callFunc ? 1 : 0;
+    nb += compoundInstr ? 1 : 0;
+    nb += nIf ? 1 : 0;
+    nb += nWhile ? 1 : 0;
+    nb += nReturn ? 1 : 0;
+    nb += nExit ? 1 : 0;
+    nb += nPrint ? 1 : 0;
+    nb += nRead ? 1 : 0;
+    assert(nb == 1);
+
+    if (compoundInstr)
+    {
+      this->derived().visit(compoundInstr);
+      return;
+    }
+
+    _indent << Utils::stringFill(SPACING_CHAR, _tab);
+    if (affect)
+    {
+      this->derived().visit(affect);
+      _indent << cfg[";"] << '\n';
+    }
+    else
+      if (callFunc)
+      {
+	this->derived().visit(callFunc);
+	_indent << cfg[";"] << '\n';
+      }
+      else
+	if (nIf)
+	  this->derived().visit(nIf);
+	else
+	  if (nWhile)
+	    this->derived().visit(nWhile);
+	  else
+	    if (nReturn)
+	    {
+	      this->derived().visit(nReturn);
+	      _indent << cfg[";"] << '\n';
+	    }
+	    else
+	      if (nExit)
+	      {
+		this->derived().visit(nExit);
+		_indent << cfg[";"] << '\n';
+	      }
+	      else
+		if (nPrint)
+		{
+		  this->derived().visit(nPrint);
+		  _indent << cfg[";"] << '\n';
+		}
+		else
+		  if (nRead)
+		  {
+		    this->derived().visit(nRead);
+		    _indent << cfg[";"] << '\n';
+		  }
+  }
+
+  /*!
+  ** Print the compound instruction node
+  **
+  ** @param node The compound instruction node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeCompoundInstr* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeInstrs* instrs = node->getInstrs();
+
+    _indent << Utils::stringFill(SPACING_CHAR, _tab) << cfg["begin"] << '\n';
+    _tab += INDENT_SIZE;
+    if (instrs)
+      this->derived().visit(instrs);
+    _tab -= INDENT_SIZE;
+    _indent << Utils::stringFill(SPACING_CHAR, _tab) << cfg["end"] << '\n';
+  }
+
+  /*!
+  ** Print the factor node
+  **
+  ** @param node The factor node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeFactor* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeExpression* expression = node->getExpression();
+    if (expression)
+    {
+      _indent << cfg["("];
+      this->derived().visit(expression);
+      _indent << cfg[")"];
+    }
+    else
+      ConstBaseVisitor<Derived>::visit(node);
+  }
+
+  /*!
+  ** Print the instructions node
+  **
+  ** @param node The instructions node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeInstrs* node)
+  {
+    assert(node);
+    ConstBaseVisitor<Derived>::visit(node);
+  }
+
+  /*!
+  ** Print the type node
+  **
+  ** @param node The ids node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeType* node)
+  {
+    assert(node);
+    _indent << node->getType();
+  }
+
+  /*!
+  ** Print the function node
+  **
+  ** @param node The function node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeFunction* node)
+  {
+    assert(node);
+    ConstBaseVisitor<Derived>::visit(node);
+    _indent << '\n';
+  }
+
+  /*!
+  ** Print the while node
+  **
+  ** @param node The while node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeWhile* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeExpression* cond = node->getCond();
+    const AST::NodeCompoundInstr* body = node->getBodyExprs();
+    assert(cond);
+    assert(body);
+
+    _indent << cfg["while"] << ' ';
+    this->derived().visit(cond);
+    _indent << ' ' << cfg["do"] << '\n';
+    this->derived().visit(body);
+  }
+
+  /*!
+  ** Print the declaration body node
+  **
+  ** @param node The declaration body node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeDeclarationBody* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeIds* ids = node->getIds();
+    const AST::NodeType* type = node->getType();
+    assert(ids);
+    assert(type);
+
+    this->derived().visit(ids);
+    _indent << ' ' << cfg[":"] << ' ';
+    this->derived().visit(type);
+  }
+
+  /*!
+  ** Print the functions node
+  **
+  ** @param node The functions node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeFunctions* node)
+  {
+    assert(node);
+    _indent << Utils::stringFill(SPACING_CHAR, _tab);
+    ConstBaseVisitor<Derived>::visit(node);
+  }
+
+  /*!
+  ** Print the number node
+  **
+  ** @param node The number node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeNumber* node)
+  {
+    assert(node);
+    _indent << node->getNumber();
+  }
+
+  /*!
+  ** Print the declaration node
+  **
+  ** @param node The declaration node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeDeclaration* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeDeclarationBody* body = node->getBody();
+    assert(body);
+    _indent << cfg["var"] << ' ';
+    this->derived().visit(body);
+    _indent << cfg[";"] << '\n';
+  }
+
+  /*!
+  ** Print the function header node
+  **
+  ** @param node The function header node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeHeaderFunc* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeIdFunc* id = node->getId();
+    const AST::NodeArguments* args = node->getArguments();
+    const AST::NodeType* type = node->getType();
+
+    assert(id);
+    assert(type);
+    _indent << cfg["function"] << ' ';
+    this->derived().visit(id);
+    _indent << cfg["("];
+    if (args)
+      this->derived().visit(args);
+    _indent << cfg[")"] << ' ' << cfg[":"] << ' ';
+    this->derived().visit(type);
+    _indent << cfg[";"] << '\n';
+  }
+
+  /*!
+  ** Print the declaration node
+  **
+  ** @param node The declaration node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeDeclarations* node)
+  {
+    assert(node);
+    _indent << Utils::stringFill(SPACING_CHAR, _tab);
+    ConstBaseVisitor<Derived>::visit(node);
+  }
+
+  /*!
+  ** Print the id node
+  **
+  ** @param node The id node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeId* node)
+  {
+    assert(node);
+    assert(node->getId() != "");
+    _indent << node->getId();
+  }
+
+  /*!
+  ** Print the function id node
+  **
+  ** @param node The function id node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodeIdFunc* node)
+  {
+    assert(node);
+    assert(node->getId() != "");
+    _indent << node->getId();
+  }
+
+  /*!
+  ** Print the print node
+  **
+  ** @param node The print node
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::visit(const AST::NodePrint* node)
+  {
+    assert(node);
+    Configuration& cfg = Configuration::getInstance();
+    const AST::NodeExpression* id = node->getExpr();
+    assert(id);
+
+    _indent << cfg["print"] << cfg["("];
+    this->derived().visit(id);
+    _indent << cfg[")"];
+  }
+
+  /*!
+  ** Print the buffered text in the choosen stream.
+  **
+  ** @param o The stream
+  */
+  template <typename Derived>
+  void
+  BasicPrettyPrinterVisitor<Derived>::print(std::ostream& o) const
+  {
+    o << _buffer.str();
+  }
+
+  /*!
+  ** Print the buffered text of the given Pretty Printer in the choosen stream.
+  **
+  ** @param o The stream
+  ** @param v The pretty printer
+  **
+  ** @return The modified stream
+  */
+  template <typename Derived>
+  std::ostream&
+  operator<<(std::ostream& o, const BasicPrettyPrinterVisitor<Derived>& v)
+  {
+    v.print(o);
+    return o;
+  }
+}
@@ -0,0 +1,38 @@
+#include <cassert>
+#include "PurityPass.hh"
+#include "PurityVisitor.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct the purity analysis, only launched when needed.
+  */
+  PurityPass::PurityPass()
+    : Pass("purity", true, 0)
+  {
+  }
+
+  /*!
+  ** Destruct the purity analysis.
+  */
+  PurityPass::~PurityPass()
+  {
+  }
+
+  /*!
+  ** Mark pure functions of the given AST.
+  **
+  ** @param tree The root of the AST
+  **
+  ** @return 0, the tree isn't modified
+  */
+  unsigned int
+  PurityPass::run(AST::NodeProgram* tree)
+  {
+    assert(tree);
+    PurityVisitor visitor;
+    visitor.visit(tree);
+
+    return 0;
+  }
+}
@@ -0,0 +1,20 @@
+#ifndef PURITYPASS_HH_
+# define PURITYPASS_HH_
+
+# include "Pass.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Analysis marking pure functions, see PurityVisitor.
+  */
+  class PurityPass : public Pass
+  {
+  public:
+    PurityPass();
+    virtual ~PurityPass();
+    virtual unsigned int run(AST::NodeProgram* tree);
+  };
+}
+
+#endif /* !PURITYPASS_HH_ */
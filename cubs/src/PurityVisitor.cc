@@ -0,0 +1,194 @@
+#include "PurityVisitor.hh"
+#include "NodeProgram.hh"
+#include "NodeCallFunc.hh"
+#include "NodeFunction.hh"
+#include "NodeFunctions.hh"
+#include "NodeId.hh"
+#include "NodeIdFunc.hh"
+#include "NodePrint.hh"
+#include "NodeRead.hh"
+#include "NodeExit.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct the purity visitor, setting current function to null.
+  */
+  PurityVisitor::PurityVisitor()
+    : _currentFunction(0), _nbPure(0)
+  {
+  }
+
+  /*!
+  ** Destruct the purity visitor.
+  */
+  PurityVisitor::~PurityVisitor()
+  {
+  }
+
+  /*!
+  ** Get the number of functions marked as pure.
+  **
+  ** @return The number of pure functions
+  */
+  unsigned int
+  PurityVisitor::nbPureFunctions() const
+  {
+    return _nbPure;
+  }
+
+  /*!
+  ** Mark the current function as impure, if we are in a function.
+  */
+  void
+  PurityVisitor::markImpure()
+  {
+    if (_currentFunction)
+      _impure.insert(_currentFunction);
+  }
+
+  /*!
+  ** A function calling an impure function is also impure.
+  ** Propagate impurity along the call graph until nothing changes,
+  ** then store the result into each function node.
+  */
+  void
+  PurityVisitor::propagate()
+  {
+    bool changed = true;
+
+    while (changed)
+    {
+      changed = false;
+      for (CallGraph::const_iterator it = _callGraph.begin();
+	   it != _callGraph.end(); ++it)
+      {
+	if (_impure.find(it->first) != _impure.end())
+	  continue;
+	for (Functions::const_iterator callee = it->second.begin();
+	     callee != it->second.end(); ++callee)
+	  if (_impure.find(*callee) != _impure.end())
+	  {
+	    _impure.insert(it->first);
+	    changed = true;
+	    break;
+	  }
+      }
+    }
+
+    _nbPure = 0;
+    for (CallGraph::const_iterator it = _callGraph.begin();
+	 it != _callGraph.end(); ++it)
+    {
+      const bool pure = _impure.find(it->first) == _impure.end();
+      it->first->setPure(pure);
+      _nbPure += pure ? 1 : 0;
+    }
+  }
+
+  /*!
+  ** Only functions are analyzed, then the result is propagated.
+  **
+  ** @param node The program node
+  */
+  void
+  PurityVisitor::visit(AST::NodeProgram* node)
+  {
+    assert(node);
+    AST::NodeFunctions* funcs = node->getFuncs();
+    if (funcs)
+      visit(funcs);
+    propagate();
+  }
+
+  /*!
+  ** Analyze a function, collecting its arguments and local variables.
+  **
+  ** @param node The function node
+  */
+  void
+  PurityVisitor::visit(AST::NodeFunction* node)
+  {
+    assert(node);
+    _currentFunction = node;
+    _locals.clear();
+    _callGraph[node];
+    NonConstBaseVisitor<PurityVisitor>::visit(node);
+    _currentFunction = 0;
+  }
+
+  /*!
+  ** Declarations are locals, any other variable must refer to one of them.
+  **
+  ** @param node The id node
+  */
+  void
+  PurityVisitor::visit(AST::NodeId* node)
+  {
+    assert(node);
+    if (node->isDeclaration())
+    {
+      _locals.insert(node);
+      return;
+    }
+
+    if (_locals.find(node->getRef()) == _locals.end())
+      markImpure();
+  }
+
+  /*!
+  ** Remember the called function in the call graph.
+  **
+  ** @param node The function call node
+  */
+  void
+  PurityVisitor::visit(AST::NodeCallFunc* node)
+  {
+    assert(node);
+    assert(node->getId());
+    AST::NodeFunction* refFunc = node->getId()->getRef();
+    assert(refFunc);
+    if (_currentFunction)
+      _callGraph[_currentFunction].insert(refFunc);
+    NonConstBaseVisitor<PurityVisitor>::visit(node);
+  }
+
+  /*!
+  ** Printing is a side effect.
+  **
+  ** @param node The print node
+  */
+  void
+  PurityVisitor::visit(AST::NodePrint* node)
+  {
+    assert(node);
+    markImpure();
+    NonConstBaseVisitor<PurityVisitor>::visit(node);
+  }
+
+  /*!
+  ** Reading is a side effect.
+  **
+  ** @param node The read node
+  */
+  void
+  PurityVisitor::visit(AST::NodeRead* node)
+  {
+    assert(node);
+    markImpure();
+    NonConstBaseVisitor<PurityVisitor>::visit(node);
+  }
+
+  /*!
+  ** Exiting is a side effect.
+  **
+  ** @param node The exit node
+  */
+  void
+  PurityVisitor::visit(AST::NodeExit* node)
+  {
+    assert(node);
+    markImpure();
+    NonConstBaseVisitor<PurityVisitor>::visit(node);
+  }
+}
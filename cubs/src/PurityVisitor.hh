@@ -0,0 +1,50 @@
+#ifndef PURITYVISITOR_HH_
+# define PURITYVISITOR_HH_
+
+# include <cassert>
+# include <map>
+# include <set>
+# include "BaseVisitor.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Mark every function whose result only depends on its arguments.
+  ** A function is pure if it doesn't touch any non local variable,
+  ** doesn't use print, read or exit, and only calls pure functions.
+  */
+  class PurityVisitor : public NonConstBaseVisitor<PurityVisitor>
+  {
+    typedef std::set<const AST::NodeId*> Locals;
+    typedef std::set<AST::NodeFunction*> Functions;
+    typedef std::map<AST::NodeFunction*, Functions> CallGraph;
+
+  public:
+    PurityVisitor();
+    ~PurityVisitor();
+    using NonConstBaseVisitor<PurityVisitor>::visit;
+    void visit(AST::NodeProgram* node);
+    void visit(AST::NodeFunction* node);
+    void visit(AST::NodeId* node);
+    void visit(AST::NodeCallFunc* node);
+    void visit(AST::NodePrint* node);
+    void visit(AST::NodeRead* node);
+    void visit(AST::NodeExit* node);
+
+  public:
+    unsigned int nbPureFunctions() const;
+
+  private:
+    void markImpure();
+    void propagate();
+
+  private:
+    CallGraph		_callGraph;
+    Functions		_impure;
+    Locals		_locals;
+    AST::NodeFunction*	_currentFunction;
+    unsigned int	_nbPure;
+  };
+}
+
+#endif /* !PURITYVISITOR_HH_ */
@@ -36,6 +36,7 @@ namespace MiniCompiler
 
   private:
     std::list<std::map<Key, Data> >	_stack;
+    std::list<std::map<Key, Data> >	_pool;
     std::string				_filter;
   };
 
@@ -112,8 +112,9 @@ namespace MiniCompiler
   Scope<Key, Data>::getFromCurrent(const Key& key)
   {
     assert(!_stack.empty());
-    if (_stack.front().find(key) != _stack.front().end())
-      return (_stack.front()[key]);
+    mapIter found = _stack.front().find(key);
+    if (found != _stack.front().end())
+      return (found->second);
 
     return (0);
   }
@@ -133,11 +134,11 @@ namespace MiniCompiler
 
     // Search for the wanted key in all scope
     for (iter i = _stack.begin(); i != _stack.end(); ++i)
-      if (i->find(key) != i->end())
-      {
-	std::map<Key, Data> m = *i;
-	return m[key];
-      }
+    {
+      mapIter found = i->find(key);
+      if (found != i->end())
+	return found->second;
+    }
 
     // Can't find the wanted key
     return 0;
@@ -145,24 +146,29 @@ namespace MiniCompiler
 
   /*!
   ** Open a scope.
+  ** A previously closed scope is reused if any, so opening and closing
+  ** scopes doesn't allocate anything once the deepest level is reached.
   */
   template <typename Key, typename Data>
   inline void
   Scope<Key, Data>::open()
   {
-    std::map<Key, Data> m;
-
-    _stack.push_front(m);
+    if (_pool.empty())
+      _stack.push_front(std::map<Key, Data>());
+    else
+      _stack.splice(_stack.begin(), _pool, _pool.begin());
   }
 
   /*!
-  ** Close a scope.
+  ** Close a scope, keeping it empty for a next opening.
   */
   template <typename Key, typename Data>
   inline void
   Scope<Key, Data>::close()
   {
-    _stack.pop_front();
+    assert(!_stack.empty());
+    _stack.front().clear();
+    _pool.splice(_pool.begin(), _stack, _stack.begin());
   }
 
   /*!
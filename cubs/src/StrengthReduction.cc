@@ -0,0 +1,259 @@
+#include <cassert>
+#include "StrengthReduction.hh"
+
+namespace MiniCompiler
+{
+  namespace StrengthReduction
+  {
+    namespace
+    {
+      /*!
+      ** Get the logarithm of a power of 2.
+      **
+      ** @param value The value
+      **
+      ** @return The logarithm, or -1 if value isn't a power of 2
+      */
+      int
+      log2(unsigned int value)
+      {
+	int res = 0;
+
+	if (value == 0 || (value & (value - 1)) != 0)
+	  return -1;
+	for (; value > 1; value >>= 1)
+	  ++res;
+	return res;
+      }
+
+      /*!
+      ** Get the absolute value of an integer, without overflow.
+      **
+      ** @param value The value
+      **
+      ** @return The absolute value
+      */
+      unsigned int
+      absolute(const int value)
+      {
+	const unsigned int res = value;
+	return value < 0 ? 0u - res : res;
+      }
+
+      /*!
+      ** Write a multiplication by a constant with lea and shifts:
+      ** a power of 2, or 3, 5 or 9 times a power of 2, maybe negated.
+      **
+      ** @param o The stream
+      ** @param constant The factor
+      ** @param base The 64 or 32 bits name of eax, used by lea
+      **
+      ** @return If the factor could be used, else imul is better
+      */
+      bool
+      writeMultiplication(std::ostream& o, const int constant,
+			  const std::string& base)
+      {
+	if (constant == 0)
+	{
+	  o << "\txor\teax, eax\n";
+	  return true;
+	}
+
+	const unsigned int factor = absolute(constant);
+	unsigned int shift = 0;
+	for (; ((factor >> shift) & 1) == 0; ++shift)
+	  ;
+	const unsigned int odd = factor >> shift;
+	if (odd != 1 && odd != 3 && odd != 5 && odd != 9)
+	  return false;
+
+	if (odd != 1)
+	  o << "\tlea\teax, [" << base << " + " << base << "*" << odd - 1
+	    << "]\n";
+	if (shift > 0)
+	  o << "\tshl\teax, " << shift << "\n";
+	if (constant < 0)
+	  o << "\tneg\teax\n";
+	return true;
+      }
+
+      /*!
+      ** Write a division, or a modulo, by a power of 2, maybe negated.
+      ** Negative values are biased first, so that the shift truncates
+      ** toward zero.
+      **
+      ** @param o The stream
+      ** @param op DIV or MODULO
+      ** @param divisor The divisor
+      ** @param shift Its logarithm, at least 1
+      */
+      void
+      writePowerOfTwo(std::ostream& o, const AST::Operator::type op,
+		      const int divisor, const int shift)
+      {
+	assert(shift > 0);
+	if (op == AST::Operator::MODULO)
+	  o << "\tmov\tedx, eax\n";
+	o << "\tmov\tecx, eax\n";
+	if (shift > 1)
+	  o << "\tsar\tecx, 31\n";
+	o << "\tshr\tecx, " << 32 - shift << "\n"
+	  "\tadd\teax, ecx\n";
+	if (op == AST::Operator::MODULO)
+	{
+	  o << "\tand\teax, "
+	    << static_cast<int>(0u - absolute(divisor)) << "\n"
+	    "\tsub\tedx, eax\n"
+	    "\tmov\teax, edx\n";
+	  return;
+	}
+	o << "\tsar\teax, " << shift << "\n";
+	if (divisor < 0)
+	  o << "\tneg\teax\n";
+      }
+
+      /*!
+      ** Write a division, or a modulo, by a constant.
+      ** The quotient is the high half of the product by the magic
+      ** number, shifted, plus one when negative.
+      **
+      ** @param o The stream
+      ** @param op DIV or MODULO
+      ** @param divisor The divisor, not 0
+      */
+      void
+      writeDivision(std::ostream& o, const AST::Operator::type op,
+		    const int divisor)
+      {
+	assert(divisor != 0);
+	if (divisor == 1 || divisor == -1)
+	{
+	  if (op == AST::Operator::MODULO)
+	    o << "\txor\teax, eax\n";
+	  else
+	    if (divisor < 0)
+	      o << "\tneg\teax\n";
+	  return;
+	}
+
+	const int shift = log2(absolute(divisor));
+	if (shift > 0)
+	{
+	  writePowerOfTwo(o, op, divisor, shift);
+	  return;
+	}
+
+	int multiplier = 0;
+	unsigned int magicShift = 0;
+	divisionMagic(divisor, multiplier, magicShift);
+	o << "\tmov\tecx, eax\n"
+	  "\tmov\tedx, " << multiplier << "\n"
+	  "\timul\tedx\n";
+	if (divisor > 0 && multiplier < 0)
+	  o << "\tadd\tedx, ecx\n";
+	if (divisor < 0 && multiplier > 0)
+	  o << "\tsub\tedx, ecx\n";
+	if (magicShift > 0)
+	  o << "\tsar\tedx, " << magicShift << "\n";
+	o << "\tmov\teax, edx\n"
+	  "\tshr\teax, 31\n"
+	  "\tadd\teax, edx\n";
+	if (op == AST::Operator::MODULO)
+	  o << "\timul\teax, eax, " << divisor << "\n"
+	    "\tsub\tecx, eax\n"
+	    "\tmov\teax, ecx\n";
+      }
+    }
+
+    /*!
+    ** Compute the magic number of a signed division by a constant, as
+    ** described in Hacker's Delight: n / d is the high half of n * M,
+    ** plus or minus n when M and d have different signs, shifted by s,
+    ** plus one when negative.
+    **
+    ** @param divisor The divisor d
+    ** @param multiplier The magic number M
+    ** @param shift The shift s
+    **
+    ** @return If there is a magic number, ie if |d| >= 2
+    */
+    bool
+    divisionMagic(const int divisor, int& multiplier, unsigned int& shift)
+    {
+      const unsigned int two31 = 0x80000000u;
+      const unsigned int ad = absolute(divisor);
+      if (ad < 2)
+	return false;
+
+      const unsigned int t =
+	two31 + (static_cast<unsigned int>(divisor) >> 31);
+      const unsigned int anc = t - 1 - t % ad;
+      unsigned int p = 31;
+      unsigned int q1 = two31 / anc;
+      unsigned int r1 = two31 - q1 * anc;
+      unsigned int q2 = two31 / ad;
+      unsigned int r2 = two31 - q2 * ad;
+      unsigned int delta = 0;
+
+      do
+      {
+	++p;
+	q1 *= 2;
+	r1 *= 2;
+	if (r1 >= anc)
+	{
+	  ++q1;
+	  r1 -= anc;
+	}
+	q2 *= 2;
+	r2 *= 2;
+	if (r2 >= ad)
+	{
+	  ++q2;
+	  r2 -= ad;
+	}
+	delta = ad - r2;
+      }
+      while (q1 < delta || (q1 == delta && r1 == 0));
+
+      const unsigned int magic = q2 + 1;
+      multiplier = static_cast<int>(divisor < 0 ? 0u - magic : magic);
+      shift = p - 32;
+      return true;
+    }
+
+    /*!
+    ** Write an arithmetic operation by a constant with cheaper
+    ** instructions, when it is worth it.
+    **
+    ** @param o The stream
+    ** @param op The operator
+    ** @param constant The right operand
+    ** @param base The name of the register containing eax, to use it as
+    ** an address: "rax" in 64 bits, "eax" in 32 bits
+    **
+    ** @return If the operation was written, else the usual instructions
+    ** must be used
+    */
+    bool
+    write(std::ostream& o, const AST::Operator::type op,
+	  const int constant, const std::string& base)
+    {
+      switch (op)
+      {
+	case AST::Operator::MUL:
+	  return writeMultiplication(o, constant, base);
+	case AST::Operator::DIV:
+	case AST::Operator::MODULO:
+	  // A division by zero must still fail at execution
+	  if (constant == 0)
+	    return false;
+	  writeDivision(o, op, constant);
+	  return true;
+	default:
+	  return false;
+      }
+    }
+  }
+}
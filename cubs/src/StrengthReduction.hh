@@ -0,0 +1,27 @@
+#ifndef STRENGTHREDUCTION_HH_
+# define STRENGTHREDUCTION_HH_
+
+# include <iostream>
+# include <string>
+# include "Utils.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Cheaper instructions for arithmetic by a constant, usable by every
+  ** x86 backend. Divisions become a multiplication by a magic number
+  ** and shifts, multiplications become lea and shifts.
+  ** The value is in eax, and so is the result; only ecx and edx are
+  ** destroyed. Integers are signed 32 bits, and divisions truncate
+  ** toward zero, like in the execution.
+  */
+  namespace StrengthReduction
+  {
+    bool divisionMagic(const int divisor, int& multiplier,
+		       unsigned int& shift);
+    bool write(std::ostream& o, const AST::Operator::type op,
+	       const int constant, const std::string& base);
+  }
+}
+
+#endif /* !STRENGTHREDUCTION_HH_ */
@@ -40,6 +40,19 @@ namespace MiniCompiler
   {
   }
 
+  /*!
+  ** Construct a symbol using the same token found on another line.
+  ** Neither the type is guessed, nor the token is shared again.
+  **
+  ** @param symb The symbol of the same token
+  ** @param line The line number
+  */
+  Symbol::Symbol(const Symbol& symb, const int line)
+    : _text(symb._text), _line(line),
+      _type(symb._type)
+  {
+  }
+
   /*!
   ** Destroy the symbol
   */
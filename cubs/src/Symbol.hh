@@ -36,6 +36,7 @@ namespace MiniCompiler
     Symbol(const std::string& token, const int line,
 	   const type type);
     Symbol(const Symbol& symb);
+    Symbol(const Symbol& symb, const int line);
     void operator=(const Symbol& symb);
     ~Symbol();
 
@@ -0,0 +1,87 @@
+#include <cassert>
+#include <vector>
+#include "ThreadPool.hh"
+
+namespace MiniCompiler
+{
+  /*!
+  ** Construct a pool of threads.
+  **
+  ** @param jobs The maximum number of threads, the calling one included
+  */
+  ThreadPool::ThreadPool(const unsigned int jobs)
+    : _jobs(jobs), _task(0), _data(0), _nb(0), _next(0)
+  {
+    assert(jobs > 0);
+    pthread_mutex_init(&_mutex, 0);
+  }
+
+  /*!
+  ** Destruct the pool.
+  */
+  ThreadPool::~ThreadPool()
+  {
+    pthread_mutex_destroy(&_mutex);
+  }
+
+  /*!
+  ** Run tasks from 0 to nb excluded, and wait for all of them.
+  ** A task must not touch what another one uses, but its data.
+  **
+  ** @param task The function running a task
+  ** @param data The data given to every task
+  ** @param nb The number of tasks
+  */
+  void
+  ThreadPool::run(Task task, void* data, const unsigned int nb)
+  {
+    assert(task);
+    const unsigned int threads = nb < _jobs ? nb : _jobs;
+    std::vector<pthread_t> ids(threads);
+    std::vector<bool> launched(threads, false);
+
+    _task = task;
+    _data = data;
+    _nb = nb;
+    _next = 0;
+    for (unsigned int i = 1; i < threads; i++)
+      launched[i] = pthread_create(&ids[i], 0, &ThreadPool::launch, this) == 0;
+    work();
+    for (unsigned int i = 1; i < threads; i++)
+      if (launched[i])
+	pthread_join(ids[i], 0);
+  }
+
+  /*!
+  ** Entry point of a thread of the pool.
+  **
+  ** @param data The pool
+  **
+  ** @return Nothing
+  */
+  void*
+  ThreadPool::launch(void* data)
+  {
+    static_cast<ThreadPool*>(data)->work();
+    return 0;
+  }
+
+  /*!
+  ** Run tasks not taken yet, until there is none.
+  */
+  void
+  ThreadPool::work()
+  {
+    for (;;)
+    {
+      pthread_mutex_lock(&_mutex);
+      const unsigned int i = _next;
+      if (_next < _nb)
+	_next++;
+      pthread_mutex_unlock(&_mutex);
+      if (i >= _nb)
+	return;
+      _task(_data, i);
+    }
+  }
+}
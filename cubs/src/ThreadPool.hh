@@ -0,0 +1,40 @@
+#ifndef THREADPOOL_HH_
+# define THREADPOOL_HH_
+
+# include <pthread.h>
+
+namespace MiniCompiler
+{
+  /*!
+  ** Run independent tasks, known by their number, on several threads.
+  ** Each thread takes the next task not taken yet, so that a long task
+  ** doesn't hold back the others. The calling thread works too, and
+  ** runs every task when no thread can be created.
+  */
+  class ThreadPool
+  {
+  public:
+    typedef void (*Task)(void* data, const unsigned int i);
+
+  public:
+    ThreadPool(const unsigned int jobs);
+    ~ThreadPool();
+
+  public:
+    void run(Task task, void* data, const unsigned int nb);
+
+  private:
+    static void* launch(void* data);
+    void work();
+
+  private:
+    const unsigned int	_jobs;
+    Task		_task;
+    void*		_data;
+    unsigned int	_nb;
+    unsigned int	_next;
+    pthread_mutex_t	_mutex;
+  };
+}
+
+#endif /* !THREADPOOL_HH_ */
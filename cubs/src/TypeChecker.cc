@@ -5,9 +5,12 @@ namespace MiniCompiler
 {
   /*!
   ** Construct the type checker.
+  **
+  ** @param jobs The maximum number of threads checking function bodies
   */
-  TypeChecker::TypeChecker()
+  TypeChecker::TypeChecker(const unsigned int jobs)
   {
+    _visitor.setJobs(jobs);
   }
 
   /*!
@@ -11,7 +11,7 @@ namespace MiniCompiler
   class TypeChecker
   {
   public:
-    TypeChecker();
+    TypeChecker(const unsigned int jobs = 1);
     ~TypeChecker();
     void checkTypes(AST::NodeProgram* node);
     bool hasErrors() const;
@@ -1,3 +1,4 @@
+#include <vector>
 #include "TypeCheckerVisitor.hh"
 #include "NodeIds.hh"
 #include "NodeProgram.hh"
@@ -29,14 +30,27 @@
 #include "NodeId.hh"
 #include "NodeIdFunc.hh"
 #include "NodePrint.hh"
+#include "ThreadPool.hh"
 
 namespace MiniCompiler
 {
+  namespace
+  {
+    /*!
+    ** Functions checked on a thread pool, each by its own visitor.
+    */
+    struct Functions
+    {
+      std::vector<AST::NodeFunction*>		nodes;
+      std::vector<TypeCheckerVisitor*>	visitors;
+    };
+  }
+
   /*!
   ** Construct the type checker visitor.
   */
   TypeCheckerVisitor::TypeCheckerVisitor()
-    : _type(AST::Type::UNDEFINED)
+    : _type(AST::Type::UNDEFINED), _jobs(1)
   {
   }
 
@@ -47,6 +61,18 @@ namespace MiniCompiler
   {
   }
 
+  /*!
+  ** Set the maximum number of threads checking function bodies.
+  **
+  ** @param jobs The number of threads, at least 1
+  */
+  void
+  TypeCheckerVisitor::setJobs(const unsigned int jobs)
+  {
+    assert(jobs > 0);
+    _jobs = jobs;
+  }
+
   /*!
   ** Get all errors.
   **
@@ -80,18 +106,18 @@ namespace MiniCompiler
     // Get the return type
     AST::NodeType* retType = header->getType();
     assert(retType);
-    retType->accept(*this);
+    visit(retType);
     func->setComputedType(retType->getComputedType());
 
     // Type the function id
     AST::NodeIdFunc* id = header->getId();
     assert(id);
-    id->accept(*this);
+    visit(id);
 
     // Type all arguments of this function
     AST::NodeArguments* args = header->getArguments();
     if (args)
-      args->accept(*this);
+      visit(args);
 
     // Go to the next function declaration
     AST::NodeFunctions* funcs = node->getFuncs();
@@ -99,6 +125,55 @@ namespace MiniCompiler
       visitFuncHeader(funcs);
   }
 
+  /*!
+  ** Check each function body by its own visitor, on a thread pool.
+  ** Bodies only read types of globals and of function headers, set
+  ** before. Errors are then taken function by function, in order, so
+  ** they are the same as when checked by a single thread.
+  **
+  ** @param node The first functions node
+  **
+  ** @return If functions were checked, ie there are several of them
+  */
+  bool
+  TypeCheckerVisitor::visitInParallel(AST::NodeFunctions* node)
+  {
+    assert(node);
+    Functions functions;
+
+    for (; node; node = node->getFuncs())
+      functions.nodes.push_back(node->getFunc());
+    if (_jobs < 2 || functions.nodes.size() < 2)
+      return false;
+
+    for (unsigned int i = 0; i < functions.nodes.size(); i++)
+      functions.visitors.push_back(new TypeCheckerVisitor());
+    ThreadPool pool(_jobs);
+    pool.run(&TypeCheckerVisitor::launch, &functions,
+	     functions.nodes.size());
+    for (unsigned int i = 0; i < functions.visitors.size(); i++)
+    {
+      _errors.moveErrors(functions.visitors[i]->_errors);
+      delete functions.visitors[i];
+    }
+
+    return true;
+  }
+
+  /*!
+  ** Check a function body, from a thread of the pool.
+  **
+  ** @param data The functions
+  ** @param i The number of the function to check
+  */
+  void
+  TypeCheckerVisitor::launch(void* data, const unsigned int i)
+  {
+    Functions* functions = static_cast<Functions*>(data);
+
+    functions->visitors[i]->visit(functions->nodes[i]);
+  }
+
   /*!
   ** Construct a type mismatch error and add it to the error handler.
   **
@@ -134,16 +209,17 @@ namespace MiniCompiler
     assert(node);
     AST::NodeDeclarations* decls = node->getDecls();
     if (decls)
-      decls->accept(*this);
+      visit(decls);
     AST::NodeFunctions* funcs = node->getFuncs();
     if (funcs)
     {
       visitFuncHeader(funcs);
-      funcs->accept(*this);
+      if (!visitInParallel(funcs))
+	visit(funcs);
     }
     AST::NodeCompoundInstr* instrs = node->getInstrs();
     if (instrs)
-      instrs->accept(*this);
+      visit(instrs);
   }
 
   /*!
@@ -155,7 +231,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeIdFunc* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
     AST::NodeFunction* ref = node->getRef();
     assert(ref);
     node->setComputedType(ref->getComputedType());
@@ -206,7 +282,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeDeclarations* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -226,8 +302,8 @@ namespace MiniCompiler
     AST::NodeCompoundInstr* instr = node->getCompoundInstr();
     assert(instr);
     if (decls)
-      decls->accept(*this);
-    instr->accept(*this);
+      visit(decls);
+    visit(instr);
   }
 
   /*!
@@ -239,7 +315,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeReturn* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
     AST::NodeExpression* expr = node->getExpr();
     assert(expr);
     node->setComputedType(expr->getComputedType());
@@ -259,7 +335,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeExit* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
     AST::NodeExpression* expr = node->getExpr();
     assert(expr);
     node->setComputedType(expr->getComputedType());
@@ -284,7 +360,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeCompoundInstr* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -296,7 +372,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeFunctions* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -312,8 +388,8 @@ namespace MiniCompiler
     AST::NodeExpression* expr = node->getExpr();
     assert(id);
     assert(expr);
-    id->accept(*this);
-    expr->accept(*this);
+    visit(id);
+    visit(expr);
 
     // Check that variable and expression are compatible
     if (id->getComputedType() != expr->getComputedType())
@@ -335,7 +411,7 @@ namespace MiniCompiler
     assert(cond);
     assert(body);
 
-    cond->accept(*this);
+    visit(cond);
     if (cond->getComputedType() != AST::Type::BOOLEAN)
     {
       Configuration& cfg = Configuration::getInstance();
@@ -344,9 +420,9 @@ namespace MiniCompiler
 		       cfg["bool"] + " expression",
 		       node->getLine());
     }
-    body->accept(*this);
+    visit(body);
     if (elseExprs)
-      elseExprs->accept(*this);
+      visit(elseExprs);
   }
 
   /*!
@@ -358,7 +434,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeRead* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -370,7 +446,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeArgument* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -382,7 +458,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeArguments* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -394,7 +470,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeCallFunc* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
     AST::NodeIdFunc* id = node->getId();
     assert(id);
     node->setComputedType(id->getComputedType());
@@ -430,13 +506,13 @@ namespace MiniCompiler
     AST::NodeFactor* leftFactor = node->getLeftFactor();
     assert(leftFactor);
 
-    leftFactor->accept(*this);
+    visit(leftFactor);
     AST::Type::type lh = leftFactor->getComputedType();
     if (node->getOpType() != AST::Operator::NONE)
     {
       AST::NodeFactor* rightFactor = node->getRightFactor();
       assert(rightFactor);
-      rightFactor->accept(*this);
+      visit(rightFactor);
 
       // Check here if type is compatible
       if (lh != rightFactor->getComputedType())
@@ -512,7 +588,7 @@ namespace MiniCompiler
     assert(node);
     AST::NodeOperation* op = node->getOperation();
     assert(op);
-    op->accept(*this);
+    visit(op);
     node->setComputedType(op->getComputedType());
   }
 
@@ -526,7 +602,7 @@ namespace MiniCompiler
   {
     assert(node);
     node->setComputedType(AST::Type::STRING);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -539,7 +615,7 @@ namespace MiniCompiler
   {
     assert(node);
     node->setComputedType(AST::Type::BOOLEAN);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -551,7 +627,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeExpressions* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -563,7 +639,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeInstr* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -593,37 +669,37 @@ namespace MiniCompiler
 
     if (id)
     {
-      id->accept(*this);
+      visit(id);
       node->setComputedType(id->getComputedType());
       return;
     }
     if (callFunc)
     {
-      callFunc->accept(*this);
+      visit(callFunc);
       node->setComputedType(callFunc->getComputedType());
       return;
     }
     if (number)
     {
-      number->accept(*this);
+      visit(number);
       node->setComputedType(number->getComputedType());
       return;
     }
     if (stringExpr)
     {
-      stringExpr->accept(*this);
+      visit(stringExpr);
       node->setComputedType(stringExpr->getComputedType());
       return;
     }
     if (boolExpr)
     {
-      boolExpr->accept(*this);
+      visit(boolExpr);
       node->setComputedType(boolExpr->getComputedType());
       return;
     }
     if (expression)
     {
-      expression->accept(*this);
+      visit(expression);
       node->setComputedType(expression->getComputedType());
       return;
     }
@@ -638,7 +714,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeInstrs* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -651,7 +727,7 @@ namespace MiniCompiler
   {
     assert(node);
     node->setComputedType(Utils::stringToType(node->getType()));
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -668,7 +744,7 @@ namespace MiniCompiler
     assert(cond);
     assert(body);
 
-    cond->accept(*this);
+    visit(cond);
     if (cond->getComputedType() != AST::Type::BOOLEAN)
     {
       Configuration& cfg = Configuration::getInstance();
@@ -677,7 +753,7 @@ namespace MiniCompiler
 		       cfg["bool"] + " expression",
 		       node->getLine());
     }
-    body->accept(*this);
+    visit(body);
   }
 
   /*!
@@ -695,9 +771,9 @@ namespace MiniCompiler
     assert(type);
 
     assert(_type == AST::Type::UNDEFINED);
-    type->accept(*this);
+    visit(type);
     _type = type->getComputedType();
-    ids->accept(*this);
+    visit(ids);
     _type = AST::Type::UNDEFINED;
   }
 
@@ -711,7 +787,7 @@ namespace MiniCompiler
   {
     assert(node);
     node->setComputedType(AST::Type::INTEGER);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -723,7 +799,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeDeclaration* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -735,7 +811,7 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodePrint* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 
   /*!
@@ -747,6 +823,6 @@ namespace MiniCompiler
   TypeCheckerVisitor::visit(AST::NodeIds* node)
   {
     assert(node);
-    NonConstBaseVisitor::visit(node);
+    NonConstBaseVisitor<TypeCheckerVisitor>::visit(node);
   }
 }
@@ -8,47 +8,50 @@
 
 namespace MiniCompiler
 {
-  class TypeCheckerVisitor : public NonConstBaseVisitor
+  class TypeCheckerVisitor : public NonConstBaseVisitor<TypeCheckerVisitor>
   {
   public:
     TypeCheckerVisitor();
-    virtual ~TypeCheckerVisitor();
-    virtual void visit(AST::NodeIds* node);
-    virtual void visit(AST::NodeId* node);
-    virtual void visit(AST::NodeIdFunc* node);
-    virtual void visit(AST::NodeHeaderFunc* node);
-    virtual void visit(AST::NodeProgram* node);
-    virtual void visit(AST::NodeAffect* node);
-    virtual void visit(AST::NodeIf* node);
-    virtual void visit(AST::NodeRead* node);
-    virtual void visit(AST::NodeArgument* node);
-    virtual void visit(AST::NodeArguments* node);
-    virtual void visit(AST::NodeReturn* node);
-    virtual void visit(AST::NodeExit* node);
-    virtual void visit(AST::NodeCallFunc* node);
-    virtual void visit(AST::NodeOperation* node);
-    virtual void visit(AST::NodeExpression* node);
-    virtual void visit(AST::NodeStringExpr* node);
-    virtual void visit(AST::NodeBoolean* node);
-    virtual void visit(AST::NodeExpressions* node);
-    virtual void visit(AST::NodeInstr* node);
-    virtual void visit(AST::NodeCompoundInstr* node);
-    virtual void visit(AST::NodeFactor* node);
-    virtual void visit(AST::NodeInstrs* node);
-    virtual void visit(AST::NodeType* node);
-    virtual void visit(AST::NodeFunction* node);
-    virtual void visit(AST::NodeWhile* node);
-    virtual void visit(AST::NodeDeclarationBody* node);
-    virtual void visit(AST::NodeFunctions* node);
-    virtual void visit(AST::NodeNumber* node);
-    virtual void visit(AST::NodeDeclaration* node);
-    virtual void visit(AST::NodeDeclarations* node);
-    virtual void visit(AST::NodePrint* node);
+    ~TypeCheckerVisitor();
+    void setJobs(const unsigned int jobs);
+    void visit(AST::NodeIds* node);
+    void visit(AST::NodeId* node);
+    void visit(AST::NodeIdFunc* node);
+    void visit(AST::NodeHeaderFunc* node);
+    void visit(AST::NodeProgram* node);
+    void visit(AST::NodeAffect* node);
+    void visit(AST::NodeIf* node);
+    void visit(AST::NodeRead* node);
+    void visit(AST::NodeArgument* node);
+    void visit(AST::NodeArguments* node);
+    void visit(AST::NodeReturn* node);
+    void visit(AST::NodeExit* node);
+    void visit(AST::NodeCallFunc* node);
+    void visit(AST::NodeOperation* node);
+    void visit(AST::NodeExpression* node);
+    void visit(AST::NodeStringExpr* node);
+    void visit(AST::NodeBoolean* node);
+    void visit(AST::NodeExpressions* node);
+    void visit(AST::NodeInstr* node);
+    void visit(AST::NodeCompoundInstr* node);
+    void visit(AST::NodeFactor* node);
+    void visit(AST::NodeInstrs* node);
+    void visit(AST::NodeType* node);
+    void visit(AST::NodeFunction* node);
+    void visit(AST::NodeWhile* node);
+    void visit(AST::NodeDeclarationBody* node);
+    void visit(AST::NodeFunctions* node);
+    void visit(AST::NodeNumber* node);
+    void visit(AST::NodeDeclaration* node);
+    void visit(AST::NodeDeclarations* node);
+    void visit(AST::NodePrint* node);
 
   private:
     void typeMismatch(const AST::TypedNode* ref,
 		      const AST::TypedNode* current);
     void visitFuncHeader(AST::NodeFunctions* node);
+    bool visitInParallel(AST::NodeFunctions* node);
+    static void launch(void* data, const unsigned int i);
 
   public:
     const ErrorHandler& getErrors() const;
@@ -56,6 +59,7 @@ namespace MiniCompiler
   private:
     ErrorHandler	_errors;
     AST::Type::type	_type;
+    unsigned int	_jobs;
   };
 }
 
@@ -72,10 +72,10 @@ namespace MiniCompiler
 	      << Utils::typeToString(node->getArgument(i)->getComputedType())
 	      << "\n";
     _indent << Utils::stringFill(SPACING_CHAR, _tab + INDENT_SIZE) << "*/\n";
-    header->accept(*this);
+    visit(header);
     if (decls)
-      decls->accept(*this);
-    instr->accept(*this);
+      visit(decls);
+    visit(instr);
     _indent << '\n';
   }
 
@@ -96,12 +96,12 @@ namespace MiniCompiler
     assert(id);
     assert(type);
     _indent << Utils::stringFill(SPACING_CHAR, _tab);
-    id->accept(*this);
+    visit(id);
     _indent << cfg["("];
     if (args)
-      args->accept(*this);
+      visit(args);
     _indent << cfg[")"] << ' ' << cfg[":"] << ' ';
-    type->accept(*this);
+    visit(type);
     _indent << cfg[";"] << '\n';
   }
 
@@ -114,7 +114,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeId* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
     _indent << " <" << Utils::typeToString(node->getComputedType()) << "> ";
   }
 
@@ -127,7 +127,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeIdFunc* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
     _indent << " <" << Utils::typeToString(node->getComputedType()) << "> ";
   }
 
@@ -145,7 +145,7 @@ namespace MiniCompiler
     assert(expr);
     _indent << cfg["return"] << " <" <<
       Utils::typeToString(node->getComputedType()) << "> ";
-    expr->accept(*this);
+    visit(expr);
   }
 
   /*!
@@ -162,7 +162,7 @@ namespace MiniCompiler
     assert(expr);
     _indent << cfg["exit"] << " <" <<
       Utils::typeToString(node->getComputedType()) << "> ";
-    expr->accept(*this);
+    visit(expr);
   }
 
   /*!
@@ -174,7 +174,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeNumber* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
     _indent << " <" << Utils::typeToString(node->getComputedType()) << "> ";
   }
 
@@ -193,13 +193,13 @@ namespace MiniCompiler
 
     if (node->getOpType() != AST::Operator::NONE)
       _indent << cfg["("];
-    leftFactor->accept(*this);
+    visit(leftFactor);
     if (node->getOpType() != AST::Operator::NONE)
     {
       const AST::NodeFactor* rightFactor = node->getRightFactor();
       assert(rightFactor);
       _indent << ' ' << Utils::OpToString(node->getOpType()) << ' ';
-      rightFactor->accept(*this);
+      visit(rightFactor);
       _indent << cfg[")"];
       _indent << " <" << Utils::typeToString(node->getComputedType()) << "> ";
     }
@@ -214,7 +214,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeStringExpr* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
     _indent << " <" << Utils::typeToString(node->getComputedType()) << "> ";
   }
 
@@ -227,7 +227,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeBoolean* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
     _indent << " <" << Utils::typeToString(node->getComputedType()) << "> ";
   }
 
@@ -244,9 +244,9 @@ namespace MiniCompiler
     const AST::NodeExpression* expression = node->getExpression();
     _indent << cfg["("];
     if (expression)
-      expression->accept(*this);
+      visit(expression);
     else
-      ConstBaseVisitor::visit(node);
+      ConstBaseVisitor<TypeCheckingPrinterVisitor>::visit(node);
     _indent << cfg[")"];
     _indent << " <" << Utils::typeToString(node->getComputedType()) << "> ";
   }
@@ -264,7 +264,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeCallFunc* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -276,7 +276,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeExpression* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -288,7 +288,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeArgument* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -300,7 +300,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeIds* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -312,7 +312,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeProgram* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -324,7 +324,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeAffect* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -336,7 +336,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeIf* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -348,7 +348,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeRead* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -360,7 +360,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeArguments* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -372,7 +372,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeExpressions* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -384,7 +384,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeInstr* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -396,7 +396,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeCompoundInstr* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -408,7 +408,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeInstrs* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -420,7 +420,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeType* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
     _indent << " <" << Utils::typeToString(node->getComputedType()) << '>';
   }
 
@@ -433,7 +433,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeWhile* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -445,7 +445,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeDeclarationBody* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -457,7 +457,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeFunctions* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -469,7 +469,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeDeclaration* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -481,7 +481,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodeDeclarations* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -493,7 +493,7 @@ namespace MiniCompiler
   TypeCheckingPrinterVisitor::visit(const AST::NodePrint* node)
   {
     assert(node);
-    PrettyPrinterVisitor::visit(node);
+    BasicPrettyPrinterVisitor<TypeCheckingPrinterVisitor>::visit(node);
   }
 
   /*!
@@ -11,7 +11,7 @@ namespace MiniCompiler
     class TypedNode : public Node
     {
     public:
-      TypedNode();
+      TypedNode(const Kind::type kind);
       virtual ~TypedNode();
 
     public:
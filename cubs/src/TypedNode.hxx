@@ -4,10 +4,12 @@ namespace MiniCompiler
   {
     /*!
     ** Construct a node and computed type to Undefined.
+    **
+    ** @param kind The kind of the node
     */
     inline
-    TypedNode::TypedNode()
-      : _computedType(Type::UNDEFINED)
+    TypedNode::TypedNode(const Kind::type kind)
+      : Node(kind), _computedType(Type::UNDEFINED)
     {
     }
 
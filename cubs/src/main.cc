@@ -1,10 +1,33 @@
 #include <iostream>
+#include <limits>
 #include "Utils.hh"
 #include "Compiler.hh"
 #include "SharedString.hh"
 
 namespace
 {
+  /*!
+  ** Settings given by command line, shared by every launched file.
+  */
+  struct Settings
+  {
+    Settings()
+      : maxDepth(MiniCompiler::ExecutionVisitor::DEFAULT_MAX_DEPTH),
+	optimizationLevel(0), printAfter(""), timePasses(false), native(false),
+	generation(), output(""), jobs(1)
+    {
+    }
+
+    unsigned int	maxDepth;
+    unsigned int	optimizationLevel;
+    std::string		printAfter;
+    bool		timePasses;
+    bool		native;
+    MiniCompiler::GenerateAST::Parameters	generation;
+    std::string		output;
+    unsigned int	jobs;
+  };
+
   /*!
   ** Find the maximum value beetween two given arguments.
   **
@@ -32,7 +55,8 @@ namespace
   int
   usage(const std::string& prog)
   {
-    std::cout << "Usage: " << prog << " [-lLpPbBtTxXVGOcCsS] files...\n" << std::nl;
+    std::cout << "Usage: " << prog << " [--max-depth=N] [--native] [-O0|-O1|-O2] [--print-after=pass] [--time-passes] [--jobs=N]"
+	      << " [-lLpPbBtTxXmjVGOcCsSaAe] files...\n" << std::nl;
     std::cout << "\tl: Launch lexer" << std::nl;
     std::cout << "\tL: Launch and show lexer" << std::nl;
     std::cout << "\tp: Launch parser" << std::nl;
@@ -43,6 +67,9 @@ namespace
     std::cout << "\tT: Launch and show type checking" << std::nl;
     std::cout << "\tx: Launch execution" << std::nl;
     std::cout << "\tX: Launch and show execution" << std::nl;
+    std::cout << "\tm: Launch execution, memoizing pure functions" << std::nl;
+    std::cout << "\tj: Launch execution, compiled to x86-64 code in memory"
+	      << std::nl;
     std::cout << "\td: Launch debugging" << std::nl;
     std::cout << "\tD: Launch debugging and show special variables" << std::nl;
     std::cout << "\tV: Launch execution and show all except debugging" << std::nl;
@@ -53,21 +80,191 @@ namespace
     std::cout << "\tC: Convert to Cpp checking given code" << std::nl;
     std::cout << "\ts: Convert to ASM without prelude" << std::nl;
     std::cout << "\tS: Convert to ASM with prelude" << std::nl;
+    std::cout << "\ta: Convert to x86-64 ASM without runtime" << std::nl;
+    std::cout << "\tA: Convert to x86-64 ASM with runtime" << std::nl;
+    std::cout << "\te: Convert to x86-64 Linux executable" << std::nl;
+    std::cout << std::nl << "Execution:" << std::nl;
+    std::cout << "\t--max-depth=N: Maximum number of nested function calls"
+	      << " (default " << MiniCompiler::ExecutionVisitor::DEFAULT_MAX_DEPTH
+	      << ", at most " << MiniCompiler::ExecutionVisitor::LIMIT_MAX_DEPTH
+	      << ')' << std::nl;
+    std::cout << "\t--native: Launch execution compiled by the system C++"
+	      << " compiler, cached in $CUBS_CACHE_DIR or ~/.cache/cubs"
+	      << std::nl;
+    std::cout << std::nl << "Optimization:" << std::nl;
+    std::cout << "\t-O0: No optimization (default)" << std::nl;
+    std::cout << "\t-O1: Constant folding, peephole optimization of generated"
+	      << " ASM" << std::nl;
+    std::cout << "\t-O2: -O1, dead code and common subexpression"
+	      << " elimination" << std::nl;
+    std::cout << "\t--print-after=pass: Show the tree after the given pass"
+	      << std::nl;
+    std::cout << "\t--time-passes: Show time and changes of each pass"
+	      << std::nl;
+    std::cout << std::nl << "Parallelism:" << std::nl;
+    std::cout << "\t--jobs=N: Maximum number of threads lexing large files,"
+	      << " parsing, binding, type checking functions and generating"
+	      << " their C++ or asm (default 1)"
+	      << std::nl;
+    std::cout << std::nl << "Generation (G):" << std::nl;
+    std::cout << "\t--seed=N: A same seed gives a same program (default 1)"
+	      << std::nl;
+    std::cout << "\t--tokens=N: Approximate number of tokens (default 1000)"
+	      << std::nl;
+    std::cout << "\t--functions=N: Number of functions (default 1 per 1000"
+	      << " tokens)" << std::nl;
+    std::cout << "\t--nesting=N: Maximum nesting of blocks and expressions"
+	      << " (default 3)" << std::nl;
+    std::cout << "\t--fan-out=N: Maximum number of parameters, and of"
+	      << " instructions per block (default 4)" << std::nl;
+    std::cout << "\t--output=file: Write the program in a file, instead of"
+	      << " the standard output" << std::nl;
 
     return 42;
   }
 
+  /*!
+  ** Parse an optimization level, ie -O followed by a digit.
+  ** Must not be confused with the 'O' step option.
+  **
+  ** @param arg The command line argument
+  ** @param settings The settings to fill
+  **
+  ** @return If the argument is an optimization level
+  */
+  bool
+  parseOptimizationLevel(const std::string& arg, Settings& settings)
+  {
+    if (arg.length() != 3 || arg[0] != '-' || arg[1] != 'O' ||
+	arg[2] < '0' || arg[2] > '2')
+      return false;
+
+    settings.optimizationLevel = arg[2] - '0';
+    return true;
+  }
+
+  /*!
+  ** Parse a strictly positive number, which fits in the given type.
+  ** Reading a negative one directly in an unsigned type would wrap it.
+  **
+  ** @param t The number to fill
+  ** @param s The string to parse
+  **
+  ** @return If the string is a valid number
+  */
+  template <typename T>
+  bool
+  parsePositive(T& t, const std::string& s)
+  {
+    long long value = 0;
+
+    if (!MiniCompiler::Utils::fromString(value, s) || value <= 0 ||
+	static_cast<unsigned long long>(value) > std::numeric_limits<T>::max())
+      return false;
+    t = value;
+    return true;
+  }
+
+  /*!
+  ** Parse a long option, ie --name=value or --name.
+  **
+  ** @param arg The command line argument
+  ** @param settings The settings to fill
+  **
+  ** @return If the option is valid
+  */
+  bool
+  parseLongOption(const std::string& arg, Settings& settings)
+  {
+    static const std::string MAX_DEPTH = "--max-depth=";
+    static const std::string PRINT_AFTER = "--print-after=";
+    static const std::string TIME_PASSES = "--time-passes";
+    static const std::string NATIVE = "--native";
+    static const std::string SEED = "--seed=";
+    static const std::string TOKENS = "--tokens=";
+    static const std::string FUNCTIONS = "--functions=";
+    static const std::string NESTING = "--nesting=";
+    static const std::string FAN_OUT = "--fan-out=";
+    static const std::string OUTPUT = "--output=";
+    static const std::string JOBS = "--jobs=";
+    MiniCompiler::GenerateAST::Parameters& generation = settings.generation;
+    int value = 0;
+
+    if (arg.compare(0, MAX_DEPTH.length(), MAX_DEPTH) == 0 &&
+	MiniCompiler::Utils::fromString(value, arg.substr(MAX_DEPTH.length())) &&
+	value > 0 &&
+	static_cast<unsigned int>(value) <=
+	MiniCompiler::ExecutionVisitor::LIMIT_MAX_DEPTH)
+    {
+      settings.maxDepth = value;
+      return true;
+    }
+
+    if (arg.compare(0, JOBS.length(), JOBS) == 0 &&
+	MiniCompiler::Utils::fromString(value, arg.substr(JOBS.length())) &&
+	value > 0)
+    {
+      settings.jobs = value;
+      return true;
+    }
+
+    if (arg.compare(0, PRINT_AFTER.length(), PRINT_AFTER) == 0 &&
+	arg.length() > PRINT_AFTER.length())
+    {
+      settings.printAfter = arg.substr(PRINT_AFTER.length());
+      return true;
+    }
+
+    if (arg == TIME_PASSES)
+    {
+      settings.timePasses = true;
+      return true;
+    }
+
+    if (arg == NATIVE)
+    {
+      settings.native = true;
+      return true;
+    }
+
+    if (arg.compare(0, SEED.length(), SEED) == 0)
+      return parsePositive(generation.seed, arg.substr(SEED.length()));
+
+    if (arg.compare(0, TOKENS.length(), TOKENS) == 0)
+      return parsePositive(generation.tokens, arg.substr(TOKENS.length()));
+
+    if (arg.compare(0, FUNCTIONS.length(), FUNCTIONS) == 0)
+      return parsePositive(generation.functions, arg.substr(FUNCTIONS.length()));
+
+    if (arg.compare(0, NESTING.length(), NESTING) == 0)
+      return parsePositive(generation.nesting, arg.substr(NESTING.length()));
+
+    if (arg.compare(0, FAN_OUT.length(), FAN_OUT) == 0)
+      return parsePositive(generation.fanOut, arg.substr(FAN_OUT.length()));
+
+    if (arg.compare(0, OUTPUT.length(), OUTPUT) == 0 &&
+	arg.length() > OUTPUT.length())
+    {
+      settings.output = arg.substr(OUTPUT.length());
+      return true;
+    }
+
+    return false;
+  }
+
   /*!
   ** Launch execution of a given step for the given file.
   **
   ** @param filename The file to proceed
   ** @param option The step to apply on it
+  ** @param settings The command line settings
   **
   ** @return 0 if no errors occured, else a different value
   */
   int
   executeFile(const std::string& filename,
-	      const char option)
+	      const char option,
+	      const Settings& settings)
   {
     mystd::SharedString::clear();
     MiniCompiler::Compiler compiler(filename);
@@ -76,6 +273,14 @@ namespace
     try
     {
       compiler.setOption(option);
+      compiler.setMaxDepth(settings.maxDepth);
+      compiler.setOptimizationLevel(settings.optimizationLevel);
+      compiler.setPrintAfter(settings.printAfter);
+      compiler.setTimePasses(settings.timePasses);
+      compiler.setNative(settings.native);
+      compiler.setGeneration(settings.generation);
+      compiler.setOutput(settings.output);
+      compiler.setJobs(settings.jobs);
       res = compiler.execute();
       std::cerr << std::nl;
       switch (res)
@@ -127,12 +332,14 @@ namespace
   **
   ** @param filename The file to proceed
   ** @param options The steps to apply on it
+  ** @param settings The command line settings
   **
   ** @return The maximum value founded
   */
   int
   executeFileWithOptions(const std::string& filename,
-			 const std::string& options)
+			 const std::string& options,
+			 const Settings& settings)
   {
     typedef std::string::const_iterator iter;
     int res = 0;
@@ -141,7 +348,7 @@ namespace
     if(*i == '-')
       ++i;
     for (; i != options.end(); ++i)
-      res = max(res, executeFile(filename, *i));
+      res = max(res, executeFile(filename, *i, settings));
 
     return res;
   }
@@ -149,7 +356,8 @@ namespace
 
 /*!
 ** The main function of this program.
-** Expected a facultativ option and one or many files.
+** Expected facultativ long options and optimization level, a facultativ option
+** and one or many files.
 **
 ** @param argc Number of argument
 ** @param argv All arguments
@@ -160,22 +368,28 @@ int main(int argc, char** argv)
 {
   int res = 0;
   int begin = 1;
-  std::string options;
+  Settings settings;
+  std::string options = "x";
 
-  if (argc > 1 && argv[1][0] == '-')
+  while (begin < argc && argv[begin][0] == '-' &&
+	 (argv[begin][1] == '-' || parseOptimizationLevel(argv[begin], settings)))
   {
-    options = argv[1];
+    if (argv[begin][1] == '-' && !parseLongOption(argv[begin], settings))
+      return usage(argv[0]);
     begin++;
   }
 
-  if (argc > 1 && argv[1][0] != '-')
-    options = "x";
+  if (begin < argc && argv[begin][0] == '-')
+  {
+    options = argv[begin];
+    begin++;
+  }
 
   if (begin >= argc)
     return usage(argv[0]);
 
   for (int i = begin; i < argc; i++)
-    res = max(res, executeFileWithOptions(argv[i], options));
+    res = max(res, executeFileWithOptions(argv[i], options, settings));
 
   return res;
 }